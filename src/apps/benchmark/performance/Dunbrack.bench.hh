@@ -0,0 +1,63 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/benchmark/performance/Dunbrack.bench.hh
+/// @brief  Performance benchmark for rotamer library energy lookups
+/// @details Scores the current rotamer of every residue against its Dunbrack library, i.e. the
+/// phi/psi interpolation done for fa_dun in every scoring call and rotamer trial.
+
+#ifndef INCLUDED_apps_benchmark_Dunbrack_bench_hh
+#define INCLUDED_apps_benchmark_Dunbrack_bench_hh
+
+#include <apps/benchmark/performance/performance_benchmark.hh>
+
+#include <core/pose/Pose.hh>
+#include <core/import_pose/import_pose.hh>
+#include <core/conformation/Residue.hh>
+#include <core/pack/dunbrack/RotamerLibraryScratchSpace.hh>
+#include <core/pack/rotamers/SingleResidueRotamerLibrary.hh>
+#include <core/pack/rotamers/SingleResidueRotamerLibraryFactory.hh>
+
+#include <utility/vector1.hh>
+
+class DunbrackBenchmark : public PerformanceBenchmark
+{
+public:
+	DunbrackBenchmark(std::string name) : PerformanceBenchmark(name), energy_(0) {};
+
+	virtual void setUp() {
+		core::import_pose::pose_from_file(pose_, "test_in.pdb", core::import_pose::PDB_file);
+		libraries_.clear();
+		for ( core::Size i=1; i<=pose_.total_residue(); ++i ) {
+			// looked up once here so that run() times the energy evaluation, not the library cache
+			libraries_.push_back( core::pack::rotamers::SingleResidueRotamerLibraryFactory::get_instance()->get( pose_.residue_type(i) ) );
+		}
+	}
+
+	virtual void run(core::Real scaleFactor) {
+		core::Size reps( (core::Size)(2000*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; } // do at least one rep, regardless of scale factor
+		core::pack::dunbrack::RotamerLibraryScratchSpace scratch;
+		for ( core::Size r=0; r<reps; ++r ) {
+			for ( core::Size i=1; i<=pose_.total_residue(); ++i ) {
+				if ( libraries_[i] ) energy_ += libraries_[i]->rotamer_energy( pose_.residue(i), scratch );
+			}
+		}
+	};
+
+	virtual void tearDown() {
+		libraries_.clear();
+	};
+
+	core::pose::Pose pose_;
+	utility::vector1< core::pack::rotamers::SingleResidueRotamerLibraryCOP > libraries_;
+	core::Real energy_; ///< accumulated so the lookups cannot be optimized away
+};
+
+#endif
@@ -0,0 +1,79 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/benchmark/performance/FragmentInsertion.bench.hh
+/// @brief  Performance benchmark for centroid fragment insertion
+/// @details 3mer and 9mer fragments are taken from the backbone of test_in2.pdb and inserted
+/// into the centroid pose of test_in_cen.pdb, so no fragment files are needed.
+
+#ifndef INCLUDED_apps_benchmark_FragmentInsertion_bench_hh
+#define INCLUDED_apps_benchmark_FragmentInsertion_bench_hh
+
+#include <apps/benchmark/performance/performance_benchmark.hh>
+
+#include <core/pose/Pose.hh>
+#include <core/import_pose/import_pose.hh>
+#include <core/chemical/ChemicalManager.hh>
+#include <core/chemical/ResidueTypeSet.hh>
+#include <core/fragment/ConstantLengthFragSet.hh>
+#include <core/fragment/util.hh>
+#include <core/kinematics/MoveMap.hh>
+
+#include <protocols/simple_moves/FragmentMover.hh>
+
+#include <utility/vector1.hh>
+
+class FragmentInsertionBenchmark : public PerformanceBenchmark
+{
+public:
+	FragmentInsertionBenchmark(std::string name) : PerformanceBenchmark(name) {};
+
+	virtual void setUp() {
+		using namespace core::fragment;
+		core::chemical::ResidueTypeSetCOP rts = core::chemical::ChemicalManager::get_instance()->residue_type_set( core::chemical::CENTROID );
+		pose_ = core::pose::PoseOP( new core::pose::Pose );
+		core::import_pose::pose_from_file(*pose_, *rts, "test_in_cen.pdb", core::import_pose::PDB_file);
+
+		core::pose::Pose source;
+		core::import_pose::pose_from_file(source, "test_in2.pdb", core::import_pose::PDB_file);
+
+		core::kinematics::MoveMapOP movemap( new core::kinematics::MoveMap );
+		movemap->set_bb( true );
+
+		ConstantLengthFragSetOP frags3( new ConstantLengthFragSet( 3 ) );
+		steal_constant_length_frag_set_from_pose( source, *frags3 );
+		ConstantLengthFragSetOP frags9( new ConstantLengthFragSet( 9 ) );
+		steal_constant_length_frag_set_from_pose( source, *frags9 );
+		mover3_ = protocols::simple_moves::ClassicFragmentMoverOP( new protocols::simple_moves::ClassicFragmentMover( frags3, movemap ) );
+		mover9_ = protocols::simple_moves::ClassicFragmentMoverOP( new protocols::simple_moves::ClassicFragmentMover( frags9, movemap ) );
+		mover3_->set_check_ss( false );
+		mover9_->set_check_ss( false );
+	}
+
+	virtual void run(core::Real scaleFactor) {
+		core::Size reps( (core::Size)(200*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; } // do at least one rep, regardless of scale factor
+		for ( core::Size i=0; i<reps; ++i ) {
+			mover9_->apply( *pose_ );
+			mover3_->apply( *pose_ );
+		}
+	};
+
+	virtual void tearDown() {
+		pose_.reset();
+		mover3_.reset();
+		mover9_.reset();
+	};
+
+private:
+	core::pose::PoseOP pose_;
+	protocols::simple_moves::ClassicFragmentMoverOP mover3_, mover9_;
+};
+
+#endif
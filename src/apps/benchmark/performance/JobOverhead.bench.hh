@@ -0,0 +1,69 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/benchmark/performance/JobOverhead.bench.hh
+/// @brief  Performance benchmark for the per-job bookkeeping of jd2
+/// @details Times what jd2 does for every job around the mover itself: creating the Job,
+/// copying the starting pose out of the InnerJob, naming the output, the checkpoint test and
+/// handing the result to a JobOutputter (NoOutputJobOutputter, so nothing touches the disk).
+/// The JobDistributor singleton is not used, so the benchmark can be repeated in one process.
+
+#ifndef INCLUDED_apps_benchmark_JobOverhead_bench_hh
+#define INCLUDED_apps_benchmark_JobOverhead_bench_hh
+
+#include <apps/benchmark/performance/performance_benchmark.hh>
+
+#include <core/pose/Pose.hh>
+#include <core/import_pose/import_pose.hh>
+
+#include <protocols/jd2/InnerJob.hh>
+#include <protocols/jd2/Job.hh>
+#include <protocols/jd2/NoOutputJobOutputter.hh>
+
+#include <utility/vector1.hh>
+
+class JobOverheadBenchmark : public PerformanceBenchmark
+{
+public:
+	JobOverheadBenchmark(std::string name) : PerformanceBenchmark(name) {};
+
+	virtual void setUp() {
+		core::pose::PoseOP pose( new core::pose::Pose );
+		core::import_pose::pose_from_file(*pose, "test_in.pdb", core::import_pose::PDB_file);
+		inner_job_ = protocols::jd2::InnerJobOP( new protocols::jd2::InnerJob( pose, "test_in", 1000 ) );
+		outputter_ = protocols::jd2::JobOutputterOP( new protocols::jd2::NoOutputJobOutputter );
+	}
+
+	virtual void run(core::Real scaleFactor) {
+		using namespace protocols::jd2;
+		core::Size reps( (core::Size)(1000*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; } // do at least one rep, regardless of scale factor
+		core::pose::Pose pose;
+		for ( core::Size i=1; i<=reps; ++i ) {
+			JobOP job( new Job( inner_job_, i ) );
+			if ( outputter_->job_has_completed( job ) ) continue;
+			job->get_pose( pose );
+			job->start_timing();
+			job->add_string_real_pair( "benchmark", (core::Real)i );
+			job->end_timing();
+			outputter_->final_pose( job, pose, outputter_->output_name( job ) );
+		}
+	};
+
+	virtual void tearDown() {
+		inner_job_.reset();
+		outputter_.reset();
+	};
+
+private:
+	protocols::jd2::InnerJobOP inner_job_;
+	protocols::jd2::JobOutputterOP outputter_;
+};
+
+#endif
@@ -28,7 +28,7 @@
 
 using namespace core;
 
-enum  ScoreFnType {SFT_dfpmin, SFT_dfpmin_armijo, SFT_dfpmin_armijo_nonmonotone};
+enum  ScoreFnType {SFT_dfpmin, SFT_dfpmin_armijo, SFT_dfpmin_armijo_nonmonotone, SFT_lbfgs_armijo_nonmonotone};
 
 template  <ScoreFnType sft, int TScale>
 class MinimizerBenchmark : public PerformanceBenchmark
@@ -65,6 +65,7 @@ public:
 			if ( sft == SFT_dfpmin ) stype = "dfpmin";
 			if ( sft == SFT_dfpmin_armijo ) stype = "dfpmin_armijo";
 			if ( sft == SFT_dfpmin_armijo_nonmonotone ) stype = "dfpmin_armijo_nonmonotone";
+			if ( sft == SFT_lbfgs_armijo_nonmonotone ) stype = "lbfgs_armijo_nonmonotone";
 			core::optimization::MinimizerOptions options( stype/*"dfpmin"*/, 0, true );
 			core::pose::Pose pose;
 			pose = *start_pose;
@@ -78,6 +79,7 @@ public:
 typedef MinimizerBenchmark<SFT_dfpmin, 1> MinimizerBenchmark_dfpmin;
 typedef MinimizerBenchmark<SFT_dfpmin_armijo, 1> MinimizerBenchmark_dfpmin_armijo;
 typedef MinimizerBenchmark<SFT_dfpmin_armijo_nonmonotone, 1> MinimizerBenchmark_dfpmin_armijo_nonmonotone;
+typedef MinimizerBenchmark<SFT_lbfgs_armijo_nonmonotone, 1> MinimizerBenchmark_lbfgs_armijo_nonmonotone;
 
 
 //class MinimizerBenchmark_dfpmin : public MinimizerBenchmark
@@ -0,0 +1,54 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/benchmark/performance/NeighborGraph.bench.hh
+/// @brief  Performance benchmark for updating the residue neighbor graph after backbone moves
+
+#ifndef INCLUDED_apps_benchmark_NeighborGraph_bench_hh
+#define INCLUDED_apps_benchmark_NeighborGraph_bench_hh
+
+#include <apps/benchmark/performance/performance_benchmark.hh>
+
+#include <core/pose/Pose.hh>
+#include <core/import_pose/import_pose.hh>
+#include <core/scoring/ScoreFunction.hh>
+#include <core/scoring/ScoreFunctionFactory.hh>
+
+#include <numeric/random/random.hh>
+
+#include <utility/vector1.hh>
+
+class NeighborGraphBenchmark : public PerformanceBenchmark
+{
+public:
+	NeighborGraphBenchmark(std::string name) : PerformanceBenchmark(name) {};
+
+	virtual void setUp() {
+		core::import_pose::pose_from_file(pose_, "test_in.pdb", core::import_pose::PDB_file);
+		// scoring sets up the Energies object that owns the neighbor graph
+		(*core::scoring::get_score_function())( pose_ );
+	}
+
+	virtual void run(core::Real scaleFactor) {
+		core::Size reps( (core::Size)(200*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; } // do at least one rep, regardless of scale factor
+		for ( core::Size i=0; i<reps; ++i ) {
+			// a small phi change moves everything downstream, so many neighbor lists change
+			core::Size const seqpos = numeric::random::random_range( 2, pose_.total_residue() );
+			pose_.set_phi( seqpos, pose_.phi( seqpos ) + numeric::random::uniform() * 10.0 - 5.0 );
+			pose_.update_residue_neighbors();
+		}
+	};
+
+	virtual void tearDown() {};
+
+	core::pose::Pose pose_;
+};
+
+#endif
@@ -0,0 +1,104 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/benchmark/performance/Packer.bench.hh
+/// @brief  Performance benchmarks for the two halves of packing: computing the rotamer pair
+/// energies (trie-vs-trie) and simulated annealing over the precomputed interaction graph
+
+#ifndef INCLUDED_apps_benchmark_Packer_bench_hh
+#define INCLUDED_apps_benchmark_Packer_bench_hh
+
+#include <apps/benchmark/performance/performance_benchmark.hh>
+
+#include <core/pose/Pose.hh>
+#include <core/import_pose/import_pose.hh>
+#include <core/graph/Graph.hh>
+#include <core/scoring/ScoreFunction.hh>
+#include <core/scoring/ScoreFunctionFactory.hh>
+#include <core/pack/pack_rotamers.hh>
+#include <core/pack/packer_neighbors.hh>
+#include <core/pack/interaction_graph/InteractionGraphFactory.hh>
+#include <core/pack/interaction_graph/InteractionGraphBase.hh>
+#include <core/pack/rotamer_set/RotamerSets.hh>
+#include <core/pack/task/PackerTask.hh>
+#include <core/pack/task/TaskFactory.hh>
+
+#include <utility/vector1.hh>
+
+enum PackerBenchmarkStage { PBS_trie_vs_trie, PBS_annealing };
+
+/// Repacks every residue of test_in2.pdb with ex1 and ex2 rotamers.
+template <PackerBenchmarkStage stage>
+class PackerBenchmark : public PerformanceBenchmark
+{
+public:
+	PackerBenchmark(std::string name) : PerformanceBenchmark(name) {};
+
+	virtual void setUp() {
+		using namespace core::pack;
+		pose_ = core::pose::PoseOP( new core::pose::Pose );
+		core::import_pose::pose_from_file(*pose_, "test_in2.pdb", core::import_pose::PDB_file);
+		scorefxn_ = core::scoring::get_score_function();
+		task_ = task::TaskFactory::create_packer_task( *pose_ );
+		task_->restrict_to_repacking();
+		for ( core::Size i=1; i<=pose_->total_residue(); ++i ) {
+			task_->nonconst_residue_task( i ).or_ex1( true );
+			task_->nonconst_residue_task( i ).or_ex2( true );
+		}
+
+		(*scorefxn_)( *pose_ );
+		scorefxn_->setup_for_packing( *pose_, task_->repacking_residues(), task_->designing_residues() );
+		packer_neighbor_graph_ = create_packer_graph( *pose_, *scorefxn_, task_ );
+		rotsets_ = rotamer_set::RotamerSetsOP( new rotamer_set::RotamerSets );
+		rotsets_->set_task( task_ );
+		rotsets_->build_rotamers( *pose_, *scorefxn_, packer_neighbor_graph_ );
+		rotsets_->prepare_sets_for_packing( *pose_, *scorefxn_ );
+		ig_ = interaction_graph::InteractionGraphFactory::create_interaction_graph( *task_, *rotsets_, *pose_, *scorefxn_ );
+		if ( stage == PBS_annealing ) {
+			rotsets_->compute_energies( *pose_, *scorefxn_, packer_neighbor_graph_, ig_ );
+		}
+	}
+
+	virtual void run(core::Real scaleFactor) {
+		using namespace core::pack;
+		core::Size reps( (core::Size)(1*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; } // do at least one rep, regardless of scale factor
+		for ( core::Size i=0; i<reps; ++i ) {
+			if ( stage == PBS_trie_vs_trie ) {
+				ig_ = interaction_graph::InteractionGraphFactory::create_interaction_graph( *task_, *rotsets_, *pose_, *scorefxn_ );
+				rotsets_->compute_energies( *pose_, *scorefxn_, packer_neighbor_graph_, ig_ );
+			} else {
+				core::pose::Pose pose( *pose_ );
+				pack_rotamers_run( pose, task_, rotsets_, ig_ );
+			}
+		}
+	};
+
+	virtual void tearDown() {
+		pose_.reset();
+		scorefxn_.reset();
+		ig_.reset();
+		task_.reset();
+		rotsets_.reset();
+		packer_neighbor_graph_.reset();
+	};
+
+private:
+	core::pose::PoseOP pose_;
+	core::scoring::ScoreFunctionOP scorefxn_;
+	core::pack::interaction_graph::InteractionGraphBaseOP ig_;
+	core::pack::task::PackerTaskOP task_;
+	core::pack::rotamer_set::RotamerSetsOP rotsets_;
+	core::graph::GraphOP packer_neighbor_graph_;
+};
+
+typedef PackerBenchmark<PBS_trie_vs_trie> PackerBenchmark_trie_vs_trie;
+typedef PackerBenchmark<PBS_annealing> PackerBenchmark_annealing;
+
+#endif
@@ -0,0 +1,50 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/benchmark/performance/SASA.bench.hh
+/// @brief  Performance benchmark for per-atom solvent accessible surface area
+
+#ifndef INCLUDED_apps_benchmark_SASA_bench_hh
+#define INCLUDED_apps_benchmark_SASA_bench_hh
+
+#include <apps/benchmark/performance/performance_benchmark.hh>
+
+#include <core/pose/Pose.hh>
+#include <core/import_pose/import_pose.hh>
+#include <core/id/AtomID_Map.hh>
+#include <core/scoring/sasa.hh>
+
+#include <utility/vector1.hh>
+
+class SASABenchmark : public PerformanceBenchmark
+{
+public:
+	SASABenchmark(std::string name) : PerformanceBenchmark(name), total_(0) {};
+
+	virtual void setUp() {
+		core::import_pose::pose_from_file(pose_, "test_in.pdb", core::import_pose::PDB_file);
+	}
+
+	virtual void run(core::Real scaleFactor) {
+		core::Size reps( (core::Size)(20*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; } // do at least one rep, regardless of scale factor
+		core::id::AtomID_Map< core::Real > atom_sasa;
+		utility::vector1< core::Real > rsd_sasa;
+		for ( core::Size i=0; i<reps; ++i ) {
+			total_ += core::scoring::calc_per_atom_sasa( pose_, atom_sasa, rsd_sasa, 1.4 );
+		}
+	};
+
+	virtual void tearDown() {};
+
+	core::pose::Pose pose_;
+	core::Real total_; ///< accumulated so the calculation cannot be optimized away
+};
+
+#endif
@@ -0,0 +1,69 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/benchmark/performance/SilentFileIO.bench.hh
+/// @brief  Performance benchmark for writing and reading binary silent files
+/// @details Poses are written to and read back from an in-memory stream, so the benchmark
+/// measures formatting and parsing rather than the file system.
+
+#ifndef INCLUDED_apps_benchmark_SilentFileIO_bench_hh
+#define INCLUDED_apps_benchmark_SilentFileIO_bench_hh
+
+#include <apps/benchmark/performance/performance_benchmark.hh>
+
+#include <core/pose/Pose.hh>
+#include <core/import_pose/import_pose.hh>
+#include <core/io/silent/SilentFileData.hh>
+#include <core/io/silent/SilentStruct.hh>
+#include <core/io/silent/SilentStructFactory.hh>
+
+#include <utility/vector1.hh>
+
+#include <sstream>
+
+class SilentFileIOBenchmark : public PerformanceBenchmark
+{
+public:
+	SilentFileIOBenchmark(std::string name) : PerformanceBenchmark(name) {};
+
+	virtual void setUp() {
+		core::import_pose::pose_from_file(pose_, "test_in.pdb", core::import_pose::PDB_file);
+	}
+
+	virtual void run(core::Real scaleFactor) {
+		using namespace core::io::silent;
+		core::Size reps( (core::Size)(20*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; } // do at least one rep, regardless of scale factor
+
+		std::ostringstream out;
+		SilentFileData sfd_out;
+		for ( core::Size i=1; i<=reps; ++i ) {
+			std::ostringstream tag;
+			tag << "decoy_" << i;
+			SilentStructOP ss = SilentStructFactory::get_instance()->get_silent_struct("binary");
+			ss->fill_struct( pose_, tag.str() );
+			if ( i == 1 ) sfd_out._write_silent_struct( *ss, out );
+			else sfd_out.write_silent_struct( *ss, out );
+		}
+
+		std::istringstream in( out.str() );
+		SilentFileData sfd_in;
+		sfd_in.read_stream( in, utility::vector1< std::string >(), true );
+		core::pose::Pose pose;
+		for ( SilentFileData::iterator it = sfd_in.begin(); it != sfd_in.end(); ++it ) {
+			it->fill_pose( pose );
+		}
+	};
+
+	virtual void tearDown() {};
+
+	core::pose::Pose pose_;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+# -*- mode:python;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t;python-indent:4;tab-width:4 -*-
+# vi: set ts=4 noet:
+#
+# (c) Copyright Rosetta Commons Member Institutions.
+# (c) This file is part of the Rosetta software suite and is made available under license.
+# (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+# (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+# (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+"""Compare two -benchmark_json reports of performance_benchmark.
+
+    compare_benchmarks.py <reference.json> <new.json> [--threshold 0.10] [--metric wall|cpu]
+
+For every benchmark present in both reports the median time per run (p50) is compared.
+A benchmark is reported as a regression (or improvement) only if its median moved by more
+than the threshold AND beyond the spread of the other run (the reference p90 for slowdowns,
+the new p90 for speedups), so noisy benchmarks do not raise false alarms.
+Peak RSS changes larger than the threshold are reported as well.
+Exit status is 1 if any benchmark regressed, 0 otherwise.
+"""
+
+from __future__ import print_function
+
+import json
+import sys
+from argparse import ArgumentParser
+
+
+def load(filename):
+	with open(filename) as f:
+		return json.load(f)['benchmarks']
+
+
+def compare(ref, new, threshold, metric):
+	regressions = 0
+	print('%9s %9s %7s %9s %9s  %s' % ('REF_p50', 'NEW_p50', 'D/R', 'REF_RSS', 'NEW_RSS', 'BENCHMARK'))
+	for name in sorted(set(ref.keys()) | set(new.keys())):
+		if name not in ref or name not in new:
+			print('%9s %9s %7s %9s %9s  %s (only in %s)' % ('', '', '', '', '', name, 'reference' if name in ref else 'new'))
+			continue
+		r, n = ref[name][metric], new[name][metric]
+		if r['trials'] == 0 or n['trials'] == 0 or r['p50'] <= 0:
+			continue
+		ratio = (n['p50'] - r['p50']) / r['p50']
+		status = ''
+		if ratio > threshold and n['p50'] > r['p90']:
+			status = 'REGRESSION'
+			regressions += 1
+		elif ratio < -threshold and n['p90'] < r['p50']:
+			status = 'improvement'
+
+		r_rss, n_rss = ref[name].get('peak_rss_kb', 0), new[name].get('peak_rss_kb', 0)
+		if r_rss > 0 and float(n_rss - r_rss) / r_rss > threshold:
+			status += ' memory'
+
+		print('%9.4f %9.4f %+6.1f%% %9d %9d  %s %s' % (r['p50'], n['p50'], 100 * ratio, r_rss, n_rss, name, status))
+	return regressions
+
+
+def main(argv):
+	parser = ArgumentParser(description='Compare two performance_benchmark JSON reports.')
+	parser.add_argument('reference')
+	parser.add_argument('new')
+	parser.add_argument('--threshold', type=float, default=0.10, help='relative change of the median to report (default 0.10)')
+	parser.add_argument('--metric', choices=['wall', 'cpu'], default='wall', help='time to compare (default wall)')
+	args = parser.parse_args(argv)
+
+	regressions = compare(load(args.reference), load(args.new), args.threshold, args.metric)
+	if regressions:
+		print('%d benchmark(s) regressed' % regressions)
+		return 1
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main(sys.argv[1:]))
@@ -16,6 +16,9 @@
 
 #include <core/pose/Pose.hh>
 #include <core/import_pose/import_pose.hh>
+#include <core/io/StructFileRep.hh>
+#include <core/io/StructFileReaderOptions.hh>
+#include <core/io/pdb/pdb_reader.hh>
 
 #include <fstream>
 
@@ -53,5 +56,27 @@ public:
 
 	virtual void tearDown() {};
 
+	virtual core::Size items_per_run() const { return 10; }
+
 	std::string pdb_string_;
 };
+
+/// Parse only: .pdb file contents into one reused StructFileRep, without building a Pose.
+class PDBParseBenchmark : public PDB_IOBenchmark
+{
+public:
+	PDBParseBenchmark(std::string name) : PDB_IOBenchmark(name) {};
+
+	virtual void run(core::Real scaleFactor) {
+		core::Size reps( (core::Size)(100*scaleFactor) );
+		if ( reps == 0 ) { reps = 1; }
+		for ( core::Size i=0; i<reps; i++ ) {
+			core::io::pdb::read_sfr_from_pdb_file_contents(pdb_string_, options_, sfr_);
+		}
+	};
+
+	virtual core::Size items_per_run() const { return 100; }
+
+	core::io::StructFileReaderOptions options_;
+	core::io::StructFileRep sfr_;
+};
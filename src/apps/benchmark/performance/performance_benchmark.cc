@@ -30,8 +30,12 @@
 #include <utility/exit.hh>
 #include <stdio.h>
 
+#include <algorithm>
+#include <cmath>
+#include <ctime>
 #include <set>
 #include <fstream>
+#include <sstream>
 
 #if  !defined(WINDOWS) && !defined(WIN32)
 #include <sys/time.h>
@@ -41,6 +45,9 @@
 
 OPT_1GRP_KEY( Real, run, benchmark_scale )
 OPT_1GRP_KEY( String, run, run_one_benchmark )
+OPT_1GRP_KEY( Integer, run, benchmark_warmup )
+OPT_1GRP_KEY( Integer, run, benchmark_trials )
+OPT_1GRP_KEY( String, run, benchmark_json )
 
 const char results_filename[]     = "./../../../../_performance_";
 const char old_results_filename[] = "./../../../../_old_performance_";
@@ -85,6 +92,7 @@ LigandDockBenchmark ligand_dock("protocols.ligand_docking.LigandDockProtocol");
 
 #include <apps/benchmark/performance/pdb_io.bench.hh>
 PDB_IOBenchmark PDB_IO_("core.import_pose.pose_from_pdbstring");
+PDBParseBenchmark PDBParse_("core.io.pdb.read_sfr_from_pdb_file_contents");
 
 //This benchmark isn't really a good representation of ResidueType performance
 //#include <apps/benchmark/performance/ResidueType.bench.hh>
@@ -97,6 +105,30 @@ XMLParseBenchmark XMLParseBenchmark_("utility_tag_Tag_Create");
 #include <apps/benchmark/performance/FastRelax.bench.hh>
 #include <apps/benchmark/performance/InteractionGraph.bench.hh>
 
+#include <apps/benchmark/performance/SilentFileIO.bench.hh>
+SilentFileIOBenchmark SilentFileIO_("core.io.silent.SilentFileData");
+
+#include <apps/benchmark/performance/Dunbrack.bench.hh>
+DunbrackBenchmark Dunbrack_("core.pack.dunbrack.rotamer_energy");
+
+#include <apps/benchmark/performance/Packer.bench.hh>
+PackerBenchmark_trie_vs_trie PackerTrieVsTrie_("core.pack.rotamer_set.compute_energies");
+PackerBenchmark_annealing PackerAnnealing_("core.pack.pack_rotamers_run");
+
+MinimizerBenchmark_lbfgs_armijo_nonmonotone Minimizer_lbfgs_armijo_nonmonotone_("protocols.optimization.Minimizer_lbfgs_armijo_nonmonotone");
+
+#include <apps/benchmark/performance/NeighborGraph.bench.hh>
+NeighborGraphBenchmark NeighborGraph_("core.pose.update_residue_neighbors");
+
+#include <apps/benchmark/performance/SASA.bench.hh>
+SASABenchmark SASA_("core.scoring.calc_per_atom_sasa");
+
+#include <apps/benchmark/performance/FragmentInsertion.bench.hh>
+FragmentInsertionBenchmark FragmentInsertion_("protocols.simple_moves.ClassicFragmentMover");
+
+#include <apps/benchmark/performance/JobOverhead.bench.hh>
+JobOverheadBenchmark JobOverhead_("protocols.jd2.Job");
+
 
 // option key includes
 
@@ -119,79 +151,148 @@ std::vector<PerformanceBenchmark *> & PerformanceBenchmark::allBenchmarks()
 	return *allBenchmarks;
 }
 
-double PerformanceBenchmark::execute(Real scaleFactor)
-{
-	/// Reseting RG system before each performance run.
-	numeric::random::rg().set_seed( "mt19937", 1000 );
-
-	TR << "Setting up "<< name() << "..." << std::endl;
-	setUp();
-
-	/*double t;
+namespace {
 
+/// wall clock seconds since some fixed point
+double wall_seconds()
+{
 #if  !defined(WINDOWS) && !defined(WIN32)
-	TR << "Running(U) " << name() << "..." << std::endl;
-	struct rusage R0, R1;
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec*1e-6;
+#else
+	return double( clock() ) / CLOCKS_PER_SEC;
+#endif
+}
 
-	getrusage(RUSAGE_SELF, &R0);
-	run(scaleFactor);
+/// user cpu seconds used by the process so far (what the time budget of -benchmark_scale is spent in)
+double cpu_seconds()
+{
+#if  !defined(WINDOWS) && !defined(WIN32)
+	struct rusage R;
+	getrusage(RUSAGE_SELF, &R);
+	return R.ru_utime.tv_sec + R.ru_utime.tv_usec*1e-6;
+#else
+	return double( clock() ) / CLOCKS_PER_SEC;
+#endif
+}
 
-	getrusage(RUSAGE_SELF, &R1);
+/// Reset the peak RSS of the process to its current RSS, where the kernel supports it (Linux >= 4.0).
+void reset_peak_rss()
+{
+#if defined(__linux__)
+	std::ofstream clear_refs("/proc/self/clear_refs");
+	if ( clear_refs ) clear_refs << "5" << std::endl;
+#endif
+}
 
-	t = R1.ru_utime.tv_sec + R1.ru_utime.tv_usec*1e-6 - R0.ru_utime.tv_sec - R0.ru_utime.tv_usec*1e-6;
-	TR << "Running(U) " << name() << "... Done. Time:" << t << std::endl;
+/// Peak RSS in kB since the last reset_peak_rss(), or since the process started where it cannot be reset.
+Size peak_rss_kb()
+{
+#if defined(__linux__)
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while ( std::getline(status, line) ) {
+		if ( line.compare(0, 6, "VmHWM:") == 0 ) {
+			std::istringstream l( line.substr(6) );
+			Size kb(0);
+			l >> kb;
+			return kb;
+		}
+	}
+#endif
+#if  !defined(WINDOWS) && !defined(WIN32)
+	struct rusage R;
+	getrusage(RUSAGE_SELF, &R);
+#if defined(__APPLE__)
+	return R.ru_maxrss / 1024; // bytes on Mac OS
 #else
-	TR << "Running(W) " << name() << "..." << std::endl;
-	t = clock();
-	run(scaleFactor);
-	t = clock() - t;
-	t = t / CLOCKS_PER_SEC;
-	TR << "Running(W) " << name() << "... Done. Time:" << t << std::endl;
+	return R.ru_maxrss;
+#endif
+#else
+	return 0;
 #endif
+}
 
+}
 
-	TR << "Tear down "<< name() << "..." << std::endl;
-	tearDown();
-	TR << "Tear down "<< name() << "... Done." << std::endl << std::endl;
+PerformanceBenchmarkStatistics::PerformanceBenchmarkStatistics(std::vector<double> samples) :
+	trials(samples.size()), min(0), mean(0), stddev(0), p50(0), p90(0), p95(0), p99(0), max(0)
+{
+	if ( samples.empty() ) return;
+	std::sort(samples.begin(), samples.end());
+
+	double sum = 0;
+	for ( Size i = 0; i < samples.size(); ++i ) sum += samples[i];
+	mean = sum / samples.size();
+	double sq = 0;
+	for ( Size i = 0; i < samples.size(); ++i ) sq += (samples[i] - mean) * (samples[i] - mean);
+	stddev = samples.size() > 1 ? std::sqrt( sq / (samples.size() - 1) ) : 0.0;
+
+	min = samples.front();
+	max = samples.back();
+	// nearest rank: smallest sample with at least p percent of the samples at or below it
+	double const percents[] = { 50, 90, 95, 99 };
+	double * const values[] = { &p50, &p90, &p95, &p99 };
+	for ( Size k = 0; k < 4; ++k ) {
+		Size rank = (Size)std::ceil( percents[k] / 100.0 * samples.size() );
+		if ( rank < 1 ) rank = 1;
+		*values[k] = samples[ rank - 1 ];
+	}
+}
 
-	result_ += t;
-	return t;*/
-	double t = 0;
-	int n = 0;
-	double init = scaleFactor;
+std::string PerformanceBenchmarkStatistics::json() const
+{
+	char buf[1024];
+	sprintf(buf, "{\"trials\":%u, \"min\":%g, \"mean\":%g, \"stddev\":%g, \"p50\":%g, \"p90\":%g, \"p95\":%g, \"p99\":%g, \"max\":%g}",
+		(unsigned int)trials, min, mean, stddev, p50, p90, p95, p99, max);
+	return std::string(buf);
+}
 
-#if  !defined(WINDOWS) && !defined(WIN32)
-	TR << "Running(U) " << name() << "..." << std::endl;
-	while ( scaleFactor > 0 ) {
-		struct rusage R0, R1;
+double PerformanceBenchmark::execute(Real scaleFactor, Size warmup, Size trials)
+{
+	/// Reseting RG system before each performance run.
+	numeric::random::rg().set_seed( "mt19937", 1000 );
 
-		getrusage(RUSAGE_SELF, &R0);
-		run(1);
+	wall_times_.clear();
+	cpu_times_.clear();
+	reset_peak_rss();
 
-		getrusage(RUSAGE_SELF, &R1);
-		n++;
-		t = R1.ru_utime.tv_sec + R1.ru_utime.tv_usec*1e-6 - R0.ru_utime.tv_sec - R0.ru_utime.tv_usec*1e-6;
-		scaleFactor -= t;
+	TR << "Setting up "<< name() << "..." << std::endl;
+	double const setup_start = wall_seconds();
+	setUp();
+	setup_time_ = wall_seconds() - setup_start;
+
+	if ( warmup > 0 ) {
+		TR << "Warming up " << name() << " (" << warmup << " runs)..." << std::endl;
+		for ( Size i = 0; i < warmup; ++i ) run(1);
 	}
-	TR << "Running(U) " << name() << "... Done. Time: " << ( init - scaleFactor ) << ". Times executed:" << n << std::endl;
 
-#else
-	TR << "Running(W) " << name() << "..." << std::endl;
-	while ( scaleFactor > 0 ) {
-		t = clock();
+	// Old behaviour when no trial count is given: repeat until scaleFactor seconds of user time are spent.
+	double const init = scaleFactor;
+	int n = 0;
+
+	TR << "Running " << name() << "..." << std::endl;
+	while ( trials > 0 ? Size(n) < trials : scaleFactor > 0 ) {
+		double const w0 = wall_seconds(), c0 = cpu_seconds();
 		run(1);
-		t = clock() - t;
-		t = t / CLOCKS_PER_SEC;
-		scaleFactor -= t;
+		double const c = cpu_seconds() - c0, w = wall_seconds() - w0;
+		wall_times_.push_back(w);
+		cpu_times_.push_back(c);
+		scaleFactor -= c;
 		n++;
 	}
-	TR << "Running(W) " << name() << "... Done. Time: " << ( init - scaleFactor ) << ". Times executed:" << n << std::endl;
-#endif
-
+	PerformanceBenchmarkStatistics const wall( wall_times_ );
+	TR << "Running " << name() << "... Done. Time: " << ( init - scaleFactor ) << ". Times executed:" << n
+		<< ". Wall time per run p50/p90/max: " << wall.p50 << " " << wall.p90 << " " << wall.max << std::endl;
+	if ( items_per_run() > 0 && wall.p50 > 0 ) {
+		TR << "Throughput of " << name() << ": " << items_per_run() / wall.p50 << " " << item_name() << "/s (median run)" << std::endl;
+	}
 
 	TR << "Tear down "<< name() << "..." << std::endl;
 	tearDown();
-	TR << "Tear down "<< name() << "... Done." << std::endl << std::endl;
+	peak_rss_kb_ = peak_rss_kb();
+	TR << "Tear down "<< name() << "... Done. Peak RSS: " << peak_rss_kb_ << " kB" << std::endl << std::endl;
 
 	result_ += n;
 	time_ += ( init - scaleFactor );
@@ -269,7 +370,9 @@ B->result_ = *results.begin();
 
 void PerformanceBenchmark::executeOneBenchmark(
 	std::string const & name,
-	Real scaleFactor
+	Real scaleFactor,
+	Size warmup,
+	Size trials
 ) {
 	// Before, scaleFactor would just be how many times B is executed
 	// Now we search for scaleFactor tightly spaced tests.
@@ -282,7 +385,7 @@ void PerformanceBenchmark::executeOneBenchmark(
 		PerformanceBenchmark * B = all[i];
 		if ( B->name() == name ) {
 
-			B->execute( scaleFactor );
+			B->execute( scaleFactor, warmup, trials );
 			// perform_until_set_found( B, scaleFactor );
 
 			found_benchmark = true;
@@ -301,7 +404,7 @@ void PerformanceBenchmark::executeOneBenchmark(
 	}
 }
 
-void PerformanceBenchmark::executeAllBenchmarks(Real scaleFactor)
+void PerformanceBenchmark::executeAllBenchmarks(Real scaleFactor, Size warmup, Size trials)
 {
 	// Before, scaleFactor would just be how many times B is executed
 	// Now we search for scaleFactor tightly spaced tests.
@@ -320,7 +423,7 @@ void PerformanceBenchmark::executeAllBenchmarks(Real scaleFactor)
 	for ( Size i = 0; i < all.size(); ++i ) {
 		PerformanceBenchmark * B = all[ i ];
 		//perform_until_set_found( B, scaleFactor );
-		B->execute( scaleFactor );
+		B->execute( scaleFactor, warmup, trials );
 	}
 	//}
 	TR << std::endl << "Executing all benchmarks... Done." << std::endl;
@@ -369,6 +472,42 @@ std::string PerformanceBenchmark::getOneReport(std::string const & name)
 }
 
 
+/// Generating report file in JSON format:
+/// { "scale": 120, "warmup": 1, "trials": 10, "benchmarks": { "Bench1": { "setup": 0.5, "peak_rss_kb": 51200,
+///   "wall": { "trials": 10, "min": ..., "p50": ... }, "cpu": { ... },
+///   "throughput": { "unit": "structures/s", "items_per_run": 10, "p50": ... } }, ... } }
+/// "throughput" is only present for benchmarks with items_per_run() > 0.
+std::string PerformanceBenchmark::getJSONReport(Real scaleFactor, Size warmup, Size trials)
+{
+	std::vector<PerformanceBenchmark *> & all( allBenchmarks() );
+
+	char buf[1024];
+	sprintf(buf, "{\n  \"scale\":%g, \"warmup\":%u, \"trials\":%u,\n  \"benchmarks\":{\n",
+		scaleFactor, (unsigned int)warmup, (unsigned int)trials);
+	std::string res = buf;
+
+	bool first = true;
+	for ( Size i = 0; i < all.size(); i++ ) {
+		PerformanceBenchmark * B = all[i];
+		if ( B->wall_times_.empty() ) continue; // not executed
+		if ( !first ) res += ",\n";
+		first = false;
+		sprintf(buf, "{\"setup\":%g, \"peak_rss_kb\":%lu,\n      \"wall\":", B->setup_time_, (unsigned long)B->peak_rss_kb_);
+		res += "    \"" + B->name_ + "\":" + std::string(buf) + B->wall_statistics().json()
+			+ ",\n      \"cpu\":" + B->cpu_statistics().json();
+		PerformanceBenchmarkStatistics const wall( B->wall_statistics() );
+		if ( B->items_per_run() > 0 && wall.p50 > 0 ) {
+			sprintf(buf, ",\n      \"throughput\":{\"unit\":\"%s/s\", \"items_per_run\":%lu, \"p50\":%g}",
+				B->item_name().c_str(), (unsigned long)B->items_per_run(), B->items_per_run() / wall.p50);
+			res += buf;
+		}
+		res += "}";
+	}
+	res += "\n  }\n}\n";
+	return res;
+}
+
+
 int real_command_line_argc; char ** real_command_line_argv;
 int command_line_argc; char ** command_line_argv;
 
@@ -386,8 +525,14 @@ int main( int argc, char *argv[])
 		//NEW_OPT(run::benchmark_scale, "Amount to scale number of cycles to repeate each test", 1 );
 		NEW_OPT(run::benchmark_scale, "Amount of time to test for", 120 );
 		NEW_OPT(run::run_one_benchmark, "Run just a single performance benchmark", "" );
+		NEW_OPT(run::benchmark_warmup, "Untimed runs of each benchmark after setUp, before timing starts", 0 );
+		NEW_OPT(run::benchmark_trials, "Timed runs of each benchmark; 0 means repeat until -benchmark_scale seconds are spent", 0 );
+		NEW_OPT(run::benchmark_json, "Also write per-benchmark trial statistics and peak RSS as JSON to this file", "" );
 		basic::options::option.add_relevant(run::benchmark_scale);
 		basic::options::option.add_relevant(run::run_one_benchmark);
+		basic::options::option.add_relevant(run::benchmark_warmup);
+		basic::options::option.add_relevant(run::benchmark_trials);
+		basic::options::option.add_relevant(run::benchmark_json);
 		basic::options::option.add_relevant(in::path::database);
 
 		devel::init(argc, argv);
@@ -403,6 +548,11 @@ int main( int argc, char *argv[])
 		//TR << "native:"  << basic::options::option[ james::native ]() << "\n";
 		//TR << "DB:"  << basic::options::option[ in::path::database ]() << "\n";
 		Real scale = basic::options::option[ run::benchmark_scale ]();
+		if ( basic::options::option[ run::benchmark_warmup ]() < 0 || basic::options::option[ run::benchmark_trials ]() < 0 ) {
+			utility_exit_with_message("-benchmark_warmup and -benchmark_trials must not be negative");
+		}
+		Size const warmup = basic::options::option[ run::benchmark_warmup ]();
+		Size const trials = basic::options::option[ run::benchmark_trials ]();
 
 		TR << "Performance Benchmark started! Scale factor: " << scale << " -------------" << std::endl;
 
@@ -411,10 +561,10 @@ int main( int argc, char *argv[])
 		std::string report;
 		if ( basic::options::option[ run::run_one_benchmark ].user() ) {
 			std::string const & name(basic::options::option[ run::run_one_benchmark ]());
-			PerformanceBenchmark::executeOneBenchmark(name, scale);
+			PerformanceBenchmark::executeOneBenchmark(name, scale, warmup, trials);
 			report = PerformanceBenchmark::getOneReport(name);
 		} else {
-			PerformanceBenchmark::executeAllBenchmarks(scale);
+			PerformanceBenchmark::executeAllBenchmarks(scale, warmup, trials);
 			report = PerformanceBenchmark::getReport();
 		}
 
@@ -437,6 +587,16 @@ int main( int argc, char *argv[])
 
 		file.close();
 
+		if ( basic::options::option[ run::benchmark_json ].user() ) {
+			std::string const json_filename( basic::options::option[ run::benchmark_json ]() );
+			std::ofstream json(json_filename.c_str(), std::ios::out | std::ios::binary);
+			if ( !json ) {
+				Error() << "PerformanceBenchmark:: Unable to open file:" << json_filename << " for writing!!!" << std::endl;
+				return 1;
+			}
+			json << PerformanceBenchmark::getJSONReport(scale, warmup, trials);
+		}
+
 		// Do not adjust this line without altering the daemon code because it will look for it as signal of normal ending!
 		TR << "Performance Benchmark ended.   --------------------------------" << std::endl;
 	} catch ( utility::excn::EXCN_Base const & e ) {
@@ -23,10 +23,25 @@
 static THREAD_LOCAL basic::Tracer TR( "benchmark" );
 
 
+/// @brief Order statistics of the per-trial times of one benchmark, in seconds.
+struct PerformanceBenchmarkStatistics
+{
+	PerformanceBenchmarkStatistics() : trials(0), min(0), mean(0), stddev(0), p50(0), p90(0), p95(0), p99(0), max(0) {}
+
+	/// @brief summarize samples (nearest-rank percentiles)
+	PerformanceBenchmarkStatistics(std::vector<double> samples);
+
+	/// @brief JSON object with all the fields
+	std::string json() const;
+
+	core::Size trials;
+	double min, mean, stddev, p50, p90, p95, p99, max;
+};
+
 class PerformanceBenchmark
 {
 public:
-	PerformanceBenchmark(std::string name) : result_(0), time_(0.0), name_(name) {
+	PerformanceBenchmark(std::string name) : result_(0), time_(0.0), setup_time_(0.0), peak_rss_kb_(0), name_(name) {
 		allBenchmarks().push_back(this);
 		for ( unsigned int i=0; i<name_.size(); i++ ) {
 			if ( name_[i]=='.' || name_[i]==' ' ) name_[i]='_';
@@ -38,23 +53,47 @@ public:
 	virtual void run(core::Real /*scaleFactor*/) {}
 	virtual void tearDown() {}
 
-	/// Execute benchmark cycle i.e.: setUp() - run() - tearDown()
-	/// return number of seconds that was used to performe 'run' step.
-	double execute(core::Real scaleFactor);
+	/// Structures (or other work items) processed by one run(1), for throughput reporting; 0 if not meaningful.
+	virtual core::Size items_per_run() const { return 0; }
+
+	/// What items_per_run() counts, e.g. "structures".
+	virtual std::string item_name() const { return "structures"; }
+
+	/// Execute benchmark cycle i.e.: setUp() - warmup x run(1) - trials x run(1) - tearDown()
+	/// If trials is 0, run(1) is repeated until scaleFactor seconds of cpu time are spent instead.
+	/// return number of times 'run' step was timed.
+	double execute(core::Real scaleFactor, core::Size warmup=0, core::Size trials=0);
 	std::string name() { return name_; }
 
+	/// Wall clock and user cpu time of each timed run(1) of the last execute().
+	PerformanceBenchmarkStatistics wall_statistics() const { return PerformanceBenchmarkStatistics(wall_times_); }
+	PerformanceBenchmarkStatistics cpu_statistics() const { return PerformanceBenchmarkStatistics(cpu_times_); }
+
+	/// Peak resident set size in kB seen by the last execute(). Where the kernel allows the high-water
+	/// mark to be reset (Linux) it is the peak of this benchmark alone, otherwise the peak of the process so far.
+	core::Size peak_rss_kb() const { return peak_rss_kb_; }
+
 public:
 	static void executeOneBenchmark(
 		std::string const & name,
-		core::Real scaleFactor=1);
-	static void executeAllBenchmarks(core::Real scaleFactor=1);
+		core::Real scaleFactor=1,
+		core::Size warmup=0,
+		core::Size trials=0);
+	static void executeAllBenchmarks(core::Real scaleFactor=1, core::Size warmup=0, core::Size trials=0);
 	//static void perform_until_set_found ( PerformanceBenchmark * B, core::Real scaleFactor );
 	static std::string getReport();
 	static std::string getOneReport(std::string const & name);
 
+	/// JSON report of every benchmark that has been executed: setup time, per-trial wall and cpu time
+	/// statistics and peak RSS, keyed by benchmark name. Input to compare_benchmarks.py.
+	static std::string getJSONReport(core::Real scaleFactor, core::Size warmup, core::Size trials);
+
 private:
 	int result_;
 	double time_;
+	double setup_time_; ///< wall clock seconds spent in setUp()
+	std::vector<double> wall_times_, cpu_times_; ///< seconds per timed run(1)
+	core::Size peak_rss_kb_;
 	std::string name_; ///< name of the benchmark, must corelate to namespace ie: core.pose
 
 	/// function for keepig record of all created benchmark classes.
@@ -20,6 +20,8 @@
 #include <core/chemical/ChemicalManager.hh>
 
 #include <protocols/cluster/cluster.hh>
+#include <protocols/cluster/CoordinateClustering.hh>
+#include <core/pose/util.hh>
 #include <protocols/loops/Loops.hh>
 #include <core/import_pose/pose_stream/MetaPoseInputStream.hh>
 #include <core/import_pose/pose_stream/util.hh>
@@ -55,6 +57,70 @@ using namespace core::pose;
 using namespace protocols;
 using namespace basic::options;
 
+/// @brief -cluster:coordinate_method: keep only the compared coordinates of every input structure
+/// (no poses, no rescoring) and cluster all of them with the coordinate RMSD engine
+void
+cluster_by_coordinates( core::chemical::ResidueTypeSetCOP rsd_set ) {
+	using namespace basic::options::OptionKeys;
+	using namespace protocols::cluster;
+
+	utility::vector1< int > exclude_res;
+	if ( option[ OptionKeys::cluster::exclude_res ].user() ) exclude_res = option[ OptionKeys::cluster::exclude_res ]();
+
+	DecoyCoordinatesOP coords;
+	utility::vector1< std::string > tags;
+	core::import_pose::pose_stream::MetaPoseInputStream input = core::import_pose::pose_stream::streams_from_cmd_line();
+	while ( input.has_another_pose() ) {
+		core::pose::Pose pose;
+		input.fill_pose( pose, *rsd_set );
+		utility::vector1< core::Vector > const xyz( cluster_coordinates( pose, false, exclude_res ) );
+		if ( xyz.empty() ) continue;
+		if ( ! coords ) coords = DecoyCoordinatesOP( new DecoyCoordinates( xyz.size() ) );
+		if ( xyz.size() != coords->n_atoms() ) {
+			std::cerr << "Skipping " << core::pose::tag_from_pose( pose ) << ": " << xyz.size() << " CA atoms instead of " << coords->n_atoms() << std::endl;
+			continue;
+		}
+		coords->add( xyz );
+		tags.push_back( core::pose::tag_from_pose( pose ) );
+	}
+	if ( ! coords ) utility_exit_with_message( "No structures with CA atoms to cluster" );
+
+	std::string const method( option[ OptionKeys::cluster::coordinate_method ]() );
+	core::Size const nthreads( option[ OptionKeys::cluster::nthreads ]() );
+	if ( method == "taylor_butina" && option[ OptionKeys::cluster::radius ]() <= 0.0 ) {
+		utility_exit_with_message( "taylor_butina clustering needs a positive -cluster:radius" );
+	}
+
+	// every RMSD is computed once: either streamed to the matrix file, which the clustering then reads
+	// block by block, or (without a file) straight into the clustering
+	RmsdBlockSourceOP rmsd;
+	if ( option[ OptionKeys::cluster::rmsd_matrix_file ].user() ) {
+		std::string const rmsd_file( option[ OptionKeys::cluster::rmsd_matrix_file ]() );
+		RmsdMatrix::compute_to_file( *coords, rmsd_file, nthreads );
+		rmsd = RmsdBlockSourceOP( new RmsdMatrixFile( rmsd_file ) );
+	} else if ( method != "taylor_butina" ) {
+		RmsdMatrixOP matrix( new RmsdMatrix );
+		matrix->compute( *coords, nthreads );
+		rmsd = matrix;
+	}
+
+	utility::vector1< CoordinateCluster > clusters;
+	if ( method == "taylor_butina" ) {
+		clusters = rmsd ?
+			taylor_butina_clusters( *rmsd, option[ OptionKeys::cluster::radius ]() ) :
+			taylor_butina_clusters( *coords, option[ OptionKeys::cluster::radius ](), nthreads );
+	} else {
+		clusters = k_medoids_clusters( *coords, *rmsd, option[ OptionKeys::cluster::n_medoids ]() );
+	}
+
+	for ( core::Size i = 1; i <= clusters.size(); ++i ) {
+		std::cout << "CLUSTER " << i << " size " << clusters[i].members.size() << " center " << tags[ clusters[i].center ] << std::endl;
+		for ( core::Size j = 1; j <= clusters[i].members.size(); ++j ) {
+			std::cout << "MEMBER " << i << " " << j << " " << tags[ clusters[i].members[j] ] << std::endl;
+		}
+	}
+}
+
 int
 main( int argc, char * argv [] ) {
 	try {
@@ -118,6 +184,10 @@ main( int argc, char * argv [] ) {
 		std::cout << "                   -cluster:limit_total_structures  <int>      Maximal number of structures in total" << std::endl;
 		std::cout << "                   -cluster:sort_groups_by_energy              Sort clusters by energy." << std::endl;
 		std::cout << "                   -cluster:remove_highest_energy_member       Remove highest energy member of each cluster" << std::endl;
+		std::cout << "                   -cluster:coordinate_rmsd                    Compute the initial RMS matrix from CA coordinates with the threaded QCP engine" << std::endl;
+		std::cout << "                   -cluster:coordinate_method  <method>        Cluster all structures by CA coordinates only: taylor_butina (uses -cluster:radius) or k_medoids (uses -cluster:n_medoids)" << std::endl;
+		std::cout << "                   -cluster:rmsd_matrix_file  <file>           Write the coordinate RMSD matrix to this binary file" << std::endl;
+		std::cout << "                   -cluster:nthreads  <int>                    Threads for coordinate RMSD matrices (0 = all cores)" << std::endl;
 		std::cout << "                   -symmetry:symmetric_rmsd       \t\t\t\t\t\t For symmetric systems find the lowest rms by testing all chain combinations. Works only with silent file input that contain symmetry info and with all CA rmsd" << std::endl;
 		std::cout << " Examples: " << std::endl;
 		std::cout << "   cluster -database ~/minirosetta_database -in:file:silent silent.out -in::file::binary_silentfile -in::file::fullatom -native 1a19.pdb " << std::endl;
@@ -188,6 +258,11 @@ main( int argc, char * argv [] ) {
 		}
 
 
+		if ( option[ basic::options::OptionKeys::cluster::coordinate_method ]() != "none" ) {
+			cluster_by_coordinates( rsd_set );
+			return 0;
+		}
+
 		// Cluster the first up-to-400 structures by calculating a full rms matrix
 		core::import_pose::pose_stream::MetaPoseInputStream input = core::import_pose::pose_stream::streams_from_cmd_line();
 		while ( input.has_another_pose() && (clustering->nposes() < 400 ) ) {
@@ -0,0 +1,63 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file  apps/public/compile_residue_type_set_image.cc
+/// @brief Pack the params, patch and list files of residue type set directories into images for
+/// -chemical:residue_type_set_images.
+/// @details One image is written per directory, named <prefix><directory>.rtsimg, e.g.
+///   compile_residue_type_set_image.default.linuxgccrelease -image:sets fa_standard centroid -image:prefix /scratch/
+/// and then used with -chemical:residue_type_set_images /scratch/fa_standard.rtsimg /scratch/centroid.rtsimg
+
+#include <core/chemical/ResidueTypeSetImage.hh>
+#include <devel/init.hh>
+#include <basic/database/open.hh>
+#include <basic/options/option.hh>
+#include <basic/options/option_macros.hh>
+#include <basic/Tracer.hh>
+#include <utility/vector1.hh>
+#include <utility/excn/EXCN_Base.hh>
+
+#include <iostream>
+#include <string>
+
+static THREAD_LOCAL basic::Tracer TR( "apps.public.compile_residue_type_set_image" );
+
+OPT_1GRP_KEY( StringVector, image, sets )
+OPT_1GRP_KEY( String, image, prefix )
+
+void register_options() {
+	NEW_OPT( image::sets, "residue type set directories (under chemical/residue_type_sets/ of the database) to compile", utility::vector1< std::string >() );
+	NEW_OPT( image::prefix, "prefix of the image files written; each is named <prefix><directory>.rtsimg", "" );
+}
+
+int
+main( int argc, char * argv [] )
+{
+	try {
+		using namespace basic::options;
+		register_options();
+		devel::init( argc, argv );
+
+		utility::vector1< std::string > sets( option[ OptionKeys::image::sets ]() );
+		if ( sets.empty() ) {
+			sets.push_back( "fa_standard" );
+			sets.push_back( "centroid" );
+		}
+		for ( core::Size ii = 1; ii <= sets.size(); ++ii ) {
+			std::string const directory( basic::database::full_name( "chemical/residue_type_sets/" + sets[ ii ] + "/" ) );
+			std::string const image_filename( option[ OptionKeys::image::prefix ]() + sets[ ii ] + ".rtsimg" );
+			TR << "Compiling " << directory << " into " << image_filename << std::endl;
+			core::chemical::ResidueTypeSetImage::compile( directory, image_filename );
+		}
+	} catch ( utility::excn::EXCN_Base const & e ) {
+		std::cerr << "caught exception " << e.msg() << std::endl;
+		return -1;
+	}
+	return 0;
+}
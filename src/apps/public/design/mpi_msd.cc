@@ -435,6 +435,7 @@ int main( int argc, char ** argv )
 
 		ds->set_score_function( *sfxn );
 		ds->set_entity_resfile( entity_resfile );
+		ds->set_n_threads( option[ ms::nthreads ]() );
 		if ( option[ msd::double_lazy_ig_mem_limit ].user() ) {
 			std::cout << "Setting dlig nmeg limit" << option[ msd::double_lazy_ig_mem_limit ] << std::endl;
 			ds->set_dlig_nmeg_limit( option[ msd::double_lazy_ig_mem_limit ] );
@@ -485,11 +486,22 @@ int main( int argc, char ** argv )
 			ga.set_func( func );
 			// </stolen code>
 
+			// keep the fitness of every sequence seen so far on disk, so that a restarted run
+			// does not repack sequences it has evaluated before
+			ga.set_checkpoint_prefix( option[ ms::checkpoint::prefix ]() );
+			ga.set_checkpoint_write_interval( option[ ms::checkpoint::interval ]() );
+			ga.set_checkpoint_gzip( option[ ms::checkpoint::gz ]() );
+			ga.set_checkpoint_rename( option[ ms::checkpoint::rename ]() );
+			bool const restarted( ga.read_checkpoint() );
+			if ( restarted ) {
+				TR << "Restarting from generation " << ga.current_generation() << " of checkpoint " << ga.generations_checkpoint_filename() << " with " << ga.entity_cache().size() << " evaluated sequences" << std::endl;
+			}
+
 			/// Now initialize the GA with a population from which to begin exploration.
 			/// Initialize this population completely randomly so that the native sequence
 			/// is not arrived at unfairly.
 
-			if ( option[ msd::seed_sequences ].user() ) {
+			if ( !restarted && option[ msd::seed_sequences ].user() ) {
 				utility::vector1< std::string > seedseqs = option[ msd::seed_sequences ];
 				for ( Size ii = 1; ii <= seedseqs.size(); ++ii ) {
 					if ( seedseqs[ ii ].size() != ds->entity_task()->total_residue() ) {
@@ -498,12 +510,14 @@ int main( int argc, char ** argv )
 					ga.add_entity( protocols::multistate_design::entity_elements_from_1letterstring( seedseqs[ ii ] ) );
 				}
 			}
-			if ( option[ msd::seed_sequence_from_input_pdb ].user() ) {
+			if ( !restarted && option[ msd::seed_sequence_from_input_pdb ].user() ) {
 				std::string seq = read_native_sequence_for_entity_elements( ds->entity_task()->total_residue() );
 				ga.add_entity( protocols::multistate_design::entity_elements_from_1letterstring( seq ) );
 			}
 
-			if ( option[ msd::fill_gen1_from_seed_sequences ] && option[ msd::seed_sequences ].user() ) {
+			if ( restarted ) {
+				// keep the population of the checkpoint
+			} else if ( option[ msd::fill_gen1_from_seed_sequences ] && option[ msd::seed_sequences ].user() ) {
 				ga.fill_with_perturbations_of_existing_entities();
 			} else {
 				ga.fill_with_random_entities();
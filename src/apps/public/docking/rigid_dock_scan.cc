@@ -0,0 +1,152 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   apps/public/docking/rigid_dock_scan.cc
+/// @brief  exhaustive two-body rigid docking scan with slide-into-contact (protocols::sic_dock::RigidDockScan)
+/// @details the two partners are read from -rigid_dock_scan:partner1 and -rigid_dock_scan:partner2 and
+/// centered at the origin. every rotation of partner 1 in a QuaternionGrid is slid into contact with
+/// partner 2 along -rigid_dock_scan:ndirections approach directions, and each contact is scored with
+/// CB contacts, weighted by a residue-pair table if -rigid_dock_scan:respair_table is given. the
+/// -rigid_dock_scan:top_k best placements are written as two-chain PDBs.
+
+#include <devel/init.hh>
+
+#include <protocols/sic_dock/RigidDockScan.hh>
+#include <protocols/sic_dock/RigidScore.hh>
+#include <protocols/sic_dock/SICFast.hh>
+#include <protocols/sic_dock/util.hh>
+#include <basic/sampling/orientations/QuaternionGrid.hh>
+
+#include <core/chemical/AA.hh>
+#include <core/import_pose/import_pose.hh>
+#include <core/pose/Pose.hh>
+#include <core/pose/util.hh>
+
+#include <basic/options/option.hh>
+#include <basic/options/option_macros.hh>
+#include <basic/options/keys/out.OptionKeys.gen.hh>
+#include <basic/Tracer.hh>
+
+#include <ObjexxFCL/FArray2D.hh>
+#include <ObjexxFCL/string.functions.hh>
+
+#include <utility/excn/Exceptions.hh>
+#include <utility/io/izstream.hh>
+#include <utility/vector1.hh>
+
+#include <iostream>
+#include <string>
+
+OPT_1GRP_KEY( File, rigid_dock_scan, partner1 )
+OPT_1GRP_KEY( File, rigid_dock_scan, partner2 )
+OPT_1GRP_KEY( File, rigid_dock_scan, respair_table )
+OPT_1GRP_KEY( Integer, rigid_dock_scan, nrotations )
+OPT_1GRP_KEY( Integer, rigid_dock_scan, ndirections )
+OPT_1GRP_KEY( Integer, rigid_dock_scan, top_k )
+OPT_1GRP_KEY( Integer, rigid_dock_scan, nthreads )
+OPT_1GRP_KEY( Real, rigid_dock_scan, clash_dis )
+OPT_1GRP_KEY( Real, rigid_dock_scan, contact_dis )
+
+static THREAD_LOCAL basic::Tracer TR( "apps.public.docking.rigid_dock_scan" );
+
+using core::Size;
+using core::Real;
+
+/// @brief read a num_canonical_aas x num_canonical_aas table of reals, rows and columns in core::chemical::AA order
+ObjexxFCL::FArray2D<Real>
+read_respair_table( std::string const & fname ) {
+	using core::chemical::num_canonical_aas;
+	utility::io::izstream in( fname );
+	if ( !in.good() ) utility_exit_with_message( "rigid_dock_scan: cannot open residue-pair table " + fname );
+	ObjexxFCL::FArray2D<Real> table( num_canonical_aas, num_canonical_aas, 0.0 );
+	for ( int i = 1; i <= num_canonical_aas; ++i ) {
+		for ( int j = 1; j <= num_canonical_aas; ++j ) {
+			if ( !( in >> table(i,j) ) ) {
+				utility_exit_with_message( "rigid_dock_scan: residue-pair table " + fname + " must hold "
+					+ ObjexxFCL::string_of( num_canonical_aas*num_canonical_aas ) + " numbers" );
+			}
+		}
+	}
+	return table;
+}
+
+void
+center_pose( core::pose::Pose & pose ) {
+	protocols::sic_dock::trans_pose( pose, -protocols::sic_dock::center_of_geom( pose ) );
+}
+
+int
+main( int argc, char * argv [] ) {
+	try {
+		using namespace basic::options;
+		using namespace basic::options::OptionKeys;
+		using namespace protocols::sic_dock;
+
+		NEW_OPT( rigid_dock_scan::partner1, "mobile docking partner", "" );
+		NEW_OPT( rigid_dock_scan::partner2, "fixed docking partner", "" );
+		NEW_OPT( rigid_dock_scan::respair_table, "num_canonical_aas x num_canonical_aas residue-pair weights for CB contacts, rows for partner1 aa, columns for partner2 aa; plain CB contacts if not given", "" );
+		NEW_OPT( rigid_dock_scan::nrotations, "approximate number of rotations of partner1 to scan", 30000 );
+		NEW_OPT( rigid_dock_scan::ndirections, "number of approach directions per rotation", 300 );
+		NEW_OPT( rigid_dock_scan::top_k, "number of best placements to keep and write", 10 );
+		NEW_OPT( rigid_dock_scan::nthreads, "threads to scan rotations with (0 = hardware concurrency; multithreaded builds only)", 1 );
+		NEW_OPT( rigid_dock_scan::clash_dis, "slide-into-contact clash distance", 3.5 );
+		NEW_OPT( rigid_dock_scan::contact_dis, "CB contact distance", 12.0 );
+
+		devel::init( argc, argv );
+
+		if ( !option[ rigid_dock_scan::partner1 ].user() || !option[ rigid_dock_scan::partner2 ].user() ) {
+			utility_exit_with_message( "rigid_dock_scan needs -rigid_dock_scan:partner1 and -rigid_dock_scan:partner2" );
+		}
+
+		core::pose::Pose pose1, pose2;
+		core::import_pose::pose_from_file( pose1, option[ rigid_dock_scan::partner1 ]().name(), core::import_pose::PDB_file );
+		core::import_pose::pose_from_file( pose2, option[ rigid_dock_scan::partner2 ]().name(), core::import_pose::PDB_file );
+		center_pose( pose1 );
+		center_pose( pose2 );
+
+		Real const contact_dis = option[ rigid_dock_scan::contact_dis ]();
+		Real const clash_dis = option[ rigid_dock_scan::clash_dis ]();
+
+		SICFastOP sic( new SICFast( clash_dis ) );
+		sic->init( pose1, pose2 );
+
+		RigidScoreOP score;
+		if ( option[ rigid_dock_scan::respair_table ].user() ) {
+			score = RigidScoreOP( new ResPairScore( pose1, pose2, contact_dis,
+				read_respair_table( option[ rigid_dock_scan::respair_table ]().name() ) ) );
+		} else {
+			score = RigidScoreOP( new CBScore( pose1, pose2, clash_dis, contact_dis ) );
+		}
+
+		basic::sampling::orientations::QuaternionGridCOP rotations =
+			basic::sampling::orientations::QuaternionGridManager::get_instance()->request_by_size( option[ rigid_dock_scan::nrotations ]() );
+		TR << "scanning " << *rotations << std::endl;
+
+		RigidDockScan scan( sic, score, rotations, option[ rigid_dock_scan::ndirections ](), option[ rigid_dock_scan::top_k ]() );
+		scan.nthreads( option[ rigid_dock_scan::nthreads ]() );
+		utility::vector1<RigidDockScanResult> const & results = scan.run();
+		scan.show( TR );
+
+		std::string const prefix = option[ out::prefix ]();
+		for ( Size i = 1; i <= results.size(); ++i ) {
+			core::pose::Pose docked( pose1 );
+			xform_pose( docked, results[i].xform );
+			core::pose::append_pose_to_pose( docked, pose2 );
+			std::string const fname = prefix + "rigid_dock_scan_" + ObjexxFCL::string_of( i ) + ".pdb";
+			docked.dump_pdb( fname );
+			TR << fname << " score " << results[i].score << std::endl;
+		}
+
+		return 0;
+
+	} catch ( utility::excn::EXCN_Base const & e ) {
+		std::cout << "caught exception " << e.msg() << std::endl;
+		return -1;
+	}
+}
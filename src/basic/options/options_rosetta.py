@@ -1087,6 +1087,10 @@ Options = Option_Group( '',
 			desc="Checkpoint time interval in seconds",
 			lower='10', default='600',
 			),
+		Option( 'compact_pose_checkpoints', 'Boolean',
+			desc="Write the poses of checkpoints as compressed compact binary pose records instead of binary silent files. Checkpoints of either kind can be recovered.",
+			default='false',
+			),
 		Option( 'protocol', 'String',
 			desc="Which protocol to run, for Rosetta@home wrapper",
 			default='abrelax',
@@ -1187,10 +1191,13 @@ Options = Option_Group( '',
 		Option( 'enzdes_out', 'Boolean', desc='causes an enzdes-style scorefile (with information about catalytic res and some pose metric stuff ) to be written instead of the regular scorefile', default='false'),
 		Option( 'buffer_silent_output', 'Integer', default = '1', desc = 'write structures to silent-files in blocks of N structures to', ),
 		Option( 'buffer_flush_frequency', 'Real', default = '1.0', desc = 'when N structures (buffer_silent_output) are collected dump to file with probability X' ),
+		Option( 'async_output', 'Boolean', default = 'false', desc = 'Write pdb and silent file output, and the file buffer node output of MPIFileBufJobDistributor, on a dedicated I/O thread so that workers do not wait for the filesystem. Needs a multithreaded build.' ),
+		Option( 'async_output_buffer_mb', 'Integer', default = '256', lower = '1', desc = 'with -jd2:async_output, workers block while more than this many MB of output wait to be written' ),
+		Option( 'async_output_fsync', 'Boolean', default = 'false', desc = 'with -jd2:async_output, fsync every file after each batch of writes to it' ),
 		Option( 'delete_old_poses', 'Boolean', default = 'false', desc = 'Delete poses after they have been processed.  For jobs that process a large number of structures, the memory consumed by old poses is wasteful.', ),# NOTE: This option should probably be used by default, however it may have issues with special uses of the job distributor.  Once these issues are resolved, either enable it by default, or just do it with out asking.
 		Option( 'resource_definition_files', 'FileVector', desc = 'Specify all the jobs and all of their resources to the new JD2ResourceManager system', ),
 		Option( 'checkpoint_file', 'File', desc='write/read nstruct-based checkpoint files to the desired filename.' ),
-		#Option( 'nthreads', 'Integer', desc='The maximum number of threads to run at once using the MultiThreadedJobDistributor' ),
+		Option( 'nthreads', 'Integer', default = '1', lower = '0', desc = 'Number of jobs to run at once in this process, each on its own thread with its own copy of the mover (0 = hardware concurrency; multithreaded builds only)' ),
 		Option( 'failed_job_exception', 'Boolean', default = 'true', desc = 'If JD2 encounters an error during job execution, raise an exception at the end of the run', ),
 		Option( 'max_nstruct_in_memory', 'Integer', default = '1000000', desc = 'If nstruct is set higher than this number, JD2 will keep only this many jobs in memory in the jobs list at any given time (to keep the jobs list from filling up memory).  As jobs complete, they will be deleted and the jobs list will be filled out with new jobs.  This option is intended for exteremly large runs on systems like the Blue Gene/Q supercomputer.  To disable this sort of memory management, set this option to 0.', ),
 		Option( 'sequential_mpi_job_distribution', 'Boolean', default='false', desc = 'If specified, MPI versions of the JobDistributor send jobs to each slave in sequence (slave1, slave2, slave3 etc.).  False by default.  Note that this should NOT be used for production runs; it is intended only for regression tests in which non-sequential job distribution would result in stochastic variations.', ),
@@ -1202,6 +1209,11 @@ Options = Option_Group( '',
 
 	), # jd2
 
+	# jd3 job distributor settings  ------------------------------------------------------
+	Option_Group( 'jd3',
+		Option( 'n_threads_per_rank', 'Integer', default = '1', lower = '0', desc = 'Number of jobs each process runs at once, each on its own thread (0 = hardware concurrency; multithreaded builds only)' ),
+	), # jd3
+
 	# score function settings  -----------------------------------------------------------
 	Option_Group( 'score',
 		Option( 'score_pose_cutpoint_variants', 'Boolean', desc='Include cutpoint variants in the pose during linear chainbreak', default='false'),
@@ -1471,6 +1483,36 @@ Options = Option_Group( '',
 		Option( 'use_electrostatic_repulsion',  'Boolean',
 			desc="Use electrostatic repulsion"
 			),
+		Option( 'ig_snapshot', 'File',
+			desc="Interaction graph snapshot file. If it holds the energies for the same pose, packer task, rotamers and score function, the packer reads the precomputed interaction graph from this file instead of computing the rotamer pair energies. Otherwise the energies are computed, and written to the file if it holds no snapshot yet. Only PDInteractionGraphs and DensePDInteractionGraphs are saved."
+			),
+		Option( 'ig_snapshot_overwrite', 'Boolean', default='false',
+			desc="Replace the -packing:ig_snapshot file with the energies of any packing that does not match it"
+			),
+		Option( 'dee', 'Boolean', default='false',
+			desc="Before annealing, remove rotamers that cannot be part of the lowest energy assignment by Goldstein dead-end elimination. Applies to precomputed pair energy interaction graphs without rotamer links or couplings."
+			),
+		Option( 'dee_pairs', 'Boolean', default='false',
+			desc="With -packing:dee, also eliminate rotamer pairs against a magic bullet pair on each edge, and remove the rotamers all of whose pairs with a neighbor were eliminated."
+			),
+		Option( 'dee_threads', 'Integer', default='1', lower='0',
+			desc="Number of threads for the residues of a dead-end elimination pass (0 = hardware concurrency; multithreaded builds only)"
+			),
+		Option( 'tree_decomposition', 'Boolean', default='false',
+			desc="Find the lowest energy rotamer assignment exactly, by dynamic programming over a tree decomposition of the interaction graph, instead of annealing. Falls back to annealing if the tables do not fit -packing:tree_decomposition_mb, if the interaction graph does not hold precomputed pair energies, or if the task links or couples rotamers."
+			),
+		Option( 'tree_decomposition_mb', 'Real', default='256', lower='0',
+			desc="Memory budget in MB for the dynamic programming tables of -packing:tree_decomposition"
+			),
+		Option( 'trials_threads', 'Integer', default='1', lower='0',
+			desc="Threads for rotamer trials and rtmin.  Anything but 1 visits the residues set by set, each set holding residues that do not interact, and runs the residues of a set on this many threads (0 = one per core).  The outcome does not depend on the number of threads."
+			),
+		Option( 'trials_deterministic', 'Boolean', default='false',
+			desc="With -packing:trials_threads, form the residue sets in sequence order instead of random order, so that the outcome does not depend on the random number generator."
+			),
+		Option( 'vectorize_otf_etable', 'Boolean', default='false',
+			desc="In on-the-fly interaction graphs, compute the fa_atr, fa_rep and fa_sol energies between side chains over packed coordinate buffers instead of through the score function. The other two-body terms are unaffected."
+			),
 		Option( 'dump_rotamer_sets', 'Boolean',
 			desc="Output NMR-style PDB's with the rotamer sets used during packing"
 			),
@@ -1650,6 +1692,13 @@ Options = Option_Group( '',
 				store RPEs for (~4 KB per rotamer by default)",
 			default='10',
 			),
+		Option( 'linmem_ig_cache_mb', 'Real', default='0', lower='0',
+			desc="Memory budget in MB for the caches of the linear memory interaction graph \
+				that keep rotamer pair energies after they fall out of the recent history. \
+				The budget is shared among the edges and moved periodically to the edges \
+				expected to get the most hits, judged by their lookups and the hit rates \
+				of their nodes.  0, the default, turns the caches off.",
+			),
 		##Option( 'minimalist_ig', 'Boolean',
 		##       desc="DOES NOT YET WORK. Force the packer to use the minimalist interaction graph.  The minimalist \
 		##             interaction graph allocates no space for RPE storage.  It is \
@@ -2036,6 +2085,7 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 		Option( 'set_patch_atomic_charge', 'StringVector', desc="Modify patch atomic charge from the command line. Happens at time of patch file reading, so changes will propagate to patched versions of the residue type.  Uses a simplified version of the residue selector so will probably not work for patches with complex selector logic.   format should be::  -chemical:set_patch_atomic_charge <rsd-type-set1-name>:<rsd-type1-name>:<patch-name>:<atom1-name>:<new-charge> ... For example: '-chemical:set_atomic_charge fa_standard:PRO:NtermProteinFull:1H:-1' " ),
 		Option( 'enlarge_H_lj', 'Boolean', desc="Use larger LJ_WDEPTH for Hs to avoid RNA clashes", default='false'),
 		Option( 'no_hbonds_to_ether_oxygens', 'Boolean', desc="no H-bonds to nucleic acid ether oxygens O3', O4', O5'", default='false'),
+		Option( 'residue_type_set_images', 'FileVector', desc="Compiled residue type set images (see compile_residue_type_set_image) to read the params and patch files of the matching residue type sets from, instead of the database directory. The image is memory mapped read-only, so processes on one node share it. An image compiled from a different version of the database files is ignored with a warning." ),
 	), #-chemical
 
 	# Coarse options
@@ -2463,6 +2513,10 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 			desc='maximum size of residue segments used in kinematic closure calculations',
 			default='12'
 		),
+		Option( 'kic_closure_threads', 'Integer',
+			desc='Number of threads that solve the closure attempts of GeneralizedKIC at once.  With 1, each attempt is perturbed, closed and filtered before the next is perturbed (0 = hardware concurrency; multithreaded builds only)',
+			default='1', lower='0'
+		),
 		Option( 'kic_recover_last', 'Boolean',
 			desc='If true, do not recover lowest scoring pose after each outer cycle and at end of protocol in kic remodel and refine',
 			default='false'
@@ -4074,6 +4128,11 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 		Option( 'score_diff_cut','Real',desc='score difference cut for RNA and SWA clustering', default = '1000000.0' ),
 		Option( 'auto_tune', 'Boolean', desc='autotune rmsd for clustering between 0.1A up to 2.0A, for SWA clusterer', default='false' ),
 		Option( 'write_centers', 'Boolean', desc='Write out a silent file with the cluster centers', default='false' ),
+		Option( 'coordinate_rmsd', 'Boolean', desc='Compute the RMS matrix of the initial clustering set from extracted CA (or backbone) coordinates with the threaded QCP engine instead of pose-by-pose superposition. Falls back to the pose-based measure for gdtmm, symmetric, hotspot, skip_align, all-atom and RNA clustering', default='false' ),
+		Option( 'coordinate_method', 'String', desc='Cluster all input structures by coordinates only (no poses kept, no rescoring) with this method and print the cluster assignment. taylor_butina uses -cluster:radius, k_medoids uses -cluster:n_medoids', legal=['none','taylor_butina','k_medoids'], default='none' ),
+		Option( 'n_medoids', 'Integer', desc='Number of clusters for -cluster:coordinate_method k_medoids', default='10' ),
+		Option( 'rmsd_matrix_file', 'String', desc='Write the all-vs-all RMSD matrix of -cluster:coordinate_method to this binary file (streamed to disk block by block); the clustering then reads it back block by block instead of keeping it in memory' ),
+		Option( 'nthreads', 'Integer', desc='Number of threads for coordinate RMSD matrices (0 = hardware concurrency; multithreaded builds only)', default='1', lower='0' ),
 	),
 
 	Option_Group( 'cm', # comparative modeling
@@ -5457,6 +5516,8 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 		Option( 'refstruct', 'String', default = '', desc = 'File with a target reference structure' ),
 		Option( 'homo_file', 'String', default = '', desc = 'File containing homologs to exclude' ),
 		Option( 'createdb_rms_cutoff', 'RealVector', default = ['0','0','0'], desc = 'RMS cutoff used for throwing out similar fragments.' ),
+		Option( 'sorted_db', 'Boolean', default = 'false', desc = 'Save and load loop hash maps as compact sorted-key binary files (loopdb.<size>.sorted.db) that are memory mapped and shared between processes' ),
+		Option( 'threads', 'Integer', default = '1', lower = '0', desc = 'Number of threads used to build the loop hash library and to look up loop positions (0 = hardware concurrency; multithreaded builds only)' ),
 		Option( 'min_bbrms', 'Real', default='20.0' ),
 		Option( 'max_bbrms', 'Real', default='1400.0' ),
 		Option( 'min_rms'  , 'Real', default='0.5' ),
@@ -5576,6 +5637,7 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 		Option( 'euler_bin_size', 'Real', desc='The bin width for the euler angle hasher, in degrees', default = '10.0'),
 		Option( 'consolidate_matches', 'Boolean', desc='Instead of outputting all matches, group matches and then write only the top -match::output_matches_per_group from each group.', default = 'false'),
 		Option( 'output_matches_per_group', 'Integer', desc='The number of matches to output per group. Requires the -match::consolidate_matches flag is active.', default = '10'),
+		Option( 'max_resident_matches', 'Integer', desc='The most matches the match consolidator holds before writing out the ones it has kept; a group written out early may output more than -match::output_matches_per_group matches. 0 for no limit.', default = '0', lower = '0'),
 		Option( 'orientation_atoms', 'StringVector', desc="The three atoms, by name, on the downstream partner \
 			to use to describe its 6 dimensional coordinate; its position and orientation. \
 			Only usable when the downstream partner is a single residue. Exactly 3 atom names must be given. \
@@ -5631,6 +5693,7 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 			fall into the same voxels that the hits from the first round fell into.  Then the matcher goes back and generates the first-round hits \
 			again, but only keeps the ones that land into the same voxels that hits from round 2 fell into.  To be used, round 2 must also use the \
 			classic match algorithm (and must not use secondary matching).", default='false' ),
+		Option( 'nthreads', 'Integer', desc='Number of threads used to build hits at the scaffold build positions and to update the occupied space hash (0 = hardware concurrency; multithreaded builds only)', default='1', lower='0' ),
 	), # -match
 
 	Option_Group( 'matdes',
@@ -5937,6 +6000,7 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 		Option( 'Boltz_temp',                    'Real',             desc='thermodynamic temperature to use for specificity calculations', default='0.6' ),
 		Option( 'mutate_rate',                   'Real',              desc='rate of mutation per position', default='0.5' ),
 		Option( 'fraction_by_recombination',     'Real',                            desc='fraction of the population that should be generated by recombination during the evolution stage', default='0.5' ),
+		Option( 'nthreads',                      'Integer',         desc='number of threads that repack the states of a sequence at once in each process of mpi_msd (0 = hardware concurrency; multithreaded builds only)', default='1', lower='0' ),
 		Option_Group( 'checkpoint',
 			Option( 'prefix',             'String',                  desc='prefix to add to the beginning of checkpoint file names', default='' ),
 			Option( 'interval',             'Integer',                  desc='frequency with which the entity checkpoint is written', default='0' ),
@@ -6284,7 +6348,9 @@ EX_SIX_QUARTER_STEP_STDDEVS   7          +/- 0.25, 0.5, 0.75, 1, 1.25 & 1.5 sd;
 	Option_Group( 'qsar',
 		Option( 'weights','String',default='talaris2013',desc = 'select qsar weight set to use'),
 		Option( 'grid_dir','String',desc = 'Directory to store grids in'),
-		Option( 'max_grid_cache_size','Integer',desc= 'delete old grids if grid cache exceeds specified size')
+		Option( 'max_grid_cache_size','Integer',desc= 'delete old grids if grid cache exceeds specified size'),
+		Option( 'grid_threads','Integer',default='1',lower='0',desc= 'number of threads used to compute the scoring grids of a new receptor conformation (0 = hardware concurrency; multithreaded builds only)'),
+		Option( 'compact_grid_cache','Boolean',default='false',desc= 'store grids in -qsar:grid_dir as <hash>.grids.gz with the grid values as 32 bit floats instead of as <hash>.json.gz.  Both formats are read')
 	), # qsar
 
 	Option_Group( 'rbe',
@@ -42,6 +42,7 @@
 #include <core/chemical/MMAtomTypeSet.hh>
 #include <core/chemical/gasteiger/GasteigerAtomTypeSet.hh>
 #include <core/chemical/ResidueTypeSet.hh>
+#include <core/chemical/ResidueTypeSetImage.hh>
 #include <core/chemical/sdf/MolFileIOReader.hh>
 #include <core/chemical/mmCIF/mmCIFParser.hh>
 //#include <core/chemical/sdf/MolFileIOData.hh>
@@ -523,7 +524,7 @@ ChemicalManager::create_residue_type_set( std::string const & tag ) const {
 
 
 	std::string const directory( temp_str );
-	ResidueTypeSetOP new_set( new ResidueTypeSet( tag, directory ) );
+	ResidueTypeSetOP new_set( new ResidueTypeSet( tag, directory, residue_type_set_image_for_directory( directory ) ) );
 	new_set->init( extra_params_files, extra_patch_files );
 
 	for ( core::Size index(1); index <= extra_residues.size(); ++index ) {
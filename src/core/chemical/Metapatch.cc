@@ -57,6 +57,16 @@ Metapatch::Metapatch() :
 /// @note keep the order to avoid triggering parsing errors
 void
 Metapatch::read_file( std::string const & filename )
+{
+	utility::io::izstream data( filename.c_str() );
+	if ( !data.good() ) {
+		utility_exit_with_message("Cannot find metapatch file: "+filename);
+	}
+	read_stream( data(), filename );
+}
+
+void
+Metapatch::read_stream( std::istream & data, std::string const & filename )
 {
 	// clear old data
 	tr.Debug << "Reading metapatch file: " << filename << std::endl;
@@ -67,10 +77,6 @@ Metapatch::read_file( std::string const & filename )
 
 	utility::vector1< std::string > lines;
 	{ // read the lines file
-		utility::io::izstream data( filename.c_str() );
-		if ( !data.good() ) {
-			utility_exit_with_message("Cannot find metapatch file: "+filename);
-		}
 		std::string line;
 		while ( getline( data,line ) ) {
 			std::string const tag( tag_from_line( line ) );
@@ -24,6 +24,8 @@
 // Utility headers
 #include <utility/vector1.hh>
 
+#include <iosfwd>
+
 
 namespace core {
 namespace chemical {
@@ -41,6 +43,10 @@ public:
 	void
 	read_file( std::string const & filename );
 
+	/// @brief constructor from the contents of a metapatch file; filename is only used in messages
+	void
+	read_stream( std::istream & data, std::string const & filename );
+
 	/// can I operate on this residue type?
 	virtual
 	bool
@@ -457,6 +457,16 @@ PatchCase::may_change_aa() const {
 /// @note keep the order to avoid triggering parsing errors
 void
 Patch::read_file( std::string const & filename )
+{
+	utility::io::izstream data( filename.c_str() );
+	if ( !data.good() ) {
+		utility_exit_with_message("Cannot find patch file: "+filename);
+	}
+	read_stream( data(), filename );
+}
+
+void
+Patch::read_stream( std::istream & data, std::string const & filename )
 {
 	// clear old data
 	tr.Debug << "Reading patch file: " << filename << std::endl;
@@ -469,10 +479,6 @@ Patch::read_file( std::string const & filename )
 
 	utility::vector1< std::string > lines;
 	{ // read the lines file
-		utility::io::izstream data( filename.c_str() );
-		if ( !data.good() ) {
-			utility_exit_with_message("Cannot find patch file: "+filename);
-		}
 		std::string line;
 		while ( getline( data,line ) ) {
 			std::string const tag( tag_from_line( line ) );
@@ -25,6 +25,8 @@
 // Utility headers
 #include <utility/vector1.hh>
 
+#include <iosfwd>
+
 
 namespace core {
 namespace chemical {
@@ -141,6 +143,10 @@ public:
 	void
 	read_file( std::string const & filename );
 
+	/// @brief constructor from the contents of a patch file; filename is only used in messages
+	void
+	read_stream( std::istream & data, std::string const & filename );
+
 	/// can I operate on this residue type?
 	virtual
 	bool
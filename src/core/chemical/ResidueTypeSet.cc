@@ -37,6 +37,7 @@
 // Rosetta headers
 #include <core/chemical/ResidueTypeSet.hh>
 #include <core/chemical/ResidueTypeSetCache.hh>
+#include <core/chemical/ResidueTypeSetImage.hh>
 #include <core/chemical/ResidueTypeFinder.hh>
 #include <core/chemical/ResidueProperties.hh>
 #include <core/chemical/MergeBehaviorManager.hh>
@@ -65,7 +66,7 @@
 // C++ headers
 #include <fstream>
 #include <string>
-//#include <sstream>
+#include <sstream>
 #include <set>
 #include <algorithm>
 
@@ -88,14 +89,39 @@ namespace chemical {
 
 static THREAD_LOCAL basic::Tracer tr( "core.chemical.ResidueTypeSet" );
 
+namespace {
+
+/// @brief Open a database file in image if it holds the file, or on disk otherwise, and return the stream
+/// to read it from; null if it can be found in neither.
+std::istream *
+open_database_file(
+	ResidueTypeSetImageCOP const & image,
+	std::string const & database_directory,
+	std::string const & filename,
+	ResidueTypeSetImage::FileStream & image_data,
+	utility::io::izstream & disk_data
+)
+{
+	if ( image && image->open_file( ResidueTypeSetImage::relative_filename( database_directory, filename ), image_data ) ) {
+		return &image_data;
+	}
+	disk_data.open( filename.c_str() );
+	if ( !disk_data.good() ) return 0;
+	return &disk_data();
+}
+
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// @brief c-tor from directory
 ResidueTypeSet::ResidueTypeSet(
 	std::string const & name,
-	std::string const & directory
+	std::string const & directory,
+	ResidueTypeSetImageCOP image /* = ResidueTypeSetImageCOP() */
 ) :
 	name_( name ),
 	database_directory_(directory),
+	image_( image ),
 	merge_behavior_manager_( new MergeBehaviorManager( directory ) ),
 	cache_( ResidueTypeSetCacheOP( new ResidueTypeSetCache( *this ) ) )
 {
@@ -117,12 +143,14 @@ void ResidueTypeSet::init(
 	// read ResidueTypes
 	{
 		std::string const list_filename( database_directory_ + "residue_types.txt" );
-		utility::io::izstream data( list_filename.c_str() );
-		if ( !data.good() ) {
+		ResidueTypeSetImage::FileStream image_data;
+		utility::io::izstream disk_data;
+		std::istream * data( open_database_file( image_, database_directory_, list_filename, image_data, disk_data ) );
+		if ( !data ) {
 			utility_exit_with_message( "Unable to open file: " + list_filename + '\n' );
 		}
 		std::string line, tag;
-		while ( getline( data, line ) ) {
+		while ( getline( *data, line ) ) {
 			// Skip empty lines and comments.
 			if ( line.size() < 1 || line[0] == '#' ) continue;
 
@@ -175,9 +203,15 @@ void ResidueTypeSet::init(
 				orbital_types_ = ChemicalManager::get_instance()->orbital_type_set(tag);
 			} else {
 				std::string const filename( database_directory_ + line );
+				ResidueTypeSetImage::FileStream image_params;
+				utility::io::izstream disk_params;
+				std::istream * params( open_database_file( image_, database_directory_, filename, image_params, disk_params ) );
+				if ( !params ) {
+					utility_exit_with_message( "Cannot find file '" + filename + "'" );
+				}
 
 				ResidueTypeOP rsd_type( read_topology_file(
-					filename, atom_types_, elements_, mm_atom_types_, orbital_types_, get_self_weak_ptr() ) );
+					*params, filename, atom_types_, elements_, mm_atom_types_, orbital_types_, get_self_weak_ptr() ) );
 				if ( option[ OptionKeys::in::file::assign_gasteiger_atom_types ] ) {
 					gasteiger::GasteigerAtomTypeSetCOP gasteiger_set(
 						ChemicalManager::get_instance()->gasteiger_atom_type_set() );
@@ -199,9 +233,10 @@ void ResidueTypeSet::init(
 	// now apply patches
 	{
 		std::string const list_filename( database_directory_+"/patches.txt" );
-		utility::io::izstream data( list_filename.c_str() );
-
-		if ( !data.good() ) {
+		ResidueTypeSetImage::FileStream image_data;
+		utility::io::izstream disk_data;
+		std::istream * data( open_database_file( image_, database_directory_, list_filename, image_data, disk_data ) );
+		if ( !data ) {
 			utility_exit_with_message( "Unable to open patch list file: "+list_filename );
 		}
 
@@ -223,7 +258,7 @@ void ResidueTypeSet::init(
 		// Unconditional loading of listed patches is deliberate --
 		// if you specified it explicitly, you probably want it to load.
 		std::string line;
-		while ( getline( data,line) ) {
+		while ( getline( *data,line) ) {
 			if ( line.size() < 1 || line[ 0 ] == '#' ) continue;
 
 			// get rid of any comment lines.
@@ -286,13 +321,14 @@ void ResidueTypeSet::init(
 		// Also obtain metapatch filenames, for FA_STANDARD only.
 		if ( name_ == "fa_standard" ) {
 			std::string const meta_filename( database_directory_+"/metapatches.txt" );
-			utility::io::izstream data2( meta_filename.c_str() );
-
-			if ( !data2.good() ) {
+			ResidueTypeSetImage::FileStream image_data2;
+			utility::io::izstream disk_data2;
+			std::istream * data2( open_database_file( image_, database_directory_, meta_filename, image_data2, disk_data2 ) );
+			if ( !data2 ) {
 				utility_exit_with_message( "Unable to open metapatch list file: "+meta_filename );
 			}
 			std::string mpline;
-			while ( getline( data2, mpline ) ) {
+			while ( getline( *data2, mpline ) ) {
 				if ( mpline.size() < 1 || mpline[0] == '#' ) continue;
 				metapatch_filenames.push_back( database_directory_ + mpline );
 			}
@@ -375,16 +411,25 @@ ResidueTypeSet::apply_patches(
 	utility::vector1< std::string > const & metapatch_filenames
 )
 {
+	ResidueTypeSetImage::FileStream data;
 	for ( Size ii=1; ii<= patch_filenames.size(); ++ii ) {
 		PatchOP p( new Patch(name_) );
-		p->read_file( patch_filenames[ii] );
+		if ( image_ && image_->open_file( ResidueTypeSetImage::relative_filename( database_directory_, patch_filenames[ii] ), data ) ) {
+			p->read_stream( data, patch_filenames[ii] );
+		} else {
+			p->read_file( patch_filenames[ii] );
+		}
 		patches_.push_back( p );
 		patch_map_[ p->name() ].push_back( p );
 	}
 
 	for ( Size ii=1; ii <= metapatch_filenames.size(); ++ii ) {
 		MetapatchOP p( new Metapatch );
-		p->read_file( metapatch_filenames[ii] );
+		if ( image_ && image_->open_file( ResidueTypeSetImage::relative_filename( database_directory_, metapatch_filenames[ii] ), data ) ) {
+			p->read_stream( data, metapatch_filenames[ii] );
+		} else {
+			p->read_file( metapatch_filenames[ii] );
+		}
 		metapatches_.push_back( p );
 		metapatch_map_[ p->name() ] = p;
 	}
@@ -514,11 +559,34 @@ ResidueTypeSet::name_mapOP( std::string const & name_in ) const
 	}
 }
 
-/// @details Instantiates ResidueType
+namespace {
+
+/// @brief Releases a claim on generating a residue type (ResidueTypeSetCache::begin_generation) when it
+/// goes out of scope, so that early returns and exceptions let waiting threads proceed.
+class GenerationClaim {
+public:
+	GenerationClaim( ResidueTypeSetCache & cache, std::string const & rsd_name ) :
+		cache_( cache ),
+		rsd_name_( rsd_name )
+	{}
+
+	~GenerationClaim() { cache_.end_generation( rsd_name_ ); }
+
+private:
+	ResidueTypeSetCache & cache_;
+	std::string const rsd_name_;
+};
+
+}
+
+/// @details Instantiates ResidueType.  Safe to call from several threads at once: a residue type is
+/// generated by the first thread asking for it, and other threads asking for the same one wait for it.
 bool
 ResidueTypeSet::generate_residue_type( std::string const & rsd_name ) const
 {
 	if ( cache_->has_generated_residue_type( rsd_name ) ) return true; // already generated
+	if ( ! cache_->begin_generation( rsd_name ) ) return true; // generated by another thread meanwhile
+	GenerationClaim const claim( *cache_, rsd_name );
 
 	// get name (which holds patch information)
 	std::string rsd_name_base, patch_name;
@@ -1010,13 +1078,16 @@ ResidueTypeSet::load_shadowed_ids( std::string const & directory, std::string co
 
 	shadowed_ids_.clear();
 
-	utility::io::izstream file( directory + filename );
-	if ( ! file.good()  ) {
+	ResidueTypeSetImage::FileStream image_data;
+	utility::io::izstream disk_data;
+	std::istream * data( open_database_file( image_, database_directory_, directory + filename, image_data, disk_data ) );
+	if ( ! data ) {
 		tr << "For ResidueTypeSet " << name() << " there is no " << filename << " file to list known PDB ids." << std::endl;
 		tr << "    This will turn off PDB component loading for ResidueTypeSet " << name() << std::endl;
 		tr << "    Expected file: " << directory + filename << std::endl;
 		return;
 	}
+	std::istream & file( *data );
 	std::string line;
 	getline( file, line );
 	while ( file.good() ) {
@@ -31,6 +31,7 @@
 #include <core/chemical/ElementSet.fwd.hh>
 #include <core/chemical/MMAtomTypeSet.fwd.hh>
 #include <core/chemical/ResidueType.fwd.hh>
+#include <core/chemical/ResidueTypeSetImage.fwd.hh>
 #include <core/chemical/VariantType.hh>
 #include <core/chemical/Metapatch.fwd.hh>
 #include <core/chemical/Patch.fwd.hh>
@@ -71,10 +72,11 @@ public:
 	/// @brief default c-tor
 	ResidueTypeSet();
 
-	/// @brief constructor from directory
+	/// @brief constructor from directory; database files found in image are read from it instead of the disk
 	ResidueTypeSet(
 		std::string const & name,
-		std::string const & directory
+		std::string const & directory,
+		ResidueTypeSetImageCOP image = ResidueTypeSetImageCOP()
 	);
 
 	virtual ~ResidueTypeSet();
@@ -388,6 +390,9 @@ private:
 	/// @brief the database directory of the generating files ---> allows to use cached dunbrack libs
 	const std::string database_directory_;
 
+	/// @brief compiled image of the database files of this set, if one was given
+	ResidueTypeSetImageCOP image_;
+
 	MergeBehaviorManagerCOP merge_behavior_manager_;
 
 	/// @brief the patches
@@ -406,7 +411,8 @@ private:
 
 	/// @brief all cached residue_type information including generated residue_types, name3_map, etc.
 	/// By making the following an OP (instead of COP) the cache effectively becomes mutable even when in a
-	/// const ResidueTypeSet.
+	/// const ResidueTypeSet.  In multithreaded builds the cache does its own locking, so residue types
+	/// can be generated on demand from several threads sharing this set.
 	ResidueTypeSetCacheOP cache_;
 
 	/// @brief A list of L-chirality base types with an equivalent D-chirality base type.
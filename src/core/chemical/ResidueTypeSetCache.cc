@@ -20,6 +20,10 @@
 
 #include <basic/Tracer.hh>
 
+#if defined MULTI_THREADED && defined CXX11
+#include <functional>
+#endif
+
 static basic::Tracer TR( "core.chemical.ResidueTypeSetCache" );
 
 namespace core {
@@ -28,24 +32,61 @@ namespace chemical {
 //Constructor
 ResidueTypeSetCache::ResidueTypeSetCache( ResidueTypeSet const & rsd_type_set ):
 	rsd_type_set_( rsd_type_set )
-{}
+{
+#if defined MULTI_THREADED && defined CXX11
+	for ( Size ii = 0; ii < n_name_map_shards; ++ii ) {
+		name_map_shards_[ ii ] = NameMapSnapshot( new NameMap );
+	}
+#endif
+}
 
 //Destructor
 ResidueTypeSetCache::~ResidueTypeSetCache()
 {}
 
+#if defined MULTI_THREADED && defined CXX11
+Size
+ResidueTypeSetCache::shard_index( std::string const & name ) const
+{
+	return std::hash< std::string >()( name ) % n_name_map_shards;
+}
+
+ResidueTypeSetCache::NameMapSnapshot
+ResidueTypeSetCache::shard( Size index ) const
+{
+	return std::atomic_load( &name_map_shards_[ index ] );
+}
+#endif
+
 /// @details Main accessor function into ResidueTypeSetCache
 ResidueTypeCOP
 ResidueTypeSetCache::name_map( std::string const & name_in ) const
 {
-	std::map< std::string, ResidueTypeCOP >::const_iterator it = name_map_.find( name_in );
-	runtime_assert( it != name_map_.end() );
+	ResidueTypeCOP residue_type( find( name_in ) );
+	runtime_assert( residue_type != 0 );
+	return residue_type;
+}
+
+ResidueTypeCOP
+ResidueTypeSetCache::find( std::string const & name_in ) const
+{
+#if defined MULTI_THREADED && defined CXX11
+	NameMapSnapshot const name_map( shard( shard_index( name_in ) ) );
+	NameMap::const_iterator it = name_map->find( name_in );
+	if ( it == name_map->end() ) return ResidueTypeCOP();
+#else
+	NameMap::const_iterator it = name_map_.find( name_in );
+	if ( it == name_map_.end() ) return ResidueTypeCOP();
+#endif
 	return it->second;
 }
 
 void
 ResidueTypeSetCache::clear_cached_maps()
 {
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( maps_mutex_ );
+#endif
 	aa_map_.clear();
 	name3_map_.clear();
 	cached_aa_variants_map_.clear();
@@ -54,48 +95,92 @@ ResidueTypeSetCache::clear_cached_maps()
 void
 ResidueTypeSetCache::add_residue_type( ResidueTypeCOP residue_type )
 {
-	runtime_assert_string_msg( name_map_.find( residue_type->name() ) == name_map_.end(), "Error in core::chemical::ResidueTypeSetCache::add_residue_type(): Attempting to add a new residue type, but it already exists in the cache.  (Did you load a .params file with the -extra_res_fa commandline option that was already listed in residue_types.txt, perhaps?)" );
-	name_map_[ residue_type->name() ] = residue_type;
+	std::string const & name( residue_type->name() );
+#if defined MULTI_THREADED && defined CXX11
+	Size const index( shard_index( name ) );
+	std::lock_guard< std::mutex > lock( shard_mutexes_[ index ] );
+	std::shared_ptr< NameMap > name_map( new NameMap( *name_map_shards_[ index ] ) );
+#else
+	NameMap * name_map( &name_map_ );
+#endif
+	runtime_assert_string_msg( name_map->find( name ) == name_map->end(), "Error in core::chemical::ResidueTypeSetCache::add_residue_type(): Attempting to add a new residue type, but it already exists in the cache.  (Did you load a .params file with the -extra_res_fa commandline option that was already listed in residue_types.txt, perhaps?)" );
+	(*name_map)[ name ] = residue_type;
+#if defined MULTI_THREADED && defined CXX11
+	std::atomic_store( &name_map_shards_[ index ], NameMapSnapshot( name_map ) );
+#endif
 	//  clear_cached_maps(); // no can't do this
 }
 
 void
 ResidueTypeSetCache::remove_residue_type( std::string const & name )
 {
-	std::map< std::string, ResidueTypeCOP >::iterator it = name_map_.find( name );
-	runtime_assert( it != name_map_.end() );
-	name_map_.erase( it );
+	{
+#if defined MULTI_THREADED && defined CXX11
+		Size const index( shard_index( name ) );
+		std::lock_guard< std::mutex > lock( shard_mutexes_[ index ] );
+		std::shared_ptr< NameMap > name_map( new NameMap( *name_map_shards_[ index ] ) );
+#else
+		NameMap * name_map( &name_map_ );
+#endif
+		NameMap::iterator it = name_map->find( name );
+		runtime_assert( it != name_map->end() );
+		name_map->erase( it );
+#if defined MULTI_THREADED && defined CXX11
+		std::atomic_store( &name_map_shards_[ index ], NameMapSnapshot( name_map ) );
+#endif
+	}
 	clear_cached_maps();
 }
 
 void
 ResidueTypeSetCache::update_residue_type( ResidueTypeCOP residue_type_original, ResidueTypeCOP residue_type_new )
 {
-	std::map< std::string, ResidueTypeCOP >::const_iterator it = name_map_.find( residue_type_original->name() );
-	runtime_assert( it != name_map_.end() );
-	runtime_assert( residue_type_original->name() == residue_type_new->name() );
-	name_map_[ residue_type_original->name() ] = residue_type_new;
+	std::string const & name( residue_type_original->name() );
+	runtime_assert( name == residue_type_new->name() );
+	{
+#if defined MULTI_THREADED && defined CXX11
+		Size const index( shard_index( name ) );
+		std::lock_guard< std::mutex > lock( shard_mutexes_[ index ] );
+		std::shared_ptr< NameMap > name_map( new NameMap( *name_map_shards_[ index ] ) );
+#else
+		NameMap * name_map( &name_map_ );
+#endif
+		runtime_assert( name_map->find( name ) != name_map->end() );
+		(*name_map)[ name ] = residue_type_new;
+#if defined MULTI_THREADED && defined CXX11
+		std::atomic_store( &name_map_shards_[ index ], NameMapSnapshot( name_map ) );
+#endif
+	}
 	clear_cached_maps();
 }
 
 bool
 ResidueTypeSetCache::has_generated_residue_type( ResidueTypeCOP residue_type ) const {
-	std::map< std::string, ResidueTypeCOP >::const_iterator it = name_map_.find( residue_type->name() );
-	if ( it == name_map_.end() ) return false;
-	runtime_assert( it->second == residue_type );
+	ResidueTypeCOP const cached( find( residue_type->name() ) );
+	if ( cached == 0 ) return false;
+	runtime_assert( cached == residue_type );
 	return true;
 }
 
 bool
 ResidueTypeSetCache::has_generated_residue_type( std::string const & rsd_name ) const {
-	return ( name_map_.find( rsd_name ) != name_map_.end() );
+	return ( find( rsd_name ) != 0 );
 }
 
+/// @details In order of name, as in the serial build, no matter how the name map is sharded.
 ResidueTypeCOPs
 ResidueTypeSetCache::generated_residue_types() {
 	ResidueTypeCOPs residue_types;
-	for ( std::map< std::string, ResidueTypeCOP >::const_iterator it = name_map_.begin();
-			it != name_map_.end(); ++it ) {
+#if defined MULTI_THREADED && defined CXX11
+	NameMap name_map;
+	for ( Size ii = 0; ii < n_name_map_shards; ++ii ) {
+		NameMapSnapshot const name_map_shard( shard( ii ) );
+		name_map.insert( name_map_shard->begin(), name_map_shard->end() );
+	}
+#else
+	NameMap const & name_map( name_map_ );
+#endif
+	for ( NameMap::const_iterator it = name_map.begin(); it != name_map.end(); ++it ) {
 		residue_types.push_back( it->second );
 	}
 	return residue_types;
@@ -104,27 +189,73 @@ ResidueTypeSetCache::generated_residue_types() {
 void
 ResidueTypeSetCache::add_prohibited( std::string const & rsd_name )
 {
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( maps_mutex_ );
+#endif
 	prohibited_types_.insert( rsd_name );
 }
 
 bool
 ResidueTypeSetCache::is_prohibited( std::string const & rsd_name ) const
 {
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( maps_mutex_ );
+#endif
 	return prohibited_types_.count( rsd_name );
 }
 
+/// @details The query runs without holding the lock, since ResidueTypeFinder generates residue types
+/// through the ResidueTypeSet; if two threads run the same query, the first result stored is kept.
 ResidueTypeCOPs
 ResidueTypeSetCache::get_all_types_with_variants_aa( AA aa,
 	utility::vector1< std::string > const & variants,
 	utility::vector1< VariantType > const & exceptions )
 {
 	AA_VariantsExceptions query( std::make_pair( aa, std::make_pair( variants, exceptions ) ) );
-	if ( cached_aa_variants_map_.find( query ) == cached_aa_variants_map_.end() ) {
-		cached_aa_variants_map_[ query ] = ResidueTypeFinder( rsd_type_set_ ).aa( aa ).variants( variants ).variant_exceptions( exceptions ).get_all_possible_residue_types();
+	{
+#if defined MULTI_THREADED && defined CXX11
+		std::lock_guard< std::mutex > lock( maps_mutex_ );
+#endif
+		std::map< AA_VariantsExceptions, ResidueTypeCOPs >::const_iterator it = cached_aa_variants_map_.find( query );
+		if ( it != cached_aa_variants_map_.end() ) return it->second;
+	}
+	ResidueTypeCOPs const residue_types( ResidueTypeFinder( rsd_type_set_ ).aa( aa ).variants( variants ).variant_exceptions( exceptions ).get_all_possible_residue_types() );
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( maps_mutex_ );
+#endif
+	return cached_aa_variants_map_.insert( std::make_pair( query, residue_types ) ).first->second;
+}
+
+bool
+ResidueTypeSetCache::begin_generation( std::string const & rsd_name )
+{
+#if defined MULTI_THREADED && defined CXX11
+	std::unique_lock< std::mutex > lock( generation_mutex_ );
+	while ( in_generation_.count( rsd_name ) ) {
+		generation_done_.wait( lock );
 	}
-	return cached_aa_variants_map_[ query ];
+	// the thread that held the claim may have failed to generate it, in which case this one tries again
+	if ( has_generated_residue_type( rsd_name ) ) return false;
+	in_generation_.insert( rsd_name );
+	return true;
+#else
+	return ! has_generated_residue_type( rsd_name );
+#endif
 }
 
+void
+ResidueTypeSetCache::end_generation( std::string const & rsd_name )
+{
+#if defined MULTI_THREADED && defined CXX11
+	{
+		std::lock_guard< std::mutex > lock( generation_mutex_ );
+		in_generation_.erase( rsd_name );
+	}
+	generation_done_.notify_all();
+#else
+	(void) rsd_name;
+#endif
+}
 
 } //chemical
 } //core
@@ -10,6 +10,10 @@
 /// @file core/chemical/ResidueTypeSetCache.hh
 /// @brief
 /// @details Internal implementation classs for ResidueTypeSet. Do not expose to the outside world.
+/// In multithreaded builds the cache may be read and extended by several threads at once: lookups
+/// by name read an immutable snapshot of one shard of the name map without taking a lock, additions
+/// copy the shard and publish the new snapshot, and each new residue type is generated by exactly
+/// one thread (see begin_generation()) while other threads asking for it wait.
 /// @author Rhiju Das, rhiju@stanford.edu
 
 
@@ -22,9 +26,16 @@
 #include <core/chemical/ResidueTypeSet.fwd.hh>
 #include <core/chemical/VariantType.hh>
 #include <core/chemical/AA.hh>
+#include <core/types.hh>
 #include <map>
 #include <set>
 
+#if defined MULTI_THREADED && defined CXX11
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#endif
+
 namespace core {
 namespace chemical {
 
@@ -46,6 +57,10 @@ public:
 	ResidueTypeCOP
 	name_map( std::string const & name_in ) const;
 
+	/// @brief the residue type called name_in, or null if it has not been generated
+	ResidueTypeCOP
+	find( std::string const & name_in ) const;
+
 	void
 	add_residue_type( ResidueTypeCOP residue_type );
 
@@ -77,6 +92,34 @@ public:
 
 	void clear_cached_maps();
 
+	/// @brief Claim the generation of rsd_name.  Returns false if rsd_name has already been generated,
+	/// waiting first if another thread is generating it right now.  Returns true if the calling thread
+	/// should generate it; it must then call end_generation( rsd_name ) whether or not it succeeds.
+	bool
+	begin_generation( std::string const & rsd_name );
+
+	/// @brief release the claim on rsd_name taken by begin_generation()
+	void
+	end_generation( std::string const & rsd_name );
+
+private:
+
+	typedef std::map< std::string, ResidueTypeCOP > NameMap;
+
+#if defined MULTI_THREADED && defined CXX11
+	typedef std::shared_ptr< NameMap const > NameMapSnapshot;
+
+	/// @brief number of independently updated pieces of the name map, so that adding a residue type
+	/// copies only a small map
+	static Size const n_name_map_shards = 32;
+
+	/// @brief the shard holding name
+	Size shard_index( std::string const & name ) const;
+
+	/// @brief the current snapshot of a shard; safe to call concurrently with add/remove/update
+	NameMapSnapshot shard( Size index ) const;
+#endif
+
 private:
 
 	ResidueTypeSet const & rsd_type_set_;
@@ -85,7 +128,14 @@ private:
 	// Following must always be up to date.
 	////////////////////////////////////////////////////////////////////////////
 	/// @brief map to ResidueType pointers by unique residue id
-	std::map< std::string, ResidueTypeCOP > name_map_;
+#if defined MULTI_THREADED && defined CXX11
+	/// @details Split into shards by hash of the name; each shard is an immutable map that is replaced
+	/// (copy, modify, atomically publish) under shard_mutexes_ and read with std::atomic_load.
+	NameMapSnapshot name_map_shards_[ n_name_map_shards ];
+	mutable std::mutex shard_mutexes_[ n_name_map_shards ];
+#else
+	NameMap name_map_;
+#endif
 
 	/// @brief annotation about types which theoretically may exist but we don't want
 	/// @details For example, for PDB components which duplicate standard types.
@@ -104,6 +154,16 @@ private:
 	/// @brief caching queries based on aa & variants to avoid recomputation with ResidueTypeFinder
 	std::map< AA_VariantsExceptions, ResidueTypeCOPs > cached_aa_variants_map_;
 
+#if defined MULTI_THREADED && defined CXX11
+	/// @brief guards prohibited_types_ and cached_aa_variants_map_
+	mutable std::mutex maps_mutex_;
+
+	/// @brief names of the residue types being generated right now, each by one thread
+	std::set< std::string > in_generation_;
+	std::mutex generation_mutex_;
+	std::condition_variable generation_done_;
+#endif
+
 };
 
 } //chemical
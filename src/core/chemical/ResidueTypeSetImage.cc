@@ -0,0 +1,440 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file core/chemical/ResidueTypeSetImage.cc
+/// @brief A compiled, read-only image of the database files a ResidueTypeSet is built from
+
+// Unit headers
+#include <core/chemical/ResidueTypeSetImage.hh>
+
+// Basic headers
+#include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/chemical.OptionKeys.gen.hh>
+
+// Utility headers
+#include <utility/exit.hh>
+#include <utility/file/FileName.hh>
+#include <utility/file/file_sys_util.hh>
+#include <utility/io/izstream.hh>
+#include <utility/string_util.hh>
+
+#include <boost/cstdint.hpp>
+
+// C++ headers
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <mutex>
+#endif
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+namespace chemical {
+
+static THREAD_LOCAL basic::Tracer tr( "core.chemical.ResidueTypeSetImage" );
+
+/// @brief Magic header of an image; followed by the file count, the directory name, the database key
+/// and the index (name, offset, size of each file), then the file contents.  Integers are uint64 in
+/// host byte order.
+static char const RTS_IMAGE_MAGIC[ 8 ] = { 'R', 'T', 'S', 'I', 'M', 'G', '0', '2' };
+
+namespace {
+
+void
+write_u64( std::ostream & out, core::Size value )
+{
+	boost::uint64_t const v( value );
+	out.write( reinterpret_cast< char const * >( &v ), sizeof( v ) );
+}
+
+void
+write_string( std::ostream & out, std::string const & s )
+{
+	write_u64( out, s.size() );
+	out.write( s.data(), s.size() );
+}
+
+/// @brief Bounds-checked reader over the image's header
+class ImageHeaderReader {
+public:
+	ImageHeaderReader( char const * data, core::Size size, std::string const & filename ) :
+		data_( data ), size_( size ), pos_( 0 ), filename_( filename ) {}
+
+	core::Size u64() {
+		check( sizeof( boost::uint64_t ) );
+		boost::uint64_t v;
+		std::memcpy( &v, data_ + pos_, sizeof( v ) );
+		pos_ += sizeof( v );
+		return v;
+	}
+
+	std::string string() {
+		core::Size const n = u64();
+		check( n );
+		std::string s( data_ + pos_, n );
+		pos_ += n;
+		return s;
+	}
+
+	void check( core::Size n ) const {
+		if ( n > size_ || pos_ > size_ - n ) {
+			utility_exit_with_message( "ResidueTypeSet image " + filename_ + " is truncated or corrupt" );
+		}
+	}
+
+	void skip( core::Size n ) { check( n ); pos_ += n; }
+
+private:
+	char const * data_;
+	core::Size size_, pos_;
+	std::string filename_;
+};
+
+/// @brief the files named in a residue type set list file: residue_types.txt (skipping the
+/// *_SET lines), patches.txt or metapatches.txt, parsed as ResidueTypeSet::init parses them
+void
+append_listed_files( std::string const & list_contents, bool residue_list, utility::vector1< std::string > & filenames )
+{
+	std::istringstream data( list_contents );
+	std::string line;
+	while ( getline( data, line ) ) {
+		if ( line.size() < 1 || line[ 0 ] == '#' ) continue;
+		if ( residue_list ) {
+			std::istringstream l( line );
+			std::string tag;
+			l >> tag;
+			if ( tag == "ATOM_TYPE_SET" || tag == "ELEMENT_SET" || tag == "MM_ATOM_TYPE_SET" || tag == "ORBITAL_TYPE_SET" ) continue;
+		} else {
+			line = utility::string_split( line, '#' )[ 1 ];
+			line = utility::string_split( line, ' ' )[ 1 ];
+			if ( line.empty() ) continue;
+		}
+		filenames.push_back( line );
+	}
+}
+
+/// @brief the list files ResidueTypeSet::init reads; only the first two are required
+utility::vector1< std::string >
+list_filenames()
+{
+	utility::vector1< std::string > names;
+	names.push_back( "residue_types.txt" );
+	names.push_back( "patches.txt" );
+	names.push_back( "metapatches.txt" );
+	names.push_back( "shadow_list.txt" );
+	return names;
+}
+
+/// @brief 64-bit FNV-1a, folded over successive calls through hash
+void
+hash_bytes( boost::uint64_t & hash, char const * data, core::Size size )
+{
+	for ( core::Size ii = 0; ii < size; ++ii ) {
+		hash ^= static_cast< unsigned char >( data[ ii ] );
+		hash *= 1099511628211ULL;
+	}
+}
+
+void
+hash_string( boost::uint64_t & hash, std::string const & s )
+{
+	hash_bytes( hash, s.data(), s.size() + 1 ); // with the terminating null, so "ab" "c" differs from "a" "bc"
+}
+
+void
+hash_u64( boost::uint64_t & hash, boost::uint64_t value )
+{
+	hash_bytes( hash, reinterpret_cast< char const * >( &value ), sizeof( value ) );
+}
+
+/// @brief size of filename (or of filename.gz, which izstream falls back to) without opening it;
+/// the largest uint64 if neither exists
+boost::uint64_t
+disk_size( std::string const & filename )
+{
+#ifndef WIN32
+	struct stat file_stat;
+	if ( stat( filename.c_str(), &file_stat ) == 0 ) return file_stat.st_size;
+	if ( stat( ( filename + ".gz" ).c_str(), &file_stat ) == 0 ) return file_stat.st_size;
+	return boost::uint64_t( -1 );
+#else
+	long size = utility::file::file_size( filename );
+	if ( size < 0 ) size = utility::file::file_size( filename + ".gz" );
+	return size < 0 ? boost::uint64_t( -1 ) : boost::uint64_t( size );
+#endif
+}
+
+bool
+read_whole_file( std::string const & filename, std::string & contents )
+{
+	utility::io::izstream data( filename.c_str() );
+	if ( !data.good() ) return false;
+	std::ostringstream out;
+	out << data().rdbuf();
+	contents = out.str();
+	return true;
+}
+
+}
+
+ResidueTypeSetImage::ResidueTypeSetImage( std::string const & filename ) :
+	database_key_( 0 ),
+	data_( 0 ),
+	size_( 0 ),
+	mapping_( 0 )
+{
+#ifndef WIN32
+	int const fd = open( filename.c_str(), O_RDONLY );
+	if ( fd < 0 ) utility_exit_with_message( "Unable to open ResidueTypeSet image " + filename );
+	struct stat file_stat;
+	if ( fstat( fd, &file_stat ) == 0 && file_stat.st_size > 0 ) {
+		void * mapping = mmap( 0, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+		if ( mapping != MAP_FAILED ) {
+			mapping_ = mapping;
+			data_ = static_cast< char const * >( mapping );
+			size_ = file_stat.st_size;
+		} else {
+			tr.Warning << "Could not memory map " << filename << "; reading it into memory instead" << std::endl;
+		}
+	}
+	close( fd );
+#endif
+	if ( ! mapping_ ) {
+		std::ifstream in( filename.c_str(), std::ios::binary );
+		if ( !in ) utility_exit_with_message( "Unable to open ResidueTypeSet image " + filename );
+		std::ostringstream out;
+		out << in.rdbuf();
+		buffer_ = out.str();
+		data_ = buffer_.data();
+		size_ = buffer_.size();
+	}
+
+	ImageHeaderReader header( data_, size_, filename );
+	header.check( sizeof( RTS_IMAGE_MAGIC ) );
+	if ( std::memcmp( data_, RTS_IMAGE_MAGIC, sizeof( RTS_IMAGE_MAGIC ) ) != 0 ) {
+		utility_exit_with_message( filename + " is not a ResidueTypeSet image" );
+	}
+	header.skip( sizeof( RTS_IMAGE_MAGIC ) );
+	core::Size const n_files = header.u64();
+	directory_name_ = header.string();
+	database_key_ = header.u64();
+	for ( core::Size ii = 1; ii <= n_files; ++ii ) {
+		std::string const name = header.string();
+		core::Size const offset = header.u64();
+		core::Size const size = header.u64();
+		if ( offset > size_ || size > size_ - offset ) {
+			utility_exit_with_message( "ResidueTypeSet image " + filename + " is truncated or corrupt" );
+		}
+		index_[ name ] = std::make_pair( offset, size );
+	}
+	tr.Debug << "Loaded image of " << directory_name_ << " with " << index_.size() << " files from " << filename << std::endl;
+}
+
+ResidueTypeSetImage::~ResidueTypeSetImage()
+{
+#ifndef WIN32
+	if ( mapping_ ) munmap( mapping_, size_ );
+#endif
+}
+
+utility::vector1< std::string >
+ResidueTypeSetImage::filenames() const
+{
+	utility::vector1< std::string > names;
+	for ( std::map< std::string, std::pair< core::Size, core::Size > >::const_iterator it = index_.begin(); it != index_.end(); ++it ) {
+		names.push_back( it->first );
+	}
+	return names;
+}
+
+bool
+ResidueTypeSetImage::has_file( std::string const & filename ) const
+{
+	return index_.find( filename ) != index_.end();
+}
+
+bool
+ResidueTypeSetImage::open_file( std::string const & filename, FileStream & stream ) const
+{
+	std::map< std::string, std::pair< core::Size, core::Size > >::const_iterator it = index_.find( filename );
+	if ( it == index_.end() ) return false;
+	stream.open( data_ + it->second.first, it->second.second );
+	return true;
+}
+
+std::string
+ResidueTypeSetImage::relative_filename( std::string const & directory, std::string const & filename )
+{
+	std::string rel( filename );
+	if ( ! directory.empty() && rel.compare( 0, directory.size(), directory ) == 0 ) {
+		rel = rel.substr( directory.size() );
+	}
+	std::string::size_type const first = rel.find_first_not_of( '/' );
+	return first == std::string::npos ? std::string() : rel.substr( first );
+}
+
+std::string
+ResidueTypeSetImage::directory_name( std::string const & directory )
+{
+	std::string::size_type const end = directory.find_last_not_of( '/' );
+	if ( end == std::string::npos ) return std::string();
+	std::string::size_type const begin = directory.find_last_of( '/', end );
+	return directory.substr( begin == std::string::npos ? 0 : begin + 1, end - ( begin == std::string::npos ? 0 : begin + 1 ) + 1 );
+}
+
+/// @details Hashes the contents of the list files, then the name and size on disk of each file they
+/// list, in sorted order.  Edits to a params or patch file that keep its size are not seen; catching
+/// them would mean reading every file, which the image is there to avoid.
+boost::uint64_t
+ResidueTypeSetImage::database_key( std::string const & database_directory )
+{
+	std::string const directory( database_directory + ( utility::endswith( database_directory, "/" ) ? "" : "/" ) );
+	boost::uint64_t key( 14695981039346656037ULL );
+
+	utility::vector1< std::string > const lists( list_filenames() );
+	utility::vector1< std::string > listed;
+	for ( core::Size ii = 1; ii <= lists.size(); ++ii ) {
+		std::string text;
+		bool const found( read_whole_file( directory + lists[ ii ], text ) );
+		hash_string( key, lists[ ii ] );
+		hash_u64( key, found ? text.size() : boost::uint64_t( -1 ) );
+		hash_bytes( key, text.data(), text.size() );
+		if ( found && ii <= 3 ) append_listed_files( text, ii == 1, listed );
+	}
+
+	std::set< std::string > names;
+	for ( core::Size ii = 1; ii <= listed.size(); ++ii ) {
+		names.insert( relative_filename( "", listed[ ii ] ) );
+	}
+	for ( std::set< std::string >::const_iterator it = names.begin(); it != names.end(); ++it ) {
+		hash_string( key, *it );
+		hash_u64( key, disk_size( directory + *it ) );
+	}
+	return key;
+}
+
+void
+ResidueTypeSetImage::compile( std::string const & database_directory_in, std::string const & image_filename )
+{
+	std::string const directory( database_directory_in + ( utility::endswith( database_directory_in, "/" ) ? "" : "/" ) );
+
+	// the list files, then everything they list
+	utility::vector1< std::string > names( list_filenames() );
+
+	std::map< std::string, std::string > contents;
+	core::Size const n_lists = names.size();
+	for ( core::Size ii = 1; ii <= n_lists; ++ii ) {
+		std::string text;
+		if ( ! read_whole_file( directory + names[ ii ], text ) ) continue; // only residue_types.txt and patches.txt are required
+		contents[ names[ ii ] ] = text;
+		if ( ii <= 3 ) append_listed_files( text, ii == 1, names );
+	}
+	if ( contents.find( "residue_types.txt" ) == contents.end() || contents.find( "patches.txt" ) == contents.end() ) {
+		utility_exit_with_message( "Cannot compile a ResidueTypeSet image: " + directory + " has no residue_types.txt or patches.txt" );
+	}
+	for ( core::Size ii = n_lists + 1; ii <= names.size(); ++ii ) {
+		std::string const name = relative_filename( "", names[ ii ] );
+		if ( contents.find( name ) != contents.end() ) continue;
+		std::string text;
+		if ( ! read_whole_file( directory + name, text ) ) {
+			tr.Warning << "Skipping " << directory + name << ", which is listed but cannot be read" << std::endl;
+			continue;
+		}
+		contents[ name ] = text;
+	}
+
+	// index size first, so the offsets are known
+	core::Size header_size = sizeof( RTS_IMAGE_MAGIC ) + 8 + 8 + directory_name( directory ).size() + 8;
+	for ( std::map< std::string, std::string >::const_iterator it = contents.begin(); it != contents.end(); ++it ) {
+		header_size += 8 + it->first.size() + 8 + 8;
+	}
+
+	std::ofstream out( image_filename.c_str(), std::ios::out | std::ios::binary );
+	if ( !out ) utility_exit_with_message( "Unable to open " + image_filename + " for writing" );
+	out.write( RTS_IMAGE_MAGIC, sizeof( RTS_IMAGE_MAGIC ) );
+	write_u64( out, contents.size() );
+	write_string( out, directory_name( directory ) );
+	write_u64( out, database_key( directory ) );
+	core::Size offset = header_size;
+	for ( std::map< std::string, std::string >::const_iterator it = contents.begin(); it != contents.end(); ++it ) {
+		write_string( out, it->first );
+		write_u64( out, offset );
+		write_u64( out, it->second.size() );
+		offset += it->second.size();
+	}
+	for ( std::map< std::string, std::string >::const_iterator it = contents.begin(); it != contents.end(); ++it ) {
+		out.write( it->second.data(), it->second.size() );
+	}
+	if ( !out ) utility_exit_with_message( "Error writing " + image_filename );
+	tr << "Wrote image of " << directory << " with " << contents.size() << " files (" << offset << " bytes) to " << image_filename << std::endl;
+}
+
+namespace {
+
+#if defined MULTI_THREADED && defined CXX11
+std::mutex mapped_images_mutex;
+#endif
+
+/// @brief the images mapped so far, by filename
+std::map< std::string, ResidueTypeSetImageCOP > mapped_images;
+
+ResidueTypeSetImageCOP
+mapped_image( std::string const & filename )
+{
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( mapped_images_mutex );
+#endif
+	ResidueTypeSetImageCOP & image( mapped_images[ filename ] );
+	if ( ! image ) image = ResidueTypeSetImageCOP( new ResidueTypeSetImage( filename ) );
+	return image;
+}
+
+}
+
+ResidueTypeSetImageCOP
+residue_type_set_image_for_directory( std::string const & database_directory )
+{
+	using namespace basic::options;
+	if ( ! option[ OptionKeys::chemical::residue_type_set_images ].user() ) return ResidueTypeSetImageCOP();
+
+	std::string const name = ResidueTypeSetImage::directory_name( database_directory );
+	utility::vector1< utility::file::FileName > const & images = option[ OptionKeys::chemical::residue_type_set_images ]();
+	bool key_known( false );
+	boost::uint64_t key( 0 );
+	for ( core::Size ii = 1; ii <= images.size(); ++ii ) {
+		ResidueTypeSetImageCOP image( mapped_image( images[ ii ].name() ) );
+		if ( image->directory_name() != name ) continue;
+		if ( ! key_known ) {
+			key = ResidueTypeSetImage::database_key( database_directory );
+			key_known = true;
+		}
+		if ( image->database_key() != key ) {
+			tr.Warning << "Not using image " << images[ ii ].name() << ": it was compiled from a different version of "
+				<< database_directory << ".  Recompile it with compile_residue_type_set_image." << std::endl;
+			continue;
+		}
+		tr << "Reading residue type set " << name << " from image " << images[ ii ].name() << std::endl;
+		return image;
+	}
+	return ResidueTypeSetImageCOP();
+}
+
+} // chemical
+} // core
@@ -0,0 +1,28 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file core/chemical/ResidueTypeSetImage.fwd.hh
+/// @brief forward declarations for compiled ResidueTypeSet database images
+
+#ifndef INCLUDED_core_chemical_ResidueTypeSetImage_FWD_HH
+#define INCLUDED_core_chemical_ResidueTypeSetImage_FWD_HH
+
+#include <utility/pointer/owning_ptr.hh>
+
+namespace core {
+namespace chemical {
+
+class ResidueTypeSetImage;
+typedef utility::pointer::shared_ptr< ResidueTypeSetImage > ResidueTypeSetImageOP;
+typedef utility::pointer::shared_ptr< ResidueTypeSetImage const > ResidueTypeSetImageCOP;
+
+} //chemical
+} //core
+
+#endif
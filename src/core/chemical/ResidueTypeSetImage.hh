@@ -0,0 +1,132 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file core/chemical/ResidueTypeSetImage.hh
+/// @brief A compiled, read-only image of the database files a ResidueTypeSet is built from
+/// @details Initializing a ResidueTypeSet opens residue_types.txt, patches.txt, metapatches.txt
+/// and every params and patch file they list -- around a thousand small files for fa_standard, read
+/// by every process of a run.  compile() packs all of them into one file, which is memory mapped
+/// read-only when the set is created, so all processes on a node share the same pages and no
+/// per-file open reaches the file system.  The image holds the database text, not built types:
+/// the ResidueTypes are still parsed and built in each process, and patched types are generated on
+/// demand from the patches parsed out of the image.  Files not in the image (e.g. -extra_res_fa
+/// params) are read from disk as usual.
+///
+/// An image is keyed on database_key(), a hash of the contents of the list files and of the name
+/// and size of every file they list.  An image is only used for a directory whose key matches, so
+/// adding, removing or resizing a params or patch file makes the image stale rather than wrong.
+#ifndef INCLUDED_core_chemical_ResidueTypeSetImage_hh
+#define INCLUDED_core_chemical_ResidueTypeSetImage_hh
+
+// Unit headers
+#include <core/chemical/ResidueTypeSetImage.fwd.hh>
+
+// Project headers
+#include <core/types.hh>
+
+// Utility headers
+#include <utility/pointer/ReferenceCount.hh>
+#include <utility/vector1.hh>
+
+#include <boost/cstdint.hpp>
+
+// C++ headers
+#include <istream>
+#include <map>
+#include <streambuf>
+#include <string>
+
+namespace core {
+namespace chemical {
+
+class ResidueTypeSetImage : public utility::pointer::ReferenceCount {
+public:
+	/// @brief An input stream over one file held in an image; it reads the image's bytes in place.
+	class FileStream : public std::istream {
+	public:
+		FileStream() : std::istream( 0 ) { rdbuf( &buffer_ ); }
+
+		void open( char const * data, core::Size size ) { buffer_.open( data, size ); clear(); }
+
+	private:
+		class Buffer : public std::streambuf {
+		public:
+			/// @details The get area only ever reads, so casting away const is safe.
+			void open( char const * data, core::Size size ) {
+				char * begin( const_cast< char * >( data ) );
+				setg( begin, begin, begin + size );
+			}
+		};
+
+		Buffer buffer_;
+	};
+
+public:
+	/// @brief map filename read-only (or read it into memory where mapping is not available)
+	ResidueTypeSetImage( std::string const & filename );
+
+	virtual ~ResidueTypeSetImage();
+
+	/// @brief last component of the residue type set directory the image was compiled from,
+	/// e.g. "fa_standard" or "fa_standard_05.2009_icoor"
+	std::string const & directory_name() const { return directory_name_; }
+
+	/// @brief database_key() of the directory when the image was compiled
+	boost::uint64_t database_key() const { return database_key_; }
+
+	/// @brief filenames (relative to the residue type set directory) held in the image
+	utility::vector1< std::string > filenames() const;
+
+	bool has_file( std::string const & filename ) const;
+
+	/// @brief point stream at the contents of filename (relative to the residue type set directory);
+	/// false if the image does not hold it
+	bool open_file( std::string const & filename, FileStream & stream ) const;
+
+	/// @brief Pack the files ResidueTypeSet::init reads from database_directory into image_filename.
+	static void compile( std::string const & database_directory, std::string const & image_filename );
+
+	/// @brief filename relative to directory if it lies inside it; leading slashes are dropped
+	static std::string relative_filename( std::string const & directory, std::string const & filename );
+
+	/// @brief last path component of directory, ignoring trailing slashes
+	static std::string directory_name( std::string const & directory );
+
+	/// @brief Hash of the list files in database_directory and of the name and size on disk of every
+	/// file they list.  Only the list files are read; the listed files are only stat'ed.
+	static boost::uint64_t database_key( std::string const & database_directory );
+
+private:
+	ResidueTypeSetImage( ResidueTypeSetImage const & ); // uncopyable
+	ResidueTypeSetImage const & operator = ( ResidueTypeSetImage const & );
+
+private:
+	std::string directory_name_;
+	boost::uint64_t database_key_;
+
+	/// @brief start of the image: a read-only memory mapping or buffer_'s data
+	char const * data_;
+	core::Size size_;
+	void * mapping_;
+	std::string buffer_;
+
+	/// @brief offset and size of each file inside the image
+	std::map< std::string, std::pair< core::Size, core::Size > > index_;
+};
+
+/// @brief The image listed in -chemical:residue_type_set_images compiled from a directory with the same
+/// name and database_key() as database_directory, or null if there is none.  Each image file is mapped
+/// once per process.
+ResidueTypeSetImageCOP
+residue_type_set_image_for_directory( std::string const & database_directory );
+
+} // chemical
+} // core
+
+#endif
@@ -545,6 +545,23 @@ read_topology_file(
 	//chemical::CSDAtomTypeSetCAP csd_atom_types kwk commenting out until they have been fully implemented
 	chemical::ResidueTypeSetCAP rsd_type_set_ap )
 {
+	std::string const filename = data.filename();
+	ResidueTypeOP rsd( read_topology_file( data(), filename, atom_types, elements, mm_atom_types, orbital_atom_types, rsd_type_set_ap ) );
+	data.close();
+	return rsd;
+}
+
+ResidueTypeOP
+read_topology_file(
+	std::istream & data,
+	std::string const & filename,
+	chemical::AtomTypeSetCAP atom_types,
+	chemical::ElementSetCAP elements,
+	chemical::MMAtomTypeSetCAP mm_atom_types,
+	chemical::orbitals::OrbitalTypeSetCAP orbital_atom_types,
+	//chemical::CSDAtomTypeSetCAP csd_atom_types kwk commenting out until they have been fully implemented
+	chemical::ResidueTypeSetCAP rsd_type_set_ap )
+{
 
 	using id::AtomID;
 	using id::DOF_ID;
@@ -553,8 +570,6 @@ read_topology_file(
 
 	using namespace basic;
 
-	std::string filename = data.filename();
-
 	// read the file
 	std::string line;
 	utility::vector1< std::string > lines;
@@ -577,7 +592,6 @@ read_topology_file(
 			if ( l.fail() ) myname.clear();
 		}
 	}
-	data.close();
 
 	std::map< std::string, std::string > atom_type_reassignments;
 	std::map< std::string, Real > atomic_charge_reassignments;
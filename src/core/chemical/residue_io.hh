@@ -56,6 +56,19 @@ read_topology_file(
 	chemical::ResidueTypeSetCAP rsd_type_set
 );
 
+/// @brief read a .params file from any stream; filename is used in error messages and to find
+/// PDB_ROTAMERS files given relative to the params file
+ResidueTypeOP
+read_topology_file(
+	std::istream & data,
+	std::string const & filename,
+	chemical::AtomTypeSetCAP atom_types,
+	chemical::ElementSetCAP elements,
+	chemical::MMAtomTypeSetCAP mm_atom_types,
+	chemical::orbitals::OrbitalTypeSetCAP orbital_atom_types,
+	chemical::ResidueTypeSetCAP rsd_type_set
+);
+
 /// @brief writes a .params file from a given ResidueType object
 void
 write_topology_file(
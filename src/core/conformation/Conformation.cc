@@ -109,6 +109,27 @@ namespace conformation {
 
 using namespace ObjexxFCL;
 
+/// @brief bytes of coordinates and torsions held by a residue
+static Size
+residue_data_bytes( Residue const & rsd )
+{
+	return ( rsd.natoms() + 1 ) * sizeof( Vector ) +
+		( rsd.mainchain_torsions().size() + rsd.chi().size() ) * sizeof( Real );
+}
+
+/// @brief do two residues of the same type have the same coordinates and torsions?
+static bool
+residue_data_matches( Residue const & rsd, Residue const & src_rsd )
+{
+	if ( rsd.actcoord() != src_rsd.actcoord() ||
+			rsd.mainchain_torsions() != src_rsd.mainchain_torsions() ||
+			rsd.chi() != src_rsd.chi() ) return false;
+	for ( Size jj = 1; jj <= rsd.natoms(); ++jj ) {
+		if ( rsd.xyz( jj ) != src_rsd.xyz( jj ) ) return false;
+	}
+	return true;
+}
+
 // Standard class methods ////////////////////////////////////////////////////////////////////////////////////////////
 
 // default destructor
@@ -126,7 +147,8 @@ Conformation::Conformation() :
 	contains_carbohydrate_residues_( false) ,
 	residue_coordinates_need_updating_( false ),
 	residue_torsions_need_updating_( false ),
-	structure_moved_( true )
+	structure_moved_( true ),
+	last_copy_bytes_( 0 )
 {
 	atom_tree_->set_weak_pointer_to_self( atom_tree_ );
 }
@@ -134,12 +156,14 @@ Conformation::Conformation() :
 // copy constructor
 Conformation::Conformation( Conformation const & src ) :
 	utility::pointer::ReferenceCount(),
-	utility::pointer::enable_shared_from_this< Conformation >()
+	utility::pointer::enable_shared_from_this< Conformation >(),
+	last_copy_bytes_( 0 )
 {
 	basic::ProfileThis doit( basic::CONFORMATION_COPY );
 	// residues
 	for ( Size i=1; i<= src.size(); ++i ) {
 		residues_.push_back( src.residues_[i]->clone() );
+		last_copy_bytes_ += residue_data_bytes( *residues_[ i ] );
 	}
 
 	// kinematics
@@ -204,8 +228,10 @@ Conformation::operator=( Conformation const & src )
 		clear();
 
 		// residues
+		last_copy_bytes_ = 0;
 		for ( Size i=1; i<= src.size(); ++i ) {
 			residues_.push_back( src.residues_[i]->clone() );
+			last_copy_bytes_ += residue_data_bytes( *residues_[ i ] );
 		}
 
 		// kinematics
@@ -4150,18 +4176,25 @@ Conformation::in_place_copy(
 
 	/// BEGIN IN PLACE OPTIMIZATION
 
-	// Do not allocate new residue objects, just reuse the old ones
+	// Do not allocate new residue objects, just reuse the old ones, and leave the residues
+	// alone that already match: a MonteCarlo step rarely moves more than a few of them.
+	last_copy_bytes_ = 0;
 	for ( Size ii = 1; ii <= size(); ++ii ) {
-		runtime_assert( & residues_[ ii ]->type() ==  & src.residues_[ ii ]->type() );
-		runtime_assert( residues_[ ii ]->seqpos() == src.residues_[ ii ]->seqpos() );
-		runtime_assert( residues_[ ii ]->chain() == src.residues_[ ii ]->chain() );
-		runtime_assert( residues_[ ii ]->connections_match( *src.residues_[ ii ] ));
-		for ( Size jj = 1; jj <= residues_[ ii ]->natoms(); ++jj ) {
-			residues_[ ii ]->set_xyz( jj, src.residues_[ ii ]->xyz( jj ) );
+		Residue & rsd( *residues_[ ii ] );
+		Residue const & src_rsd( *src.residues_[ ii ] );
+		runtime_assert( & rsd.type() ==  & src_rsd.type() );
+		runtime_assert( rsd.seqpos() == src_rsd.seqpos() );
+		runtime_assert( rsd.chain() == src_rsd.chain() );
+		runtime_assert( rsd.connections_match( src_rsd ));
+		if ( residue_data_matches( rsd, src_rsd ) ) continue;
+
+		for ( Size jj = 1; jj <= rsd.natoms(); ++jj ) {
+			rsd.set_xyz( jj, src_rsd.xyz( jj ) );
 		}
-		residues_[ ii ]->mainchain_torsions( src.residues_[ ii ]->mainchain_torsions() );
-		residues_[ ii ]->chi( src.residues_[ ii ]->chi() );
-		residues_[ ii ]->actcoord() = src.residues_[ ii ]->actcoord();
+		rsd.mainchain_torsions( src_rsd.mainchain_torsions() );
+		rsd.chi( src_rsd.chi() );
+		rsd.actcoord() = src_rsd.actcoord();
+		last_copy_bytes_ += residue_data_bytes( rsd );
 	}
 
 	/// END IN PLACE OPTIMIZATION
@@ -980,6 +980,14 @@ public:  // for tracking changes to the structure
 		structure_moved_ = false;
 	}
 
+	/// @brief residue coordinate and torsion bytes written by the last assignment to this conformation;
+	/// an assignment from a conformation with the same sequence only rewrites the residues that differ
+	Size
+	last_copy_bytes() const
+	{
+		return last_copy_bytes_;
+	}
+
 	/// @brief forget all the structure modifications
 	void
 	reset_move_data();
@@ -1496,6 +1504,8 @@ private:
 	/// @brief has the structure moved since the last call to reset_move_data?
 	mutable bool structure_moved_;
 
+	/// @brief bytes of residue data written by the last operator=; not part of the state of the conformation
+	Size last_copy_bytes_;
 
 	utility::vector1< char > secstruct_;
 
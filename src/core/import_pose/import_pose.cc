@@ -226,11 +226,8 @@ determine_file_type( std::string const &contents_of_file) {
 
 	//See if this is a pdb file
 	//code to determine the type of file
-	utility::vector1< io::pdb::Record> records( io::pdb::create_records_from_pdb_file_contents( contents_of_file ) );
-	for ( core::Size ii=1; ii<= records.size(); ++ii ) {
-		if ( records[ ii ][ "type" ].value != "UNKNOW" ) {
-			return PDB_file;
-		}
+	if ( io::pdb::pdb_file_contents_have_pdb_records( contents_of_file ) ) {
+		return PDB_file;
 	}
 	//See if this is a CIF file
 	std::string diagnostics;
@@ -285,7 +282,8 @@ pose_from_file(
 			pose.set_new_conformation( conformation_op );
 		}
 
-		io::StructFileRepOP sfr( io::pdb::create_sfr_from_pdb_file_contents(contents_of_file, options).clone() );
+		io::StructFileRepOP sfr( new io::StructFileRep );
+		io::pdb::read_sfr_from_pdb_file_contents( contents_of_file, options, *sfr );
 		if ( sfr->filename() == "" ) {
 			sfr->filename() = utility::join(filenames, "_");
 		}
@@ -543,7 +541,8 @@ pose_from_file(
 				sub_lines = all_lines.substr( pos1, pos2-pos1 ) ;
 				pos1 = pos2;
 
-				io::StructFileRepOP sfr( io::pdb::create_sfr_from_pdb_file_contents( sub_lines, options ).clone() );
+				io::StructFileRepOP sfr( new io::StructFileRep );
+				io::pdb::read_sfr_from_pdb_file_contents( sub_lines, options, *sfr );
 				sfr->filename() = filename;
 				build_pose( sfr, pose, residue_set, options );
 
@@ -552,7 +551,8 @@ pose_from_file(
 				poses.push_back( pose );
 			}
 		} else {
-			StructFileRepOP sfr( io::pdb::create_sfr_from_pdb_file_contents( all_lines, options ).clone() );
+			StructFileRepOP sfr( new io::StructFileRep );
+			io::pdb::read_sfr_from_pdb_file_contents( all_lines, options, *sfr );
 			if ( sfr->filename() == "" ) {
 				sfr->filename() = filename;
 			}
@@ -572,7 +572,8 @@ pose_from_pdbstring(
 	std::string const & filename
 )
 {
-	io::StructFileRepOP sfr( io::pdb::create_sfr_from_pdb_file_contents( pdbcontents, options ).clone() );
+	io::StructFileRepOP sfr( new io::StructFileRep );
+	io::pdb::read_sfr_from_pdb_file_contents( pdbcontents, options, *sfr );
 	sfr->filename() = filename;
 	chemical::ResidueTypeSetCOP residue_set
 		( chemical::ChemicalManager::get_instance()->residue_type_set( chemical::FA_STANDARD ) );
@@ -611,7 +612,8 @@ pose_from_pdbstring(
 	ImportPoseOptions const & options,
 	std::string const & filename
 ){
-	io::StructFileRepOP sfr( io::pdb::create_sfr_from_pdb_file_contents( pdbcontents, options ).clone() );
+	io::StructFileRepOP sfr( new io::StructFileRep );
+	io::pdb::read_sfr_from_pdb_file_contents( pdbcontents, options, *sfr );
 	sfr->filename() = filename;
 	core::import_pose::build_pose( sfr, pose, residue_set, options);
 }
@@ -66,6 +66,31 @@ StructFileRep::append_to_additional_string_output( std::string const &input_stri
 }
 
 
+/// @details  The header and remarks are replaced rather than emptied, since a Pose built from this
+/// StructFileRep may still hold them.
+void
+StructFileRep::clear()
+{
+	filename_.clear();
+	modeltag_.clear();
+	header_ = HeaderInformationOP( new HeaderInformation() );
+	remarks_ = RemarksOP( new Remarks );
+	chain_sequences_.clear();
+	modres_map_.clear();
+	heterogen_names_.clear();
+	heterogen_synonyms_.clear();
+	heterogen_formulae_.clear();
+	residue_type_base_names_.clear();
+	ssbond_map_.clear();
+	link_map_.clear();
+	cispep_map_.clear();
+	crystinfo_ = CrystInfo();
+	chains_.clear();
+	foldtree_string_.clear();
+	pdb_comments_.clear();
+	additional_string_output_.clear();
+}
+
 // Helper Functions ///////////////////////////////////////////////////////////
 // Debug printing, serializing to Tracer-like object
 std::ostream &
@@ -285,6 +285,9 @@ public:  // Accessors /////////////////////////////////////////////////////////
 	/// @brief   Append more string data to the additional_string_output_ string in the SFR.
 	void append_to_additional_string_output( std::string const & input_string );
 
+	/// @brief  Reset to the state of a newly constructed StructFileRep.
+	void clear();
+
 
 private:
 	std::string filename_;
@@ -75,6 +75,7 @@ typedef utility::pointer::shared_ptr< CifFile > CifFileOP;
 #include <cstdlib>
 #include <cstdio>
 #include <algorithm>
+#include <vector>
 
 
 static THREAD_LOCAL basic::Tracer TR( "core.io.mmcif.cif_reader" );
@@ -98,8 +99,6 @@ StructFileRepOP create_sfr_from_cif_file_op( CifFileOP cifFile, StructFileReader
 
 	StructFileRepOP sfr( new StructFileRep );
 
-	std::map<char, ChainAtoms> atom_chain_map;
-	std::vector< char > chain_list; // preserve order
 	std::map<char, Size> chain_to_idx;
 
 	std::map<std::pair<Size, Size>, char> modelchain_to_chain;
@@ -277,11 +276,30 @@ StructFileRepOP create_sfr_from_cif_file_op( CifFileOP cifFile, StructFileReader
 	std::string last_model = "";
 	if ( block.IsTablePresent( "atom_site" ) ) {
 		ISTable& atom_site = block.GetTable("atom_site");
-		for ( Size i = 0; i <= atom_site.GetLastRowIndex(); ++i ) {
-			AtomInformation ai;
 
-			std::string temp_model = atom_site( i, "pdbx_PDB_model_num" );
-			temp_model = ObjexxFCL::strip_whitespace( temp_model );
+		// Fetch each column once, rather than searching the table's columns by name for every atom; the name
+		// fields are then swapped out of the fetched columns instead of copied.
+		std::vector< std::string > model_num, group_PDB, id, atom_id, alt_id, comp_id, asym_id, seq_id, ins_code,
+			cartn_x, cartn_y, cartn_z, occupancy, b_iso, type_symbol;
+		atom_site.GetColumn( model_num, "pdbx_PDB_model_num" );
+		atom_site.GetColumn( group_PDB, "group_PDB" );
+		atom_site.GetColumn( id, "id" );
+		atom_site.GetColumn( atom_id, "auth_atom_id" );
+		atom_site.GetColumn( alt_id, "label_alt_id" );
+		atom_site.GetColumn( comp_id, "auth_comp_id" );
+		atom_site.GetColumn( asym_id, "auth_asym_id" );
+		atom_site.GetColumn( seq_id, "auth_seq_id" );
+		atom_site.GetColumn( ins_code, "pdbx_PDB_ins_code" );
+		atom_site.GetColumn( cartn_x, "Cartn_x" );
+		atom_site.GetColumn( cartn_y, "Cartn_y" );
+		atom_site.GetColumn( cartn_z, "Cartn_z" );
+		atom_site.GetColumn( occupancy, "occupancy" );
+		atom_site.GetColumn( b_iso, "B_iso_or_equiv" );
+		atom_site.GetColumn( type_symbol, "type_symbol" );
+
+		std::map< char, Size > chain_index;  // index in sfr->chains() of each chain ID, in order of first appearance
+		for ( Size i = 0; i < model_num.size(); ++i ) {
+			std::string temp_model = ObjexxFCL::strip_whitespace( model_num[ i ] );
 
 			// PUT OBEY ENDMDL RECOGNITION HERE!!!!!!!
 			if ( last_model != "" && last_model != temp_model ) {
@@ -313,80 +331,80 @@ StructFileRepOP create_sfr_from_cif_file_op( CifFileOP cifFile, StructFileReader
 				}
 			}
 
-
-			ai.isHet = ( atom_site( i, "group_PDB" ) == "HETATM" );
-			ai.serial = atoi( atom_site( i, "id" ).c_str() );
-			ai.name = atom_site( i, "auth_atom_id" );
-			ai.altLoc = 0;
-			if ( atom_site( i, "label_alt_id" ).size() > 0 ) {
-				ai.altLoc = atom_site( i, "label_alt_id" )[ 0 ];
-			}
-
-			ai.resName = atom_site( i, "auth_comp_id" );
-			ai.chainID = ' ';
-			if ( atom_site( i, "auth_asym_id" ).size() > 0 ) ai.chainID = atom_site( i, "auth_asym_id" )[0];
+			char chainID = ' ';
+			if ( asym_id[ i ].size() > 0 ) chainID = asym_id[ i ][0];
 			if ( options.new_chain_order() ) {
-				if ( atom_site( i, "auth_asym_id" ).size() > 0 ) {
-					char chainid = atom_site( i, "auth_asym_id" )[0];
+				if ( asym_id[ i ].size() > 0 ) {
+					char chainid = asym_id[ i ][0];
 					if ( chain_to_idx.find(chainid) == chain_to_idx.end() ) {
 						chain_to_idx[chainid] = chain_to_idx.size()+1;
 						TR << "found new chain " << chainid << " " << chain_to_idx.size() << std::endl;
 					}
-					ai.chainID = modelchain_to_chain[std::pair<Size, Size>(modelidx, chain_to_idx[chainid])];
+					chainID = modelchain_to_chain[std::pair<Size, Size>(modelidx, chain_to_idx[chainid])];
 				}
 			}
 
-			ai.resSeq = atoi( atom_site( i, "auth_seq_id" ).c_str() );
+			std::map< char, Size >::const_iterator index = chain_index.find( chainID );
+			if ( index == chain_index.end() ) {
+				index = chain_index.insert( std::make_pair( chainID, sfr->chains().size() ) ).first;
+				sfr->chains().push_back( ChainAtoms() );
+			}
+			ChainAtoms & chain( sfr->chains()[ index->second ] );
+			chain.push_back( AtomInformation() );
+			AtomInformation & ai( chain.back() );
+			ai.chainID = chainID;
+
+			ai.isHet = ( group_PDB[ i ] == "HETATM" );
+			ai.serial = atoi( id[ i ].c_str() );
+			ai.name.swap( atom_id[ i ] );
+			ai.altLoc = 0;
+			if ( alt_id[ i ].size() > 0 ) {
+				ai.altLoc = alt_id[ i ][ 0 ];
+			}
+
+			ai.resName.swap( comp_id[ i ] );
+
+			ai.resSeq = atoi( seq_id[ i ].c_str() );
 			ai.iCode = ' ';
-			if ( atom_site( i, "pdbx_PDB_ins_code" ).size() > 0 && atom_site( i, "pdbx_PDB_ins_code" )[0] != '?' ) ai.iCode = atom_site( i, "pdbx_PDB_ins_code" )[0];
+			if ( ins_code[ i ].size() > 0 && ins_code[ i ][0] != '?' ) ai.iCode = ins_code[ i ][0];
 
 			// how can you check properly if something will successfully convert to a number !?!?!?
 			bool force_no_occupancy = false;
-			if ( atom_site( i, "Cartn_x" ) == "     nan" ) {
+			if ( cartn_x[ i ] == "     nan" ) {
 				ai.x =0.0;
 				force_no_occupancy=true;
 			} else {
-				ai.x = atof( atom_site( i, "Cartn_x" ).c_str() );
+				ai.x = atof( cartn_x[ i ].c_str() );
 			}
-			if ( atom_site( i, "Cartn_y" ) == "     nan" ) {
+			if ( cartn_y[ i ] == "     nan" ) {
 				ai.y =0.0;
 				force_no_occupancy=true;
 			} else {
-				ai.y = atof( atom_site( i, "Cartn_y" ).c_str() );
+				ai.y = atof( cartn_y[ i ].c_str() );
 			}
-			if ( atom_site( i, "Cartn_z" ) == "     nan" ) {
+			if ( cartn_z[ i ] == "     nan" ) {
 				ai.z =0.0;
 				force_no_occupancy=true;
 			} else {
-				ai.z = atof( atom_site( i, "Cartn_z" ).c_str() );
+				ai.z = atof( cartn_z[ i ].c_str() );
 			}
 
 			// check that the occupancy column actually exists. If it doesn't, assume full occupancy.
 			// otherwise read it.
-			if ( atom_site( i, "occupancy" ) == "      " ) {
+			if ( occupancy[ i ] == "      " ) {
 				ai.occupancy = 1.0;
 			} else {
-				ai.occupancy = atof( atom_site( i, "occupancy" ).c_str() );
+				ai.occupancy = atof( occupancy[ i ].c_str() );
 			}
 			if ( force_no_occupancy ) ai.occupancy = -1.0;
 
-			ai.temperature = atof( atom_site( i, "B_iso_or_equiv" ).c_str() );
+			ai.temperature = atof( b_iso[ i ].c_str() );
 			ai.segmentID = "    ";
-			ai.element = atom_site( i, "type_symbol" );
+			ai.element.swap( type_symbol[ i ] );
 			ai.terCount = 0;
-
-			atom_chain_map[ai.chainID].push_back(ai);
-			if ( std::find( chain_list.begin(), chain_list.end(), ai.chainID ) == chain_list.end() ) {
-				chain_list.push_back( ai.chainID );
-			}
 		}
 	}
 
-
-	for ( Size i=0; i< chain_list.size(); ++i ) { // std::vector
-		sfr->chains().push_back( atom_chain_map.find( chain_list[i] )->second );
-	}
-
 	return sfr;
 }
 
@@ -38,11 +38,11 @@ Field::Field( core::uint start_in, core::uint end_in  ) :
 // Read field value from given .pdb line and set.
 // Thank you, Frank diMaio for idea to have zero indicate no upper bound! ~Labonte
 void
-Field::set_value_from_pdb_line( std::string source ) {
+Field::set_value_from_pdb_line( std::string const & source ) {
 	if ( end != 0 ) {
-		value = std::string( source.begin() + start - 1, source.begin() + end );
+		value.assign( source.begin() + start - 1, source.begin() + end );
 	} else {
-		value = std::string( source.begin() + start - 1, source.end() );
+		value.assign( source.begin() + start - 1, source.end() );
 	}
 }
 
@@ -41,7 +41,7 @@ struct Field {
 
 
 	/// @brief  Read field value from given .pdb line and set.
-	void set_value_from_pdb_line( std::string source );
+	void set_value_from_pdb_line( std::string const & source );
 
 
 	// Member data ////////////////////////////////////////////////////////////
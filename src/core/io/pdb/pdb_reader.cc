@@ -39,6 +39,7 @@
 
 // C++ header
 #include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <map>
 
@@ -91,258 +92,477 @@ create_records_from_pdb_file_contents( std::string const & pdb_contents )
 }
 
 
-/// @remarks  The bulk of SFR generation occurs within this function.
-// Create a representation of structural file data from a list of .pdb format records with options.
-StructFileRep
-create_sfr_from_pdb_records( utility::vector1< Record > & records, StructFileReaderOptions const & options )
+namespace {
+
+/// @brief  One line of a .pdb file, read in place.  Columns past its end read as blanks, as they do in a Record.
+class PDBLine {
+public:
+	PDBLine( char const * begin, Size size ) : begin_( begin ), size_( size ) {}
+
+	/// @brief  The character in (1-based) column col.
+	char column( Size col ) const { return col <= size_ ? begin_[ col - 1 ] : ' '; }
+
+	/// @brief  Are columns 1-6 the given 6-character record name (e.g. "ATOM  ")?
+	bool
+	is_record( char const * type ) const
+	{
+		for ( Size col = 1; col <= 6; ++col ) {
+			if ( column( col ) != type[ col - 1 ] ) return false;
+		}
+		return true;
+	}
+
+	/// @brief  Copy columns start to end (1-based, inclusive) into buffer, which must have room for the
+	/// terminating NUL.
+	void
+	columns( Size start, Size end, char * buffer ) const
+	{
+		for ( Size col = start; col <= end; ++col ) *buffer++ = column( col );
+		*buffer = '\0';
+	}
+
+	std::string str() const { return std::string( begin_, size_ ); }
+
+private:
+	char const * begin_;
+	Size size_;
+};
+
+/// @brief  Parse a fixed-width decimal field such as "  12.345" without copying it.
+/// @details  Returns false for anything but blanks around an optional sign, digits and at most one decimal point
+/// (e.g. "nan" or exponents), so that the caller can fall back on atof().  With at most 15 digits both the digits
+/// and the power of ten are exact doubles, so the one division rounds the same way strtod() does.
+bool
+parse_fixed_decimal( char const * begin, char const * end, double & value )
 {
-	using namespace std;
-	StructFileRep sfr;
+	while ( begin != end && *begin == ' ' ) ++begin;
+	while ( end != begin && *( end - 1 ) == ' ' ) --end;
+	bool negative( false );
+	if ( begin != end && ( *begin == '-' || *begin == '+' ) ) {
+		negative = ( *begin == '-' );
+		++begin;
+	}
+	double digits( 0.0 ), scale( 1.0 );
+	bool point( false );
+	Size n_digits( 0 );
+	for ( ; begin != end; ++begin ) {
+		if ( *begin >= '0' && *begin <= '9' ) {
+			digits = digits * 10.0 + ( *begin - '0' );
+			if ( point ) scale *= 10.0;
+			++n_digits;
+		} else if ( *begin == '.' && ! point ) {
+			point = true;
+		} else {
+			return false;
+		}
+	}
+	if ( n_digits == 0 || n_digits > 15 ) return false;
+	value = ( negative ? -digits : digits ) / scale;
+	return true;
+}
+
+/// @brief  The distinct values of one fixed-width text field (atom name, residue name...) seen in a file.
+/// @details  A file has only a few dozen distinct atom and residue names, so every AtomInformation gets a copy
+/// of a pooled string (sharing its buffer where std::string is reference counted, and never allocating where
+/// it is short-string optimized) instead of a string newly built from the line.
+class FieldPool {
+public:
+	/// @brief  A pool for columns start to end (1-based, inclusive), at most 4 columns wide.
+	FieldPool( Size start, Size end ) : start_( start ), end_( end ) {}
+
+	std::string const &
+	value( PDBLine const & line )
+	{
+		unsigned int key( 0 );
+		for ( Size col = start_; col <= end_; ++col ) {
+			key = ( key << 8 ) | static_cast< unsigned char >( line.column( col ) );
+		}
+		std::map< unsigned int, std::string >::iterator it( strings_.find( key ) );
+		if ( it == strings_.end() ) {
+			char buffer[ 8 ];
+			line.columns( start_, end_, buffer );
+			it = strings_.insert( std::make_pair( key, std::string( buffer ) ) ).first;
+		}
+		return it->second;
+	}
+
+private:
+	Size start_, end_;
+	std::map< unsigned int, std::string > strings_;
+};
+
+/// @brief  The state of reading one .pdb file into a StructFileRep, shared by the Record-based reader and the
+/// fixed-column reader of file contents.
+class StructFileRepBuilder {
+public:
+	StructFileRepBuilder( StructFileRep & sfr, StructFileReaderOptions const & options );
+
+	/// @brief  Store the data of one record.
+	void add_record( Record & record );
+
+	/// @brief  Store the data of one line, reading ATOM and HETATM records straight from their columns.
+	void add_line( PDBLine const & line );
+
+	/// @brief  Finish the StructFileRep once every record has been added.
+	void finish();
+
+private:
+	/// @brief  A new atom at the end of its chain, with its chain ID (after any renaming for new_chain_order)
+	/// and TER count set.
+	AtomInformation & new_atom( char chainID );
 
-	map< char, ChainAtoms > chain_atoms_map;  // A map of chain ID to every atom in the chain.
-	Size ter_record_count = 0;
-	utility::vector1< char > chain_list;
-	std::map< char, Size > chain_to_idx;
+	/// @brief  Fill an ATOM or HETATM atom from the fixed columns of line.
+	void add_atom_line( PDBLine const & line );
+
+private:
+	StructFileRep & sfr_;
+	StructFileReaderOptions const & options_;
+
+	std::map< char, Size > chain_index_;  // index in sfr_.chains() of each chain ID
+	Size ter_record_count_;
+	std::map< char, Size > chain_to_idx_;
 
 	// Prepare for multi-model .pdbs.
-	map< std::pair< Size, Size >, char > modelchain_to_chain;  // TODO: What is this?
-	string const & chain_letters( utility::UPPERCASE_ALPHANUMERICS );
+	std::map< std::pair< Size, Size >, char > modelchain_to_chain_;  // TODO: What is this?
+	Size modelidx_;
+	bool modeltags_present_;
+
+	utility::vector1< Record > unknow_records_;  // place to store unrecognized records for 2nd pass for non-RCSB
+	bool stop_reading_coordinate_section_;  // might be set to true when ENDMDL is reached
+
+	FieldPool atom_names_, residue_names_, segment_ids_, elements_;
+};
+
+StructFileRepBuilder::StructFileRepBuilder( StructFileRep & sfr, StructFileReaderOptions const & options ) :
+	sfr_( sfr ),
+	options_( options ),
+	ter_record_count_( 0 ),
+	modelidx_( 1 ),
+	modeltags_present_( false ),
+	stop_reading_coordinate_section_( false ),
+	atom_names_( 13, 16 ),
+	residue_names_( 18, 20 ),
+	segment_ids_( 73, 76 ),
+	elements_( 77, 78 )
+{
+	std::string const & chain_letters( utility::UPPERCASE_ALPHANUMERICS );
 	for ( Size i = 0; i < chain_letters.size(); ++i ) {
-		modelchain_to_chain[ std::pair< Size, Size >( 0, i ) ] = chain_letters[ i ];
-		modelchain_to_chain[ std::pair< Size, Size >( 1, i ) ] = chain_letters[ i ];
+		modelchain_to_chain_[ std::pair< Size, Size >( 0, i ) ] = chain_letters[ i ];
+		modelchain_to_chain_[ std::pair< Size, Size >( 1, i ) ] = chain_letters[ i ];
 	}
-	Size modelidx = 1;
-	bool modeltags_present = false;
-
-
-	// Loop over all PDB records.
-	Size const n_records( records.size() );
-	utility::vector1< Record > unknow_records;  // place to store unrecognized records for 2nd pass for non-RCSB
-	bool stop_reading_coordinate_section( false );  // might be set to true when ENDMDL is reached
-	for ( core::uint i = 1; i <= n_records; ++i ) {
-		std::string const record_type( records[ i ][ "type" ].value );
-		TR.Trace << "Record type: " << record_type << endl;
-
-		// Title Section //////////////////////////////////////////////////////
-		// Record contains "header information", i.e., is from the Title Section of the PDB file.
-		if ( record_type == "HEADER" || record_type == "KEYWDS" ||
-				record_type == "TITLE " || record_type == "COMPND" ||
-				record_type == "EXPDTA" ) {
-			// TODO: Add rest of Title Section records.
-			sfr.header()->store_record( records[ i ] );
-
-			// Record contains a remark from the Title Section of the PDB file.
-		} else if ( record_type == "REMARK" )  {
-			RemarkInfo ri;
-			ri.num = atoi( records[ i ][ "remarkNum" ].value.c_str() ),
-				ri.value = records[ i ][ "value" ].value;
-
-			//Added by DANIEL to skip reading the PDBinfo-LABEL, which comes "nfo-LABEL:"
-			//Those are read in a different way, using: core.import_pose().read_additional_pdb_data()
-			if ( ( ri.value.size() >= 10 ) && ( ri.value.substr( 0, 10 ) == "nfo-LABEL:" ) ) {
-				continue;
-			}
-			sfr.remarks()->push_back( ri );
+}
 
+AtomInformation &
+StructFileRepBuilder::new_atom( char chainID )
+{
+	if ( options_.new_chain_order() ) {
+		if ( chain_to_idx_.find( chainID ) == chain_to_idx_.end() ) {
+			chain_to_idx_[ chainID ] = chain_to_idx_.size()+1;
+			TR << "found new chain " << chainID << " " << chain_to_idx_.size() << std::endl;
+		}
+		chainID = modelchain_to_chain_[ std::pair< Size, Size >( modelidx_, chain_to_idx_[ chainID ] ) ];
+	}
 
-			// Primary Structure Section //////////////////////////////////////////
-			// Record contains cross-references from PDB sequence fragments to a corresponding database sequence.
-		} else if ( record_type == "DBREF " || record_type == "DBREF1" || record_type == "DBREF2" ||
-				record_type == "SEQADV" ) {
-			//sfr.primary_struct_info()->store_sequence_database_refs( records[ i ] );  // TODO
-			continue;  // TEMP
+	// Chains are kept in order of first appearance.
+	std::map< char, Size >::const_iterator index( chain_index_.find( chainID ) );
+	ChainAtoms * chain;
+	if ( index == chain_index_.end() ) {
+		chain_index_[ chainID ] = sfr_.chains().size();
+		sfr_.chains().push_back( ChainAtoms() );
+		chain = &sfr_.chains().back();
+	} else {
+		chain = &sfr_.chains()[ index->second ];
+	}
+	chain->push_back( AtomInformation() );
+	AtomInformation & ai( chain->back() );
+	ai.chainID = chainID;
+	ai.terCount = ter_record_count_;
+	return ai;
+}
 
-			// Record contains a linear (or cyclic) primary sequence declaration.
-		} else if ( record_type == "SEQRES" ) {
-			store_chain_sequence_record_in_sfr( records[ i ], sfr );
+void
+StructFileRepBuilder::add_line( PDBLine const & line )
+{
+	if ( line.is_record( "ATOM  " ) || line.is_record( "HETATM" ) ) {
+		if ( ! stop_reading_coordinate_section_ ) add_atom_line( line );
+	} else if ( ! stop_reading_coordinate_section_ && ( line.is_record( "TER   " ) || line.is_record( "END   " ) ) ) {
+		++ter_record_count_;
+	} else {
+		Record record( create_record_from_pdb_line( line.str() ) );
+		add_record( record );
+	}
+}
 
-			// Record that a residue is modified and how.
-		} else if ( record_type == "MODRES" ) {
-			store_mod_res_record_in_sfr( records[ i ], sfr );
+/// @details  Columns as in the ATOM and HETATM definitions of database/input_output/pdb_record_defs.
+void
+StructFileRepBuilder::add_atom_line( PDBLine const & line )
+{
+	char buffer[ 16 ];
+
+	AtomInformation & ai( new_atom( line.column( 22 ) ) );
+	ai.isHet = ( line.column( 1 ) == 'H' );
+	line.columns( 7, 11, buffer );
+	ai.serial = atoi( buffer );
+	ai.name = atom_names_.value( line );
+	ai.altLoc = line.column( 17 );
+	ai.resName = residue_names_.value( line );
+	line.columns( 23, 26, buffer );
+	ai.resSeq = atoi( buffer );
+	ai.iCode = line.column( 27 );
+
+	// x, y and z of "     nan" mean the coordinates are unknown.
+	bool force_no_occupancy( false );
+	double * const coordinates[ 3 ] = { &ai.x, &ai.y, &ai.z };
+	for ( Size i = 0; i < 3; ++i ) {
+		line.columns( 31 + 8 * i, 38 + 8 * i, buffer );
+		if ( parse_fixed_decimal( buffer, buffer + 8, *coordinates[ i ] ) ) continue;
+		if ( std::string( buffer ) == "     nan" ) {
+			*coordinates[ i ] = 0.0;
+			force_no_occupancy = true;
+		} else {
+			*coordinates[ i ] = atof( buffer );
+		}
+	}
 
+	// A blank occupancy column means full occupancy.
+	line.columns( 55, 60, buffer );
+	if ( std::string( buffer ) == "      " ) {
+		ai.occupancy = 1.0;
+	} else if ( ! parse_fixed_decimal( buffer, buffer + 6, ai.occupancy ) ) {
+		ai.occupancy = atof( buffer );
+	}
+	if ( force_no_occupancy ) {
+		ai.occupancy = -1.0;
+	}
 
-			// Heterogen Section //////////////////////////////////////////////////
-			// Record contains heterogen nomenclature information.
-		} else if ( record_type == "HETNAM" ) {
-			store_heterogen_name_record_in_sfr( records[ i ], sfr );
+	line.columns( 61, 66, buffer );
+	if ( ! parse_fixed_decimal( buffer, buffer + 6, ai.temperature ) ) {
+		ai.temperature = atof( buffer );
+	}
+	ai.segmentID = segment_ids_.value( line );
+	ai.element = elements_.value( line );
+}
 
-			// Record contains heterogen synonym information.
-		} else if ( record_type == "HETSYN" ) {
-			store_heterogen_synonym_record_in_sfr( records[ i ], sfr );
+void
+StructFileRepBuilder::add_record( Record & record )
+{
+	std::string const & chain_letters( utility::UPPERCASE_ALPHANUMERICS );
+	std::string const record_type( record[ "type" ].value );
+	TR.Trace << "Record type: " << record_type << std::endl;
+
+	// Title Section //////////////////////////////////////////////////////
+	// Record contains "header information", i.e., is from the Title Section of the PDB file.
+	if ( record_type == "HEADER" || record_type == "KEYWDS" ||
+			record_type == "TITLE " || record_type == "COMPND" ||
+			record_type == "EXPDTA" ) {
+		// TODO: Add rest of Title Section records.
+		sfr_.header()->store_record( record );
+
+		// Record contains a remark from the Title Section of the PDB file.
+	} else if ( record_type == "REMARK" )  {
+		RemarkInfo ri;
+		ri.num = atoi( record[ "remarkNum" ].value.c_str() ),
+			ri.value = record[ "value" ].value;
+
+		//Added by DANIEL to skip reading the PDBinfo-LABEL, which comes "nfo-LABEL:"
+		//Those are read in a different way, using: core.import_pose().read_additional_pdb_data()
+		if ( ( ri.value.size() >= 10 ) && ( ri.value.substr( 0, 10 ) == "nfo-LABEL:" ) ) {
+			return;
+		}
+		sfr_.remarks()->push_back( ri );
 
-			// Record contains formula information.
-		} else if ( record_type == "FORMUL" ) {
-			store_formula_record_in_sfr( records[ i ], sfr );
 
+		// Primary Structure Section //////////////////////////////////////////
+		// Record contains cross-references from PDB sequence fragments to a corresponding database sequence.
+	} else if ( record_type == "DBREF " || record_type == "DBREF1" || record_type == "DBREF2" ||
+			record_type == "SEQADV" ) {
+		//sfr_.primary_struct_info()->store_sequence_database_refs( record );  // TODO
+		return;  // TEMP
 
-			// Secondary Structure Section ////////////////////////////////////////
-			// Record contains helix definitions.
-		} else if ( record_type == "HELIX " ) {
-			// TODO: Store HELIX record types here.
-			continue;
+		// Record contains a linear (or cyclic) primary sequence declaration.
+	} else if ( record_type == "SEQRES" ) {
+		store_chain_sequence_record_in_sfr( record, sfr_ );
 
-			// Record contains sheet definitions.
-		} else if ( record_type == "SHEET " ) {
-			// TODO: Store SHEET record types here.
-			continue;
+		// Record that a residue is modified and how.
+	} else if ( record_type == "MODRES" ) {
+		store_mod_res_record_in_sfr( record, sfr_ );
 
 
-			// Connectivity Annotation Section ////////////////////////////////////
-			// Record contains disulfide linkage information.
-		} else if ( record_type == "SSBOND" ) {
-			store_ssbond_record_in_sfr( records[ i ], sfr );
+		// Heterogen Section //////////////////////////////////////////////////
+		// Record contains heterogen nomenclature information.
+	} else if ( record_type == "HETNAM" ) {
+		store_heterogen_name_record_in_sfr( record, sfr_ );
 
-			// Record contains nonstandard polymer linkage information.
-		} else if ( record_type == "LINK  " ) {
-			store_link_record_in_sfr( records[ i ], sfr );
+		// Record contains heterogen synonym information.
+	} else if ( record_type == "HETSYN" ) {
+		store_heterogen_synonym_record_in_sfr( record, sfr_ );
 
-		} else if ( record_type == "CISPEP" ) {
-			store_cis_peptide_record_in_sfr( records[ i ], sfr );
+		// Record contains formula information.
+	} else if ( record_type == "FORMUL" ) {
+		store_formula_record_in_sfr( record, sfr_ );
 
 
-			// Miscellaneous Features Section /////////////////////////////////////
-		} else if ( record_type == "SITE  " ) {
-			// TODO: Store SITE record types here.
-			continue;
+		// Secondary Structure Section ////////////////////////////////////////
+		// Record contains helix definitions.
+	} else if ( record_type == "HELIX " ) {
+		// TODO: Store HELIX record types here.
+		return;
 
-			// Crystallographic and Coordinate Transformation Section /////////////
-			// Record contains crystal information.
-		} else if ( records[i]["type"].value == "CRYST1" )  {
-			store_crystallographic_parameter_record_in_sfr( records[ i ], sfr );
+		// Record contains sheet definitions.
+	} else if ( record_type == "SHEET " ) {
+		// TODO: Store SHEET record types here.
+		return;
 
 
-			// Coordinate Section /////////////////////////////////////////////////
-			// Record contains multimodel PDBs.
-		} else if ( record_type == "MODEL " ) {
-			if ( stop_reading_coordinate_section ) continue;
+		// Connectivity Annotation Section ////////////////////////////////////
+		// Record contains disulfide linkage information.
+	} else if ( record_type == "SSBOND" ) {
+		store_ssbond_record_in_sfr( record, sfr_ );
 
-			// store the serial number as the filename, which will become the PDBInfo name of the pose
-			std::string temp_model = ObjexxFCL::strip_whitespace( records[i]["serial"].value ) ;
-			sfr.modeltag() = temp_model.c_str();
-			if ( options.new_chain_order() ) {
-				if ( modeltags_present ) {
-					// second model... all chains should be present...
-					for ( Size model_idx=2; model_idx*chain_to_idx.size()<chain_letters.size(); ++model_idx ) {
-						for ( Size chain_idx=1; chain_idx <= chain_to_idx.size(); ++chain_idx ) {
-							TR << "REARRANGE CHAINS " << model_idx << " " << chain_idx << " ";
-							TR << (model_idx-1)*chain_to_idx.size()+chain_idx << std::endl;
-							modelchain_to_chain[std::pair<Size, Size>(model_idx, chain_idx)] =
-								chain_letters[(model_idx-1)*chain_to_idx.size() + chain_idx - 1];
-						}
-					}
-					++modelidx;
-					if ( modelidx > 8 ) utility_exit_with_message("quitting: too many MODELs");
-				} else {
-					modeltags_present = true;
-				}
-			}
+		// Record contains nonstandard polymer linkage information.
+	} else if ( record_type == "LINK  " ) {
+		store_link_record_in_sfr( record, sfr_ );
 
-			// Record contains atom information.
-		} else if ( record_type == "ATOM  " || record_type == "HETATM" ) {
-			if ( stop_reading_coordinate_section ) continue;
+	} else if ( record_type == "CISPEP" ) {
+		store_cis_peptide_record_in_sfr( record, sfr_ );
 
-			// TODO: Refactor?
-			Record & R( records[ i ] );
 
-			AtomInformation ai;
-			ai.isHet = ( R[ "type" ].value == "HETATM" );  // probably not worth storing here
-			ai.serial = atoi( R[ "serial" ].value.c_str() );
-			ai.name = R[ "name" ].value;
-			ai.altLoc = 0;
-			if ( R[ "altLoc" ].value.size() > 0 ) {
-				ai.altLoc = R[ "altLoc" ].value[ 0 ];
-			}
+		// Miscellaneous Features Section /////////////////////////////////////
+	} else if ( record_type == "SITE  " ) {
+		// TODO: Store SITE record types here.
+		return;
 
-			ai.resName = R[ "resName" ].value;
-			ai.chainID = 0;
-			if ( R[ "chainID" ].value.size() > 0 ) {
-				ai.chainID = R[ "chainID" ].value[ 0 ];
-			}
-			if ( options.new_chain_order() ) {
-				if ( R["chainID"].value.size() > 0 ) {
-					char chainid = R["chainID"].value[0];
-					if ( chain_to_idx.find(chainid) == chain_to_idx.end() ) {
-						chain_to_idx[chainid] = chain_to_idx.size()+1;
-						TR << "found new chain " << chainid << " " << chain_to_idx.size() << std::endl;
+		// Crystallographic and Coordinate Transformation Section /////////////
+		// Record contains crystal information.
+	} else if ( record[ "type" ].value == "CRYST1" )  {
+		store_crystallographic_parameter_record_in_sfr( record, sfr_ );
+
+
+		// Coordinate Section /////////////////////////////////////////////////
+		// Record contains multimodel PDBs.
+	} else if ( record_type == "MODEL " ) {
+		if ( stop_reading_coordinate_section_ ) return;
+
+		// store the serial number as the filename, which will become the PDBInfo name of the pose
+		std::string temp_model = ObjexxFCL::strip_whitespace( record[ "serial" ].value ) ;
+		sfr_.modeltag() = temp_model.c_str();
+		if ( options_.new_chain_order() ) {
+			if ( modeltags_present_ ) {
+				// second model... all chains should be present...
+				for ( Size model_idx=2; model_idx*chain_to_idx_.size()<chain_letters.size(); ++model_idx ) {
+					for ( Size chain_idx=1; chain_idx <= chain_to_idx_.size(); ++chain_idx ) {
+						TR << "REARRANGE CHAINS " << model_idx << " " << chain_idx << " ";
+						TR << (model_idx-1)*chain_to_idx_.size()+chain_idx << std::endl;
+						modelchain_to_chain_[std::pair<Size, Size>(model_idx, chain_idx)] =
+							chain_letters[(model_idx-1)*chain_to_idx_.size() + chain_idx - 1];
 					}
-					ai.chainID = modelchain_to_chain[std::pair<Size, Size>(modelidx, chain_to_idx[chainid])];
 				}
+				++modelidx_;
+				if ( modelidx_ > 8 ) utility_exit_with_message("quitting: too many MODELs");
+			} else {
+				modeltags_present_ = true;
 			}
+		}
 
-			ai.resSeq = atoi( R["resSeq"].value.c_str() );
-			ai.iCode = 0;
-			if ( R["iCode"].value.size() > 0 ) ai.iCode = R["iCode"].value[0];
+		// Record contains atom information.
+	} else if ( record_type == "ATOM  " || record_type == "HETATM" ) {
+		if ( stop_reading_coordinate_section_ ) return;
 
-			// how can you check properly if something will successfully convert to a number !?!?!?
-			bool force_no_occupancy = false;
-			if ( R["x"].value == "     nan" ) {
-				ai.x =0.0;
-				force_no_occupancy=true;
-			} else {
-				ai.x = atof( R["x"].value.c_str() );
-			}
-			if ( R["y"].value == "     nan" ) {
-				ai.y =0.0;
-				force_no_occupancy=true;
-			} else {
-				ai.y = atof( R["y"].value.c_str() );
-			}
-			if ( R["z"].value == "     nan" ) {
-				ai.z =0.0;
-				force_no_occupancy=true;
-			} else {
-				ai.z = atof( R["z"].value.c_str() );
-			}
+		// TODO: Refactor?
+		Record & R( record );
 
-			// check that the occupancy column actually exists. If it doesn't, assume full occupancy.
-			// otherwise read it.
-			if ( R["occupancy"].value == "      " ) {
-				ai.occupancy = 1.0;
-			} else {
-				ai.occupancy = atof( R["occupancy"].value.c_str() );
-			}
-			if ( force_no_occupancy ) {
-				ai.occupancy = -1.0;
-			}
+		AtomInformation & ai( new_atom( R[ "chainID" ].value.size() > 0 ? R[ "chainID" ].value[ 0 ] : 0 ) );
+		ai.isHet = ( R[ "type" ].value == "HETATM" );  // probably not worth storing here
+		ai.serial = atoi( R[ "serial" ].value.c_str() );
+		ai.name = R[ "name" ].value;
+		ai.altLoc = 0;
+		if ( R[ "altLoc" ].value.size() > 0 ) {
+			ai.altLoc = R[ "altLoc" ].value[ 0 ];
+		}
 
-			ai.temperature = atof( R["tempFactor"].value.c_str() );
-			// if ( ai.resName == "CYS" ) {
-			//  TR << "In reader " << R["tempFactor"] << endl;
-			// }
-			ai.segmentID = R["segmentID"].value;
-			ai.element = R["element"].value;
-			ai.terCount = ter_record_count;
-
-			chain_atoms_map[ ai.chainID ].push_back( ai );
-			if ( find( chain_list.begin(), chain_list.end(), ai.chainID ) == chain_list.end() ) {
-				chain_list.push_back( ai.chainID );
-			}
+		ai.resName = R[ "resName" ].value;
+		ai.resSeq = atoi( R["resSeq"].value.c_str() );
+		ai.iCode = 0;
+		if ( R["iCode"].value.size() > 0 ) ai.iCode = R["iCode"].value[0];
 
-		} else if ( ! stop_reading_coordinate_section && ( record_type == "TER   " || record_type == "END   " ) ) {
-			++ter_record_count;
+		// how can you check properly if something will successfully convert to a number !?!?!?
+		bool force_no_occupancy = false;
+		if ( R["x"].value == "     nan" ) {
+			ai.x =0.0;
+			force_no_occupancy=true;
+		} else {
+			ai.x = atof( R["x"].value.c_str() );
+		}
+		if ( R["y"].value == "     nan" ) {
+			ai.y =0.0;
+			force_no_occupancy=true;
+		} else {
+			ai.y = atof( R["y"].value.c_str() );
+		}
+		if ( R["z"].value == "     nan" ) {
+			ai.z =0.0;
+			force_no_occupancy=true;
+		} else {
+			ai.z = atof( R["z"].value.c_str() );
+		}
 
-		} else if ( record_type == "ENDMDL" )  {
-			if ( options.obey_ENDMDL() )  {
-				TR.Warning << "Hit ENDMDL; not reading further coordinate section records." << endl;
-				stop_reading_coordinate_section = true;
-			}
-		} else /*UNKNOW record*/ {
-			unknow_records.push_back( records[ i ] );
+		// check that the occupancy column actually exists. If it doesn't, assume full occupancy.
+		// otherwise read it.
+		if ( R["occupancy"].value == "      " ) {
+			ai.occupancy = 1.0;
+		} else {
+			ai.occupancy = atof( R["occupancy"].value.c_str() );
 		}
-	}
+		if ( force_no_occupancy ) {
+			ai.occupancy = -1.0;
+		}
+
+		ai.temperature = atof( R["tempFactor"].value.c_str() );
+		// if ( ai.resName == "CYS" ) {
+		//  TR << "In reader " << R["tempFactor"] << std::endl;
+		// }
+		ai.segmentID = R["segmentID"].value;
+		ai.element = R["element"].value;
 
-	sfr.header()->finalize_parse();
+	} else if ( ! stop_reading_coordinate_section_ && ( record_type == "TER   " || record_type == "END   " ) ) {
+		++ter_record_count_;
 
-	for ( Size i = 1; i <= chain_list.size(); ++i ) {
-		sfr.chains().push_back( chain_atoms_map.find( chain_list[ i ] )->second );
+	} else if ( record_type == "ENDMDL" )  {
+		if ( options_.obey_ENDMDL() )  {
+			TR.Warning << "Hit ENDMDL; not reading further coordinate section records." << std::endl;
+			stop_reading_coordinate_section_ = true;
+		}
+	} else /*UNKNOW record*/ {
+		unknow_records_.push_back( record );
 	}
+}
+
+void
+StructFileRepBuilder::finish()
+{
+	sfr_.header()->finalize_parse();
 
 	// Now check through the list of unknown record lines to see if there are any Rosetta-specific things that we care
 	// about loading.
-	if ( options.pdb_comments() ) {
-		store_unknown_records_in_sfr( unknow_records, sfr );
+	if ( options_.pdb_comments() ) {
+		store_unknown_records_in_sfr( unknow_records_, sfr_ );
 	}
+}
 
+}  // anonymous namespace
+
+
+/// @remarks  The bulk of SFR generation occurs within StructFileRepBuilder::add_record().
+// Create a representation of structural file data from a list of .pdb format records with options.
+StructFileRep
+create_sfr_from_pdb_records( utility::vector1< Record > & records, StructFileReaderOptions const & options )
+{
+	StructFileRep sfr;
+	StructFileRepBuilder builder( sfr, options );
+	for ( core::uint i = 1; i <= records.size(); ++i ) {
+		builder.add_record( records[ i ] );
+	}
+	builder.finish();
 	return sfr;
 }
 
@@ -359,8 +579,9 @@ create_sfr_from_pdb_records( utility::vector1< Record > & records )
 StructFileRep
 create_sfr_from_pdb_file_contents( std::string const & pdb_contents, StructFileReaderOptions const & options )
 {
-	utility::vector1< Record > records( create_records_from_pdb_file_contents( pdb_contents ) );
-	return create_sfr_from_pdb_records( records, options );
+	StructFileRep sfr;
+	read_sfr_from_pdb_file_contents( pdb_contents, options, sfr );
+	return sfr;
 }
 
 // Create a representation of structural file data from .pdb file contents.
@@ -371,6 +592,43 @@ create_sfr_from_pdb_file_contents( std::string const & pdb_contents )
 	return create_sfr_from_pdb_file_contents( pdb_contents, options );
 }
 
+/// @details  Lines are read in place rather than split into strings, blank lines are skipped, and ATOM and HETATM
+/// records are read from their fixed columns without building a Record.
+void
+read_sfr_from_pdb_file_contents(
+	std::string const & pdb_contents,
+	StructFileReaderOptions const & options,
+	StructFileRep & sfr )
+{
+	sfr.clear();
+	StructFileRepBuilder builder( sfr, options );
+	char const * const contents_end( pdb_contents.data() + pdb_contents.size() );
+	for ( char const * begin( pdb_contents.data() ); begin < contents_end; ) {
+		char const * end( begin );
+		while ( end != contents_end && *end != '\n' && *end != '\r' ) ++end;
+		if ( end != begin ) builder.add_line( PDBLine( begin, end - begin ) );
+		begin = end + 1;
+	}
+	builder.finish();
+}
+
+// Is this the contents of a .pdb file, i.e., does any line start with a known record type?
+bool
+pdb_file_contents_have_pdb_records( std::string const & pdb_contents )
+{
+	std::string::size_type begin( 0 );
+	while ( begin < pdb_contents.size() ) {
+		std::string::size_type end( pdb_contents.find_first_of( "\n\r", begin ) );
+		if ( end == std::string::npos ) end = pdb_contents.size();
+		if ( end != begin ) {
+			std::string const record_type( utility::trim( pdb_contents.substr( begin, std::min< std::string::size_type >( end - begin, 6 ) ) ) );
+			if ( record_type != "UNKNOW" && RecordCollection::is_valid_record_type( record_type ) ) return true;
+		}
+		begin = end + 1;
+	}
+	return false;
+}
+
 
 // The 2 functions below are covered by import_pose.cc.
 // Create a representation of structural file data from a .pdb file by file.
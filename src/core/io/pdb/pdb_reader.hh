@@ -60,6 +60,16 @@ StructFileRep create_sfr_from_pdb_file_contents( std::string const & pdb_content
 /// @brief  Create a representation of structural file data from .pdb file contents.
 StructFileRep create_sfr_from_pdb_file_contents( std::string const & pdb_contents );
 
+/// @brief  Read .pdb file contents into sfr, which is cleared first.
+/// @details  ATOM and HETATM records are read straight from their columns, without building a Record.
+void read_sfr_from_pdb_file_contents(
+	std::string const & pdb_contents,
+	StructFileReaderOptions const & options,
+	StructFileRep & sfr );
+
+/// @brief  Does any line of the given file contents start with a known .pdb record type?
+bool pdb_file_contents_have_pdb_records( std::string const & pdb_contents );
+
 
 /// @brief  Create a representation of structural file data from a .pdb file by file.
 //StructFileRep create_sfr_from_pdb_file( utility::io::izstream const & file );
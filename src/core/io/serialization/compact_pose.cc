@@ -0,0 +1,489 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/io/serialization/compact_pose.cc
+/// @brief  Compact binary wire format of a Pose for checkpoints and for sending poses between processes.
+
+// Unit headers
+#include <core/io/serialization/compact_pose.hh>
+
+// Project headers
+#include <core/pose/Pose.hh>
+#include <core/pose/PDBInfo.hh>
+#include <core/pose/symmetry/util.hh>
+#include <core/chemical/ChemicalManager.hh>
+#include <core/chemical/ResidueType.hh>
+#include <core/chemical/ResidueTypeSet.hh>
+#include <core/conformation/Conformation.hh>
+#include <core/conformation/Residue.hh>
+#include <core/conformation/ResidueFactory.hh>
+#include <core/kinematics/FoldTree.hh>
+
+// Utility headers
+#include <utility/excn/Exceptions.hh>
+#include <utility/exit.hh>
+#include <utility/vector1.hh>
+
+// External headers
+#include <zlib/zlib.h>
+
+// C++ headers
+#include <cstring>
+#include <map>
+#include <sstream>
+
+namespace core {
+namespace io {
+namespace serialization {
+
+namespace {
+
+char const COMPACT_POSE_MAGIC[ 4 ] = { 'C', 'P', 'O', 'S' };
+unsigned char const COMPACT_POSE_VERSION = 1;
+core::Size const COMPACT_POSE_HEADER_SIZE = 16;
+
+unsigned char const FLAG_ZLIB = 0x01;
+unsigned char const FLAG_PDB_INFO = 0x02;
+
+unsigned char const RESIDUE_POLYMER_BOND = 0x01;
+
+/// @brief Appends little endian numbers, LEB128 varints and length-prefixed strings to a string.
+class CompactWriter {
+public:
+	CompactWriter( std::string & out ) : out_( out ) {}
+
+	void byte( unsigned char x ) { out_.push_back( char( x ) ); }
+
+	void uint32( unsigned int x ) {
+		for ( int ii = 0; ii < 4; ++ii ) byte( ( x >> ( 8 * ii ) ) & 0xFF );
+	}
+
+	void int32( int x ) { uint32( (unsigned int) x ); }
+
+	void varint( core::Size x ) {
+		while ( x >= 0x80 ) {
+			byte( ( x & 0x7F ) | 0x80 );
+			x >>= 7;
+		}
+		byte( x );
+	}
+
+	void float32( float x ) {
+		unsigned int bits;
+		std::memcpy( &bits, &x, sizeof( bits ) );
+		uint32( bits );
+	}
+
+	void string( std::string const & x ) {
+		varint( x.size() );
+		out_.append( x );
+	}
+
+private:
+	std::string & out_;
+};
+
+/// @brief Reads what CompactWriter wrote, throwing EXCN_BadInput instead of reading past the end.
+class CompactReader {
+public:
+	CompactReader( char const * begin, char const * end ) : pos_( begin ), end_( end ) {}
+
+	unsigned char byte() {
+		need( 1 );
+		return (unsigned char) *pos_++;
+	}
+
+	unsigned int uint32() {
+		need( 4 );
+		unsigned int x( 0 );
+		for ( int ii = 0; ii < 4; ++ii ) x |= (unsigned int)( (unsigned char) pos_[ ii ] ) << ( 8 * ii );
+		pos_ += 4;
+		return x;
+	}
+
+	int int32() { return (int) uint32(); }
+
+	core::Size varint() {
+		core::Size x( 0 );
+		for ( int shift = 0; shift < 64; shift += 7 ) {
+			unsigned char const b( byte() );
+			x |= core::Size( b & 0x7F ) << shift;
+			if ( !( b & 0x80 ) ) return x;
+		}
+		throw utility::excn::EXCN_BadInput( "compact pose: malformed integer" );
+	}
+
+	float float32() {
+		unsigned int const bits( uint32() );
+		float x;
+		std::memcpy( &x, &bits, sizeof( x ) );
+		return x;
+	}
+
+	std::string string() {
+		core::Size const n( varint() );
+		need( n );
+		std::string x( pos_, n );
+		pos_ += n;
+		return x;
+	}
+
+	bool at_end() const { return pos_ == end_; }
+
+private:
+	void need( core::Size n ) const {
+		if ( core::Size( end_ - pos_ ) < n ) {
+			throw utility::excn::EXCN_BadInput( "compact pose: record is truncated" );
+		}
+	}
+
+private:
+	char const * pos_;
+	char const * end_;
+};
+
+/// @brief Is connection resconn of residue seqpos the polymer bond that append_residue_by_bond()
+/// makes between seqpos-1 and seqpos (or seqpos and seqpos+1)?
+bool
+is_appended_polymer_bond(
+	core::pose::Pose const & pose,
+	core::Size seqpos,
+	core::Size resconn,
+	utility::vector1< unsigned char > const & residue_flags
+) {
+	core::conformation::Residue const & rsd( pose.residue( seqpos ) );
+	core::Size const partner( rsd.connected_residue_at_resconn( resconn ) );
+	if ( partner + 1 == seqpos ) {
+		return ( residue_flags[ seqpos ] & RESIDUE_POLYMER_BOND ) && resconn == rsd.type().lower_connect_id();
+	}
+	if ( partner == seqpos + 1 ) {
+		return ( residue_flags[ partner ] & RESIDUE_POLYMER_BOND ) && resconn == rsd.type().upper_connect_id();
+	}
+	return false;
+}
+
+void
+write_payload( core::pose::Pose const & pose, std::string & payload )
+{
+	using core::conformation::Residue;
+	using core::chemical::ResidueType;
+
+	CompactWriter w( payload );
+	core::Size const nres( pose.total_residue() );
+
+	// residue type table
+	std::map< ResidueType const *, core::Size > type_index;
+	utility::vector1< ResidueType const * > types;
+	utility::vector1< core::Size > residue_type_index( nres, 0 );
+	for ( core::Size ii = 1; ii <= nres; ++ii ) {
+		ResidueType const * type( &pose.residue_type( ii ) );
+		std::map< ResidueType const *, core::Size >::const_iterator it( type_index.find( type ) );
+		if ( it == type_index.end() ) {
+			types.push_back( type );
+			it = type_index.insert( std::make_pair( type, types.size() ) ).first;
+		}
+		residue_type_index[ ii ] = it->second;
+	}
+	w.varint( types.size() );
+	for ( core::Size ii = 1; ii <= types.size(); ++ii ) {
+		// types are stored by name and set, so a type built on the fly could not be read back
+		if ( !types[ ii ]->in_residue_type_set() ) {
+			throw utility::excn::EXCN_Msg_Exception( "compact pose: residue type " + types[ ii ]->name()
+				+ " does not belong to a residue type set and cannot be written" );
+		}
+		w.string( types[ ii ]->residue_type_set()->name() );
+		w.string( types[ ii ]->name() );
+	}
+
+	// residues
+	utility::vector1< unsigned char > residue_flags( nres, 0 );
+	for ( core::Size ii = 2; ii <= nres; ++ii ) {
+		Residue const & rsd( pose.residue( ii ) );
+		if ( rsd.is_polymer() && rsd.type().lower_connect_id() && pose.residue( ii - 1 ).is_polymer()
+				&& pose.residue( ii - 1 ).type().upper_connect_id()
+				&& rsd.connected_residue_at_resconn( rsd.type().lower_connect_id() ) == ii - 1 ) {
+			residue_flags[ ii ] |= RESIDUE_POLYMER_BOND;
+		}
+	}
+	w.varint( nres );
+	for ( core::Size ii = 1; ii <= nres; ++ii ) {
+		w.varint( residue_type_index[ ii ] );
+		w.byte( residue_flags[ ii ] );
+		w.byte( pose.secstruct( ii ) );
+	}
+
+	// chain endings
+	utility::vector1< core::Size > const & chain_endings( pose.conformation().chain_endings() );
+	w.varint( chain_endings.size() );
+	for ( core::Size ii = 1; ii <= chain_endings.size(); ++ii ) w.varint( chain_endings[ ii ] );
+
+	// chemical bonds not made by appending the residues: disulfides, cyclic peptides, branches
+	std::string bonds;
+	CompactWriter wb( bonds );
+	core::Size n_bonds( 0 );
+	for ( core::Size ii = 1; ii <= nres; ++ii ) {
+		Residue const & rsd( pose.residue( ii ) );
+		for ( core::Size conn = 1; conn <= rsd.connect_map_size(); ++conn ) {
+			core::Size const partner( rsd.connected_residue_at_resconn( conn ) );
+			if ( partner == 0 || partner < ii ) continue;
+			core::Size const partner_conn( rsd.residue_connection_conn_id( conn ) );
+			if ( partner == ii && partner_conn < conn ) continue;
+			if ( is_appended_polymer_bond( pose, ii, conn, residue_flags ) ) continue;
+			wb.varint( ii );
+			wb.varint( rsd.residue_connect_atom_index( conn ) );
+			wb.varint( partner );
+			wb.varint( pose.residue( partner ).residue_connect_atom_index( partner_conn ) );
+			++n_bonds;
+		}
+	}
+	w.varint( n_bonds );
+	payload.append( bonds );
+
+	// coordinates; the atom count of each residue is that of its type
+	for ( core::Size ii = 1; ii <= nres; ++ii ) {
+		Residue const & rsd( pose.residue( ii ) );
+		for ( core::Size jj = 1; jj <= rsd.natoms(); ++jj ) {
+			core::Vector const & xyz( rsd.xyz( jj ) );
+			w.float32( xyz.x() );
+			w.float32( xyz.y() );
+			w.float32( xyz.z() );
+		}
+	}
+
+	// fold tree
+	std::ostringstream fold_tree;
+	fold_tree << pose.fold_tree();
+	w.string( fold_tree.str() );
+
+	// PDBInfo numbering
+	if ( pose.pdb_info() ) {
+		core::pose::PDBInfo const & info( *pose.pdb_info() );
+		w.string( info.name() );
+		for ( core::Size ii = 1; ii <= nres; ++ii ) {
+			w.byte( info.chain( ii ) );
+			w.int32( info.number( ii ) );
+			w.byte( info.icode( ii ) );
+		}
+	}
+}
+
+void
+read_payload( char const * begin, char const * end, bool has_pdb_info, core::pose::Pose & pose )
+{
+	using namespace core::chemical;
+	using core::conformation::ResidueOP;
+
+	CompactReader r( begin, end );
+
+	// residue type table
+	core::Size const n_types( r.varint() );
+	utility::vector1< ResidueType const * > types( n_types, 0 );
+	for ( core::Size ii = 1; ii <= n_types; ++ii ) {
+		std::string const type_set( r.string() );
+		std::string const type_name( r.string() );
+		ResidueTypeSetCOP rts( ChemicalManager::get_instance()->residue_type_set( type_set ) );
+		if ( !rts->has_name( type_name ) ) {
+			throw utility::excn::EXCN_BadInput( "compact pose: unknown residue type " + type_name + " in residue type set " + type_set );
+		}
+		types[ ii ] = &rts->name_map( type_name );
+	}
+
+	// residues
+	core::Size const nres( r.varint() );
+	utility::vector1< ResidueType const * > residue_types( nres, 0 );
+	utility::vector1< unsigned char > residue_flags( nres, 0 );
+	std::string secstruct( nres, 'L' );
+	for ( core::Size ii = 1; ii <= nres; ++ii ) {
+		core::Size const type( r.varint() );
+		if ( type < 1 || type > n_types ) {
+			throw utility::excn::EXCN_BadInput( "compact pose: residue type index out of range" );
+		}
+		residue_types[ ii ] = types[ type ];
+		residue_flags[ ii ] = r.byte();
+		secstruct[ ii - 1 ] = r.byte();
+	}
+
+	utility::vector1< core::Size > chain_endings( r.varint() );
+	for ( core::Size ii = 1; ii <= chain_endings.size(); ++ii ) chain_endings[ ii ] = r.varint();
+
+	core::Size const n_bonds( r.varint() );
+	utility::vector1< utility::vector1< core::Size > > bonds( n_bonds, utility::vector1< core::Size >( 4, 0 ) );
+	for ( core::Size ii = 1; ii <= n_bonds; ++ii ) {
+		for ( core::Size jj = 1; jj <= 4; ++jj ) bonds[ ii ][ jj ] = r.varint();
+	}
+
+	// build the residues at their stored coordinates; append_residue_by_bond() without ideal
+	// geometry keeps them, so nothing has to be refolded
+	pose.clear();
+	for ( core::Size ii = 1; ii <= nres; ++ii ) {
+		ResidueOP rsd( core::conformation::ResidueFactory::create_residue( *residue_types[ ii ] ) );
+		for ( core::Size jj = 1; jj <= rsd->natoms(); ++jj ) {
+			float const x( r.float32() );
+			float const y( r.float32() );
+			float const z( r.float32() );
+			rsd->set_xyz( jj, core::Vector( x, y, z ) );
+		}
+		if ( ii == 1 || ( residue_flags[ ii ] & RESIDUE_POLYMER_BOND ) ) {
+			pose.append_residue_by_bond( *rsd );
+		} else {
+			pose.append_residue_by_jump( *rsd, 1 );
+		}
+	}
+	pose.conformation().chain_endings( chain_endings );
+
+	for ( core::Size ii = 1; ii <= n_bonds; ++ii ) {
+		core::Size const res1( bonds[ ii ][ 1 ] ), res2( bonds[ ii ][ 3 ] );
+		if ( res1 < 1 || res1 > nres || res2 < 1 || res2 > nres
+				|| bonds[ ii ][ 2 ] > pose.residue( res1 ).natoms() || bonds[ ii ][ 4 ] > pose.residue( res2 ).natoms() ) {
+			throw utility::excn::EXCN_BadInput( "compact pose: chemical bond out of range" );
+		}
+		pose.conformation().declare_chemical_bond(
+			res1, pose.residue( res1 ).atom_name( bonds[ ii ][ 2 ] ),
+			res2, pose.residue( res2 ).atom_name( bonds[ ii ][ 4 ] ) );
+	}
+
+	// fold tree; the jumps follow from the coordinates
+	std::istringstream fold_tree_in( r.string() );
+	if ( nres > 0 ) {
+		core::kinematics::FoldTree fold_tree;
+		fold_tree_in >> fold_tree;
+		if ( !fold_tree_in || fold_tree.nres() != nres ) {
+			throw utility::excn::EXCN_BadInput( "compact pose: bad fold tree" );
+		}
+		pose.fold_tree( fold_tree );
+	}
+
+	for ( core::Size ii = 1; ii <= nres; ++ii ) pose.set_secstruct( ii, secstruct[ ii - 1 ] );
+
+	if ( has_pdb_info ) {
+		core::pose::PDBInfoOP info( new core::pose::PDBInfo( pose ) );
+		info->name( r.string() );
+		for ( core::Size ii = 1; ii <= nres; ++ii ) {
+			char const chain( r.byte() );
+			int const number( r.int32() );
+			char const icode( r.byte() );
+			info->set_resinfo( ii, chain, number, icode );
+		}
+		pose.pdb_info( info );
+	}
+
+	if ( !r.at_end() ) {
+		throw utility::excn::EXCN_BadInput( "compact pose: trailing data in record" );
+	}
+}
+
+} // anonymous namespace
+
+void
+write_compact_pose( core::pose::Pose const & pose, std::string & out, bool compress )
+{
+	if ( core::pose::symmetry::is_symmetric( pose ) ) {
+		utility_exit_with_message( "The compact pose format does not support symmetric poses." );
+	}
+
+	std::string payload;
+	payload.reserve( 64 + pose.total_residue() * 16 * 12 );
+	write_payload( pose, payload );
+
+	unsigned char flags( pose.pdb_info() ? FLAG_PDB_INFO : 0 );
+	std::string compressed;
+	if ( compress && !payload.empty() ) {
+		uLongf compressed_size( compressBound( payload.size() ) );
+		compressed.resize( compressed_size );
+		int const status( compress2( (Bytef *) &compressed[ 0 ], &compressed_size,
+			(Bytef const *) payload.data(), payload.size(), Z_BEST_SPEED ) );
+		if ( status == Z_OK && compressed_size < payload.size() ) {
+			compressed.resize( compressed_size );
+			flags |= FLAG_ZLIB;
+		}
+	}
+	std::string const & stored( ( flags & FLAG_ZLIB ) ? compressed : payload );
+
+	out.reserve( out.size() + COMPACT_POSE_HEADER_SIZE + stored.size() );
+	out.append( COMPACT_POSE_MAGIC, 4 );
+	CompactWriter w( out );
+	w.byte( COMPACT_POSE_VERSION );
+	w.byte( flags );
+	w.byte( 0 );
+	w.byte( 0 );
+	w.uint32( stored.size() );
+	w.uint32( payload.size() );
+	out.append( stored );
+}
+
+std::string
+compact_pose( core::pose::Pose const & pose, bool compress )
+{
+	std::string out;
+	write_compact_pose( pose, out, compress );
+	return out;
+}
+
+core::Size
+read_compact_pose( char const * data, core::Size size, core::pose::Pose & pose )
+{
+	if ( !is_compact_pose( data, size ) || size < COMPACT_POSE_HEADER_SIZE ) {
+		throw utility::excn::EXCN_BadInput( "compact pose: not a compact pose record" );
+	}
+	CompactReader header( data + 4, data + COMPACT_POSE_HEADER_SIZE );
+	unsigned char const version( header.byte() );
+	unsigned char const flags( header.byte() );
+	header.byte();
+	header.byte();
+	core::Size const stored_size( header.uint32() );
+	core::Size const raw_size( header.uint32() );
+	if ( version != COMPACT_POSE_VERSION ) {
+		std::ostringstream msg;
+		msg << "compact pose: unsupported version " << int( version );
+		throw utility::excn::EXCN_BadInput( msg.str() );
+	}
+	if ( size - COMPACT_POSE_HEADER_SIZE < stored_size ) {
+		throw utility::excn::EXCN_BadInput( "compact pose: record is truncated" );
+	}
+
+	char const * payload( data + COMPACT_POSE_HEADER_SIZE );
+	std::string uncompressed;
+	if ( flags & FLAG_ZLIB ) {
+		uncompressed.resize( raw_size );
+		uLongf uncompressed_size( raw_size );
+		int const status( uncompress( (Bytef *) &uncompressed[ 0 ], &uncompressed_size, (Bytef const *) payload, stored_size ) );
+		if ( status != Z_OK || uncompressed_size != raw_size ) {
+			throw utility::excn::EXCN_BadInput( "compact pose: corrupt compressed payload" );
+		}
+		read_payload( uncompressed.data(), uncompressed.data() + raw_size, flags & FLAG_PDB_INFO, pose );
+	} else {
+		read_payload( payload, payload + stored_size, flags & FLAG_PDB_INFO, pose );
+	}
+	return COMPACT_POSE_HEADER_SIZE + stored_size;
+}
+
+void
+read_compact_pose( std::string const & data, core::pose::Pose & pose )
+{
+	core::Size const used( read_compact_pose( data.data(), data.size(), pose ) );
+	if ( used != data.size() ) {
+		throw utility::excn::EXCN_BadInput( "compact pose: trailing data after record" );
+	}
+}
+
+bool
+is_compact_pose( char const * data, core::Size size )
+{
+	return size >= 4 && std::memcmp( data, COMPACT_POSE_MAGIC, 4 ) == 0;
+}
+
+bool
+is_compact_pose( std::string const & data )
+{
+	return is_compact_pose( data.data(), data.size() );
+}
+
+} // serialization
+} // io
+} // core
@@ -0,0 +1,64 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/io/serialization/compact_pose.hh
+/// @brief  Compact binary wire format of a Pose for checkpoints and for sending poses between processes.
+/// @details A record is a 16 byte header (magic "CPOS", version, flags, stored and raw payload sizes)
+/// followed by the payload, optionally zlib-compressed at the fastest level.  The payload holds the
+/// table of residue types used by the pose (each type set and type name once), then per residue an
+/// index into that table, its polymer bond to the previous residue and its secondary structure, the
+/// chain endings, the non-polymer chemical bonds, the atom coordinates as floats, the fold tree and,
+/// if present, the PDBInfo residue numbering.  Jumps are not stored: they are rederived from the
+/// coordinates when the fold tree is set on the rebuilt pose.  All numbers are little endian.
+/// Symmetric poses, energies, constraints and data cache entries are not part of the format.
+
+#ifndef INCLUDED_core_io_serialization_compact_pose_hh
+#define INCLUDED_core_io_serialization_compact_pose_hh
+
+#include <core/pose/Pose.fwd.hh>
+#include <core/types.hh>
+
+#include <string>
+
+namespace core {
+namespace io {
+namespace serialization {
+
+/// @brief Append the compact record of pose to out.  With compress the payload is zlib-compressed,
+/// which roughly halves the size of a full atom pose at some cost in speed.  Throws
+/// EXCN_Msg_Exception if a residue type of pose does not belong to a residue type set.
+void
+write_compact_pose( core::pose::Pose const & pose, std::string & out, bool compress = false );
+
+/// @brief The compact record of pose.
+std::string
+compact_pose( core::pose::Pose const & pose, bool compress = false );
+
+/// @brief Replace pose by the pose of the compact record at the start of data; returns the number
+/// of bytes of the record so that several concatenated records can be read one after the other.
+/// Throws utility::excn::EXCN_BadInput if the data is not a complete record.
+core::Size
+read_compact_pose( char const * data, core::Size size, core::pose::Pose & pose );
+
+/// @brief Replace pose by the pose of the compact record data.
+void
+read_compact_pose( std::string const & data, core::pose::Pose & pose );
+
+/// @brief Does data start with the magic of a compact pose record?
+bool
+is_compact_pose( char const * data, core::Size size );
+
+bool
+is_compact_pose( std::string const & data );
+
+} // serialization
+} // io
+} // core
+
+#endif // INCLUDED_core_io_serialization_compact_pose_hh
@@ -19,15 +19,19 @@
 #include <core/pack/annealer/FixbbCoupledRotamerSimAnnealer.hh>
 #include <core/pack/annealer/FixbbLinkingRotamerSimAnnealer.hh>
 #include <core/pack/annealer/MultiCoolAnnealer.hh>
+#include <core/pack/annealer/TreeDecompositionAnnealer.hh>
 
 #include <core/pack/rotamer_set/RotamerCouplings.hh>
 #include <core/pack/rotamer_set/RotamerLinks.hh>
 #include <core/pack/rotamer_set/FixbbRotamerSets.hh>
 #include <core/pack/interaction_graph/AnnealableGraphBase.hh>
+#include <core/pack/interaction_graph/PrecomputedPairEnergiesInteractionGraph.hh>
 
 #include <core/pack/task/PackerTask.hh>
 
 #include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/packing.OptionKeys.gen.hh>
 
 #include <utility/vector0.hh>
 #include <utility/vector1.hh>
@@ -65,7 +69,28 @@ AnnealerFactory::create_annealer(
 			rot_to_pack, bestrotamer_at_seqpos, bestenergy, start_with_current, ig,
 			rotamer_sets, current_rot_index, calc_rot_freq, rot_freq,
 			task->rotamer_links() ) );
-	} else if ( task->multi_cool_annealer() ) {
+	}
+
+	if ( basic::options::option[ basic::options::OptionKeys::packing::tree_decomposition ]() ) {
+		interaction_graph::PrecomputedPairEnergiesInteractionGraphOP pig(
+			utility::pointer::dynamic_pointer_cast< interaction_graph::PrecomputedPairEnergiesInteractionGraph >( ig ) );
+		if ( pig ) {
+			Size const budget( static_cast< Size >( basic::options::option[ basic::options::OptionKeys::packing::tree_decomposition_mb ]() * 1024 * 1024 ) );
+			TreeDecompositionAnnealerOP annealer( new TreeDecompositionAnnealer(
+				rot_to_pack, bestrotamer_at_seqpos, bestenergy, start_with_current, pig,
+				rotamer_sets, current_rot_index, calc_rot_freq, rot_freq, budget ) );
+			if ( annealer->fits_budget() ) {
+				TR.Debug << "Creating TreeDecompositionAnnealer" << std::endl;
+				return annealer;
+			}
+			TR << "Tree decomposition of treewidth " << annealer->treewidth() << " needs "
+				<< annealer->table_bytes() / ( 1024 * 1024 ) << " MB of tables, over the budget; annealing instead" << std::endl;
+		} else {
+			TR << "The tree decomposition packer needs an interaction graph with precomputed pair energies; annealing instead" << std::endl;
+		}
+	}
+
+	if ( task->multi_cool_annealer() ) {
 		TR.Debug << "Creating MultiCoolAnnealer" << std::endl;
 		return SimAnnealerBaseOP( new MultiCoolAnnealer(
 			task, rot_to_pack, bestrotamer_at_seqpos, bestenergy, start_with_current, ig,
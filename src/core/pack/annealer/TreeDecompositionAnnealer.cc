@@ -0,0 +1,346 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/pack/annealer/TreeDecompositionAnnealer.cc
+/// @brief  exact packer: dynamic programming over a tree decomposition of the interaction graph
+
+// Unit Headers
+#include <core/pack/annealer/TreeDecompositionAnnealer.hh>
+
+// Package Headers
+#include <core/pack/interaction_graph/PrecomputedPairEnergiesInteractionGraph.hh>
+#include <core/pack/rotamer_set/FixbbRotamerSets.hh>
+
+#include <basic/Tracer.hh>
+
+#include <utility/exit.hh>
+
+// C++ headers
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <set>
+
+using namespace ObjexxFCL;
+
+namespace core {
+namespace pack {
+namespace annealer {
+
+static THREAD_LOCAL basic::Tracer TR( "core.pack.annealer.TreeDecompositionAnnealer" );
+
+namespace {
+
+/// @brief a table over the states of the residues in its scope; the state of scope[ k ] moves
+/// the index by stride[ k ]
+template < class T >
+struct Table {
+	utility::vector1< int > scope;
+	utility::vector1< Size > stride;
+	utility::vector1< T > values;
+
+	void
+	set_scope( std::set< int > const & nodes, utility::vector1< utility::vector1< int > > const & states_for_node )
+	{
+		scope.assign( nodes.begin(), nodes.end() );
+		stride.resize( scope.size() );
+		Size size( 1 );
+		for ( Size kk = 1; kk <= scope.size(); ++kk ) {
+			stride[ kk ] = size;
+			size *= states_for_node[ scope[ kk ] ].size();
+		}
+		values.resize( size );
+	}
+
+	/// @brief the index for the states in local (1-based positions in the node's state list)
+	Size
+	index( utility::vector1< int > const & local ) const
+	{
+		Size index( 1 );
+		for ( Size kk = 1; kk <= scope.size(); ++kk ) {
+			index += ( local[ scope[ kk ] ] - 1 ) * stride[ kk ];
+		}
+		return index;
+	}
+
+	Size
+	stride_for( int node ) const
+	{
+		for ( Size kk = 1; kk <= scope.size(); ++kk ) {
+			if ( scope[ kk ] == node ) return stride[ kk ];
+		}
+		return 0;
+	}
+};
+
+typedef Table< core::PackerEnergy > EnergyTable;
+typedef Table< int > ChoiceTable;
+
+}
+
+TreeDecompositionAnnealer::TreeDecompositionAnnealer(
+	utility::vector0< int > & rot_to_pack,
+	FArray1D_int & bestrotamer_at_seqpos,
+	core::PackerEnergy & bestenergy,
+	bool start_with_current,
+	interaction_graph::PrecomputedPairEnergiesInteractionGraphOP ig,
+	FixbbRotamerSetsCOP rotamer_sets,
+	FArray1_int & current_rot_index,
+	bool calc_rot_freq,
+	FArray1D< core::PackerEnergy > & rot_freq,
+	core::Size memory_budget
+) :
+	parent(
+	rot_to_pack,
+	(int) rot_to_pack.size(),
+	bestrotamer_at_seqpos,
+	bestenergy,
+	start_with_current,
+	rotamer_sets,
+	current_rot_index,
+	calc_rot_freq,
+	rot_freq
+	),
+	ig_( ig ),
+	memory_budget_( memory_budget ),
+	num_nodes_( ig->get_num_nodes() ),
+	treewidth_( 0 ),
+	table_bytes_( 0 )
+{
+	gather_states_and_edges();
+	decompose();
+}
+
+TreeDecompositionAnnealer::~TreeDecompositionAnnealer() {}
+
+bool
+TreeDecompositionAnnealer::fits_budget() const
+{
+	return table_bytes_ <= memory_budget_;
+}
+
+core::Size
+TreeDecompositionAnnealer::treewidth() const
+{
+	return treewidth_;
+}
+
+core::Real
+TreeDecompositionAnnealer::table_bytes() const
+{
+	return table_bytes_;
+}
+
+/// @details The graph is not prepared for annealing until run(), since the factory anneals instead
+/// if the tables do not fit; edges without energies between the states to pack, which
+/// prepare_for_simulated_annealing() would drop, are left out here instead.
+void
+TreeDecompositionAnnealer::gather_states_and_edges()
+{
+	states_for_node_.resize( num_nodes_ );
+	for ( Size ii = 0; ii < rot_to_pack().size(); ++ii ) {
+		int const rot( rot_to_pack()[ ii ] );
+		states_for_node_[ rotamer_sets()->moltenres_for_rotamer( rot ) ].push_back( rotamer_sets()->rotid_on_moltenresidue( rot ) );
+	}
+
+	for ( int ii = 1; ii <= num_nodes_; ++ii ) {
+		for ( ig_->reset_edge_list_iterator_for_node( ii ); !ig_->edge_list_iterator_at_end(); ig_->increment_edge_list_iterator() ) {
+			int const jj( ig_->get_edge().get_other_ind( ii ) );
+			if ( ii < jj ) edges_.push_back( std::make_pair( ii, jj ) );
+		}
+	}
+
+	utility::vector1< std::pair< int, int > > edges_with_energies;
+	for ( Size ee = 1; ee <= edges_.size(); ++ee ) {
+		int const ii( edges_[ ee ].first ), jj( edges_[ ee ].second );
+		bool has_energy( false );
+		for ( Size rr = 1; rr <= states_for_node_[ ii ].size() && !has_energy; ++rr ) {
+			for ( Size tt = 1; tt <= states_for_node_[ jj ].size() && !has_energy; ++tt ) {
+				has_energy = ig_->get_two_body_energy_for_edge( ii, jj, states_for_node_[ ii ][ rr ], states_for_node_[ jj ][ tt ] ) != 0;
+			}
+		}
+		if ( has_energy ) edges_with_energies.push_back( edges_[ ee ] );
+	}
+	edges_.swap( edges_with_energies );
+}
+
+/// @details Greedy elimination order: each step eliminates the residue whose separator table is
+/// smallest, then connects its remaining neighbors to each other.
+void
+TreeDecompositionAnnealer::decompose()
+{
+	utility::vector1< std::set< int > > neighbors( num_nodes_ );
+	for ( Size ee = 1; ee <= edges_.size(); ++ee ) {
+		neighbors[ edges_[ ee ].first ].insert( edges_[ ee ].second );
+		neighbors[ edges_[ ee ].second ].insert( edges_[ ee ].first );
+	}
+
+	utility::vector1< bool > eliminated( num_nodes_, false );
+	for ( int step = 1; step <= num_nodes_; ++step ) {
+		int best_node( 0 );
+		core::Real best_size( 0 );
+		for ( int ii = 1; ii <= num_nodes_; ++ii ) {
+			if ( eliminated[ ii ] ) continue;
+			core::Real size( 1 );
+			for ( std::set< int >::const_iterator nb = neighbors[ ii ].begin(); nb != neighbors[ ii ].end(); ++nb ) {
+				size *= states_for_node_[ *nb ].size();
+			}
+			if ( best_node == 0 || size < best_size ) {
+				best_node = ii;
+				best_size = size;
+			}
+		}
+
+		std::set< int > const & separator( neighbors[ best_node ] );
+		for ( std::set< int >::const_iterator nb = separator.begin(); nb != separator.end(); ++nb ) {
+			neighbors[ *nb ].erase( best_node );
+			neighbors[ *nb ].insert( separator.begin(), separator.end() );
+			neighbors[ *nb ].erase( *nb );
+		}
+		elimination_order_.push_back( best_node );
+		eliminated[ best_node ] = true;
+		treewidth_ = std::max( treewidth_, separator.size() );
+		table_bytes_ += best_size * ( sizeof( core::PackerEnergy ) + sizeof( int ) );
+		neighbors[ best_node ].clear();
+	}
+
+	TR.Debug << "tree decomposition of " << num_nodes_ << " residues and " << edges_.size() << " edges: treewidth "
+		<< treewidth_ << ", " << table_bytes_ / ( 1024 * 1024 ) << " MB of tables" << std::endl;
+}
+
+void
+TreeDecompositionAnnealer::run()
+{
+	if ( !fits_budget() ) {
+		utility_exit_with_message( "TreeDecompositionAnnealer: the dynamic programming tables exceed the memory budget" );
+	}
+	ig_->prepare_for_simulated_annealing();
+
+	// the energy terms: one table per residue and per edge
+	std::list< EnergyTable > live;
+	for ( int ii = 1; ii <= num_nodes_; ++ii ) {
+		std::set< int > scope;
+		scope.insert( ii );
+		live.push_back( EnergyTable() );
+		live.back().set_scope( scope, states_for_node_ );
+		for ( Size ss = 1; ss <= states_for_node_[ ii ].size(); ++ss ) {
+			live.back().values[ ss ] = ig_->get_one_body_energy_for_node_state( ii, states_for_node_[ ii ][ ss ] );
+		}
+	}
+	for ( Size ee = 1; ee <= edges_.size(); ++ee ) {
+		int const ii( edges_[ ee ].first ), jj( edges_[ ee ].second );
+		interaction_graph::PrecomputedPairEnergiesEdge const * edge(
+			static_cast< interaction_graph::PrecomputedPairEnergiesEdge const * >( ig_->find_edge( ii, jj ) ) );
+		std::set< int > scope;
+		scope.insert( ii );
+		scope.insert( jj );
+		live.push_back( EnergyTable() );
+		EnergyTable & table( live.back() );
+		table.set_scope( scope, states_for_node_ );
+		Size index( 1 );
+		for ( Size tt = 1; tt <= states_for_node_[ jj ].size(); ++tt ) {
+			for ( Size rr = 1; rr <= states_for_node_[ ii ].size(); ++rr ) {
+				table.values[ index++ ] = edge->get_two_body_energy( states_for_node_[ ii ][ rr ], states_for_node_[ jj ][ tt ] );
+			}
+		}
+	}
+
+	// eliminate the residues; local holds the position of each residue's state in its state list
+	utility::vector1< int > local( num_nodes_, 1 );
+	utility::vector1< ChoiceTable > choices( num_nodes_ );
+	for ( Size step = 1; step <= elimination_order_.size(); ++step ) {
+		int const node( elimination_order_[ step ] );
+		Size const nstates( states_for_node_[ node ].size() );
+
+		std::list< EnergyTable > bucket;
+		std::set< int > separator;
+		for ( std::list< EnergyTable >::iterator it = live.begin(); it != live.end(); ) {
+			std::list< EnergyTable >::iterator next( it );
+			++next;
+			if ( std::find( it->scope.begin(), it->scope.end(), node ) != it->scope.end() ) {
+				separator.insert( it->scope.begin(), it->scope.end() );
+				bucket.splice( bucket.end(), live, it );
+			}
+			it = next;
+		}
+		separator.erase( node );
+
+		live.push_back( EnergyTable() );
+		EnergyTable & message( live.back() );
+		message.set_scope( separator, states_for_node_ );
+		ChoiceTable & choice( choices[ node ] );
+		choice.set_scope( separator, states_for_node_ );
+
+		utility::vector1< EnergyTable const * > terms;
+		utility::vector1< Size > node_strides;
+		for ( std::list< EnergyTable >::const_iterator it = bucket.begin(); it != bucket.end(); ++it ) {
+			terms.push_back( &*it );
+			node_strides.push_back( it->stride_for( node ) );
+		}
+		utility::vector1< Size > bases( terms.size() );
+
+		for ( Size kk = 1; kk <= message.scope.size(); ++kk ) local[ message.scope[ kk ] ] = 1;
+		local[ node ] = 1;
+		for ( Size index = 1; index <= message.values.size(); ++index ) {
+			for ( Size tt = 1; tt <= terms.size(); ++tt ) bases[ tt ] = terms[ tt ]->index( local );
+
+			core::PackerEnergy best( std::numeric_limits< core::PackerEnergy >::max() );
+			int best_state( 1 );
+			for ( Size ss = 1; ss <= nstates; ++ss ) {
+				core::PackerEnergy sum( 0 );
+				for ( Size tt = 1; tt <= terms.size(); ++tt ) {
+					sum += terms[ tt ]->values[ bases[ tt ] + ( ss - 1 ) * node_strides[ tt ] ];
+				}
+				if ( sum < best ) {
+					best = sum;
+					best_state = ss;
+				}
+			}
+			message.values[ index ] = best;
+			choice.values[ index ] = best_state;
+
+			// next assignment of the separator, first residue fastest
+			for ( Size kk = 1; kk <= message.scope.size(); ++kk ) {
+				int const nb( message.scope[ kk ] );
+				if ( ++local[ nb ] <= (int) states_for_node_[ nb ].size() ) break;
+				local[ nb ] = 1;
+			}
+		}
+	}
+
+	// only constants are left
+	core::PackerEnergy optimum( 0 );
+	for ( std::list< EnergyTable >::const_iterator it = live.begin(); it != live.end(); ++it ) {
+		optimum += it->values[ 1 ];
+	}
+
+	// read the choices back; the separator of a residue is eliminated after it
+	for ( Size step = elimination_order_.size(); step >= 1; --step ) {
+		int const node( elimination_order_[ step ] );
+		local[ node ] = choices[ node ].values[ choices[ node ].index( local ) ];
+	}
+
+	FArray1D_int best_state_on_node( num_nodes_, 0 );
+	for ( int ii = 1; ii <= num_nodes_; ++ii ) {
+		best_state_on_node( ii ) = states_for_node_[ ii ][ local[ ii ] ];
+	}
+	ig_->blanket_assign_state_0();
+	bestenergy() = ig_->set_network_state( best_state_on_node );
+
+	TR << "treewidth " << treewidth_ << ", best_energy: " << bestenergy() << " (dynamic programming: " << optimum << ")" << std::endl;
+
+	for ( int ii = 1; ii <= num_nodes_; ++ii ) {
+		int const iiresid = rotamer_sets()->moltenres_2_resid( ii );
+		bestrotamer_at_seqpos()( iiresid ) = rotamer_sets()->moltenres_rotid_2_rotid( ii, best_state_on_node( ii ) );
+	}
+}
+
+}
+}
+}
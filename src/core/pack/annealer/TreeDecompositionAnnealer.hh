@@ -0,0 +1,101 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/pack/annealer/TreeDecompositionAnnealer.hh
+/// @brief  exact packer: dynamic programming over a tree decomposition of the interaction graph
+/// @details The residues are eliminated one at a time in a greedy order that keeps the tables small.
+/// Eliminating a residue replaces the energy terms that involve it by one table over its remaining
+/// neighbors (its separator), holding the lowest energy over its rotamers for each assignment of the
+/// separator, and remembers which rotamer gave it.  The residue and its separator form a bag of the
+/// tree decomposition; the largest separator is the treewidth.  Once every residue is eliminated the
+/// remembered rotamers are read back in the reverse order, which gives the lowest energy assignment.
+/// The decomposition is computed when the annealer is constructed; if the tables would not fit the
+/// memory budget, fits_budget() is false and the caller should anneal instead.
+
+#ifndef INCLUDED_core_pack_annealer_TreeDecompositionAnnealer_hh
+#define INCLUDED_core_pack_annealer_TreeDecompositionAnnealer_hh
+
+// Unit headers
+#include <core/pack/annealer/TreeDecompositionAnnealer.fwd.hh>
+
+// Package headers
+#include <core/types.hh>
+#include <core/pack/annealer/RotamerAssigningAnnealer.hh>
+#include <core/pack/interaction_graph/PrecomputedPairEnergiesInteractionGraph.fwd.hh>
+#include <core/pack/rotamer_set/FixbbRotamerSets.fwd.hh>
+
+// Utility headers
+#include <utility/vector0.hh>
+#include <utility/vector1.hh>
+
+// Objexx Headers
+#include <ObjexxFCL/FArray1D.hh>
+
+namespace core {
+namespace pack {
+namespace annealer {
+
+class TreeDecompositionAnnealer : public RotamerAssigningAnnealer
+{
+public:
+	typedef RotamerAssigningAnnealer parent;
+
+public:
+	/// @brief Computes the decomposition; memory_budget bounds the bytes of the dynamic programming tables.
+	TreeDecompositionAnnealer(
+		utility::vector0< int > & rot_to_pack,
+		ObjexxFCL::FArray1D_int & bestrotamer_at_seqpos,
+		core::PackerEnergy & bestenergy,
+		bool start_with_current, // ignored: the result does not depend on a starting assignment
+		interaction_graph::PrecomputedPairEnergiesInteractionGraphOP ig,
+		FixbbRotamerSetsCOP rotamer_sets,
+		ObjexxFCL::FArray1_int & current_rot_index,
+		bool calc_rot_freq, // ignored: no rotamer frequencies are sampled
+		ObjexxFCL::FArray1D< core::PackerEnergy > & rot_freq,
+		core::Size memory_budget
+	);
+
+	virtual ~TreeDecompositionAnnealer();
+
+	/// @brief Do the tables of the decomposition fit the memory budget?  run() exits if they do not.
+	bool fits_budget() const;
+
+	/// @brief the largest number of residues in a separator
+	core::Size treewidth() const;
+
+	/// @brief the bytes of tables the dynamic programming needs
+	core::Real table_bytes() const;
+
+	void run();
+
+private:
+	void gather_states_and_edges();
+	void decompose();
+
+private:
+	interaction_graph::PrecomputedPairEnergiesInteractionGraphOP ig_;
+	core::Size memory_budget_;
+
+	int num_nodes_;
+	/// @brief per residue, the states the annealer may assign it
+	utility::vector1< utility::vector1< int > > states_for_node_;
+	/// @brief edges that hold energies, as (lower, higher) residue pairs
+	utility::vector1< std::pair< int, int > > edges_;
+
+	/// @brief residues in the order they are eliminated
+	utility::vector1< int > elimination_order_;
+	core::Size treewidth_;
+	core::Real table_bytes_;
+};
+
+}
+}
+}
+
+#endif
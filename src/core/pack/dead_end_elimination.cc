@@ -0,0 +1,413 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/pack/dead_end_elimination.cc
+/// @brief  dead-end elimination of rotamers before annealing
+
+// Unit Headers
+#include <core/pack/dead_end_elimination.hh>
+
+// Package Headers
+#include <core/pack/interaction_graph/DensePDInteractionGraph.hh>
+#include <core/pack/interaction_graph/DoubleDensePDInteractionGraph.hh>
+#include <core/pack/interaction_graph/PDInteractionGraph.hh>
+#include <core/pack/interaction_graph/PrecomputedPairEnergiesInteractionGraph.hh>
+#include <core/pack/rotamer_set/FixbbRotamerSets.hh>
+#include <core/pack/task/PackerTask.hh>
+
+// Basic Headers
+#include <basic/Tracer.hh>
+
+// Utility Headers
+#include <utility/thread/parallel_for.hh>
+#include <utility/vector1.hh>
+
+// C++ Headers
+#include <limits>
+#include <typeinfo>
+
+namespace core {
+namespace pack {
+
+static THREAD_LOCAL basic::Tracer TR( "core.pack.dead_end_elimination" );
+
+using namespace interaction_graph;
+
+namespace {
+
+/// @brief pairs are only tested on edges with at most this many pairs of remaining rotamers;
+/// the test of an edge costs this many times the rotamers at the neighbors of its residues
+core::Size const max_pairs_per_edge = 1024;
+
+core::PackerEnergy const no_bound = std::numeric_limits< core::PackerEnergy >::max();
+
+/// @brief an edge as seen from one of its nodes
+struct DEENeighbor {
+	int node;
+	PrecomputedPairEnergiesEdge const * edge;
+	/// @brief is the viewing node the edge's first (lower indexed) node?
+	bool first;
+
+	core::PackerEnergy
+	energy( int own_state, int other_state ) const
+	{
+		return first ? edge->get_two_body_energy( own_state, other_state ) : edge->get_two_body_energy( other_state, own_state );
+	}
+};
+
+typedef utility::vector1< int > States;
+
+/// @brief the energies the eliminations read, gathered once from the interaction graph
+struct DEEProblem {
+	int nnodes;
+	utility::vector1< utility::vector1< core::PackerEnergy > > one_body;
+	utility::vector1< utility::vector1< DEENeighbor > > neighbors;
+	/// @brief edges as seen from their first node
+	utility::vector1< DEENeighbor > edges;
+};
+
+/// @brief states of node ii that are still alive
+States
+alive_states( utility::vector1< char > const & alive )
+{
+	States states;
+	for ( Size ss = 1; ss <= alive.size(); ++ss ) {
+		if ( alive[ ss ] ) states.push_back( ss );
+	}
+	return states;
+}
+
+/// @brief edges both of whose nodes are down to one state
+Size
+count_fixed_edges( DEEProblem const & problem, utility::vector1< States > const & alive )
+{
+	Size n_fixed( 0 );
+	for ( Size ee = 1; ee <= problem.edges.size(); ++ee ) {
+		PrecomputedPairEnergiesEdge const & edge( *problem.edges[ ee ].edge );
+		if ( alive[ edge.get_first_node_ind() ].size() == 1 && alive[ edge.get_second_node_ind() ].size() == 1 ) ++n_fixed;
+	}
+	return n_fixed;
+}
+
+/// @brief Goldstein singles at one node.  Competitors are taken from the node's own, shrinking,
+/// state list; the states of the neighbors are those alive at the start of the pass.
+struct SinglesPass {
+	DEEProblem const & problem;
+	utility::vector1< States > const & alive;
+	utility::vector1< utility::vector1< char > > & next_alive;
+
+	SinglesPass(
+		DEEProblem const & problem_in,
+		utility::vector1< States > const & alive_in,
+		utility::vector1< utility::vector1< char > > & next_alive_in
+	) :
+		problem( problem_in ),
+		alive( alive_in ),
+		next_alive( next_alive_in )
+	{}
+
+	/// @brief for utility::thread::parallel_for()
+	void
+	operator() ( Size ii, Size ) const
+	{
+		utility::vector1< char > & own( next_alive[ ii ] );
+		utility::vector1< core::PackerEnergy > const & one_body( problem.one_body[ ii ] );
+		utility::vector1< DEENeighbor > const & neighbors( problem.neighbors[ ii ] );
+		States const & states( alive[ ii ] );
+		Size n_alive( states.size() );
+
+		for ( Size rr = 1; rr <= states.size() && n_alive > 1; ++rr ) {
+			int const r( states[ rr ] );
+			for ( Size pp = 1; pp <= states.size(); ++pp ) {
+				int const p( states[ pp ] );
+				if ( p == r || !own[ p ] ) continue;
+				core::PackerEnergy bound( one_body[ r ] - one_body[ p ] );
+				for ( Size jj = 1; jj <= neighbors.size(); ++jj ) {
+					DEENeighbor const & nb( neighbors[ jj ] );
+					States const & other( alive[ nb.node ] );
+					core::PackerEnergy min_diff( no_bound );
+					for ( Size ss = 1; ss <= other.size(); ++ss ) {
+						core::PackerEnergy const diff( nb.energy( r, other[ ss ] ) - nb.energy( p, other[ ss ] ) );
+						if ( diff < min_diff ) min_diff = diff;
+					}
+					bound += min_diff;
+				}
+				if ( bound > 0 ) {
+					own[ r ] = 0;
+					--n_alive;
+					break;
+				}
+			}
+		}
+	}
+};
+
+/// @brief Pairs at one edge, against the pair with the lowest energy bound.  Records the states
+/// all of whose pairs with the other node were eliminated.
+struct PairsPass {
+	typedef utility::vector1< std::pair< int, int > > Eliminated;
+
+	DEEProblem const & problem;
+	utility::vector1< States > const & alive;
+	utility::vector1< Eliminated > & eliminated;
+
+	PairsPass(
+		DEEProblem const & problem_in,
+		utility::vector1< States > const & alive_in,
+		utility::vector1< Eliminated > & eliminated_in
+	) :
+		problem( problem_in ),
+		alive( alive_in ),
+		eliminated( eliminated_in )
+	{}
+
+	/// @brief the terms the third nodes contribute to the pair (r,t): per third node and its state
+	/// u, E(r,u) + E(t,u)
+	void
+	third_node_terms(
+		utility::vector1< std::pair< DEENeighbor const *, DEENeighbor const * > > const & thirds,
+		int r,
+		int t,
+		utility::vector1< utility::vector1< core::PackerEnergy > > & terms
+	) const
+	{
+		for ( Size kk = 1; kk <= thirds.size(); ++kk ) {
+			DEENeighbor const * ik( thirds[ kk ].first );
+			DEENeighbor const * jk( thirds[ kk ].second );
+			States const & other( alive[ ik ? ik->node : jk->node ] );
+			terms[ kk ].resize( other.size() );
+			for ( Size uu = 1; uu <= other.size(); ++uu ) {
+				terms[ kk ][ uu ] = ( ik ? ik->energy( r, other[ uu ] ) : 0 ) + ( jk ? jk->energy( t, other[ uu ] ) : 0 );
+			}
+		}
+	}
+
+	/// @brief for utility::thread::parallel_for()
+	void
+	operator() ( Size ee, Size ) const
+	{
+		DEENeighbor const & edge( problem.edges[ ee ] );
+		int const ii( edge.edge->get_first_node_ind() );
+		int const jj( edge.edge->get_second_node_ind() );
+		States const & states_i( alive[ ii ] );
+		States const & states_j( alive[ jj ] );
+		if ( states_i.size() < 2 && states_j.size() < 2 ) return;
+		if ( states_i.size() * states_j.size() > max_pairs_per_edge ) return;
+
+		// the third nodes: neighbors of either end, with their edges to each end (or null)
+		utility::vector1< std::pair< DEENeighbor const *, DEENeighbor const * > > thirds;
+		utility::vector1< DEENeighbor > const & neighbors_i( problem.neighbors[ ii ] );
+		utility::vector1< DEENeighbor > const & neighbors_j( problem.neighbors[ jj ] );
+		for ( Size kk = 1; kk <= neighbors_i.size(); ++kk ) {
+			if ( neighbors_i[ kk ].node == jj ) continue;
+			DEENeighbor const * jk( 0 );
+			for ( Size ll = 1; ll <= neighbors_j.size(); ++ll ) {
+				if ( neighbors_j[ ll ].node == neighbors_i[ kk ].node ) jk = &neighbors_j[ ll ];
+			}
+			thirds.push_back( std::make_pair( &neighbors_i[ kk ], jk ) );
+		}
+		for ( Size ll = 1; ll <= neighbors_j.size(); ++ll ) {
+			if ( neighbors_j[ ll ].node == ii ) continue;
+			bool shared( false );
+			for ( Size kk = 1; kk <= neighbors_i.size(); ++kk ) {
+				if ( neighbors_i[ kk ].node == neighbors_j[ ll ].node ) shared = true;
+			}
+			if ( !shared ) thirds.push_back( std::make_pair( static_cast< DEENeighbor const * >( 0 ), &neighbors_j[ ll ] ) );
+		}
+
+		utility::vector1< core::PackerEnergy > const & one_body_i( problem.one_body[ ii ] );
+		utility::vector1< core::PackerEnergy > const & one_body_j( problem.one_body[ jj ] );
+		utility::vector1< utility::vector1< core::PackerEnergy > > terms( thirds.size() );
+
+		// the magic bullet: the pair with the lowest lower bound on the energy of its assignments
+		Size bullet_r( 1 ), bullet_t( 1 );
+		core::PackerEnergy best_bound( no_bound );
+		for ( Size rr = 1; rr <= states_i.size(); ++rr ) {
+			for ( Size tt = 1; tt <= states_j.size(); ++tt ) {
+				int const r( states_i[ rr ] ), t( states_j[ tt ] );
+				core::PackerEnergy bound( one_body_i[ r ] + one_body_j[ t ] + edge.energy( r, t ) );
+				third_node_terms( thirds, r, t, terms );
+				for ( Size kk = 1; kk <= terms.size(); ++kk ) {
+					core::PackerEnergy min_term( no_bound );
+					for ( Size uu = 1; uu <= terms[ kk ].size(); ++uu ) {
+						if ( terms[ kk ][ uu ] < min_term ) min_term = terms[ kk ][ uu ];
+					}
+					bound += min_term;
+				}
+				if ( bound < best_bound ) {
+					best_bound = bound;
+					bullet_r = rr;
+					bullet_t = tt;
+				}
+			}
+		}
+
+		int const br( states_i[ bullet_r ] ), bt( states_j[ bullet_t ] );
+		core::PackerEnergy const bullet_pair( one_body_i[ br ] + one_body_j[ bt ] + edge.energy( br, bt ) );
+		utility::vector1< utility::vector1< core::PackerEnergy > > bullet_terms( thirds.size() );
+		third_node_terms( thirds, br, bt, bullet_terms );
+
+		utility::vector1< Size > dead_with_i( states_i.size(), 0 ), dead_with_j( states_j.size(), 0 );
+		for ( Size rr = 1; rr <= states_i.size(); ++rr ) {
+			for ( Size tt = 1; tt <= states_j.size(); ++tt ) {
+				if ( rr == bullet_r && tt == bullet_t ) continue;
+				int const r( states_i[ rr ] ), t( states_j[ tt ] );
+				core::PackerEnergy bound( one_body_i[ r ] + one_body_j[ t ] + edge.energy( r, t ) - bullet_pair );
+				third_node_terms( thirds, r, t, terms );
+				for ( Size kk = 1; kk <= terms.size(); ++kk ) {
+					core::PackerEnergy min_diff( no_bound );
+					for ( Size uu = 1; uu <= terms[ kk ].size(); ++uu ) {
+						core::PackerEnergy const diff( terms[ kk ][ uu ] - bullet_terms[ kk ][ uu ] );
+						if ( diff < min_diff ) min_diff = diff;
+					}
+					bound += min_diff;
+				}
+				if ( bound > 0 ) {
+					++dead_with_i[ rr ];
+					++dead_with_j[ tt ];
+				}
+			}
+		}
+
+		for ( Size rr = 1; rr <= states_i.size(); ++rr ) {
+			if ( dead_with_i[ rr ] == states_j.size() ) eliminated[ ee ].push_back( std::make_pair( ii, states_i[ rr ] ) );
+		}
+		for ( Size tt = 1; tt <= states_j.size(); ++tt ) {
+			if ( dead_with_j[ tt ] == states_i.size() ) eliminated[ ee ].push_back( std::make_pair( jj, states_j[ tt ] ) );
+		}
+	}
+};
+
+} // anonymous namespace
+
+bool
+dead_end_elimination_applies(
+	task::PackerTask const & task,
+	AnnealableGraphBase const & ig
+)
+{
+	if ( task.rotamer_links_exist() || task.rotamer_couplings_exist() ) return false;
+	return typeid( ig ) == typeid( PDInteractionGraph ) ||
+		typeid( ig ) == typeid( DensePDInteractionGraph ) ||
+		typeid( ig ) == typeid( DoubleDensePDInteractionGraph );
+}
+
+/// @details The eliminations of a pass only read the states alive at its start, so the residues
+/// (and, for pairs, the edges) of a pass are independent of each other.  The interaction graph is
+/// only read: pruned rotamers keep their energies, and the annealer just never visits them, so the
+/// same graph can be pruned and annealed again, as pack_rotamers_loop() does.
+utility::vector0< int >
+prune_rotamers_by_dead_end_elimination(
+	task::PackerTask const & task,
+	rotamer_set::FixbbRotamerSets const & rotsets,
+	AnnealableGraphBase & annealable_ig,
+	utility::vector0< int > const & rot_to_pack,
+	bool pairs,
+	Size n_threads
+)
+{
+	if ( !dead_end_elimination_applies( task, annealable_ig ) ) {
+		TR.Debug << "dead-end elimination skipped: needs a precomputed pair energy interaction graph and no rotamer links or couplings" << std::endl;
+		return rot_to_pack;
+	}
+	PrecomputedPairEnergiesInteractionGraph & ig( static_cast< PrecomputedPairEnergiesInteractionGraph & >( annealable_ig ) );
+
+	DEEProblem problem;
+	problem.nnodes = ig.get_num_nodes();
+
+	utility::vector1< utility::vector1< char > > alive( problem.nnodes );
+	for ( int ii = 1; ii <= problem.nnodes; ++ii ) {
+		alive[ ii ].resize( ig.get_num_states_for_node( ii ), rot_to_pack.empty() ? 1 : 0 );
+	}
+	for ( Size ii = 0; ii < rot_to_pack.size(); ++ii ) {
+		alive[ rotsets.moltenres_for_rotamer( rot_to_pack[ ii ] ) ][ rotsets.rotid_on_moltenresidue( rot_to_pack[ ii ] ) ] = 1;
+	}
+
+	Size n_start( 0 );
+	utility::vector1< States > states( problem.nnodes );
+	for ( int ii = 1; ii <= problem.nnodes; ++ii ) {
+		states[ ii ] = alive_states( alive[ ii ] );
+		if ( states[ ii ].empty() ) {
+			TR.Debug << "dead-end elimination skipped: residue " << rotsets.moltenres_2_resid( ii ) << " has no rotamers to pack" << std::endl;
+			return rot_to_pack;
+		}
+		n_start += states[ ii ].size();
+	}
+
+	// gather the one-body energies and the edges; the edge list iterator is not thread safe
+	problem.one_body.resize( problem.nnodes );
+	problem.neighbors.resize( problem.nnodes );
+	for ( int ii = 1; ii <= problem.nnodes; ++ii ) {
+		problem.one_body[ ii ].resize( alive[ ii ].size() );
+		for ( Size ss = 1; ss <= alive[ ii ].size(); ++ss ) {
+			problem.one_body[ ii ][ ss ] = ig.get_one_body_energy_for_node_state( ii, ss );
+		}
+		for ( ig.reset_edge_list_iterator_for_node( ii ); !ig.edge_list_iterator_at_end(); ig.increment_edge_list_iterator() ) {
+			int const jj( ig.get_edge().get_other_ind( ii ) );
+			DEENeighbor nb;
+			nb.node = jj;
+			nb.edge = static_cast< PrecomputedPairEnergiesEdge const * >( ig.find_edge( ii, jj ) );
+			nb.first = ii < jj;
+			problem.neighbors[ ii ].push_back( nb );
+			if ( nb.first ) problem.edges.push_back( nb );
+		}
+	}
+
+	// an edge is eliminated once both its residues are down to one rotamer: it only adds a constant
+	Size const n_fixed_edges_start( count_fixed_edges( problem, states ) );
+
+	// eliminate until a pass changes nothing
+	Size n_passes( 0 );
+	bool changed( true );
+	while ( changed ) {
+		changed = false;
+		++n_passes;
+
+		utility::vector1< utility::vector1< char > > next_alive( alive );
+		utility::thread::parallel_for( problem.nnodes, n_threads, SinglesPass( problem, states, next_alive ) );
+		for ( int ii = 1; ii <= problem.nnodes; ++ii ) {
+			if ( next_alive[ ii ] != alive[ ii ] ) {
+				changed = true;
+				states[ ii ] = alive_states( next_alive[ ii ] );
+			}
+		}
+		alive.swap( next_alive );
+
+		if ( !pairs ) continue;
+		utility::vector1< PairsPass::Eliminated > eliminated( problem.edges.size() );
+		utility::thread::parallel_for( problem.edges.size(), n_threads, PairsPass( problem, states, eliminated ) );
+		for ( Size ee = 1; ee <= eliminated.size(); ++ee ) {
+			for ( Size kk = 1; kk <= eliminated[ ee ].size(); ++kk ) {
+				int const node( eliminated[ ee ][ kk ].first ), state( eliminated[ ee ][ kk ].second );
+				if ( alive[ node ][ state ] ) {
+					alive[ node ][ state ] = 0;
+					changed = true;
+				}
+			}
+		}
+		for ( int ii = 1; ii <= problem.nnodes; ++ii ) states[ ii ] = alive_states( alive[ ii ] );
+	}
+
+	utility::vector0< int > surviving;
+	for ( int ii = 1; ii <= problem.nnodes; ++ii ) {
+		for ( Size ss = 1; ss <= states[ ii ].size(); ++ss ) {
+			surviving.push_back( rotsets.nrotamer_offset_for_moltenres( ii ) + states[ ii ][ ss ] );
+		}
+	}
+
+	Size const n_fixed_edges( count_fixed_edges( problem, states ) );
+	TR << "dead-end elimination removed " << n_start - surviving.size() << " of " << n_start << " rotamers and "
+		<< n_fixed_edges - n_fixed_edges_start << " of " << problem.edges.size() << " edges in "
+		<< n_passes << " passes" << std::endl;
+
+	return surviving;
+}
+
+} // namespace pack
+} // namespace core
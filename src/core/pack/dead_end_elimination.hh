@@ -0,0 +1,65 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/pack/dead_end_elimination.hh
+/// @brief  dead-end elimination of rotamers before annealing
+/// @details Goldstein singles elimination removes rotamer r at a residue if another rotamer r' there
+/// is always better: E(r) - E(r') + sum over neighbors j of min_s [ E(r,s) - E(r',s) ] > 0.  With
+/// pairs, the rotamer pairs of an edge are tested the same way against its lowest bound "magic bullet"
+/// pair, and a rotamer whose pairs with every remaining rotamer of a neighbor are dead is removed.
+/// Passes repeat until nothing more is eliminated.  The interaction graph itself is not changed: the
+/// surviving rotamers are handed to the annealer as rot_to_pack.  An edge whose residues are both
+/// left with a single rotamer contributes a constant and is counted as eliminated in the report.
+
+#ifndef INCLUDED_core_pack_dead_end_elimination_hh
+#define INCLUDED_core_pack_dead_end_elimination_hh
+
+// Package Headers
+#include <core/pack/task/PackerTask.fwd.hh>
+#include <core/pack/rotamer_set/FixbbRotamerSets.fwd.hh>
+#include <core/pack/interaction_graph/AnnealableGraphBase.fwd.hh>
+
+// Project Headers
+#include <core/types.hh>
+
+// Utility Headers
+#include <utility/vector0.hh>
+
+namespace core {
+namespace pack {
+
+/// @brief Can the rotamer space of this task and interaction graph be pruned by dead-end elimination?
+/// True for the precomputed pair energy graphs (PD, DensePD and DoubleDensePD) when the task neither
+/// links nor couples rotamers.
+bool
+dead_end_elimination_applies(
+	task::PackerTask const & task,
+	interaction_graph::AnnealableGraphBase const & ig
+);
+
+/// @brief Prune the rotamers in rot_to_pack (all rotamers if it is empty) by dead-end elimination,
+/// without changing the interaction graph.  Returns the surviving rotamers, in the form the annealers
+/// take as rot_to_pack.
+/// Residues are split over n_threads threads in each pass (0 = hardware concurrency); the result
+/// does not depend on the number of threads.  Returns rot_to_pack unchanged if
+/// dead_end_elimination_applies() is false.
+utility::vector0< int >
+prune_rotamers_by_dead_end_elimination(
+	task::PackerTask const & task,
+	rotamer_set::FixbbRotamerSets const & rotsets,
+	interaction_graph::AnnealableGraphBase & ig,
+	utility::vector0< int > const & rot_to_pack,
+	bool pairs,
+	core::Size n_threads
+);
+
+} // namespace pack
+} // namespace core
+
+#endif
@@ -148,6 +148,9 @@ DoubleLazyNode::count_dynamic_memory() const
 
 	total_memory += curr_state_two_body_energies_.size() * sizeof( core::PackerEnergy );
 	total_memory += alternate_state_two_body_energies_.size() * sizeof( core::PackerEnergy );
+	total_memory += uncached_edges_.capacity() * sizeof( int );
+	total_memory += uncached_neighbor_states_.capacity() * sizeof( int );
+	total_memory += uncached_energies_.capacity() * sizeof( core::PackerEnergy );
 
 	return total_memory;
 }
@@ -675,19 +678,41 @@ DoubleLazyEdge::get_two_body_energy_smi(
 	SparseMatrixIndex const & node1info,
 	SparseMatrixIndex const & node2info
 ) const
+{
+	core::PackerEnergy energy = get_stored_two_body_energy_smi( node1info, node2info );
+
+	if ( energy == NOT_YET_COMPUTED_ENERGY ) {
+		energy = store_two_body_energy_smi( node1info, node2info,
+			get_otf_node(0)->compute_rotamer_pair_energy(
+			get_edges_position_in_nodes_edge_vector( 0 ),
+			node1state, node2state ) );
+	}
+	return energy;
+}
+
+core::PackerEnergy
+DoubleLazyEdge::get_stored_two_body_energy_smi(
+	SparseMatrixIndex const & node1info,
+	SparseMatrixIndex const & node2info
+) const
 {
 	if ( ! sparse_aa_neighbors_( node2info.get_aa_type(), node1info.get_aa_type() ) ) {
 		return 0.0;
 	}
 	prep_aa_submatrix( node1info.get_aa_type(), node2info.get_aa_type() );
-	core::PackerEnergy energy = read_aa_submatrix( node1info, node2info );
+	return read_aa_submatrix( node1info, node2info );
+}
 
-	if ( energy == NOT_YET_COMPUTED_ENERGY ) {
-		energy = get_otf_node(0)->compute_rotamer_pair_energy(
-			get_edges_position_in_nodes_edge_vector( 0 ),
-			node1state, node2state ) * edge_weight();
-		set_aa_submatrix( node1info, node2info, energy );
-	}
+/// @details updates mutable data
+core::PackerEnergy
+DoubleLazyEdge::store_two_body_energy_smi(
+	SparseMatrixIndex const & node1info,
+	SparseMatrixIndex const & node2info,
+	core::PackerEnergy energy
+) const
+{
+	energy *= edge_weight();
+	set_aa_submatrix( node1info, node2info, energy );
 	return energy;
 }
 
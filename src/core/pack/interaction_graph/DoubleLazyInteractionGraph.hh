@@ -177,6 +177,11 @@ private:
 	core::PackerEnergy alternate_state_total_energy_;
 	std::vector< core::PackerEnergy > alternate_state_two_body_energies_;
 
+	/// @brief the energies of the alternate state that are not stored yet, computed as one row
+	utility::vector1< int > uncached_edges_;
+	utility::vector1< int > uncached_neighbor_states_;
+	utility::vector1< core::PackerEnergy > uncached_energies_;
+
 	bool alternate_state_is_being_considered_;
 	bool procrastinated_;
 
@@ -227,6 +232,23 @@ public:
 		SparseMatrixIndex const & node2info
 	) const;
 
+	/// @brief The energy of the state pair, or NOT_YET_COMPUTED_ENERGY if it still has to be computed
+	/// and handed to store_two_body_energy_smi
+	core::PackerEnergy
+	get_stored_two_body_energy_smi(
+		SparseMatrixIndex const & node1info,
+		SparseMatrixIndex const & node2info
+	) const;
+
+	/// @brief Keep the energy of the state pair computed by one of the nodes; returns it with the
+	/// edge weight applied, as get_two_body_energy_smi would
+	core::PackerEnergy
+	store_two_body_energy_smi(
+		SparseMatrixIndex const & node1info,
+		SparseMatrixIndex const & node2info,
+		core::PackerEnergy energy
+	) const;
+
 	//virtual methods inherited from EdgeBase
 	virtual void declare_energies_final();
 	virtual void prepare_for_simulated_annealing();
@@ -677,19 +699,32 @@ DoubleLazyNode::project_deltaE_for_substitution
 	//int nstates_offset =
 	// num_states_for_aa_type_for_higher_indexed_neighbor_.index(1,1) - 1;
 
-	for ( int ii = 1; ii <= get_num_edges_to_smaller_indexed_nodes(); ++ii ) {
-
+	// look up the stored energies first and compute the missing ones as one row
+	uncached_edges_.clear();
+	uncached_neighbor_states_.clear();
+	for ( int ii = 1; ii <= get_num_incident_edges(); ++ii ) {
+		bool const neighbor_is_node1( ii <= get_num_edges_to_smaller_indexed_nodes() );
 		alternate_state_two_body_energies_[ ii ] = get_incident_dlazy_edge(ii)->
-			get_two_body_energy_smi(
-			neighbors_curr_state_[ ii ], alternate_state_,
-			neighbors_curr_state_sparse_info_[ ii ], alt_state_sparse_mat_info_ );
+			get_stored_two_body_energy_smi(
+			neighbor_is_node1 ? neighbors_curr_state_sparse_info_[ ii ] : alt_state_sparse_mat_info_,
+			neighbor_is_node1 ? alt_state_sparse_mat_info_ : neighbors_curr_state_sparse_info_[ ii ] );
+		if ( alternate_state_two_body_energies_[ ii ] == DoubleLazyEdge::NOT_YET_COMPUTED_ENERGY ) {
+			uncached_edges_.push_back( ii );
+			uncached_neighbor_states_.push_back( neighbors_curr_state_[ ii ] );
+		}
 	}
 
-	for ( int ii = get_num_edges_to_smaller_indexed_nodes() + 1; ii <= get_num_incident_edges(); ++ii ) {
-		alternate_state_two_body_energies_[ ii ] = get_incident_dlazy_edge(ii)->
-			get_two_body_energy_smi(
-			alternate_state_, neighbors_curr_state_[ ii ],
-			alt_state_sparse_mat_info_, neighbors_curr_state_sparse_info_[ ii ] );
+	if ( ! uncached_edges_.empty() ) {
+		compute_rotamer_pair_energies( alternate_state_, uncached_edges_, uncached_neighbor_states_, uncached_energies_ );
+		for ( Size jj = 1; jj <= uncached_edges_.size(); ++jj ) {
+			int const ii = uncached_edges_[ jj ];
+			bool const neighbor_is_node1( ii <= get_num_edges_to_smaller_indexed_nodes() );
+			alternate_state_two_body_energies_[ ii ] = get_incident_dlazy_edge(ii)->
+				store_two_body_energy_smi(
+				neighbor_is_node1 ? neighbors_curr_state_sparse_info_[ ii ] : alt_state_sparse_mat_info_,
+				neighbor_is_node1 ? alt_state_sparse_mat_info_ : neighbors_curr_state_sparse_info_[ ii ],
+				uncached_energies_[ jj ] );
+		}
 	}
 
 	for ( int ii = 1; ii <= get_num_incident_edges(); ++ii ) {
@@ -30,6 +30,8 @@
 #include <core/pack/interaction_graph/SymmLinMemInteractionGraph.hh>
 
 #include <core/pack/interaction_graph/ResidueArrayAnnealingEvaluator.hh>
+#include <core/pack/interaction_graph/InteractionGraphSnapshot.hh>
+#include <core/pack/interaction_graph/PrecomputedPairEnergiesInteractionGraph.hh>
 
 #include <core/pack/rotamer_set/RotamerSets.hh>
 #include <core/pack/rotamer_set/RotamerSet.hh>
@@ -44,6 +46,8 @@
 
 #include <basic/prof.hh>
 #include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/packing.OptionKeys.gen.hh>
 
 #include <utility/pointer/owning_ptr.hh>
 
@@ -178,10 +182,33 @@ InteractionGraphFactory::create_and_initialize_two_body_interaction_graph(
 	scoring::ScoreFunction const & scfxn,
 	graph::GraphCOP packer_neighbor_graph)
 {
+	using namespace basic::options;
+
 	InteractionGraphBaseOP ig = create_interaction_graph( packer_task, rotsets, pose, scfxn);
 
+	// with -packing:ig_snapshot, reuse the energies of an earlier run with the same input
+	std::string snapshot_filename;
+	PrecomputedPairEnergiesInteractionGraphOP pig;
+	if ( option[ OptionKeys::packing::ig_snapshot ].user() && InteractionGraphSnapshot::supported( *ig ) ) {
+		snapshot_filename = option[ OptionKeys::packing::ig_snapshot ]();
+		pig = utility::pointer::static_pointer_cast< PrecomputedPairEnergiesInteractionGraph >( ig );
+	}
+
 	PROF_START( basic::GET_ENERGIES );
-	rotsets.compute_energies( pose, scfxn, packer_neighbor_graph, ig );
+	if ( pig ) {
+		InteractionGraphSnapshot const snapshot( snapshot_filename );
+		if ( snapshot.matches( pose, packer_task, rotsets, scfxn ) ) {
+			snapshot.restore( rotsets, *pig );
+		} else {
+			rotsets.compute_energies( pose, scfxn, packer_neighbor_graph, ig );
+			// writing costs about as much as reading; a protocol packing many inputs writes only once
+			if ( ! snapshot.valid() || option[ OptionKeys::packing::ig_snapshot_overwrite ]() ) {
+				InteractionGraphSnapshot::write( snapshot_filename, pose, packer_task, rotsets, scfxn, *pig );
+			}
+		}
+	} else {
+		rotsets.compute_energies( pose, scfxn, packer_neighbor_graph, ig );
+	}
 	PROF_STOP( basic::GET_ENERGIES );
 	T << "IG: " << ig->getTotalMemoryUsage() << " bytes" << std::endl;
 
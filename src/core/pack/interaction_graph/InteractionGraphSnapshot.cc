@@ -0,0 +1,449 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   core/pack/interaction_graph/InteractionGraphSnapshot.cc
+/// @brief  A binary file holding the energies of a precomputed interaction graph, for reuse by later packing runs
+
+// Unit headers
+#include <core/pack/interaction_graph/InteractionGraphSnapshot.hh>
+
+// Package headers
+#include <core/pack/interaction_graph/DensePDInteractionGraph.hh>
+#include <core/pack/interaction_graph/PDInteractionGraph.hh>
+#include <core/pack/interaction_graph/PrecomputedPairEnergiesInteractionGraph.hh>
+#include <core/pack/rotamer_set/RotamerSet.hh>
+#include <core/pack/rotamer_set/RotamerSets.hh>
+#include <core/pack/task/PackerTask.hh>
+
+// Project headers
+#include <core/conformation/Conformation.hh>
+#include <core/conformation/Residue.hh>
+#include <core/kinematics/FoldTree.hh>
+#include <core/pose/Pose.hh>
+#include <core/scoring/ScoreFunction.hh>
+#include <core/scoring/constraints/Constraint.hh>
+#include <core/scoring/constraints/ConstraintSet.hh>
+#include <core/scoring/func/XYZ_Func.hh>
+#include <core/scoring/methods/EnergyMethodOptions.hh>
+
+// Basic headers
+#include <basic/Tracer.hh>
+
+// Utility headers
+#include <utility/exit.hh>
+#include <utility/vector1.hh>
+
+// ObjexxFCL headers
+#include <ObjexxFCL/FArray2D.hh>
+
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+
+// C++ headers
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+#include <vector>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+namespace core {
+namespace pack {
+namespace interaction_graph {
+
+static THREAD_LOCAL basic::Tracer TR( "core.pack.interaction_graph.InteractionGraphSnapshot" );
+
+/// @brief Magic header of a snapshot; followed by the four hashes, the number of nodes, the number of
+/// states of each node, the number of amino acid types, the one-body energies of every state, the
+/// number of edges and then, for each edge, its nodes, its amino acid neighbor table (node1 aa major)
+/// and the energies of its state pairs whose amino acids are neighbors (node1 state major).
+/// Integers are uint64 and energies float, in host byte order.
+static char const IG_SNAPSHOT_MAGIC[ 8 ] = { 'I', 'G', 'S', 'N', 'A', 'P', '0', '1' };
+
+namespace {
+
+void
+write_u64( std::ostream & out, core::Size value )
+{
+	boost::uint64_t const v( value );
+	out.write( reinterpret_cast< char const * >( &v ), sizeof( v ) );
+}
+
+void
+write_energy( std::ostream & out, core::PackerEnergy value )
+{
+	float const v( value );
+	out.write( reinterpret_cast< char const * >( &v ), sizeof( v ) );
+}
+
+/// @brief Reader over a snapshot file; once a read runs past the end, failed() is set and reads give zeros
+class SnapshotReader {
+public:
+	SnapshotReader( std::istream & in ) : in_( in ) {}
+
+	core::Size u64() {
+		boost::uint64_t v( 0 );
+		read( &v, sizeof( v ) );
+		return v;
+	}
+
+	void read( void * dest, core::Size n ) {
+		if ( n == 0 ) return;
+		if ( ! in_.read( static_cast< char * >( dest ), n ) ) std::memset( dest, 0, n );
+	}
+
+	void skip( core::Size n ) { in_.seekg( n, std::ios::cur ); }
+
+	bool failed() const { return ! in_; }
+	core::Size pos() { return failed() ? 0 : core::Size( in_.tellg() ); }
+
+private:
+	std::istream & in_;
+};
+
+void
+hash_xyz( core::Size & seed, conformation::Residue const & res )
+{
+	boost::hash_combine( seed, res.name() );
+	for ( core::Size ii = 1; ii <= res.natoms(); ++ii ) {
+		for ( core::Size jj = 0; jj < 3; ++jj ) {
+			float const coord( res.xyz( ii )[ jj ] );
+			boost::uint32_t bits;
+			std::memcpy( &bits, &coord, sizeof( bits ) );
+			boost::hash_combine( seed, bits );
+		}
+	}
+}
+
+/// @brief residues, their connections, the fold tree and the constraints: the pose state that the
+/// packer's energies depend on besides the score function
+core::Size
+pose_hash( pose::Pose const & pose, scoring::ScoreFunction const & sfxn )
+{
+	core::Size seed( pose.total_residue() );
+	for ( core::Size ii = 1; ii <= pose.total_residue(); ++ii ) {
+		conformation::Residue const & res( pose.residue( ii ) );
+		hash_xyz( seed, res );
+		for ( core::Size jj = 1; jj <= res.n_possible_residue_connections(); ++jj ) {
+			boost::hash_combine( seed, res.connected_residue_at_resconn( jj ) );
+		}
+	}
+	// a symmetric conformation scores its subunits together
+	boost::hash_combine( seed, std::string( typeid( pose.conformation() ).name() ) );
+
+	std::ostringstream fold_tree;
+	fold_tree << pose.fold_tree();
+	boost::hash_combine( seed, fold_tree.str() );
+	utility::vector1< core::Size > const & chain_endings( pose.conformation().chain_endings() );
+	for ( core::Size ii = 1; ii <= chain_endings.size(); ++ii ) boost::hash_combine( seed, chain_endings[ ii ] );
+
+	// not every constraint can print itself, so a constraint is identified by its type, its atoms and
+	// its unweighted score on the pose
+	scoring::constraints::ConstraintCOPs const csts( pose.constraint_set()->get_all_constraints() );
+	boost::hash_combine( seed, csts.size() );
+	scoring::func::ConformationXYZ const xyz( pose.conformation() );
+	for ( core::Size ii = 1; ii <= csts.size(); ++ii ) {
+		scoring::constraints::Constraint const & cst( *csts[ ii ] );
+		boost::hash_combine( seed, cst.type() );
+		boost::hash_combine( seed, core::Size( cst.score_type() ) );
+		for ( core::Size jj = 1; jj <= cst.natoms(); ++jj ) {
+			boost::hash_combine( seed, cst.atom( jj ).rsd() );
+			boost::hash_combine( seed, cst.atom( jj ).atomno() );
+		}
+		scoring::EnergyMap emap;
+		cst.setup_for_scoring( xyz, sfxn );
+		cst.score( xyz, sfxn.weights(), emap );
+		boost::hash_combine( seed, emap[ cst.score_type() ] );
+	}
+	return seed;
+}
+
+core::Size
+task_hash( task::PackerTask const & task )
+{
+	std::ostringstream out;
+	task.show_all_residue_tasks( out );
+	core::Size seed( 0 );
+	boost::hash_combine( seed, out.str() );
+	boost::hash_combine( seed, task.design_any() );
+	return seed;
+}
+
+core::Size
+rotamers_hash( rotamer_set::RotamerSets const & rotsets )
+{
+	core::Size seed( rotsets.nmoltenres() );
+	for ( core::Size ii = 1; ii <= rotsets.nmoltenres(); ++ii ) {
+		rotamer_set::RotamerSetCOP rotset( rotsets.rotamer_set_for_moltenresidue( ii ) );
+		boost::hash_combine( seed, rotsets.moltenres_2_resid( ii ) );
+		boost::hash_combine( seed, rotset->num_rotamers() );
+		for ( core::Size jj = 1; jj <= rotset->num_rotamers(); ++jj ) {
+			hash_xyz( seed, *rotset->rotamer( jj ) );
+		}
+	}
+	return seed;
+}
+
+core::Size
+score_function_hash( scoring::ScoreFunction const & sfxn )
+{
+	core::Size seed( 0 );
+	for ( core::Size ii = 1; ii <= core::Size( scoring::n_score_types ); ++ii ) {
+		boost::hash_combine( seed, sfxn.get_weight( scoring::ScoreType( ii ) ) );
+	}
+	std::ostringstream out;
+	sfxn.energy_method_options().show( out );
+	boost::hash_combine( seed, out.str() );
+	return seed;
+}
+
+}
+
+InteractionGraphSnapshot::InteractionGraphSnapshot( std::string const & filename ) :
+	filename_( filename ),
+	valid_( false ),
+	nodes_offset_( 0 )
+{
+	for ( core::Size ii = 0; ii < 4; ++ii ) hashes_[ ii ] = 0;
+
+	std::ifstream in( filename.c_str(), std::ios::binary );
+	if ( !in ) return;
+	valid_ = index( in );
+	if ( !valid_ ) TR.Warning << filename << " is not a complete interaction graph snapshot; ignoring it" << std::endl;
+}
+
+InteractionGraphSnapshot::~InteractionGraphSnapshot() {}
+
+/// @details Reads the header and the per-edge counts only, seeking past the energies.
+bool
+InteractionGraphSnapshot::index( std::istream & file )
+{
+	file.seekg( 0, std::ios::end );
+	core::Size const size( file.tellg() );
+	file.seekg( 0, std::ios::beg );
+
+	char magic[ sizeof( IG_SNAPSHOT_MAGIC ) ];
+	SnapshotReader in( file );
+	in.read( magic, sizeof( magic ) );
+	if ( in.failed() || std::memcmp( magic, IG_SNAPSHOT_MAGIC, sizeof( IG_SNAPSHOT_MAGIC ) ) != 0 ) return false;
+	for ( core::Size ii = 0; ii < 4; ++ii ) hashes_[ ii ] = in.u64();
+
+	nodes_offset_ = in.pos();
+	core::Size const nnodes( in.u64() );
+	if ( nnodes > size ) return false;
+	core::Size nstates( 0 );
+	for ( core::Size ii = 1; ii <= nnodes && !in.failed(); ++ii ) nstates += in.u64();
+	core::Size const naa( in.u64() );
+	if ( in.failed() || nstates > size || naa > size ) return false;
+	in.skip( nstates * sizeof( float ) );
+
+	core::Size const nedges( in.u64() );
+	for ( core::Size ii = 1; ii <= nedges && !in.failed(); ++ii ) {
+		in.skip( 2 * sizeof( boost::uint64_t ) + naa * naa );
+		core::Size const nenergies( in.u64() );
+		if ( nenergies > size ) return false;
+		in.skip( nenergies * sizeof( float ) );
+	}
+	return !in.failed() && in.pos() == size;
+}
+
+bool
+InteractionGraphSnapshot::matches(
+	pose::Pose const & pose,
+	task::PackerTask const & task,
+	rotamer_set::RotamerSets const & rotsets,
+	scoring::ScoreFunction const & sfxn
+) const
+{
+	if ( !valid_ ) return false;
+	if ( hashes_[ 0 ] != pose_hash( pose, sfxn ) ) {
+		TR << "Interaction graph snapshot " << filename_ << " was taken of another pose" << std::endl;
+		return false;
+	}
+	if ( hashes_[ 1 ] != task_hash( task ) ) {
+		TR << "Interaction graph snapshot " << filename_ << " was taken with another packer task" << std::endl;
+		return false;
+	}
+	if ( hashes_[ 2 ] != rotamers_hash( rotsets ) ) {
+		TR << "Interaction graph snapshot " << filename_ << " was taken with other rotamers" << std::endl;
+		return false;
+	}
+	if ( hashes_[ 3 ] != score_function_hash( sfxn ) ) {
+		TR << "Interaction graph snapshot " << filename_ << " was taken with another score function" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void
+InteractionGraphSnapshot::restore(
+	rotamer_set::RotamerSets const & rotsets,
+	PrecomputedPairEnergiesInteractionGraph & ig
+) const
+{
+	runtime_assert( valid_ );
+	ig.initialize( rotsets );
+
+	std::ifstream file( filename_.c_str(), std::ios::binary );
+	file.seekg( nodes_offset_ );
+	SnapshotReader in( file );
+	core::Size const nnodes( in.u64() );
+	if ( nnodes != core::Size( ig.get_num_nodes() ) ) {
+		utility_exit_with_message( "Interaction graph snapshot " + filename_ + " does not fit the interaction graph" );
+	}
+	utility::vector1< core::Size > nstates( nnodes );
+	for ( core::Size ii = 1; ii <= nnodes; ++ii ) {
+		nstates[ ii ] = in.u64();
+		if ( nstates[ ii ] != core::Size( ig.get_num_states_for_node( ii ) ) ) {
+			utility_exit_with_message( "Interaction graph snapshot " + filename_ + " does not fit the interaction graph" );
+		}
+	}
+	int const naa( in.u64() );
+	if ( naa != ig.get_num_aatypes() ) {
+		utility_exit_with_message( "Interaction graph snapshot " + filename_ + " does not fit the interaction graph" );
+	}
+
+	std::vector< float > energies;
+	for ( core::Size ii = 1; ii <= nnodes; ++ii ) {
+		energies.resize( nstates[ ii ] );
+		in.read( energies.data(), energies.size() * sizeof( float ) );
+		utility::vector1< core::PackerEnergy > one_body_energies( energies.begin(), energies.end() );
+		ig.add_to_nodes_one_body_energy( ii, one_body_energies );
+	}
+
+	core::Size const nedges( in.u64() );
+	std::vector< char > neighbors( naa * naa );
+	ObjexxFCL::FArray2D_bool aa_neighbors( naa, naa, false );
+	for ( core::Size ee = 1; ee <= nedges; ++ee ) {
+		int const node1( in.u64() );
+		int const node2( in.u64() );
+		in.read( neighbors.data(), neighbors.size() );
+		for ( int aa1 = 1; aa1 <= naa; ++aa1 ) {
+			for ( int aa2 = 1; aa2 <= naa; ++aa2 ) {
+				aa_neighbors( aa2, aa1 ) = neighbors[ ( aa1 - 1 ) * naa + aa2 - 1 ] != 0;
+			}
+		}
+		energies.resize( in.u64() );
+		in.read( energies.data(), energies.size() * sizeof( float ) );
+		ig.add_edge( node1, node2 );
+		ig.set_sparse_aa_info_for_edge( node1, node2, aa_neighbors );
+		core::Size next( 0 );
+		for ( core::Size s1 = 1; s1 <= nstates[ node1 ]; ++s1 ) {
+			int const aa1( ig.aatype_for_node_state( node1, s1 ) );
+			for ( core::Size s2 = 1; s2 <= nstates[ node2 ]; ++s2 ) {
+				if ( ! aa_neighbors( ig.aatype_for_node_state( node2, s2 ), aa1 ) ) continue;
+				runtime_assert( next < energies.size() );
+				core::PackerEnergy const energy( energies[ next++ ] );
+				if ( energy != 0.0 ) ig.set_two_body_energy_for_edge( node1, node2, s1, s2, energy );
+			}
+		}
+		runtime_assert( next == energies.size() );
+		ig.declare_edge_energies_final( node1, node2 );
+	}
+	if ( in.failed() ) {
+		utility_exit_with_message( "Interaction graph snapshot " + filename_ + " was truncated while it was read" );
+	}
+	TR << "Restored " << nedges << " edges of the interaction graph from snapshot " << filename_ << std::endl;
+}
+
+bool
+InteractionGraphSnapshot::supported( InteractionGraphBase const & ig )
+{
+	// exact types: the surface and hpatch graphs derive from PDInteractionGraph
+	return typeid( ig ) == typeid( PDInteractionGraph ) || typeid( ig ) == typeid( DensePDInteractionGraph );
+}
+
+void
+InteractionGraphSnapshot::write(
+	std::string const & filename,
+	pose::Pose const & pose,
+	task::PackerTask const & task,
+	rotamer_set::RotamerSets const & rotsets,
+	scoring::ScoreFunction const & sfxn,
+	PrecomputedPairEnergiesInteractionGraph & ig
+)
+{
+	std::ostringstream tmp_name;
+	tmp_name << filename << ".tmp";
+#ifndef WIN32
+	tmp_name << "." << getpid();
+#endif
+	std::string const tmp_filename( tmp_name.str() );
+	std::ofstream out( tmp_filename.c_str(), std::ios::binary );
+	if ( !out ) {
+		TR.Warning << "Unable to write interaction graph snapshot " << tmp_filename << std::endl;
+		return;
+	}
+
+	out.write( IG_SNAPSHOT_MAGIC, sizeof( IG_SNAPSHOT_MAGIC ) );
+	write_u64( out, pose_hash( pose, sfxn ) );
+	write_u64( out, task_hash( task ) );
+	write_u64( out, rotamers_hash( rotsets ) );
+	write_u64( out, score_function_hash( sfxn ) );
+
+	int const nnodes( ig.get_num_nodes() );
+	int const naa( ig.get_num_aatypes() );
+	write_u64( out, nnodes );
+	for ( int ii = 1; ii <= nnodes; ++ii ) write_u64( out, ig.get_num_states_for_node( ii ) );
+	write_u64( out, naa );
+	for ( int ii = 1; ii <= nnodes; ++ii ) {
+		for ( int jj = 1; jj <= ig.get_num_states_for_node( ii ); ++jj ) {
+			write_energy( out, ig.get_one_body_energy_for_node_state( ii, jj ) );
+		}
+	}
+
+	write_u64( out, ig.get_num_edges() );
+	core::Size nedges( 0 );
+	for ( int node1 = 1; node1 <= nnodes; ++node1 ) {
+		for ( ig.reset_edge_list_iterator_for_node( node1 ); !ig.edge_list_iterator_at_end(); ig.increment_edge_list_iterator() ) {
+			int const node2( ig.get_edge().get_other_ind( node1 ) );
+			if ( node2 < node1 ) continue; // each edge once, from its lower node
+			++nedges;
+			write_u64( out, node1 );
+			write_u64( out, node2 );
+			for ( int aa1 = 1; aa1 <= naa; ++aa1 ) {
+				for ( int aa2 = 1; aa2 <= naa; ++aa2 ) {
+					char const neighbors( ig.get_sparse_aa_info_for_edge( node1, node2, aa1, aa2 ) ? 1 : 0 );
+					out.write( &neighbors, 1 );
+				}
+			}
+			std::ostringstream energies;
+			core::Size nenergies( 0 );
+			for ( int s1 = 1; s1 <= ig.get_num_states_for_node( node1 ); ++s1 ) {
+				int const aa1( ig.aatype_for_node_state( node1, s1 ) );
+				for ( int s2 = 1; s2 <= ig.get_num_states_for_node( node2 ); ++s2 ) {
+					if ( ! ig.get_sparse_aa_info_for_edge( node1, node2, aa1, ig.aatype_for_node_state( node2, s2 ) ) ) continue;
+					write_energy( energies, ig.get_two_body_energy_for_edge( node1, node2, s1, s2 ) );
+					++nenergies;
+				}
+			}
+			write_u64( out, nenergies );
+			out << energies.str();
+		}
+	}
+	runtime_assert( nedges == core::Size( ig.get_num_edges() ) );
+
+	out.close();
+	// the rename replaces the file in one step, so a run reading the old snapshot keeps its open file
+	if ( !out || std::rename( tmp_filename.c_str(), filename.c_str() ) != 0 ) {
+		TR.Warning << "Unable to write interaction graph snapshot " << filename << std::endl;
+		std::remove( tmp_filename.c_str() );
+		return;
+	}
+	TR << "Wrote snapshot of " << nedges << " interaction graph edges to " << filename << std::endl;
+}
+
+} // namespace interaction_graph
+} // namespace pack
+} // namespace core
@@ -0,0 +1,122 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   core/pack/interaction_graph/InteractionGraphSnapshot.hh
+/// @brief  A binary file holding the energies of a precomputed interaction graph, for reuse by later packing runs
+/// @details Computing the rotamer pair energies is the expensive part of packing a large design, and
+/// the dozens of independent trajectories launched on one input all compute the same energies.  With
+/// -packing:ig_snapshot the first run writes the one- and two-body energies of its graph to a file,
+/// together with hashes of the pose (residues, connections, fold tree and constraints), the packer task,
+/// the rotamers and the score function.  Later runs build their rotamers as usual and, if all four hashes
+/// match, fill their graph from the file instead of scoring the rotamer pairs.  The graphs own their
+/// energies, so restoring copies every energy out of the file; the saving is the scoring, not the copy.
+/// A snapshot is written only when the file holds none, so a protocol that packs many different
+/// inputs writes once rather than on every packing; -packing:ig_snapshot_overwrite replaces a
+/// snapshot that does not match.
+/// Snapshots are taken of PDInteractionGraphs and DensePDInteractionGraphs only: the lazy and on-the-fly
+/// graphs compute their energies during annealing, and the surface and hpatch graphs hold more than
+/// pair energies.
+
+#ifndef INCLUDED_core_pack_interaction_graph_InteractionGraphSnapshot_hh
+#define INCLUDED_core_pack_interaction_graph_InteractionGraphSnapshot_hh
+
+// Unit headers
+#include <core/pack/interaction_graph/InteractionGraphSnapshot.fwd.hh>
+
+// Package headers
+#include <core/pack/interaction_graph/InteractionGraphBase.fwd.hh>
+#include <core/pack/interaction_graph/PrecomputedPairEnergiesInteractionGraph.fwd.hh>
+#include <core/pack/rotamer_set/RotamerSets.fwd.hh>
+#include <core/pack/task/PackerTask.fwd.hh>
+
+// Project headers
+#include <core/types.hh>
+#include <core/pose/Pose.fwd.hh>
+#include <core/scoring/ScoreFunction.fwd.hh>
+
+// Utility headers
+#include <utility/pointer/ReferenceCount.hh>
+
+// C++ headers
+#include <iosfwd>
+#include <string>
+
+namespace core {
+namespace pack {
+namespace interaction_graph {
+
+class InteractionGraphSnapshot : public utility::pointer::ReferenceCount {
+public:
+	/// @brief read the hashes and check the layout of filename; a missing, truncated or foreign
+	/// file gives a snapshot that matches nothing
+	InteractionGraphSnapshot( std::string const & filename );
+
+	virtual ~InteractionGraphSnapshot();
+
+	/// @brief Was the file a complete snapshot?
+	bool valid() const { return valid_; }
+
+	/// @brief Does the snapshot hold the energies for packing this pose with this task, these
+	/// rotamers and this score function?
+	bool
+	matches(
+		pose::Pose const & pose,
+		task::PackerTask const & task,
+		rotamer_set::RotamerSets const & rotsets,
+		scoring::ScoreFunction const & sfxn
+	) const;
+
+	/// @brief Initialize ig for rotsets and give it the energies of the snapshot, as
+	/// RotamerSets::compute_energies would.  The snapshot must match.
+	void
+	restore(
+		rotamer_set::RotamerSets const & rotsets,
+		PrecomputedPairEnergiesInteractionGraph & ig
+	) const;
+
+	/// @brief Can a snapshot be taken of ig?
+	static bool supported( InteractionGraphBase const & ig );
+
+	/// @brief Write the energies of ig, once RotamerSets::compute_energies has filled it, to filename.
+	/// The file is written under a temporary name and renamed, so that concurrent runs never read
+	/// a partial snapshot.
+	static
+	void
+	write(
+		std::string const & filename,
+		pose::Pose const & pose,
+		task::PackerTask const & task,
+		rotamer_set::RotamerSets const & rotsets,
+		scoring::ScoreFunction const & sfxn,
+		PrecomputedPairEnergiesInteractionGraph & ig
+	);
+
+private:
+	InteractionGraphSnapshot( InteractionGraphSnapshot const & ); // uncopyable
+	InteractionGraphSnapshot const & operator = ( InteractionGraphSnapshot const & );
+
+	/// @brief walk the sections of the file and check that they are complete
+	bool index( std::istream & file );
+
+private:
+	std::string filename_;
+	bool valid_;
+
+	/// @brief hashes of pose, task, rotamers and score function
+	core::Size hashes_[ 4 ];
+	/// @brief offset of the node section
+	core::Size nodes_offset_;
+};
+
+} // namespace interaction_graph
+} // namespace pack
+} // namespace core
+
+#endif
@@ -19,11 +19,14 @@
 #include <core/scoring/ScoreFunction.hh>
 #include <core/conformation/Residue.hh>
 #include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/packing.OptionKeys.gen.hh>
 
 // Utility headers
 #include <utility/excn/Exceptions.hh>
 
 #include <iostream>
+#include <limits>
 
 #include <utility/vector1.hh>
 #include <ObjexxFCL/FArray1A.hh>
@@ -36,6 +39,7 @@ namespace pack {
 namespace interaction_graph {
 
 static THREAD_LOCAL basic::Tracer T( "core.pack.interaction_graph.linmem_ig", basic::t_error );
+static THREAD_LOCAL basic::Tracer TR_cache( "core.pack.interaction_graph.linmem_ig.cache" );
 
 /// @brief For testing the LinMemIG, you'll want to set this to true
 bool const debug = { false };
@@ -139,6 +143,9 @@ LinearMemNode::count_dynamic_memory() const
 
 	total_memory += curr_state_two_body_energies_.size() * sizeof( core::PackerEnergy );
 	total_memory += alternate_state_two_body_energies_.size() * sizeof( core::PackerEnergy );
+	total_memory += uncached_edges_.capacity() * sizeof( int );
+	total_memory += uncached_neighbor_states_.capacity() * sizeof( int );
+	total_memory += uncached_energies_.capacity() * sizeof( core::PackerEnergy );
 
 	total_memory += accepted_rejected_substitution_history_.size() * sizeof( int );
 
@@ -275,6 +282,10 @@ LinearMemNode::project_deltaE_for_substitution
 	int aa_neighb_linear_index_offset = aa_neighbors_for_edges_.
 		index(1, 1, alt_state_sparse_mat_info_.get_aa_type() ) - 1;
 
+	// look up the stored energies first, then compute the rest as one row so that the alternate
+	// rotamer is evaluated against all of its neighbors in a single pass
+	uncached_edges_.clear();
+	uncached_neighbor_states_.clear();
 	for ( int ii = 1; ii <= get_num_incident_edges();
 			++ii, aa_neighb_linear_index_offset += get_num_aa_types() ) {
 
@@ -283,7 +294,7 @@ LinearMemNode::project_deltaE_for_substitution
 				+ neighbors_curr_state_sparse_info_[ ii ].get_aa_type() ] ) {
 
 			alternate_state_two_body_energies_[ ii ] =
-				get_incident_linmem_edge( ii )->get_energy_for_alt_state(
+				get_incident_linmem_edge( ii )->get_stored_energy_for_alt_state(
 				store_rpes,
 				get_node_index(),
 				alternate_state_,
@@ -291,11 +302,33 @@ LinearMemNode::project_deltaE_for_substitution
 				neighbors_curr_state_[ ii ],
 				neighbors_state_recent_history_index_[ ii ]
 			);
+			if ( alternate_state_two_body_energies_[ ii ] == LinearMemEdge::NOT_YET_COMPUTED_ENERGY ) {
+				uncached_edges_.push_back( ii );
+				uncached_neighbor_states_.push_back( neighbors_curr_state_[ ii ] );
+			}
 
 		} else {
 			alternate_state_two_body_energies_[ ii ] = 0;
 		}
+	}
+
+	if ( ! uncached_edges_.empty() ) {
+		compute_rotamer_pair_energies( alternate_state_, uncached_edges_, uncached_neighbor_states_, uncached_energies_ );
+		for ( Size jj = 1; jj <= uncached_edges_.size(); ++jj ) {
+			int const ii = uncached_edges_[ jj ];
+			alternate_state_two_body_energies_[ ii ] = uncached_energies_[ jj ];
+			get_incident_linmem_edge( ii )->store_energy_for_alt_state(
+				get_node_index(),
+				alternate_state_,
+				alternate_state_recent_history_index,
+				neighbors_curr_state_[ ii ],
+				neighbors_state_recent_history_index_[ ii ],
+				uncached_energies_[ jj ]
+			);
+		}
+	}
 
+	for ( int ii = 1; ii <= get_num_incident_edges(); ++ii ) {
 		alternate_state_total_energy_ += alternate_state_two_body_energies_[ ii ];
 	}
 
@@ -798,7 +831,13 @@ LinearMemEdge::LinearMemEdge(
 	(unsigned char) 0 ),
 	curr_state_energy_( 0.0f ),
 	partial_state_assignment_( false ),
-	preped_for_sim_annealing_( false )
+	preped_for_sim_annealing_( false ),
+	cache_shift_( 32 ),
+	cache_lookups_( 0 ),
+	cache_hits_( 0 ),
+	cache_demand_( 0.0 ),
+	cache_total_lookups_( 0 ),
+	cache_total_hits_( 0 )
 {
 	store_rpes_[ 0 ] = store_rpes_[ 1 ] = true;
 }
@@ -863,6 +902,7 @@ LinearMemEdge::prepare_for_simulated_annealing()
 		if ( ! store_rpes_[ ii ] ) wipe( ii );
 		store_rpes_[ ii ] = true;
 	}
+	cache_total_lookups_ = cache_total_hits_ = 0;
 
 	if ( preped_for_sim_annealing_ ) return;
 
@@ -890,6 +930,8 @@ LinearMemEdge::count_dynamic_memory() const
 	total_memory += sparse_aa_neighbors_.size() * sizeof( unsigned char );
 	total_memory += stored_rpes_[ 0 ].size() * sizeof( core::PackerEnergy );
 	total_memory += stored_rpes_[ 1 ].size() * sizeof( core::PackerEnergy );
+	total_memory += cache_keys_.size() * sizeof( unsigned int );
+	total_memory += cache_energies_.size() * sizeof( core::PackerEnergy );
 
 	return total_memory;
 }
@@ -906,6 +948,9 @@ LinearMemEdge::set_edge_weight( Real weight )
 			}
 		}
 	}
+	for ( Size ii = 0; ii < cache_keys_.size(); ++ii ) {
+		if ( cache_keys_[ ii ] != 0 ) cache_energies_[ ii ] *= reweight_factor;
+	}
 	edge_weight( weight );
 }
 
@@ -1062,21 +1107,42 @@ LinearMemEdge::get_energy_for_alt_state
 	int other_node_state_recent_history_index
 )
 {
-	debug_assert( other_node_curr_state != 0 );
+	core::PackerEnergy const stored_energy = get_stored_energy_for_alt_state(
+		store_rpes,
+		changing_node_index,
+		alternate_state,
+		alternate_state_recent_history_index,
+		other_node_curr_state,
+		other_node_state_recent_history_index );
+	if ( stored_energy != NOT_YET_COMPUTED_ENERGY ) return stored_energy;
 
-	//T << "get_energy_for_alt_state: " << get_node_index( 0 )  << " " << get_node_index( 1 ) << " srpe: " << store_rpes;
-	//T << " chID " << changing_node_index << " alt: " << alternate_state << " altHI: " << alternate_state_recent_history_index;
-	//T << " oncurr: " << other_node_curr_state << " oncurrHI: " << other_node_state_recent_history_index << std::endl;
+	int const node_changing = changing_node_index == get_node_index( 0 ) ? 0 : 1;
+	core::PackerEnergy const energy = get_linmem_node( node_changing )->
+		compute_pair_energy_for_alternate_state(
+		get_edges_position_in_nodes_edge_vector( node_changing ));
 
-	bool assignment_of_interest = debug && false; //get_node_index(0) == 67 && get_node_index(1) == 68;
+	store_energy_for_alt_state(
+		changing_node_index,
+		alternate_state,
+		alternate_state_recent_history_index,
+		other_node_curr_state,
+		other_node_state_recent_history_index,
+		energy );
+	return alt_state_energy_;
+}
 
-	///if ( false ) {
-	if ( assignment_of_interest ) {
-		T << "get_energy_for_alt_state: " << get_node_index( 0 )  << " " << get_node_index( 1 ) << " srpe: " << store_rpes;
-		T << " chID " << changing_node_index << " alt: " << alternate_state << " altHI: " << alternate_state_recent_history_index;
-		T << " oncurr: " << other_node_curr_state << " oncurrHI: " << other_node_state_recent_history_index << std::endl;
-		T << "store_rpes_[ 0 ] " << store_rpes_[ 0 ] << "store_rpes_[ 1 ] " << store_rpes_[ 1 ] << std::endl;
-	}
+core::PackerEnergy
+LinearMemEdge::get_stored_energy_for_alt_state
+(
+	bool store_rpes,
+	int changing_node_index,
+	int alternate_state,
+	int alternate_state_recent_history_index,
+	int other_node_curr_state,
+	int other_node_state_recent_history_index
+)
+{
+	debug_assert( other_node_curr_state != 0 );
 
 	int const node_changing = changing_node_index == get_node_index( 0 ) ? 0 : 1;
 	int const node_not_changing = ! node_changing;
@@ -1088,51 +1154,132 @@ LinearMemEdge::get_energy_for_alt_state
 
 	if ( store_rpes_[ node_changing ] && alternate_state_recent_history_index != 0 ) {
 		alt_state_energy_ = stored_rpes_[ node_changing ]( other_node_curr_state, alternate_state_recent_history_index );
-		if ( alt_state_energy_ != NOT_YET_COMPUTED_ENERGY ) {
-
-			if ( assignment_of_interest ) {
-				T << "retrieving from stored_rpes_[ " << node_changing << " ] " << alt_state_energy_ << std::endl;
-				T << "stored at location: " << & ( stored_rpes_[ node_changing ]( other_node_curr_state, alternate_state_recent_history_index ) ) << std::endl;
-			}
-
-			return alt_state_energy_;
-		}
+		if ( alt_state_energy_ != NOT_YET_COMPUTED_ENERGY ) return alt_state_energy_;
 	}
 
 	if ( store_rpes_[ node_not_changing ] ) {
 		alt_state_energy_ = stored_rpes_[ node_not_changing ]( alternate_state, other_node_state_recent_history_index );
-		if ( alt_state_energy_ != NOT_YET_COMPUTED_ENERGY ) {
+		if ( alt_state_energy_ != NOT_YET_COMPUTED_ENERGY ) return alt_state_energy_;
+	}
 
-			if ( assignment_of_interest ) {
-				T << "retrieving from stored_rpes_[ " << node_not_changing << " ] " << alt_state_energy_ << std::endl;
-				T << "stored at location: " << & ( stored_rpes_[ node_not_changing ]( alternate_state, other_node_state_recent_history_index ) ) << std::endl;
-			}
-			return alt_state_energy_;
-		}
+	alt_state_energy_ = node_changing == 0 ?
+		cached_pair_energy( alternate_state, other_node_curr_state ) :
+		cached_pair_energy( other_node_curr_state, alternate_state );
+	if ( alt_state_energy_ != NOT_YET_COMPUTED_ENERGY ) {
+		store_alt_state_energy_for_recent_history( node_changing, alternate_state,
+			alternate_state_recent_history_index, other_node_curr_state, other_node_state_recent_history_index );
 	}
+	return alt_state_energy_;
+}
 
-	alt_state_energy_ = get_linmem_node( node_changing )->
-		compute_pair_energy_for_alternate_state(
-		get_edges_position_in_nodes_edge_vector( node_changing ));
+void
+LinearMemEdge::store_energy_for_alt_state
+(
+	int changing_node_index,
+	int alternate_state,
+	int alternate_state_recent_history_index,
+	int other_node_curr_state,
+	int other_node_state_recent_history_index,
+	core::PackerEnergy energy
+)
+{
+	int const node_changing = changing_node_index == get_node_index( 0 ) ? 0 : 1;
 
-	//if ( false ) {
-	if ( assignment_of_interest ) {
-		T << "get_energy_for_alt_state: computing energy: " << alt_state_energy_ << std::endl;
+	alt_state_energy_ = energy;
+	store_alt_state_energy_for_recent_history( node_changing, alternate_state,
+		alternate_state_recent_history_index, other_node_curr_state, other_node_state_recent_history_index );
+
+	if ( node_changing == 0 ) {
+		cache_pair_energy( alternate_state, other_node_curr_state, energy );
+	} else {
+		cache_pair_energy( other_node_curr_state, alternate_state, energy );
 	}
+}
+
+void
+LinearMemEdge::store_alt_state_energy_for_recent_history(
+	int node_changing,
+	int alternate_state,
+	int alternate_state_recent_history_index,
+	int other_node_curr_state,
+	int other_node_state_recent_history_index
+)
+{
+	int const node_not_changing = ! node_changing;
 
 	if ( store_rpes_[ node_changing ] && alternate_state_recent_history_index != 0 ) {
 		stored_rpes_[ node_changing ]( other_node_curr_state, alternate_state_recent_history_index ) = alt_state_energy_;
 	}
 	if ( store_rpes_[ node_not_changing ] ) {
 		debug_assert( other_node_state_recent_history_index );
-		if ( assignment_of_interest ) {
-			T << "about to write alt_state_energy_ to location: " << & ( stored_rpes_[ node_not_changing ]( alternate_state, other_node_state_recent_history_index ) ) << std::endl;
-		}
-
 		stored_rpes_[ node_not_changing ]( alternate_state, other_node_state_recent_history_index ) = alt_state_energy_;
 	}
+}
 
-	return alt_state_energy_;
+Size
+LinearMemEdge::pair_energy_cache_max_size() const
+{
+	Size const num_pairs = Size( get_num_states_for_node( 0 ) ) * Size( get_num_states_for_node( 1 ) );
+	if ( num_pairs >= Size( std::numeric_limits< unsigned int >::max() ) ) return 0;
+	Size max_size = 1;
+	while ( max_size < num_pairs ) max_size *= 2;
+	return max_size;
+}
+
+void
+LinearMemEdge::resize_pair_energy_cache( Size new_size )
+{
+	debug_assert( ( new_size & ( new_size - 1 ) ) == 0 );
+	if ( new_size == cache_keys_.size() ) return;
+
+	utility::vector0< unsigned int > old_keys( new_size, 0 );
+	utility::vector0< core::PackerEnergy > old_energies( new_size, NOT_YET_COMPUTED_ENERGY );
+	old_keys.swap( cache_keys_ );
+	old_energies.swap( cache_energies_ );
+
+	cache_shift_ = 32;
+	for ( Size ii = new_size; ii > 1; ii /= 2 ) --cache_shift_;
+
+	if ( new_size == 0 ) return;
+	for ( Size ii = 0; ii < old_keys.size(); ++ii ) {
+		if ( old_keys[ ii ] == 0 ) continue;
+		Size const slot = pair_energy_cache_slot( old_keys[ ii ] );
+		cache_keys_[ slot ] = old_keys[ ii ];
+		cache_energies_[ slot ] = old_energies[ ii ];
+	}
+}
+
+void
+LinearMemEdge::update_pair_energy_cache_demand( Real hit_rate )
+{
+	cache_demand_ = 0.5 * cache_demand_ + hit_rate * cache_lookups_;
+	cache_lookups_ = cache_hits_ = 0;
+}
+
+core::PackerEnergy
+LinearMemEdge::cached_pair_energy( int node1_state, int node2_state )
+{
+	++cache_lookups_;
+	++cache_total_lookups_;
+	if ( cache_keys_.empty() ) return NOT_YET_COMPUTED_ENERGY;
+
+	unsigned int const key = ( unsigned int ) ( node1_state - 1 ) * get_num_states_for_node( 1 ) + node2_state;
+	Size const slot = pair_energy_cache_slot( key );
+	if ( cache_keys_[ slot ] != key ) return NOT_YET_COMPUTED_ENERGY;
+	++cache_hits_;
+	++cache_total_hits_;
+	return cache_energies_[ slot ];
+}
+
+void
+LinearMemEdge::cache_pair_energy( int node1_state, int node2_state, core::PackerEnergy energy )
+{
+	if ( cache_keys_.empty() ) return;
+
+	unsigned int const key = ( unsigned int ) ( node1_state - 1 ) * get_num_states_for_node( 1 ) + node2_state;
+	Size const slot = pair_energy_cache_slot( key );
+	cache_keys_[ slot ] = key;
+	cache_energies_[ slot ] = energy;
 }
 
 int LinearMemEdge::get_two_body_table_size() const
@@ -1209,8 +1356,12 @@ LinearMemoryInteractionGraph::LinearMemoryInteractionGraph(
 	total_energy_alternate_state_assignment_( 0.0 ),
 	node_considering_alt_state_( 0 ),
 	recent_history_size_( 10 ),
-	have_not_committed_last_substitution_( false )
+	have_not_committed_last_substitution_( false ),
+	pair_energy_cache_budget_( 0 ),
+	num_substitutions_since_cache_rebalance_( 0 )
 {
+	using namespace basic::options;
+	set_pair_energy_cache_budget( Size( option[ OptionKeys::packing::linmem_ig_cache_mb ]() * 1024 * 1024 ) );
 }
 
 
@@ -1272,6 +1423,11 @@ LinearMemoryInteractionGraph::consider_substitution(
 
 	node_considering_alt_state_ = node_ind;
 
+	if ( pair_energy_cache_budget_ != 0 &&
+			++num_substitutions_since_cache_rebalance_ == SUBSTITUTIONS_BETWEEN_CACHE_REBALANCES ) {
+		rebalance_pair_energy_caches();
+	}
+
 	delta_energy = get_linmem_node( node_ind )->
 		project_deltaE_for_substitution( new_state, prev_energy_for_node );
 
@@ -1378,6 +1534,9 @@ LinearMemoryInteractionGraph::prepare_for_simulated_annealing()
 	}
 	InteractionGraphBase::prepare_for_simulated_annealing();
 
+	reset_rpe_calculations_count();
+	if ( pair_energy_cache_budget_ != 0 ) rebalance_pair_energy_caches();
+
 }
 
 void
@@ -1390,6 +1549,133 @@ LinearMemoryInteractionGraph::get_recent_history_size() const {
 	return recent_history_size_;
 }
 
+void
+LinearMemoryInteractionGraph::set_pair_energy_cache_budget( Size bytes ) {
+	pair_energy_cache_budget_ = bytes;
+	if ( bytes == 0 ) {
+		for ( std::list< EdgeBase* >::iterator iter = get_edge_list_begin();
+				iter != get_edge_list_end(); ++iter ) {
+			static_cast< LinearMemEdge * >( *iter )->resize_pair_energy_cache( 0 );
+		}
+	}
+}
+
+Size
+LinearMemoryInteractionGraph::get_pair_energy_cache_budget() const {
+	return pair_energy_cache_budget_;
+}
+
+/// @details An edge's demand is its expected number of hits: its lookups times the hit rate of
+/// its two nodes.  A node's hit rate is measured over the caches of all its edges, since how often
+/// pair energies are reused depends mostly on how many states the node still moves between; an edge
+/// without a cache borrows it from its nodes.  Rates are pulled toward the rate of the whole graph,
+/// so that a node with few lookups in caches is not judged on them alone, and before any cache has
+/// been looked up every rate is 1.  Before any lookups at all (at the start of annealing) every
+/// edge's demand is its number of state pairs.  Budget freed by edges that are given all they can
+/// use goes to the others; each share is then rounded down to a power of 2, and shares too small to
+/// be useful are dropped.
+void
+LinearMemoryInteractionGraph::rebalance_pair_energy_caches()
+{
+	Size const min_cache_size = 64;
+	Size const bytes_per_slot = sizeof( unsigned int ) + sizeof( core::PackerEnergy );
+	Real const prior_lookups = 64.0;
+
+	num_substitutions_since_cache_rebalance_ = 0;
+
+	utility::vector1< Size > node_lookups( get_num_nodes(), 0 );
+	utility::vector1< Size > node_hits( get_num_nodes(), 0 );
+	Size graph_lookups( 0 ), graph_hits( 0 );
+	for ( std::list< EdgeBase* >::iterator iter = get_edge_list_begin();
+			iter != get_edge_list_end(); ++iter ) {
+		LinearMemEdge const * edge = static_cast< LinearMemEdge const * >( *iter );
+		if ( edge->pair_energy_cache_size() == 0 ) continue;
+		int const nodes[ 2 ] = { edge->get_first_node_ind(), edge->get_second_node_ind() };
+		for ( int ii = 0; ii < 2; ++ii ) {
+			node_lookups[ nodes[ ii ] ] += edge->pair_energy_cache_recent_lookups();
+			node_hits[ nodes[ ii ] ] += edge->pair_energy_cache_recent_hits();
+		}
+		graph_lookups += edge->pair_energy_cache_recent_lookups();
+		graph_hits += edge->pair_energy_cache_recent_hits();
+	}
+	Real const graph_hit_rate = graph_lookups == 0 ? 1.0 : Real( graph_hits ) / graph_lookups;
+
+	utility::vector1< LinearMemEdge * > edges;
+	utility::vector1< Real > demands;
+	utility::vector1< Size > max_sizes;
+	Real total_demand( 0.0 );
+	for ( std::list< EdgeBase* >::iterator iter = get_edge_list_begin();
+			iter != get_edge_list_end(); ++iter ) {
+		LinearMemEdge * edge = static_cast< LinearMemEdge * >( *iter );
+		int const nodes[ 2 ] = { edge->get_first_node_ind(), edge->get_second_node_ind() };
+		Real hit_rate( 0.0 );
+		for ( int ii = 0; ii < 2; ++ii ) {
+			hit_rate += 0.5 * ( node_hits[ nodes[ ii ] ] + prior_lookups * graph_hit_rate ) /
+				( node_lookups[ nodes[ ii ] ] + prior_lookups );
+		}
+		edge->update_pair_energy_cache_demand( hit_rate );
+		edges.push_back( edge );
+		max_sizes.push_back( edge->pair_energy_cache_max_size() );
+		demands.push_back( edge->pair_energy_cache_demand() );
+		total_demand += demands.back();
+	}
+	if ( total_demand == 0.0 ) {
+		for ( Size ii = 1; ii <= edges.size(); ++ii ) {
+			demands[ ii ] = max_sizes[ ii ];
+			total_demand += demands[ ii ];
+		}
+	}
+
+	// water filling: hand the edges that cannot use their share everything they can use, and
+	// divide the rest among the others
+	utility::vector1< Real > shares( edges.size(), 0.0 );
+	utility::vector1< bool > capped( edges.size(), false );
+	Real budget = Real( pair_energy_cache_budget_ / bytes_per_slot );
+	bool any_capped = true;
+	while ( any_capped && total_demand > 0.0 ) {
+		any_capped = false;
+		for ( Size ii = 1; ii <= edges.size(); ++ii ) {
+			if ( capped[ ii ] || demands[ ii ] == 0.0 ) continue;
+			if ( budget * demands[ ii ] / total_demand >= max_sizes[ ii ] ) {
+				capped[ ii ] = true;
+				any_capped = true;
+				shares[ ii ] = max_sizes[ ii ];
+				budget -= max_sizes[ ii ];
+				total_demand -= demands[ ii ];
+			}
+		}
+	}
+	for ( Size ii = 1; ii <= edges.size(); ++ii ) {
+		if ( ! capped[ ii ] && total_demand > 0.0 ) shares[ ii ] = budget * demands[ ii ] / total_demand;
+	}
+
+	for ( Size ii = 1; ii <= edges.size(); ++ii ) {
+		Size size = 1;
+		while ( size * 2 <= shares[ ii ] ) size *= 2;
+		edges[ ii ]->resize_pair_energy_cache( size < min_cache_size ? 0 : size );
+	}
+}
+
+void
+LinearMemoryInteractionGraph::report_pair_energy_cache_statistics() const
+{
+	Size lookups( 0 ), hits( 0 ), slots( 0 ), edges_with_cache( 0 ), num_edges( 0 );
+	for ( std::list< EdgeBase* >::const_iterator iter = get_edge_list_begin();
+			iter != get_edge_list_end(); ++iter ) {
+		LinearMemEdge const * edge = static_cast< LinearMemEdge const * >( *iter );
+		lookups += edge->pair_energy_cache_lookups();
+		hits += edge->pair_energy_cache_hits();
+		slots += edge->pair_energy_cache_size();
+		if ( edge->pair_energy_cache_size() != 0 ) ++edges_with_cache;
+		++num_edges;
+	}
+	TR_cache << "pair energy cache: " << lookups << " lookups, " << hits << " hits";
+	if ( lookups != 0 ) TR_cache << " (" << 100.0 * hits / lookups << "%)";
+	TR_cache << "; " << get_num_rpe_calculations_count() << " pair energies computed; "
+		<< slots * ( sizeof( unsigned int ) + sizeof( core::PackerEnergy ) ) << " of "
+		<< pair_energy_cache_budget_ << " bytes on " << edges_with_cache << " of " << num_edges << " edges" << std::endl;
+}
+
 /*
 bool
 LinearMemoryInteractionGraph::build_sc_only_rotamer() const
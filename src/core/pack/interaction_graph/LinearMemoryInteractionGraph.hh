@@ -22,6 +22,7 @@
 
 #include <ObjexxFCL/FArray3D.hh>
 
+#include <utility/vector0.hh>
 #include <utility/vector1.hh>
 #include <utility/recent_history_queue.hh>
 
@@ -213,6 +214,11 @@ private:
 	core::PackerEnergy alternate_state_total_energy_;
 	utility::vector1< core::PackerEnergy > alternate_state_two_body_energies_;
 
+	// the edges whose energies for the alternate state were not stored, computed as one row
+	utility::vector1< int > uncached_edges_;
+	utility::vector1< int > uncached_neighbor_states_;
+	utility::vector1< core::PackerEnergy > uncached_energies_;
+
 	bool alternate_state_is_being_considered_;
 	bool already_prepped_for_simA_;
 
@@ -303,6 +309,31 @@ public:
 		int other_node_state_recent_history_index
 	);
 
+	/// @brief the first half of get_energy_for_alt_state: the stored energy, or
+	/// NOT_YET_COMPUTED_ENERGY if the energy has to be computed
+	core::PackerEnergy
+	get_stored_energy_for_alt_state
+	(
+		bool store_rpes,
+		int changing_node_index,
+		int alternate_state,
+		int alternate_state_recent_history_index,
+		int other_node_curr_state,
+		int other_node_state_recent_history_index
+	);
+
+	/// @brief the second half of get_energy_for_alt_state: remember the computed energy
+	void
+	store_energy_for_alt_state
+	(
+		int changing_node_index,
+		int alternate_state,
+		int alternate_state_recent_history_index,
+		int other_node_curr_state,
+		int other_node_state_recent_history_index,
+		core::PackerEnergy energy
+	);
+
 	inline
 	void acknowledge_substitution(
 		int substituted_node_index,
@@ -330,6 +361,32 @@ public:
 
 	virtual void set_edge_weight( Real weight );
 
+	/// @brief the number of slots in the pair energy cache of this edge
+	Size pair_energy_cache_size() const { return cache_energies_.size(); }
+
+	/// @brief the largest pair energy cache worth giving this edge: one that can hold every
+	/// state pair, or 0 if the state pairs cannot be numbered in an unsigned int
+	Size pair_energy_cache_max_size() const;
+
+	/// @brief resize the pair energy cache, keeping the entries that still fit; new_size must be
+	/// 0 or a power of 2
+	void resize_pair_energy_cache( Size new_size );
+
+	/// @brief the demand for the pair energy cache of this edge: the number of lookups since
+	/// the last call to update_pair_energy_cache_demand times the hit rate given to it, plus half
+	/// of the demand before
+	Real pair_energy_cache_demand() const { return cache_demand_; }
+
+	void update_pair_energy_cache_demand( Real hit_rate );
+
+	/// @brief the pair energy cache lookups and hits since the last update_pair_energy_cache_demand
+	Size pair_energy_cache_recent_lookups() const { return cache_lookups_; }
+	Size pair_energy_cache_recent_hits() const { return cache_hits_; }
+
+	/// @brief the pair energy cache lookups and hits since the last prepare_for_simulated_annealing
+	Size pair_energy_cache_lookups() const { return cache_total_lookups_; }
+	Size pair_energy_cache_hits() const { return cache_total_hits_; }
+
 protected:
 
 	//Hooks for SASAEdge< V, E, G > class
@@ -356,6 +413,28 @@ private:
 
 	void wipe( int node );
 
+	/// @brief write alt_state_energy_ into the recent history tables
+	void
+	store_alt_state_energy_for_recent_history(
+		int node_changing,
+		int alternate_state,
+		int alternate_state_recent_history_index,
+		int other_node_curr_state,
+		int other_node_state_recent_history_index
+	);
+
+	/// @brief the energy of the state pair from the pair energy cache, or NOT_YET_COMPUTED_ENERGY
+	core::PackerEnergy cached_pair_energy( int node1_state, int node2_state );
+	void cache_pair_energy( int node1_state, int node2_state, core::PackerEnergy energy );
+
+	inline
+	Size
+	pair_energy_cache_slot( unsigned int key ) const
+	{
+		// Fibonacci hashing: the high bits of the product
+		return ( key * 2654435769u ) >> cache_shift_;
+	}
+
 	bool store_rpes_[ 2 ];
 	ObjexxFCL::FArray2D< core::PackerEnergy > stored_rpes_[ 2 ];
 	ObjexxFCL::FArray2D< unsigned char > sparse_aa_neighbors_;
@@ -364,6 +443,18 @@ private:
 	bool partial_state_assignment_;
 	bool preped_for_sim_annealing_;
 
+	// Direct mapped cache of the pair energies that fell out of the recent history tables, keyed
+	// by ( node1_state - 1 ) * node2_num_states + node2_state; key 0 marks an empty slot.  The
+	// LinearMemoryInteractionGraph sizes the caches of all edges from one memory budget.
+	utility::vector0< unsigned int > cache_keys_;
+	utility::vector0< core::PackerEnergy > cache_energies_;
+	int cache_shift_;
+	Size cache_lookups_;
+	Size cache_hits_;
+	Real cache_demand_;
+	Size cache_total_lookups_;
+	Size cache_total_hits_;
+
 	//no default constructor, uncopyable
 	LinearMemEdge();
 	LinearMemEdge( LinearMemEdge const & );
@@ -398,6 +489,16 @@ public:
 	void set_recent_history_size( Size recent_history_size );
 	Size get_recent_history_size() const;
 
+	/// @brief The memory budget in bytes shared by the pair energy caches of all edges, which keep
+	/// the pair energies that fell out of the recent history tables; 0 turns the caches off.
+	/// Initialized from -packing:linmem_ig_cache_mb.
+	void set_pair_energy_cache_budget( Size bytes );
+	Size get_pair_energy_cache_budget() const;
+
+	/// @brief Trace the lookups and hits of the pair energy caches since the start of annealing
+	/// and the number of pair energies computed.
+	void report_pair_energy_cache_statistics() const;
+
 	//bool build_sc_only_rotamer() const;
 
 	virtual unsigned int count_static_memory() const;
@@ -428,6 +529,10 @@ private:
 	/// @brief Set the recent history size for all nodes in the graph
 	void set_recent_history_sizes();
 
+	/// @brief Divide the pair energy cache budget among the edges in proportion to their demand,
+	/// weighted by the hit rates of their nodes, giving no edge more than it can use.
+	void rebalance_pair_energy_caches();
+
 	bool first_time_prepping_for_simA_;
 	int num_commits_since_last_update_;
 	core::PackerEnergy total_energy_current_state_assignment_;
@@ -437,7 +542,11 @@ private:
 
 	bool have_not_committed_last_substitution_;
 
+	Size pair_energy_cache_budget_;
+	int num_substitutions_since_cache_rebalance_;
+
 	static const int COMMIT_LIMIT_BETWEEN_UPDATES = 1024; // 2^10
+	static const int SUBSTITUTIONS_BETWEEN_CACHE_REBALANCES = 65536; // 2^16
 
 	//no default constructor, uncopyable
 	LinearMemoryInteractionGraph();
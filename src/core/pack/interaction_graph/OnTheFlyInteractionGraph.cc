@@ -22,11 +22,14 @@
 #include <core/conformation/Residue.hh>
 #include <core/pose/Pose.hh>
 #include <core/scoring/ScoreFunction.hh>
+#include <core/scoring/ScoreType.hh>
 #include <core/scoring/util.hh>
 #include <core/scoring/methods/LongRangeTwoBodyEnergy.hh>
 
 // Utility headers
 #include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/packing.OptionKeys.gen.hh>
 
 #include <iostream>
 
@@ -51,6 +54,7 @@ OnTheFlyNode::OnTheFlyNode(
 	rotamer_set_( /* 0 */ ),
 	rotamers_( num_states ),
 	sc_bounding_spheres_( num_states, std::make_pair( Vector( 0.0 ), Real( 0.0 ) ) ),
+	sc_atoms_( num_states ),
 	bb_bounding_sphere_( std::make_pair( Vector( 0.0 ), Real( 0.0 ) )),
 	num_aa_types_( get_on_the_fly_owner()->get_num_aatypes() ),
 	num_states_for_aatype_( num_aa_types_, 0 ),
@@ -82,6 +86,7 @@ OnTheFlyNode::set_rotamers(
 		}
 		sc_bounding_spheres_[ ii ].first  = scoring::compute_sc_centroid( *rotamers_[ ii ] );
 		sc_bounding_spheres_[ ii ].second = scoring::compute_sc_radius(   *rotamers_[ ii ], sc_bounding_spheres_[ ii ].first );
+		sc_atoms_[ ii ].set( *rotamers_[ ii ] );
 	}
 
 	// figure out which residue-type group each rotamer is a member of
@@ -166,6 +171,9 @@ OnTheFlyNode::count_dynamic_memory() const
 
 	total_memory += rotamers_.size() * sizeof ( conformation::ResidueCOP );
 	total_memory += sc_bounding_spheres_.size() * sizeof( BoundingSphere );
+	for ( Size ii = 1; ii <= sc_atoms_.size(); ++ii ) {
+		total_memory += sizeof( SidechainAtomBuffer ) + sc_atoms_[ ii ].memory();
+	}
 	total_memory += num_states_for_aatype_.size() * sizeof( int );
 	total_memory += state_offset_for_aatype_.size() * sizeof( int );
 	total_memory += sparse_mat_info_for_state_.size() * sizeof( SparseMatrixIndex );
@@ -181,6 +189,19 @@ OnTheFlyNode::compute_rotamer_pair_energy(
 	int state_this,
 	int state_other
 ) const
+{
+	return compute_rotamer_pair_energy( edge_making_energy_request, state_this, state_other, 0 );
+}
+
+/// @details sc_etable_emap, if not null, holds the etable energies of a side-chain pair that the
+/// sidechain_etable_evaluator() handles, computed already for a whole row.
+core::PackerEnergy
+OnTheFlyNode::compute_rotamer_pair_energy(
+	int edge_making_energy_request,
+	int state_this,
+	int state_other,
+	scoring::EnergyMap const * sc_etable_emap
+) const
 {
 	using namespace scoring;
 	using namespace scoring::methods;
@@ -194,9 +215,31 @@ OnTheFlyNode::compute_rotamer_pair_energy(
 
 	if ( spanning_edge.short_range_interactions_exist() ) {
 		EnergyMap tbody_emap;
+		// the score function whose weights go with tbody_emap
+		ScoreFunction const * sr_sfxn( & get_on_the_fly_owner()->score_function() );
 
 		switch ( spanning_edge.eval_type( get_node_index() )) {
-		case ( sc_sc ) :
+		case ( sc_sc ) : {
+			SidechainEtableEvaluator const * sc_etable( get_on_the_fly_owner()->sidechain_etable_evaluator() );
+			if ( sc_etable_emap ) {
+				esum += static_cast< core::PackerEnergy > ( sr_sfxn->weights().dot( *sc_etable_emap ) );
+				sr_sfxn = & get_on_the_fly_owner()->score_function_without_etable();
+			} else if ( sc_etable && sc_etable->handles( get_rotamer( state_this ), neighbor.get_rotamer( state_other ) ) ) {
+				EnergyMap etable_emap;
+				sc_etable->sidechain_sidechain_energy(
+					get_rotamer( state_this ),
+					sc_atoms( state_this ),
+					sc_bounding_sphere( state_this ).first,
+					sc_bounding_sphere( state_this ).second,
+					neighbor.get_rotamer( state_other ),
+					neighbor.sc_atoms( state_other ),
+					neighbor.sc_bounding_sphere( state_other ).first,
+					neighbor.sc_bounding_sphere( state_other ).second,
+					etable_emap );
+				esum += static_cast< core::PackerEnergy > ( sr_sfxn->weights().dot( etable_emap ) );
+				sr_sfxn = & get_on_the_fly_owner()->score_function_without_etable();
+			}
+
 			scoring::eval_scsc_sr2b_energies(
 				get_rotamer( state_this ),
 				neighbor.get_rotamer( state_other ),
@@ -205,7 +248,7 @@ OnTheFlyNode::compute_rotamer_pair_energy(
 				sc_bounding_sphere( state_this ).second,
 				neighbor.sc_bounding_sphere( state_other ).second,
 				get_on_the_fly_owner()->pose(),
-				get_on_the_fly_owner()->score_function(),
+				*sr_sfxn,
 				tbody_emap );
 
 			/*get_on_the_fly_owner()->score_function().eval_ci_2b_sc_sc(
@@ -222,6 +265,7 @@ OnTheFlyNode::compute_rotamer_pair_energy(
 			);*/
 
 			break;
+		}
 		case ( sc_whole ) :
 			get_on_the_fly_owner()->score_function().eval_ci_2b_sc_sc(
 				get_rotamer( state_this ),
@@ -296,7 +340,7 @@ OnTheFlyNode::compute_rotamer_pair_energy(
 
 			break;
 		}
-		esum += static_cast< core::PackerEnergy > ( get_on_the_fly_owner()->score_function().weights().dot( tbody_emap ) );
+		esum += static_cast< core::PackerEnergy > ( sr_sfxn->weights().dot( tbody_emap ) );
 
 	}
 
@@ -340,6 +384,57 @@ OnTheFlyNode::compute_rotamer_pair_energy(
 
 }
 
+/// @details The etable energies of the side-chain pairs that the sidechain_etable_evaluator()
+/// handles are evaluated for the whole row in one pass; the other terms and the other pairs are
+/// computed one at a time as by compute_rotamer_pair_energy, and the energies are the same.
+void
+OnTheFlyNode::compute_rotamer_pair_energies(
+	int state_this,
+	utility::vector1< int > const & edges,
+	utility::vector1< int > const & states_other,
+	utility::vector1< core::PackerEnergy > & energies
+) const
+{
+	debug_assert( edges.size() == states_other.size() );
+
+	SidechainEtableEvaluator const * sc_etable( get_on_the_fly_owner()->sidechain_etable_evaluator() );
+	utility::vector1< SidechainEtablePartner > partners;
+	utility::vector1< Size > partner_for_entry( edges.size(), 0 );
+	if ( sc_etable ) {
+		for ( Size ii = 1; ii <= edges.size(); ++ii ) {
+			OnTheFlyEdge const & spanning_edge( * get_incident_otf_edge( edges[ ii ] ) );
+			if ( ! spanning_edge.short_range_interactions_exist() || spanning_edge.eval_type( get_node_index() ) != sc_sc ) continue;
+			OnTheFlyNode const & neighbor( * get_adjacent_otf_node( edges[ ii ] ) );
+			if ( ! sc_etable->handles( get_rotamer( state_this ), neighbor.get_rotamer( states_other[ ii ] ) ) ) continue;
+			SidechainEtablePartner partner;
+			partner.rsd = & neighbor.get_rotamer( states_other[ ii ] );
+			partner.atoms = & neighbor.sc_atoms( states_other[ ii ] );
+			partner.sc_centroid = neighbor.sc_bounding_sphere( states_other[ ii ] ).first;
+			partner.sc_radius = neighbor.sc_bounding_sphere( states_other[ ii ] ).second;
+			partner.emap = 0;
+			partners.push_back( partner );
+			partner_for_entry[ ii ] = partners.size();
+		}
+	}
+
+	utility::vector1< scoring::EnergyMap > etable_emaps( partners.size() );
+	if ( ! partners.empty() ) {
+		for ( Size ii = 1; ii <= partners.size(); ++ii ) partners[ ii ].emap = & etable_emaps[ ii ];
+		sc_etable->sidechain_sidechain_energies(
+			get_rotamer( state_this ),
+			sc_atoms( state_this ),
+			sc_bounding_sphere( state_this ).first,
+			sc_bounding_sphere( state_this ).second,
+			partners );
+	}
+
+	energies.resize( edges.size() );
+	for ( Size ii = 1; ii <= edges.size(); ++ii ) {
+		energies[ ii ] = compute_rotamer_pair_energy( edges[ ii ], state_this, states_other[ ii ],
+			partner_for_entry[ ii ] ? & etable_emaps[ partner_for_entry[ ii ] ] : 0 );
+	}
+}
+
 
 //-------------------------------------------------------------//
 
@@ -461,6 +556,19 @@ OnTheFlyInteractionGraph::set_score_function( ScoreFunction const & sfxn )
 {
 	score_function_ = sfxn.clone();
 	if ( pose_ ) ( *score_function_)(*pose_); // rescore the pose with the input score function
+
+	sidechain_etable_evaluator_.reset();
+	score_function_without_etable_.reset();
+	if ( basic::options::option[ basic::options::OptionKeys::packing::vectorize_otf_etable ]() ) {
+		SidechainEtableEvaluatorOP evaluator( new SidechainEtableEvaluator( *score_function_ ) );
+		if ( evaluator->active() ) {
+			sidechain_etable_evaluator_ = evaluator;
+			score_function_without_etable_ = score_function_->clone();
+			score_function_without_etable_->set_weight( scoring::fa_atr, 0.0 );
+			score_function_without_etable_->set_weight( scoring::fa_rep, 0.0 );
+			score_function_without_etable_->set_weight( scoring::fa_sol, 0.0 );
+		}
+	}
 }
 
 void
@@ -20,6 +20,7 @@
 // Package headers
 #include <core/pack/interaction_graph/SparseMatrixIndex.hh>
 #include <core/pack/interaction_graph/FixedBBInteractionGraph.hh>
+#include <core/pack/interaction_graph/SidechainEtableEvaluator.hh>
 
 #include <core/pack/rotamer_set/RotamerSet.fwd.hh>
 
@@ -30,6 +31,7 @@
 #endif
 
 #include <core/pose/Pose.fwd.hh>
+#include <core/scoring/EnergyMap.fwd.hh>
 #include <core/scoring/ScoreFunction.fwd.hh>
 
 // Numeric headers
@@ -149,6 +151,17 @@ public:
 		int state_other
 	) const;
 
+	/// @brief The energies of state_this with the states of the neighbors across several edges:
+	/// energies[ ii ] is the energy with state states_other[ ii ] of the neighbor across edges[ ii ].
+	/// The side-chain etable energies of the whole row are evaluated in one pass.
+	void
+	compute_rotamer_pair_energies(
+		int state_this,
+		utility::vector1< int > const & edges,
+		utility::vector1< int > const & states_other,
+		utility::vector1< core::PackerEnergy > & energies
+	) const;
+
 protected:
 
 	inline
@@ -192,10 +205,27 @@ protected:
 	inline
 	BoundingSphere const & bb_bounding_sphere() const { return bb_bounding_sphere_; }
 
+	inline
+	SidechainAtomBuffer const &
+	sc_atoms( int state ) const
+	{
+		return sc_atoms_[ state ];
+	}
+
+private:
+	core::PackerEnergy
+	compute_rotamer_pair_energy(
+		int edge_making_energy_request,
+		int state_this,
+		int state_other,
+		scoring::EnergyMap const * sc_etable_emap
+	) const;
+
 private:
 	rotamer_set::RotamerSetCOP rotamer_set_;
 	utility::vector1< conformation::ResidueCOP > rotamers_;
 	utility::vector1< BoundingSphere > sc_bounding_spheres_;
+	utility::vector1< SidechainAtomBuffer > sc_atoms_;
 	BoundingSphere bb_bounding_sphere_;
 
 	int num_aa_types_; // rename num_aa_groups_
@@ -344,6 +374,25 @@ public:
 		return *score_function_;
 	}
 
+	/// @brief The evaluator of the etable energies between side chains, or null if the score function
+	/// has no etable method or -packing:vectorize_otf_etable is off.
+	inline
+	SidechainEtableEvaluator const *
+	sidechain_etable_evaluator() const
+	{
+		return sidechain_etable_evaluator_.get();
+	}
+
+	/// @brief the score function with fa_atr, fa_rep and fa_sol weighted zero, for the residue pairs
+	/// whose etable energies come from the sidechain_etable_evaluator()
+	inline
+	ScoreFunction const &
+	score_function_without_etable() const
+	{
+		debug_assert( score_function_without_etable_ );
+		return *score_function_without_etable_;
+	}
+
 	/*
 	// for using ResidueWeightMap
 	inline void set_residue_weight_map(PackerTaskResidueWeightMap const & residue_weight_map_in) {
@@ -451,6 +500,8 @@ private:
 	mutable Size num_rpe_calcs_;
 
 	scoring::ScoreFunctionOP score_function_;
+	SidechainEtableEvaluatorOP sidechain_etable_evaluator_;
+	scoring::ScoreFunctionOP score_function_without_etable_;
 	pose::PoseOP pose_;
 
 	// Additional per-residue (or per-residue-per-aa) weights
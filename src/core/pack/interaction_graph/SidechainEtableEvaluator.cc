@@ -0,0 +1,241 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/pack/interaction_graph/SidechainEtableEvaluator.cc
+/// @brief  fa_atr, fa_rep and fa_sol between the side chains of two rotamers, for the on-the-fly
+/// interaction graphs
+
+// Unit headers
+#include <core/pack/interaction_graph/SidechainEtableEvaluator.hh>
+
+// Project headers
+#include <core/conformation/Residue.hh>
+#include <core/chemical/AtomType.hh>
+#include <core/scoring/EnergyMap.hh>
+#include <core/scoring/ScoreFunction.hh>
+#include <core/scoring/etable/EtableEnergy.hh>
+#include <core/scoring/etable/atom_pair_energy_inline.hh>
+
+// C++ headers
+#include <algorithm>
+
+namespace core {
+namespace pack {
+namespace interaction_graph {
+
+namespace {
+
+/// @brief count pair function of residues without bonds between them: every pair counts fully
+struct CountAllPairs {
+	bool
+	operator() ( int, int, Real &, Size & ) const
+	{
+		return true;
+	}
+};
+
+/// @brief squared distance error the float coordinates may introduce, in A^2
+float const prefilter_margin = 0.25f;
+
+}
+
+void
+SidechainAtomBuffer::set( conformation::Residue const & rotamer )
+{
+	x.clear(); y.clear(); z.clear(); atomno.clear();
+	for ( Size ii = rotamer.first_sidechain_atom(); ii <= rotamer.nheavyatoms(); ++ii ) {
+		if ( rotamer.atom_type( ii ).is_virtual() ) continue;
+		Vector const & xyz( rotamer.xyz( ii ) );
+		x.push_back( xyz.x() );
+		y.push_back( xyz.y() );
+		z.push_back( xyz.z() );
+		atomno.push_back( ii );
+	}
+}
+
+SidechainEtableEvaluator::SidechainEtableEvaluator( scoring::ScoreFunction const & sfxn ) :
+	table_lookup_method_( 0 ),
+	analytic_method_( 0 ),
+	interaction_cutoff_( 0 ),
+	prefilter_d2_( 0 )
+{
+	using namespace scoring::etable;
+
+	for ( scoring::ScoreFunction::CI_2B_Methods::const_iterator
+			iter = sfxn.ci_2b_begin(), iter_end = sfxn.ci_2b_end(); iter != iter_end; ++iter ) {
+		if ( ! table_lookup_method_ ) table_lookup_method_ = dynamic_cast< TableLookupEtableEnergy const * >( iter->get() );
+		if ( ! analytic_method_ ) analytic_method_ = dynamic_cast< AnalyticEtableEnergy const * >( iter->get() );
+	}
+
+	Real hydrogen_cutoff2( 0 );
+	if ( table_lookup_method_ ) {
+		interaction_cutoff_ = table_lookup_method_->atomic_interaction_cutoff();
+		hydrogen_cutoff2 = table_lookup_method_->interres_evaluator().hydrogen_interaction_cutoff2();
+	} else if ( analytic_method_ ) {
+		interaction_cutoff_ = analytic_method_->atomic_interaction_cutoff();
+		hydrogen_cutoff2 = analytic_method_->interres_evaluator().hydrogen_interaction_cutoff2();
+	}
+	prefilter_d2_ = static_cast< float >( std::max( interaction_cutoff_ * interaction_cutoff_, hydrogen_cutoff2 ) ) + prefilter_margin;
+}
+
+SidechainEtableEvaluator::~SidechainEtableEvaluator() {}
+
+bool
+SidechainEtableEvaluator::active() const
+{
+	return table_lookup_method_ || analytic_method_;
+}
+
+bool
+SidechainEtableEvaluator::handles( conformation::Residue const & rsd1, conformation::Residue const & rsd2 ) const
+{
+	if ( rsd1.is_pseudo_bonded( rsd2.seqpos() ) || rsd1.is_bonded( rsd2 ) ) return false;
+	// the etable counts atom pairs across the middle residue by path distance
+	if ( rsd1.polymeric_sequence_distance( rsd2 ) == 2 ) return false;
+	if ( table_lookup_method_ ) return table_lookup_method_->calculate_interres( rsd1, rsd2 );
+	if ( analytic_method_ ) return analytic_method_->calculate_interres( rsd1, rsd2 );
+	return false;
+}
+
+void
+SidechainEtableEvaluator::sidechain_sidechain_energy(
+	conformation::Residue const & rsd1,
+	SidechainAtomBuffer const & atoms1,
+	Vector const & sc_centroid1,
+	Real sc_radius1,
+	conformation::Residue const & rsd2,
+	SidechainAtomBuffer const & atoms2,
+	Vector const & sc_centroid2,
+	Real sc_radius2,
+	scoring::EnergyMap & emap
+) const
+{
+	utility::vector1< SidechainEtablePartner > partners( 1 );
+	partners[ 1 ].rsd = &rsd2;
+	partners[ 1 ].atoms = &atoms2;
+	partners[ 1 ].sc_centroid = sc_centroid2;
+	partners[ 1 ].sc_radius = sc_radius2;
+	partners[ 1 ].emap = &emap;
+	sidechain_sidechain_energies( rsd1, atoms1, sc_centroid1, sc_radius1, partners );
+}
+
+void
+SidechainEtableEvaluator::sidechain_sidechain_energies(
+	conformation::Residue const & rsd1,
+	SidechainAtomBuffer const & atoms1,
+	Vector const & sc_centroid1,
+	Real sc_radius1,
+	utility::vector1< SidechainEtablePartner > const & partners
+) const
+{
+	// the partners whose side-chain bounding spheres are within reach, as the score function's
+	// short-ranged side-chain evaluation would skip the others
+	utility::vector1< Size > row_partners;
+	utility::vector1< Size > row_begin;
+	Size natoms( 0 );
+	for ( Size ii = 1; ii <= partners.size(); ++ii ) {
+		SidechainEtablePartner const & partner( partners[ ii ] );
+		Real const cutoff( sc_radius1 + partner.sc_radius + interaction_cutoff_ );
+		if ( sc_centroid1.distance_squared( partner.sc_centroid ) >= cutoff * cutoff ) continue;
+		if ( partner.atoms->size() == 0 ) continue;
+		row_partners.push_back( ii );
+		row_begin.push_back( natoms );
+		natoms += partner.atoms->size();
+	}
+	row_begin.push_back( natoms );
+	if ( row_partners.empty() || atoms1.size() == 0 ) return;
+
+	// a single partner's buffer is used as it is
+	SidechainAtomBuffer gathered;
+	if ( row_partners.size() > 1 ) {
+		gathered.x.reserve( natoms ); gathered.y.reserve( natoms ); gathered.z.reserve( natoms ); gathered.atomno.reserve( natoms );
+		for ( Size ii = 1; ii <= row_partners.size(); ++ii ) {
+			SidechainAtomBuffer const & atoms( *partners[ row_partners[ ii ] ].atoms );
+			gathered.x.insert( gathered.x.end(), atoms.x.begin(), atoms.x.end() );
+			gathered.y.insert( gathered.y.end(), atoms.y.begin(), atoms.y.end() );
+			gathered.z.insert( gathered.z.end(), atoms.z.begin(), atoms.z.end() );
+			gathered.atomno.insert( gathered.atomno.end(), atoms.atomno.begin(), atoms.atomno.end() );
+		}
+	}
+	SidechainAtomBuffer const & row_atoms( row_partners.size() > 1 ? gathered : *partners[ row_partners[ 1 ] ].atoms );
+
+	if ( table_lookup_method_ ) {
+		evaluate_row( table_lookup_method_->interres_evaluator(), rsd1, atoms1, partners, row_partners, row_begin, row_atoms );
+	} else if ( analytic_method_ ) {
+		evaluate_row( analytic_method_->interres_evaluator(), rsd1, atoms1, partners, row_partners, row_begin, row_atoms );
+	}
+}
+
+/// @details For each partner, the same sums in the same order as inline_residue_atom_pair_energy()
+/// with a count-all count pair function; the distance prefilter only skips pairs the etable would
+/// give no energy.
+template < class Evaluator >
+void
+SidechainEtableEvaluator::evaluate_row(
+	Evaluator const & evaluator,
+	conformation::Residue const & rsd1,
+	SidechainAtomBuffer const & atoms1,
+	utility::vector1< SidechainEtablePartner > const & partners,
+	utility::vector1< Size > const & row_partners,
+	utility::vector1< Size > const & row_begin,
+	SidechainAtomBuffer const & row_atoms
+) const
+{
+	Size const n1( atoms1.size() ), n2( row_atoms.size() );
+
+	Real const hydrogen_cutoff2( evaluator.hydrogen_interaction_cutoff2() );
+	utility::vector1< Size > const & r1hbegin( rsd1.attached_H_begin() );
+	utility::vector1< Size > const & r1hend( rsd1.attached_H_end() );
+	CountAllPairs const count_pair = CountAllPairs();
+
+	float const * x2( &row_atoms.x[ 0 ] );
+	float const * y2( &row_atoms.y[ 0 ] );
+	float const * z2( &row_atoms.z[ 0 ] );
+	utility::vector0< float > d2_row( n2 );
+	float * d2( &d2_row[ 0 ] );
+
+	for ( Size ii = 0; ii < n1; ++ii ) {
+		float const x1( atoms1.x[ ii ] ), y1( atoms1.y[ ii ] ), z1( atoms1.z[ ii ] );
+		int const at1( atoms1.atomno[ ii ] );
+		conformation::Atom const & atom1( rsd1.atom( at1 ) );
+
+		// distances to the atoms of every partner at once
+		for ( Size jj = 0; jj < n2; ++jj ) {
+			float const dx( x2[ jj ] - x1 );
+			float const dy( y2[ jj ] - y1 );
+			float const dz( z2[ jj ] - z1 );
+			d2[ jj ] = dx * dx + dy * dy + dz * dz;
+		}
+
+		for ( Size pp = 1; pp <= row_partners.size(); ++pp ) {
+			conformation::Residue const & rsd2( *partners[ row_partners[ pp ] ].rsd );
+			scoring::EnergyMap & emap( *partners[ row_partners[ pp ] ].emap );
+			utility::vector1< Size > const & r2hbegin( rsd2.attached_H_begin() );
+			utility::vector1< Size > const & r2hend( rsd2.attached_H_end() );
+			for ( Size jj = row_begin[ pp ]; jj < row_begin[ pp + 1 ]; ++jj ) {
+				if ( d2[ jj ] >= prefilter_d2_ ) continue;
+				int const at2( row_atoms.atomno[ jj ] );
+				conformation::Atom const & atom2( rsd2.atom( at2 ) );
+				DistanceSquared dsq;
+				evaluator.atom_pair_energy( atom1, atom2, 1.0, emap, dsq );
+				if ( dsq < hydrogen_cutoff2 ) {
+					scoring::residue_fast_pair_energy_attached_H(
+						rsd1, at1, rsd2, at2,
+						r1hbegin[ at1 ], r1hend[ at1 ],
+						r2hbegin[ at2 ], r2hend[ at2 ],
+						count_pair, evaluator, emap );
+				}
+			}
+		}
+	}
+}
+
+}
+}
+}
@@ -0,0 +1,152 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   core/pack/interaction_graph/SidechainEtableEvaluator.hh
+/// @brief  fa_atr, fa_rep and fa_sol between the side chains of two rotamers, for the on-the-fly
+/// interaction graphs
+/// @details Each rotamer keeps its side-chain heavy atoms as a SidechainAtomBuffer: contiguous float
+/// coordinates plus the atom indices into the rotamer.  A row of energies, one rotamer against the
+/// current rotamers of its neighbors, is evaluated in one pass: the side-chain atoms of all neighbors
+/// within reach are gathered into one buffer, and for each atom of the rotamer the squared distances
+/// to the whole buffer are computed in one branch-free loop, which is left to the compiler to
+/// vectorize; there are no intrinsics.  Only the pairs within the interaction distance go on to the
+/// etable's own evaluator (table lookup or analytic) and to its attached-hydrogen loop.  The energies
+/// are those of the etable method's sidechain_sidechain_energy for residues without chemical bonds or
+/// pseudobonds between them, which count every atom pair.  Other residue pairs are left to the
+/// score function.
+///
+/// The evaluator is used only with -packing:vectorize_otf_etable, which is off by default: it covers
+/// the etable terms alone, and it has not been timed against the score function path.
+
+#ifndef INCLUDED_core_pack_interaction_graph_SidechainEtableEvaluator_hh
+#define INCLUDED_core_pack_interaction_graph_SidechainEtableEvaluator_hh
+
+// Unit headers
+#include <core/pack/interaction_graph/SidechainEtableEvaluator.fwd.hh>
+
+// Project headers
+#include <core/types.hh>
+#include <core/conformation/Residue.fwd.hh>
+#include <core/scoring/EnergyMap.fwd.hh>
+#include <core/scoring/ScoreFunction.fwd.hh>
+#include <core/scoring/etable/EtableEnergy.fwd.hh>
+
+// Numeric headers
+#include <numeric/xyzVector.hh>
+
+// Utility headers
+#include <utility/pointer/ReferenceCount.hh>
+#include <utility/vector0.hh>
+#include <utility/vector1.hh>
+
+namespace core {
+namespace pack {
+namespace interaction_graph {
+
+/// @brief the non-virtual side-chain heavy atoms of a rotamer, coordinates as float arrays
+struct SidechainAtomBuffer {
+	utility::vector0< float > x;
+	utility::vector0< float > y;
+	utility::vector0< float > z;
+	/// @brief index of each atom in the rotamer
+	utility::vector0< int > atomno;
+
+	void set( conformation::Residue const & rotamer );
+
+	Size size() const { return atomno.size(); }
+
+	Size memory() const { return atomno.size() * ( 3 * sizeof( float ) + sizeof( int ) ); }
+};
+
+/// @brief one neighbor rotamer in a row of SidechainEtableEvaluator::sidechain_sidechain_energies
+struct SidechainEtablePartner {
+	conformation::Residue const * rsd;
+	SidechainAtomBuffer const * atoms;
+	Vector sc_centroid;
+	Real sc_radius;
+	/// @brief where the energies are added
+	scoring::EnergyMap * emap;
+};
+
+class SidechainEtableEvaluator : public utility::pointer::ReferenceCount
+{
+public:
+	typedef numeric::xyzVector< Real > Vector;
+
+public:
+	/// @brief Evaluates the etable method of sfxn, which must outlive this evaluator.
+	SidechainEtableEvaluator( scoring::ScoreFunction const & sfxn );
+
+	virtual ~SidechainEtableEvaluator();
+
+	/// @brief Does the score function have a table lookup or analytic etable method?
+	bool active() const;
+
+	/// @brief Can the energies between the side chains of these residues be evaluated here?
+	/// True unless they are bonded, pseudobonded or two residues apart in the same chain, where the
+	/// etable method would not count all atom pairs, or the method skips the pair altogether.
+	bool
+	handles( conformation::Residue const & rsd1, conformation::Residue const & rsd2 ) const;
+
+	/// @brief Add the fa_atr, fa_rep and fa_sol between the side chains of rsd1 and rsd2 to emap.  Like
+	/// the score function's short-ranged side-chain evaluation, nothing is added if the side-chain
+	/// bounding spheres are farther apart than the interaction cutoff.
+	void
+	sidechain_sidechain_energy(
+		conformation::Residue const & rsd1,
+		SidechainAtomBuffer const & atoms1,
+		Vector const & sc_centroid1,
+		Real sc_radius1,
+		conformation::Residue const & rsd2,
+		SidechainAtomBuffer const & atoms2,
+		Vector const & sc_centroid2,
+		Real sc_radius2,
+		scoring::EnergyMap & emap
+	) const;
+
+	/// @brief Add the fa_atr, fa_rep and fa_sol between the side chains of rsd1 and each partner to the
+	/// partner's emap, with the same values as sidechain_sidechain_energy.  All partners must be handled().
+	void
+	sidechain_sidechain_energies(
+		conformation::Residue const & rsd1,
+		SidechainAtomBuffer const & atoms1,
+		Vector const & sc_centroid1,
+		Real sc_radius1,
+		utility::vector1< SidechainEtablePartner > const & partners
+	) const;
+
+private:
+	/// @brief the energies of rsd1 with the partners listed in row_partners, whose atoms are in
+	/// row_atoms, those of row_partners[ ii ] from row_begin[ ii ] to row_begin[ ii + 1 ]
+	template < class Evaluator >
+	void
+	evaluate_row(
+		Evaluator const & evaluator,
+		conformation::Residue const & rsd1,
+		SidechainAtomBuffer const & atoms1,
+		utility::vector1< SidechainEtablePartner > const & partners,
+		utility::vector1< Size > const & row_partners,
+		utility::vector1< Size > const & row_begin,
+		SidechainAtomBuffer const & row_atoms
+	) const;
+
+private:
+	scoring::etable::TableLookupEtableEnergy const * table_lookup_method_;
+	scoring::etable::AnalyticEtableEnergy const * analytic_method_;
+	Real interaction_cutoff_;
+	/// @brief squared distance below which heavy atom pairs are handed to the etable; includes a
+	/// margin for the float coordinates
+	float prefilter_d2_;
+};
+
+}
+}
+}
+
+#endif
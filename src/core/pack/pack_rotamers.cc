@@ -15,6 +15,7 @@
 #include <core/pack/pack_rotamers.hh>
 
 // Package Headers
+#include <core/pack/dead_end_elimination.hh>
 #include <core/pack/packer_neighbors.hh>
 #include <core/pack/task/PackerTask.hh>
 #include <core/pack/make_symmetric_task.hh>
@@ -26,6 +27,7 @@
 #include <core/pack/annealer/SimAnnealerBase.hh>
 #include <core/pack/interaction_graph/InteractionGraphFactory.hh>
 #include <core/pack/interaction_graph/AnnealableGraphBase.hh>
+#include <core/pack/interaction_graph/LinearMemoryInteractionGraph.hh>
 
 //#include <core/kinematics/FoldTree.hh>
 //#include <core/kinematics/Jump.hh>
@@ -288,6 +290,12 @@ pack_rotamers_run(
 	/// Parameters passed by reference in task's constructor to which it writes at the
 	/// completion of sim annealing.
 
+	if ( basic::options::option[ basic::options::OptionKeys::packing::dee ]() ) {
+		rot_to_pack = prune_rotamers_by_dead_end_elimination( *task, *rotsets, *ig, rot_to_pack,
+			basic::options::option[ basic::options::OptionKeys::packing::dee_pairs ](),
+			basic::options::option[ basic::options::OptionKeys::packing::dee_threads ]() );
+	}
+
 	SimAnnealerBaseOP annealer = AnnealerFactory::create_annealer(
 		task, rot_to_pack, bestrotamer_at_seqpos, bestenergy, start_with_current, ig,
 		rotsets, current_rot_index, calc_rot_freq, rot_freq );
@@ -301,6 +309,12 @@ pack_rotamers_run(
 	PROF_START( basic::SIMANNEALING );
 	annealer->run();
 	PROF_STOP( basic::SIMANNEALING );
+
+	interaction_graph::LinearMemoryInteractionGraphCOP linmem_ig(
+		utility::pointer::dynamic_pointer_cast< interaction_graph::LinearMemoryInteractionGraph const >( ig ) );
+	if ( linmem_ig && linmem_ig->get_pair_energy_cache_budget() != 0 ) {
+		linmem_ig->report_pair_energy_cache_statistics();
+	}
 }
 
 } // namespace pack
@@ -0,0 +1,229 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   core/pack/parallel_residue_trials.cc
+/// @brief  scheduling of rotamer trials and rtmin on residue sets that do not interact
+
+// Unit headers
+#include <core/pack/parallel_residue_trials.hh>
+
+// Project headers
+#include <core/conformation/Residue.hh>
+#include <core/graph/Graph.hh>
+#include <core/pose/Pose.hh>
+#include <core/scoring/Energies.hh>
+#include <core/scoring/LREnergyContainer.hh>
+#include <core/scoring/ScoreFunction.hh>
+#include <core/scoring/methods/LongRangeTwoBodyEnergy.hh>
+
+// Basic headers
+#include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/packing.OptionKeys.gen.hh>
+
+// Numeric headers
+#include <numeric/random/random.hh>
+#include <numeric/random/random_permutation.hh>
+
+// Utility headers
+#include <utility/thread/parallel_for.hh>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <algorithm>
+#endif
+
+namespace core {
+namespace pack {
+
+static THREAD_LOCAL basic::Tracer TR( "core.pack.parallel_residue_trials" );
+
+ResidueTrial::~ResidueTrial() {}
+
+void
+ResidueTrial::accept( pose::Pose & pose, Size seqpos, conformation::Residue const & rsd ) const
+{
+	pose.replace_residue( seqpos, rsd, false );
+}
+
+bool
+use_parallel_residue_trials()
+{
+	return basic::options::option[ basic::options::OptionKeys::packing::trials_threads ]() != 1;
+}
+
+utility::vector1< utility::vector1< Size > >
+independent_residue_sets(
+	pose::Pose const & pose,
+	scoring::ScoreFunction const & sfxn,
+	graph::Graph const & packer_neighbor_graph,
+	utility::vector1< Size > const & residues
+)
+{
+	using namespace scoring;
+
+	utility::vector1< Size > color( pose.total_residue(), 0 );
+	utility::vector1< bool > in_trials( pose.total_residue(), false );
+	for ( Size ii = 1; ii <= residues.size(); ++ii ) in_trials[ residues[ ii ] ] = true;
+
+	utility::vector1< utility::vector1< Size > > sets;
+	utility::vector1< bool > color_taken;
+	for ( Size ii = 1; ii <= residues.size(); ++ii ) {
+		Size const iires = residues[ ii ];
+		color_taken.assign( sets.size() + 1, false );
+
+		for ( graph::Node::EdgeListConstIter
+				eiter = packer_neighbor_graph.get_node( iires )->const_edge_list_begin(),
+				eiter_end = packer_neighbor_graph.get_node( iires )->const_edge_list_end();
+				eiter != eiter_end; ++eiter ) {
+			Size const jjres = (*eiter)->get_other_ind( iires );
+			if ( in_trials[ jjres ] && color[ jjres ] != 0 ) color_taken[ color[ jjres ] ] = true;
+		}
+
+		for ( ScoreFunction::LR_2B_MethodIterator
+				iter = sfxn.long_range_energies_begin(),
+				iter_end = sfxn.long_range_energies_end();
+				iter != iter_end; ++iter ) {
+			LREnergyContainerCOP lrec = pose.energies().long_range_container( (*iter)->long_range_type() );
+			if ( !lrec || lrec->empty() ) continue;
+			for ( ResidueNeighborConstIteratorOP
+					rni = lrec->const_neighbor_iterator_begin( iires ),
+					rniend = lrec->const_neighbor_iterator_end( iires );
+					(*rni) != (*rniend); ++(*rni) ) {
+				Size const jjres = rni->lower_neighbor_id() == iires ? rni->upper_neighbor_id() : rni->lower_neighbor_id();
+				if ( in_trials[ jjres ] && color[ jjres ] != 0 ) color_taken[ color[ jjres ] ] = true;
+			}
+		}
+
+		Size iicolor = 1;
+		while ( color_taken[ iicolor ] ) ++iicolor;
+		if ( iicolor > sets.size() ) sets.resize( iicolor );
+		color[ iires ] = iicolor;
+		sets[ iicolor ].push_back( iires );
+	}
+
+	TR.Debug << residues.size() << " residues in " << sets.size() << " independent sets" << std::endl;
+	return sets;
+}
+
+void
+order_residues_for_coloring( utility::vector1< Size > & residues )
+{
+	if ( basic::options::option[ basic::options::OptionKeys::packing::trials_deterministic ]() ) return;
+	numeric::random::random_permutation( residues, numeric::random::rg() );
+}
+
+#if defined MULTI_THREADED && defined CXX11
+namespace {
+
+/// @brief Do the two poses have the same residue types, position by position?
+bool
+same_residue_types( pose::Pose const & pose1, pose::Pose const & pose2 )
+{
+	if ( pose1.total_residue() != pose2.total_residue() ) return false;
+	for ( Size ii = 1; ii <= pose1.total_residue(); ++ii ) {
+		if ( &pose1.residue_type( ii ) != &pose2.residue_type( ii ) ) return false;
+	}
+	return true;
+}
+
+/// @brief The copies of the pose that threads 2 and up of run_residue_trials() work on, kept from
+/// one call to the next by the thread making the calls.  Packing calls rotamer trials and rtmin over
+/// and over on the same pose, and assigning a pose to a copy of the same sequence only copies what
+/// has changed since, so bringing the kept copies up to date is much cheaper than making new ones.
+/// The copies are only kept while they serve that purpose: all of them are released when the pose
+/// has a different sequence than the last one, and those beyond n_copies when fewer are needed.
+utility::vector1< pose::PoseOP > &
+thread_pose_copies( pose::Pose const & pose, Size n_copies )
+{
+	static THREAD_LOCAL utility::vector1< pose::PoseOP > copies;
+	if ( ! copies.empty() && ! same_residue_types( *copies[ 1 ], pose ) ) copies.clear();
+	copies.resize( n_copies );
+	for ( Size ii = 1; ii <= n_copies; ++ii ) {
+		if ( copies[ ii ] ) {
+			*copies[ ii ] = pose;
+		} else {
+			copies[ ii ] = pose::PoseOP( new pose::Pose( pose ) );
+		}
+	}
+	return copies;
+}
+
+}
+#endif
+
+/// @details With a single thread the trials run on the pose itself; since the residues of a set
+/// do not interact, accepting each residue right away gives the same result.  With more, the calling
+/// thread, which parallel_for() always runs as thread 1, also works on the pose itself, and the other
+/// threads on copies of it.
+bool
+run_residue_trials(
+	pose::Pose & pose,
+	utility::vector1< utility::vector1< Size > > const & residue_sets,
+	ResidueTrial const & trial
+)
+{
+	Size n_threads = basic::options::option[ basic::options::OptionKeys::packing::trials_threads ]();
+	bool replaced_residue( false );
+
+#if defined MULTI_THREADED && defined CXX11
+	Size largest_set( 0 );
+	for ( Size ii = 1; ii <= residue_sets.size(); ++ii ) {
+		largest_set = std::max( largest_set, residue_sets[ ii ].size() );
+	}
+	n_threads = utility::thread::parallel_thread_count( largest_set, n_threads );
+	if ( n_threads > 1 ) {
+		utility::vector1< pose::PoseOP > const & copies( thread_pose_copies( pose, n_threads - 1 ) );
+		utility::vector1< pose::Pose * > poses( 1, &pose );
+		utility::vector1< ResidueTrialOP > trials;
+		for ( Size tt = 1; tt <= n_threads; ++tt ) {
+			if ( tt > 1 ) poses.push_back( copies[ tt - 1 ].get() );
+			trials.push_back( trial.clone() );
+		}
+
+		for ( Size ii = 1; ii <= residue_sets.size(); ++ii ) {
+			utility::vector1< Size > const & set( residue_sets[ ii ] );
+			utility::vector1< conformation::ResidueOP > results( set.size() );
+
+			utility::thread::parallel_for( set.size(), n_threads, [&]( Size jj, Size tt ) {
+				results[ jj ] = trials[ tt ]->trial( *poses[ tt ], set[ jj ] );
+			} );
+
+			for ( Size jj = 1; jj <= set.size(); ++jj ) {
+				if ( ! results[ jj ] ) continue;
+				replaced_residue = true;
+				for ( Size tt = 1; tt <= n_threads; ++tt ) {
+					trials[ tt ]->accept( *poses[ tt ], set[ jj ], *results[ jj ] );
+				}
+			}
+		}
+		return replaced_residue;
+	}
+#else
+	static bool warned( false );
+	if ( n_threads > 1 && ! warned ) {
+		TR.Warning << "-packing:trials_threads needs a multithreaded build; running on one thread." << std::endl;
+		warned = true;
+	}
+#endif
+
+	ResidueTrialOP single_trial( trial.clone() );
+	for ( Size ii = 1; ii <= residue_sets.size(); ++ii ) {
+		for ( Size jj = 1; jj <= residue_sets[ ii ].size(); ++jj ) {
+			conformation::ResidueOP rsd( single_trial->trial( pose, residue_sets[ ii ][ jj ] ) );
+			if ( ! rsd ) continue;
+			replaced_residue = true;
+			single_trial->accept( pose, residue_sets[ ii ][ jj ], *rsd );
+		}
+	}
+	return replaced_residue;
+}
+
+} // namespace pack
+} // namespace core
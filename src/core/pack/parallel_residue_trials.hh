@@ -0,0 +1,96 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   core/pack/parallel_residue_trials.hh
+/// @brief  scheduling of rotamer trials and rtmin on residue sets that do not interact
+/// @details Residues are colored greedily, in the order given, so that no two residues of the same
+/// color are neighbors in the packer neighbor graph or in the long range energy containers of the
+/// score function.  The trial at a residue only depends on the residues it interacts with, so the
+/// trials of one color can run at the same time, the calling thread on the pose and every other
+/// thread on its own copy of it, and the outcome is the same as that of visiting the residues one
+/// after the other color by color.  The accepted residues are copied into the pose and into every
+/// copy before the next color; the copies are kept for the next call from the same thread on a pose
+/// of the same sequence, and released when the sequence changes.
+
+#ifndef INCLUDED_core_pack_parallel_residue_trials_hh
+#define INCLUDED_core_pack_parallel_residue_trials_hh
+
+// Project Headers
+#include <core/conformation/Residue.fwd.hh>
+#include <core/graph/Graph.fwd.hh>
+#include <core/pose/Pose.fwd.hh>
+#include <core/scoring/ScoreFunction.fwd.hh>
+#include <core/types.hh>
+
+// Utility Headers
+#include <utility/pointer/ReferenceCount.hh>
+#include <utility/pointer/owning_ptr.hh>
+#include <utility/vector1.hh>
+
+namespace core {
+namespace pack {
+
+class ResidueTrial;
+typedef utility::pointer::shared_ptr< ResidueTrial > ResidueTrialOP;
+
+/// @brief The work done at one residue by a residue-at-a-time protocol such as rotamer trials.
+/// Every thread works with its own clone().
+class ResidueTrial : public utility::pointer::ReferenceCount
+{
+public:
+	virtual ~ResidueTrial();
+
+	/// @brief a copy for another thread
+	virtual ResidueTrialOP clone() const = 0;
+
+	/// @brief The residue to put at seqpos, or null to keep the residue there.  The pose is this
+	/// thread's copy; the trial may change it at seqpos only.
+	virtual conformation::ResidueOP trial( pose::Pose & pose, Size seqpos ) = 0;
+
+	/// @brief Put rsd at seqpos.  Called for the pose and for every copy of it.
+	virtual void accept( pose::Pose & pose, Size seqpos, conformation::Residue const & rsd ) const;
+};
+
+/// @brief Should rotamer trials and rtmin run on independent residue sets?  True unless
+/// -packing:trials_threads is 1.
+bool
+use_parallel_residue_trials();
+
+/// @brief Color the residues, in the given order, so that no two residues of the same color
+/// interact through the packer neighbor graph or through a long range two body energy of sfxn.
+/// Returns the residues of each color, in the given order.
+utility::vector1< utility::vector1< Size > >
+independent_residue_sets(
+	pose::Pose const & pose,
+	scoring::ScoreFunction const & sfxn,
+	graph::Graph const & packer_neighbor_graph,
+	utility::vector1< Size > const & residues
+);
+
+/// @brief The residues to visit, in the order to color them: the residues in random order, or as
+/// given if -packing:trials_deterministic is on, so that neither the coloring nor the outcome
+/// depend on the random number generator.
+void
+order_residues_for_coloring( utility::vector1< Size > & residues );
+
+/// @brief Run the trial at every residue of every set, the sets one after the other and the
+/// residues of a set on up to -packing:trials_threads threads (0 = hardware concurrency).
+/// Returns true if any residue was replaced.
+bool
+run_residue_trials(
+	pose::Pose & pose,
+	utility::vector1< utility::vector1< Size > > const & residue_sets,
+	ResidueTrial const & trial
+);
+
+} // namespace pack
+} // namespace core
+
+#endif
@@ -17,6 +17,7 @@
 // Package headers
 
 #include <core/pack/packer_neighbors.hh>
+#include <core/pack/parallel_residue_trials.hh>
 #include <core/pack/rotamer_set/RotamerSet.hh>
 #include <core/pack/rotamer_set/RotamerSetFactory.hh>
 #include <core/pack/rotamer_set/symmetry/SymmetricRotamerSetFactory.hh>
@@ -67,6 +68,58 @@ typedef conformation::symmetry::SymmetryInfo SymmetryInfo;
 
 static THREAD_LOCAL basic::Tracer TR( "core.pack.rotamer_trials" );
 
+/// @brief rotamer trials at one residue, for run_residue_trials().  Each clone scores with its own
+/// copy of the score function, since energy methods keep mutable scratch state.
+class RotamerTrial : public ResidueTrial
+{
+public:
+	RotamerTrial(
+		scoring::ScoreFunction const & scfxn,
+		task::PackerTask const & rottrial_task,
+		graph::GraphCOP packer_neighbor_graph
+	) :
+		scfxn_( scfxn.clone() ),
+		rottrial_task_( rottrial_task.clone() ),
+		packer_neighbor_graph_( packer_neighbor_graph )
+	{}
+
+	virtual ResidueTrialOP clone() const
+	{
+		return ResidueTrialOP( new RotamerTrial( *scfxn_, *rottrial_task_, packer_neighbor_graph_ ) );
+	}
+
+	virtual conformation::ResidueOP trial( pose::Pose & pose, Size resid )
+	{
+		pose.update_residue_neighbors(); // will return if uptodate
+		rottrial_task_->temporarily_set_pack_residue( resid, true );
+
+		rotamer_set::RotamerSetFactory rsf;
+		rotamer_set::RotamerSetOP rotset = rsf.create_rotamer_set( pose.residue( resid ) );
+		rotset->set_resid( resid );
+		rotset->build_rotamers( pose, *scfxn_, *rottrial_task_, packer_neighbor_graph_ );
+		scfxn_->prepare_rotamers_for_packing( pose, *rotset );
+
+		utility::vector1< core::PackerEnergy > one_body_energies( rotset->num_rotamers() );
+		rotset->compute_one_body_energies( pose, *scfxn_, *rottrial_task_, packer_neighbor_graph_, one_body_energies );
+		rottrial_task_->temporarily_set_pack_residue( resid, false );
+
+		Size const bestrot = utility::arg_min( one_body_energies );
+		if ( bestrot == rotset->id_for_current_rotamer() ) return 0;
+		return rotset->rotamer( bestrot )->clone();
+	}
+
+	virtual void accept( pose::Pose & pose, Size resid, conformation::Residue const & rsd ) const
+	{
+		pose.replace_residue( resid, rsd, false );
+		scfxn_->update_residue_for_packing( pose, resid );
+	}
+
+private:
+	scoring::ScoreFunctionOP scfxn_;
+	task::PackerTaskOP rottrial_task_;
+	graph::GraphCOP packer_neighbor_graph_;
+};
+
 utility::vector1< uint >
 symmetric_repackable_residues(
 	task::PackerTask const & the_task,
@@ -96,9 +149,10 @@ rotamer_trials(
 	pose.update_residue_neighbors();
 
 	utility::vector1< uint > residues_for_trials( repackable_residues( *input_task ));
+	bool const parallel = use_parallel_residue_trials();
 	// Replace this random shuffle with one based on rosetta's RNG
 	//random__shuffle(residues_for_trials.begin(), residues_for_trials.end() );
-	random_permutation( residues_for_trials, numeric::random::rg() );
+	if ( ! parallel ) random_permutation( residues_for_trials, numeric::random::rg() );
 
 	task::PackerTaskOP rottrial_task( input_task->clone() );
 
@@ -118,6 +172,16 @@ rotamer_trials(
 
 	bool replaced_residue( false );
 
+	if ( parallel ) {
+		// visit residues that do not interact with one another at the same time
+		utility::vector1< Size > residues( residues_for_trials.begin(), residues_for_trials.end() );
+		order_residues_for_coloring( residues );
+		replaced_residue = run_residue_trials( pose,
+			independent_residue_sets( pose, scfxn, *packer_neighbor_graph, residues ),
+			RotamerTrial( scfxn, *rottrial_task, packer_neighbor_graph ) );
+		residues_for_trials.clear();
+	}
+
 	Size const num_in_trials = residues_for_trials.size();
 	for ( Size ii = 1; ii <= num_in_trials; ++ii ) {
 		pose.update_residue_neighbors(); // will return if uptodate
@@ -18,6 +18,7 @@
 // Package headers
 
 #include <core/pack/packer_neighbors.hh>
+#include <core/pack/parallel_residue_trials.hh>
 #include <core/pack/rotamer_set/RotamerSet.hh>
 #include <core/pack/rotamer_set/RotamerSetFactory.hh>
 #include <core/pack/task/PackerTask.hh>
@@ -105,13 +106,67 @@ RTMin::RTMin(
 
 RTMin::~RTMin(){}
 
+/// @brief The minimization graph, background residues and minimizer map of rtmin over the residues
+/// a task packs.  They are set up once for all of those residues; minimize() then optimizes one
+/// residue at a time.
+class RTMinResidueMinimizer : public utility::pointer::ReferenceCount
+{
+public:
+	/// @brief Set up for the residues input_task packs, visited in the order of active_residues.
+	/// The task is kept, and changed as rtmin needs.
+	RTMinResidueMinimizer(
+		pose::Pose & pose,
+		scoring::ScoreFunction const & scfxn,
+		task::PackerTaskOP input_task,
+		utility::vector1< Size > const & active_residues,
+		bool cartesian,
+		bool nonideal
+	);
+
+	/// @brief Put the best minimized rotamer for iiresid into the pose.
+	void minimize( pose::Pose & pose, Size iiresid );
+
+	/// @brief The residue at seqpos in the pose was replaced from outside; update the background.
+	void residue_replaced( pose::Pose & pose, Size seqpos );
+
+private:
+	scoring::ScoreFunction const & scfxn_;
+	task::PackerTaskOP task_;
+	bool cartesian_;
+	bool nonideal_;
+	Size ndofs_;
+
+	graph::GraphOP packer_neighbor_graph_;
+	scoring::MinimizationGraph mingraph_;
+	scmin::SCMinMinimizerMapOP scminmap_;
+	utility::vector1< conformation::ResidueCOP > bgres_;
+	utility::vector1< bool > residue_is_inactive_neighbor_;
+	utility::vector1< bool > active_residue_has_been_visited_;
+	optimization::MinimizerOptions min_options_;
+	scoring::EnergyMap emap_dummy_;
+};
+
+typedef utility::pointer::shared_ptr< RTMinResidueMinimizer > RTMinResidueMinimizerOP;
+
 /// @details Don't look, it's not pretty!
-void
-RTMin::rtmin(
+RTMinResidueMinimizer::RTMinResidueMinimizer(
 	pose::Pose & pose,
 	scoring::ScoreFunction const & scfxn,
-	task::PackerTaskOP input_task
-) const
+	task::PackerTaskOP input_task,
+	utility::vector1< Size > const & active_residues,
+	bool cartesian,
+	bool nonideal
+) :
+	scfxn_( scfxn ),
+	task_( input_task ),
+	cartesian_( cartesian ),
+	nonideal_( nonideal ),
+	ndofs_( 4 ),
+	mingraph_( pose.total_residue() ),
+	bgres_( pose.total_residue() ),
+	residue_is_inactive_neighbor_( pose.total_residue(), false ),
+	active_residue_has_been_visited_( pose.total_residue(), false ),
+	min_options_( "lbfgs", 0.1, true, false, false )
 {
 	using namespace conformation;
 	using namespace chemical;
@@ -129,8 +184,8 @@ RTMin::rtmin(
 	/// can be used within rtmin, unless it is a whole-structure energy, in which
 	/// case, RTMin will not complain, BUT the energy will not be minimized.
 	bool bad( false );
-	for ( ScoreFunction::AllMethodsIterator iter = scfxn.all_methods().begin(),
-			iter_end = scfxn.all_methods().end(); iter != iter_end; ++iter ) {
+	for ( ScoreFunction::AllMethodsIterator iter = scfxn_.all_methods().begin(),
+			iter_end = scfxn_.all_methods().end(); iter != iter_end; ++iter ) {
 		/// Allow whole-structure energy methods to be present.  They will not be minized!
 		/// When would this be good?  If RG or chainbreak were on.
 		if ( (*iter)->method_type() != ws  && (*iter)->minimize_in_whole_structure_context( pose ) ) {
@@ -149,72 +204,62 @@ RTMin::rtmin(
 
 	utility::vector1< Size > inactive_neighbors;
 	inactive_neighbors.reserve( pose.total_residue() );
-	utility::vector1< bool > residue_is_inactive_neighbor( pose.total_residue(), false );
-	utility::vector1< bool > active_residue_has_been_visited( pose.total_residue(), false );
-
-	utility::vector1< Size > active_residues = pack::repackable_residues_dup( *input_task );
-	numeric::random::random_permutation( active_residues, numeric::random::rg() );
 
-	utility::vector1< conformation::ResidueCOP > bgres( pose.total_residue() );
-	graph::GraphOP packer_neighbor_graph = pack::create_packer_graph( pose, scfxn, input_task );
-	scoring::MinimizationGraph mingraph( pose.total_residue() );
+	packer_neighbor_graph_ = pack::create_packer_graph( pose, scfxn_, task_ );
 
-	SCMinMinimizerMapOP scminmap;
 	if ( cartesian_ ) {
-		scminmap = SCMinMinimizerMapOP( new CartSCMinMinimizerMap() );
+		scminmap_ = SCMinMinimizerMapOP( new CartSCMinMinimizerMap() );
 	} else {
-		scminmap = SCMinMinimizerMapOP( new AtomTreeSCMinMinimizerMap() );
+		scminmap_ = SCMinMinimizerMapOP( new AtomTreeSCMinMinimizerMap() );
 	}
-	scminmap->set_nonideal( nonideal_ );
-	scminmap->set_total_residue( pose.total_residue() );
-
-	EnergyMap emap_dummy;
+	scminmap_->set_nonideal( nonideal_ );
+	scminmap_->set_total_residue( pose.total_residue() );
 
 	// true -- nblist, false -- deriv_check, false -- deriv_verbose
 	//optimization::MinimizerOptions min_options( "lbfgs_armijo_nonmonotone", 0.1, true, false, false );
 	std::string minimizer = "lbfgs";
 	Size max_iter=200;
 	if ( cartesian_ || nonideal_ ) {
-		if ( !scfxn.ready_for_nonideal_scoring() ) {
+		if ( !scfxn_.ready_for_nonideal_scoring() ) {
 			utility_exit_with_message( "scorefunction not set up for nonideal/Cartesian scoring" );
 		}
 	}
 
-	optimization::MinimizerOptions min_options( minimizer, 0.1, true, false, false );
-	min_options.max_iter(max_iter);
-	min_options.silent(true);
+	min_options_ = optimization::MinimizerOptions( minimizer, 0.1, true, false, false );
+	min_options_.max_iter(max_iter);
+	min_options_.silent(true);
 
 
-	for ( Size ii = 1; ii <= input_task->num_to_be_packed(); ++ii ) {
+	for ( Size ii = 1; ii <= task_->num_to_be_packed(); ++ii ) {
 		Size iires = active_residues[ ii ];
 		for ( graph::Node::EdgeListConstIter
-				eiter = packer_neighbor_graph->get_node( iires )->const_edge_list_begin(),
-				eiter_end = packer_neighbor_graph->get_node( iires )->const_edge_list_end();
+				eiter = packer_neighbor_graph_->get_node( iires )->const_edge_list_begin(),
+				eiter_end = packer_neighbor_graph_->get_node( iires )->const_edge_list_end();
 				eiter != eiter_end; ++eiter ) {
 			Size jjres = (*eiter)->get_other_ind( iires );
-			if ( ! bgres[ jjres ] && ! input_task->being_packed( jjres ) ) {
+			if ( ! bgres_[ jjres ] && ! task_->being_packed( jjres ) ) {
 				inactive_neighbors.push_back( jjres );
-				residue_is_inactive_neighbor[ jjres ] = true;
-				bgres[ jjres ] = ResidueOP( new Residue( pose.residue( jjres ) ) );
-				scminmap->set_natoms_for_residue( jjres, bgres[ jjres ]->natoms() );
+				residue_is_inactive_neighbor_[ jjres ] = true;
+				bgres_[ jjres ] = ResidueOP( new Residue( pose.residue( jjres ) ) );
+				scminmap_->set_natoms_for_residue( jjres, bgres_[ jjres ]->natoms() );
 				/// Do setup_for_minimizing for background nodes once and leave them alone for
 				/// the rest of the trajectory
-				scfxn.setup_for_minimizing_for_node(
-					* mingraph.get_minimization_node( jjres ), pose.residue( jjres ),
-					*scminmap, pose, false, emap_dummy );
+				scfxn_.setup_for_minimizing_for_node(
+					* mingraph_.get_minimization_node( jjres ), pose.residue( jjres ),
+					*scminmap_, pose, false, emap_dummy_ );
 			}
-			if ( ! input_task->being_packed( jjres ) || iires < jjres ) {
-				mingraph.add_edge( iires, jjres ); // add edges, but don't bother calling setup_for_minimization yet
+			if ( ! task_->being_packed( jjres ) || iires < jjres ) {
+				mingraph_.add_edge( iires, jjres ); // add edges, but don't bother calling setup_for_minimization yet
 			}
 		}
 
 		// LR2B neighbor graphs may not coincide with the
-		// packer_neighbor_graph. Make the background nodes the union of
-		// the background nodes from the packer_neighbor_graph and the
+		// packer_neighbor_graph_. Make the background nodes the union of
+		// the background nodes from the packer_neighbor_graph_ and the
 		// background nodes for each LR2B neighbor graph
 		for ( ScoreFunction::LR_2B_MethodIterator
-				iter = scfxn.long_range_energies_begin(),
-				iter_end = scfxn.long_range_energies_end();
+				iter = scfxn_.long_range_energies_begin(),
+				iter_end = scfxn_.long_range_energies_end();
 				iter != iter_end; ++iter ) {
 
 			if ( (*iter)->minimize_in_whole_structure_context( pose ) ) continue;
@@ -234,20 +279,20 @@ RTMin::rtmin(
 				Size const jjres = ( r1 == iires ? r2 : r1 );
 				//bool const res_moving_wrt_eachother( true );
 
-				if ( ! bgres[ jjres ] && ! input_task->being_packed( jjres ) ) {
+				if ( ! bgres_[ jjres ] && ! task_->being_packed( jjres ) ) {
 					inactive_neighbors.push_back( jjres );
-					residue_is_inactive_neighbor[ jjres ] = true;
-					bgres[ jjres ] = ResidueOP( new Residue( pose.residue( jjres ) ) );
-					scminmap->set_natoms_for_residue( jjres, bgres[ jjres ]->natoms() );
+					residue_is_inactive_neighbor_[ jjres ] = true;
+					bgres_[ jjres ] = ResidueOP( new Residue( pose.residue( jjres ) ) );
+					scminmap_->set_natoms_for_residue( jjres, bgres_[ jjres ]->natoms() );
 					// Do setup_for_minimizing for background nodes once and leave them alone for
 					// the rest of the trajectory
-					scfxn.setup_for_minimizing_for_node(
-						* mingraph.get_minimization_node( jjres ), pose.residue( jjres ),
-						*scminmap, pose, false, emap_dummy );
+					scfxn_.setup_for_minimizing_for_node(
+						* mingraph_.get_minimization_node( jjres ), pose.residue( jjres ),
+						*scminmap_, pose, false, emap_dummy_ );
 				}
-				if ( ! input_task->being_packed( jjres ) || iires < jjres ) {
-					if ( !mingraph.get_edge_exists(iires, jjres) ) {
-						mingraph.add_edge( iires, jjres ); // add edges, but don't bother calling setup_for_minimization yet
+				if ( ! task_->being_packed( jjres ) || iires < jjres ) {
+					if ( !mingraph_.get_edge_exists(iires, jjres) ) {
+						mingraph_.add_edge( iires, jjres ); // add edges, but don't bother calling setup_for_minimization yet
 					}
 				}
 			}
@@ -256,262 +301,366 @@ RTMin::rtmin(
 	}
 
 
-	input_task->set_bump_check( false );
-	input_task->or_include_current( true );
-	input_task->temporarily_fix_everything();
+	task_->set_bump_check( false );
+	task_->or_include_current( true );
+	task_->temporarily_fix_everything();
 
-	/// in real rtmin, the active residues will be examined in a random order;
-	/// random__shuffle( active_residues );
+	if ( nonideal_ ) ndofs_=14;
+	if ( cartesian_ ) ndofs_=75;
+}
 
-	Size ndofs = 4;
-	if ( nonideal_ ) ndofs=14;
-	if ( cartesian_ ) ndofs=75;
+void
+RTMinResidueMinimizer::minimize( pose::Pose & pose, Size iiresid )
+{
+	using namespace conformation;
+	using namespace chemical;
+	using namespace pack::rotamer_set;
+	using namespace pack::scmin;
+	using namespace pose;
+	using namespace scoring;
+	using namespace scoring::methods;
+	using namespace optimization;
+	using namespace graph;
+	using namespace basic::options;
 
-	optimization::Multivec chi(ndofs); // guess -- resized smaller
+	/// Now, build rotamers, prep the nodes and edges of the minimization graph
+	/// and build the AtomTreeCollection for this residue;
+	optimization::Multivec chi(ndofs_); // guess -- resized smaller
+
+	conformation::Residue const & trial_res = pose.residue( iiresid );
+	scminmap_->activate_residue_dofs( iiresid );
+
+	//pretend this is a repacking and only this residue is being repacked
+	//while all other residues are being held fixed.
+	task_->temporarily_set_pack_residue( iiresid, true );
+
+	RotamerSetFactory rsf;
+	rotamer_set::RotamerSetOP iirotset = rsf.create_rotamer_set( trial_res );
+	iirotset->set_resid( iiresid );
+	iirotset->build_rotamers( pose, scfxn_, *task_, packer_neighbor_graph_ );
+	debug_assert( iirotset->id_for_current_rotamer() != 0 );
+
+	AtomTreeCollectionOP ii_atc( new AtomTreeCollection( pose, *iirotset, iiresid ) );
+	ii_atc->residue_atomtree_collection( iiresid ).set_active_restype_index( 1 ); // start at the beginning.
+	ii_atc->residue_atomtree_collection( iiresid ).set_rescoords( * iirotset->rotamer( 1 ) );
+	ii_atc->residue_atomtree_collection( iiresid ).update_atom_tree();
+	scminmap_->setup( ii_atc );
+
+	{/// SCOPE -- make sure the minimization graph is ready to optimize this residue
+		Residue const & iirsd( ii_atc->residue_atomtree_collection( iiresid ).active_residue() );
+		if ( ! bgres_[ iiresid ] ) {
+			// we have not ever done setup for scoring for this residue
+			scfxn_.setup_for_minimizing_for_node(
+				* mingraph_.get_minimization_node( iiresid ), iirsd,
+				*scminmap_, pose, false, emap_dummy_ );
+		} else {
+			scfxn_.reinitialize_minnode_for_residue(
+				* mingraph_.get_minimization_node( iiresid ), iirsd,
+				*scminmap_, pose );
+		}
+		for ( graph::Node::EdgeListIter
+				eiter = mingraph_.get_node( iiresid )->edge_list_begin(),
+				eiter_end = mingraph_.get_node( iiresid )->edge_list_end();
+				eiter != eiter_end; ++eiter ) {
 
-	for ( Size ii = 1; ii <= active_residues.size(); ++ii ) {
-		/// Now, build rotamers, prep the nodes and edges of the minimization graph
-		/// and build the AtomTreeCollection for this residue;
-		Size iiresid = active_residues[ ii ];
-		conformation::Residue const & trial_res = pose.residue( iiresid );
-		scminmap->activate_residue_dofs( iiresid );
-
-		//pretend this is a repacking and only this residue is being repacked
-		//while all other residues are being held fixed.
-		input_task->temporarily_set_pack_residue( iiresid, true );
-
-		RotamerSetFactory rsf;
-		rotamer_set::RotamerSetOP iirotset = rsf.create_rotamer_set( trial_res );
-		iirotset->set_resid( iiresid );
-		iirotset->build_rotamers( pose, scfxn, *input_task, packer_neighbor_graph );
-		debug_assert( iirotset->id_for_current_rotamer() != 0 );
-
-		AtomTreeCollectionOP ii_atc( new AtomTreeCollection( pose, *iirotset, iiresid ) );
-		ii_atc->residue_atomtree_collection( iiresid ).set_active_restype_index( 1 ); // start at the beginning.
-		ii_atc->residue_atomtree_collection( iiresid ).set_rescoords( * iirotset->rotamer( 1 ) );
-		ii_atc->residue_atomtree_collection( iiresid ).update_atom_tree();
-		scminmap->setup( ii_atc );
-
-		{/// SCOPE -- make sure the minimization graph is ready to optimize this residue
-			Residue const & iirsd( ii_atc->residue_atomtree_collection( iiresid ).active_residue() );
-			if ( ! bgres[ iiresid ] ) {
-				// we have not ever done setup for scoring for this residue
-				scfxn.setup_for_minimizing_for_node(
-					* mingraph.get_minimization_node( iiresid ), iirsd,
-					*scminmap, pose, false, emap_dummy );
-			} else {
-				scfxn.reinitialize_minnode_for_residue(
-					* mingraph.get_minimization_node( iiresid ), iirsd,
-					*scminmap, pose );
+			Size jjresid = (*eiter)->get_other_ind( iiresid );
+			if ( ! bgres_[ jjresid ] ) {
+				/// we have an active residue which we have not yet visited in the rtmin traversal
+				bgres_[ jjresid ] = ResidueOP( new Residue( pose.residue( jjresid ) ) );
+				scfxn_.setup_for_minimizing_for_node(
+					* mingraph_.get_minimization_node( jjresid ),
+					* bgres_[ jjresid ],
+					*scminmap_, pose, false, emap_dummy_ );
+				scminmap_->set_natoms_for_residue( jjresid, bgres_[ jjresid ]->natoms() );
 			}
-			for ( graph::Node::EdgeListIter
-					eiter = mingraph.get_node( iiresid )->edge_list_begin(),
-					eiter_end = mingraph.get_node( iiresid )->edge_list_end();
-					eiter != eiter_end; ++eiter ) {
-
-				Size jjresid = (*eiter)->get_other_ind( iiresid );
-				if ( ! bgres[ jjresid ] ) {
-					/// we have an active residue which we have not yet visited in the rtmin traversal
-					bgres[ jjresid ] = ResidueOP( new Residue( pose.residue( jjresid ) ) );
-					scfxn.setup_for_minimizing_for_node(
-						* mingraph.get_minimization_node( jjresid ),
-						* bgres[ jjresid ],
-						*scminmap, pose, false, emap_dummy );
-					scminmap->set_natoms_for_residue( jjresid, bgres[ jjresid ]->natoms() );
+			Residue const & jjrsd( * bgres_[ jjresid ] );
+			MinimizationEdge & min_edge( static_cast< MinimizationEdge & > ( **eiter ));
+			//std::cout << "Minedge " << iiresid << " " << jjresid << std::endl;
+			if ( jjresid < iiresid ) {
+				if ( residue_is_inactive_neighbor_[ jjresid ] || ! active_residue_has_been_visited_[ jjresid ] ) {
+					scfxn_.setup_for_minimizing_sr2b_enmeths_for_minedge(
+						jjrsd, iirsd, min_edge, *scminmap_, pose, true, false, ( EnergyEdge * ) 0, emap_dummy_ );
+				} else {
+					min_edge.reinitialize_active_energy_methods( iirsd, jjrsd, pose, true);
 				}
-				Residue const & jjrsd( * bgres[ jjresid ] );
-				MinimizationEdge & min_edge( static_cast< MinimizationEdge & > ( **eiter ));
-				//std::cout << "Minedge " << iiresid << " " << jjresid << std::endl;
-				if ( jjresid < iiresid ) {
-					if ( residue_is_inactive_neighbor[ jjresid ] || ! active_residue_has_been_visited[ jjresid ] ) {
-						scfxn.setup_for_minimizing_sr2b_enmeths_for_minedge(
-							jjrsd, iirsd, min_edge, *scminmap, pose, true, false, ( EnergyEdge * ) 0, emap_dummy );
-					} else {
-						min_edge.reinitialize_active_energy_methods( iirsd, jjrsd, pose, true);
-					}
-					/// hold off on the setup_for_minimizing until we know we're done with this edge (no long-range additions)
-					///min_edge.setup_for_minimizing( jjrsd, iirsd, pose, scfxn, scminmap );
+				/// hold off on the setup_for_minimizing until we know we're done with this edge (no long-range additions)
+				///min_edge.setup_for_minimizing( jjrsd, iirsd, pose, scfxn_, scminmap_ );
 
+			} else {
+				if ( residue_is_inactive_neighbor_[ jjresid ]  || ! active_residue_has_been_visited_[ jjresid ] ) {
+					scfxn_.setup_for_minimizing_sr2b_enmeths_for_minedge(
+						iirsd, jjrsd, min_edge, *scminmap_, pose, true, false, ( EnergyEdge * ) 0, emap_dummy_ );
 				} else {
-					if ( residue_is_inactive_neighbor[ jjresid ]  || ! active_residue_has_been_visited[ jjresid ] ) {
-						scfxn.setup_for_minimizing_sr2b_enmeths_for_minedge(
-							iirsd, jjrsd, min_edge, *scminmap, pose, true, false, ( EnergyEdge * ) 0, emap_dummy );
-					} else {
-						min_edge.reinitialize_active_energy_methods( jjrsd, iirsd, pose, true);
-					}
-					/// hold off on the setup_for_minimizing until we know we're done with this edge (no long-range additions)
-					///min_edge.setup_for_minimizing( iirsd, jjrsd, pose, scfxn, scminmap );
+					min_edge.reinitialize_active_energy_methods( jjrsd, iirsd, pose, true);
 				}
+				/// hold off on the setup_for_minimizing until we know we're done with this edge (no long-range additions)
+				///min_edge.setup_for_minimizing( iirsd, jjrsd, pose, scfxn_, scminmap_ );
 			}
-			//// LONG RANGE SETUP
-			for ( ScoreFunction::LR_2B_MethodIterator
-					iter = scfxn.long_range_energies_begin(),
-					iter_end = scfxn.long_range_energies_end();
-					iter != iter_end; ++iter ) {
-
-				if ( (*iter)->minimize_in_whole_structure_context( pose ) ) continue;
-
-				LREnergyContainerCOP lrec = pose.energies().long_range_container( (*iter)->long_range_type() );
-				if ( !lrec || lrec->empty() ) continue;
-
-				EnergyMap dummy_emap;
-
-				// Potentially O(N) operation...
-				for ( ResidueNeighborConstIteratorOP
-						rni = lrec->const_neighbor_iterator_begin( iiresid ), // traverse both upper and lower neighbors
-						rniend = lrec->const_neighbor_iterator_end( iiresid );
-						(*rni) != (*rniend); ++(*rni) ) {
-					Size const r1 = rni->lower_neighbor_id();
-					Size const r2 = rni->upper_neighbor_id();
-					Size const jjresid = ( r1 == iiresid ? r2 : r1 );
-					bool const res_moving_wrt_eachother( true );
-
-					/// We've already set up the long-range energy methods for this edge if
-					/// jjresid is an active residue that has already had its conformation optimized
-					if ( active_residue_has_been_visited[ jjresid ] ) continue;
-					conformation::Residue const & lower_res( r1 == iiresid ? iirsd : *bgres[ jjresid ] );
-					conformation::Residue const & upper_res( r1 == iiresid ? *bgres[ jjresid ] : iirsd );
-					scfxn.setup_for_lr2benmeth_minimization_for_respair(
-						lower_res, upper_res, *iter, mingraph, *scminmap, pose,
-						res_moving_wrt_eachother, false, rni, dummy_emap );
-				}
+		}
+		//// LONG RANGE SETUP
+		for ( ScoreFunction::LR_2B_MethodIterator
+				iter = scfxn_.long_range_energies_begin(),
+				iter_end = scfxn_.long_range_energies_end();
+				iter != iter_end; ++iter ) {
+
+			if ( (*iter)->minimize_in_whole_structure_context( pose ) ) continue;
+
+			LREnergyContainerCOP lrec = pose.energies().long_range_container( (*iter)->long_range_type() );
+			if ( !lrec || lrec->empty() ) continue;
+
+			EnergyMap dummy_emap;
+
+			// Potentially O(N) operation...
+			for ( ResidueNeighborConstIteratorOP
+					rni = lrec->const_neighbor_iterator_begin( iiresid ), // traverse both upper and lower neighbors
+					rniend = lrec->const_neighbor_iterator_end( iiresid );
+					(*rni) != (*rniend); ++(*rni) ) {
+				Size const r1 = rni->lower_neighbor_id();
+				Size const r2 = rni->upper_neighbor_id();
+				Size const jjresid = ( r1 == iiresid ? r2 : r1 );
+				bool const res_moving_wrt_eachother( true );
+
+				/// We've already set up the long-range energy methods for this edge if
+				/// jjresid is an active residue that has already had its conformation optimized
+				if ( active_residue_has_been_visited_[ jjresid ] ) continue;
+				conformation::Residue const & lower_res( r1 == iiresid ? iirsd : *bgres_[ jjresid ] );
+				conformation::Residue const & upper_res( r1 == iiresid ? *bgres_[ jjresid ] : iirsd );
+				scfxn_.setup_for_lr2benmeth_minimization_for_respair(
+					lower_res, upper_res, *iter, mingraph_, *scminmap_, pose,
+					res_moving_wrt_eachother, false, rni, dummy_emap );
 			}
+		}
 
-		} /// END MinimizationGraph initialization SCOPE
+	} /// END MinimizationGraph initialization SCOPE
 
-		/// OK: now start iterating across rotamers, setting up for minimization when the residue type changes,
-		/// initializing the scminmultifunc
-		Size next_restype_index( 2 );
+	/// OK: now start iterating across rotamers, setting up for minimization when the residue type changes,
+	/// initializing the scminmultifunc
+	Size next_restype_index( 2 );
 
-		Real best_score( 0.0 ); bool first_pass( true );
+	Real best_score( 0.0 ); bool first_pass( true );
 #ifdef APL_FULL_DEBUG
-		Real best_real_score( 0.0 );
+	Real best_real_score( 0.0 );
 #endif
-		ResidueAtomTreeCollectionMomento momento;
-		scminmap->set_natoms_for_residue( iiresid, ii_atc->residue_atomtree_collection( iiresid ).active_residue().natoms()  );
-		for ( Size jj = 1, jj_end = iirotset->num_rotamers(); jj <= jj_end; ++jj ) {
-			if ( next_restype_index <= iirotset->get_n_residue_types() &&
-					iirotset->get_residue_type_begin( next_restype_index ) == jj ) {
-				ii_atc->residue_atomtree_collection( iiresid ).set_active_restype_index( next_restype_index );
-				++next_restype_index;
-
-				ii_atc->residue_atomtree_collection( iiresid ).set_rescoords( * iirotset->rotamer( jj ));
-				ii_atc->residue_atomtree_collection( iiresid ).update_atom_tree();
-				scminmap->set_natoms_for_residue( iiresid, iirotset->rotamer( jj )->natoms() );
-
-				scminmap->setup( ii_atc ); // traverse the atom tree and identify dofs
-			}
+	ResidueAtomTreeCollectionMomento momento;
+	scminmap_->set_natoms_for_residue( iiresid, ii_atc->residue_atomtree_collection( iiresid ).active_residue().natoms()  );
+	for ( Size jj = 1, jj_end = iirotset->num_rotamers(); jj <= jj_end; ++jj ) {
+		if ( next_restype_index <= iirotset->get_n_residue_types() &&
+				iirotset->get_residue_type_begin( next_restype_index ) == jj ) {
+			ii_atc->residue_atomtree_collection( iiresid ).set_active_restype_index( next_restype_index );
+			++next_restype_index;
 
 			ii_atc->residue_atomtree_collection( iiresid ).set_rescoords( * iirotset->rotamer( jj ));
 			ii_atc->residue_atomtree_collection( iiresid ).update_atom_tree();
-			//chi = iirotset->rotamer( jj )->chi();
-			scminmap->starting_dofs( chi );
+			scminmap_->set_natoms_for_residue( iiresid, iirotset->rotamer( jj )->natoms() );
 
-			reinitialize_mingraph_neighborhood_for_residue( pose, scfxn, bgres, *scminmap, scminmap->residue( iiresid ), mingraph );
+			scminmap_->setup( ii_atc ); // traverse the atom tree and identify dofs
+		}
+
+		ii_atc->residue_atomtree_collection( iiresid ).set_rescoords( * iirotset->rotamer( jj ));
+		ii_atc->residue_atomtree_collection( iiresid ).update_atom_tree();
+		//chi = iirotset->rotamer( jj )->chi();
+		scminmap_->starting_dofs( chi );
+
+		reinitialize_mingraph_neighborhood_for_residue( pose, scfxn_, bgres_, *scminmap_, scminmap_->residue( iiresid ), mingraph_ );
 
 #ifdef APL_FULL_DEBUG
-			pose.replace_residue( iiresid, ii_atc->residue_atomtree_collection( iiresid ).active_residue(), false );
-			Real const real_start_score( scfxn( pose ) );
+		pose.replace_residue( iiresid, ii_atc->residue_atomtree_collection( iiresid ).active_residue(), false );
+		Real const real_start_score( scfxn_( pose ) );
 #endif
-			//pose.dump_pdb( "rtmin_before_" + utility::to_string( iiresid ) + "_" + utility::to_string( jj ) + ".pdb" );
-			/// OK: Minimization graph is initialized.  Now setup the SCMinMultifunc
-			//SCMinMultifunc scmin_multifunc( pose, bgres, scfxn, mingraph, *scminmap );
-			MultifuncOP scmin_multifunc = scminmap->make_multifunc( pose, bgres, scfxn, mingraph );
-			//Real const start_score( scmin_multifunc( chi ) );
+		//pose.dump_pdb( "rtmin_before_" + utility::to_string( iiresid ) + "_" + utility::to_string( jj ) + ".pdb" );
+		/// OK: Minimization graph is initialized.  Now setup the SCMinMultifunc
+		//SCMinMultifunc scmin_multifunc( pose, bgres_, scfxn_, mingraph_, *scminmap_ );
+		MultifuncOP scmin_multifunc = scminmap_->make_multifunc( pose, bgres_, scfxn_, mingraph_ );
+		//Real const start_score( scmin_multifunc( chi ) );
 
-			//std::cout << "Starting comparison: " << iiresid << " " << start_score  << " " << iirotset->rotamer( jj )->name() << std::endl;
+		//std::cout << "Starting comparison: " << iiresid << " " << start_score  << " " << iirotset->rotamer( jj )->name() << std::endl;
 #ifdef APL_FULL_DEBUG
-			deriv_check_for_residue( iiresid, jj, *scmin_multifunc, chi );
-			compare_mingraph_and_energy_graph( iiresid, pose, scfxn, mingraph );
+		deriv_check_for_residue( iiresid, jj, *scmin_multifunc, chi );
+		compare_mingraph_and_energy_graph( iiresid, pose, scfxn_, mingraph_ );
 #endif
 
-			Minimizer minimizer( *scmin_multifunc, min_options );
-			//Real const start_func = (*scmin_multifunc)( chi );
-			//Real const end_func =
-			minimizer.run( chi );
-			/// Note: our neighborlist may have gone out-of-date.  Update now to make sure the best rotamer is placed in the pose
-			reinitialize_mingraph_neighborhood_for_residue( pose, scfxn, bgres, *scminmap, scminmap->residue( iiresid ), mingraph );
-			Real const end_score = (*scmin_multifunc)( chi );
-			//for ( Size kk = 1; kk <= chi.size(); ++kk ) {
-			// std::cout << "chi " << kk << " " << chi[ kk ] << " vs "
-			//  << ii_atc->residue_atomtree_collection( iiresid ).active_residue().chi()[ kk ]
-			//  << " ";
-			//}
-			//std::cout << std::endl;
+		Minimizer minimizer( *scmin_multifunc, min_options_ );
+		//Real const start_func = (*scmin_multifunc)( chi );
+		//Real const end_func =
+		minimizer.run( chi );
+		/// Note: our neighborlist may have gone out-of-date.  Update now to make sure the best rotamer is placed in the pose
+		reinitialize_mingraph_neighborhood_for_residue( pose, scfxn_, bgres_, *scminmap_, scminmap_->residue( iiresid ), mingraph_ );
+		Real const end_score = (*scmin_multifunc)( chi );
+		//for ( Size kk = 1; kk <= chi.size(); ++kk ) {
+		// std::cout << "chi " << kk << " " << chi[ kk ] << " vs "
+		//  << ii_atc->residue_atomtree_collection( iiresid ).active_residue().chi()[ kk ]
+		//  << " ";
+		//}
+		//std::cout << std::endl;
 
 #ifdef APL_FULL_DEBUG
-			pose.replace_residue( iiresid, ii_atc->residue_atomtree_collection( iiresid ).active_residue(), false );
-			Real const real_end_score( scfxn( pose ) );
-			//std::cout << "Ending comparison: " << iiresid  << " " << end_score << " " << real_end_score << " " << iirotset->rotamer( jj )->name() << std::endl;
-			deriv_check_for_residue( iiresid, jj, *scmin_multifunc, chi );
-			compare_mingraph_and_energy_graph( iiresid, pose, scfxn, mingraph );
-			//if ( iiresid == 14 && jj == 7 ) {
-			//	atom_tree_multifunc_dump( pose, scfxn, chi, ii );
-			//}
+		pose.replace_residue( iiresid, ii_atc->residue_atomtree_collection( iiresid ).active_residue(), false );
+		Real const real_end_score( scfxn_( pose ) );
+		//std::cout << "Ending comparison: " << iiresid  << " " << end_score << " " << real_end_score << " " << iirotset->rotamer( jj )->name() << std::endl;
+		deriv_check_for_residue( iiresid, jj, *scmin_multifunc, chi );
+		compare_mingraph_and_energy_graph( iiresid, pose, scfxn_, mingraph_ );
+		//if ( iiresid == 14 && jj == 7 ) {
+		//	atom_tree_multifunc_dump( pose, scfxn_, chi, ii );
+		//}
 #endif
 
-			if ( first_pass || end_score <= best_score ) {
-				best_score = end_score;
+		if ( first_pass || end_score <= best_score ) {
+			best_score = end_score;
 #ifdef APL_FULL_DEBUG
-				best_real_score = real_end_score;
+			best_real_score = real_end_score;
 #endif
-				first_pass = false;
-				ii_atc->residue_atomtree_collection( iiresid ).save_momento( momento );
-			}
+			first_pass = false;
+			ii_atc->residue_atomtree_collection( iiresid ).save_momento( momento );
+		}
 
-			// ok -- lets get here
-			//std::cout << "iiresid " << iiresid << " rot: " << jj << " start score: "
-			// << start_score << " end score: " << end_score << " real start: " << real_start_score
-			// << " real end:" << real_end_score << " ddScore " << ( end_score - start_score ) - ( real_end_score - real_start_score )
-			// << std::endl;
+		// ok -- lets get here
+		//std::cout << "iiresid " << iiresid << " rot: " << jj << " start score: "
+		// << start_score << " end score: " << end_score << " real start: " << real_start_score
+		// << " real end:" << real_end_score << " ddScore " << ( end_score - start_score ) - ( real_end_score - real_start_score )
+		// << std::endl;
 
-			//pose.dump_pdb( "rtmin_after_" + utility::to_string( iiresid ) + "_" + utility::to_string( jj ) + ".pdb" );
+		//pose.dump_pdb( "rtmin_after_" + utility::to_string( iiresid ) + "_" + utility::to_string( jj ) + ".pdb" );
 
-		}
-		ii_atc->residue_atomtree_collection( iiresid ).update_from_momento( momento );
-		bgres[ iiresid ] = ResidueOP( new Residue( ii_atc->residue_atomtree_collection( iiresid ).active_residue() ) );
-
-		/// NOW, we must call setup_for_scoring_for_residue for this residue we've just replaced, and
-		/// for the edges adjacent to this residue and to other non-background residues so that the guarantee
-		/// that setup_for_scoring_for_residue has been called on a residue before the next time its score is
-		/// evaluated as a two-body energy
-
-		//scfxn.reinitialize_minnode_for_residue( * mingraph.get_minimization_node( iiresid ),
-		// *bgres[ iiresid ], scminmap, pose );
-		reinitialize_mingraph_neighborhood_for_residue( pose, scfxn, bgres, *scminmap, *bgres[ iiresid ], mingraph );
-
-		/*for ( graph::Graph::EdgeListIter
-		edgeit = mingraph.get_node( iiresid )->edge_list_begin(),
-		edgeit_end = mingraph.get_node( iiresid )->edge_list_end();
-		edgeit != edgeit_end; ++edgeit ) {
-		Size const jjresid = (*edgeit)->get_other_ind( iiresid );
-		if ( residue_is_inactive_neighbor[ jjresid ] ) continue;
-
-		MinimizationEdge & min_edge = static_cast< MinimizationEdge & > ( (**edgeit) );
-		if ( iiresid < jjresid ) {
-		min_edge.reinitialize_active_energy_methods( *bgres[ iiresid ], *bgres[ jjresid ], pose, true);
-		min_edge.setup_for_minimizing( *bgres[ iiresid ], *bgres[ jjresid ], pose, scfxn, scminmap );
-		} else {
-		min_edge.reinitialize_active_energy_methods( *bgres[ jjresid ], *bgres[ iiresid ], pose, true);
-		min_edge.setup_for_minimizing( *bgres[ jjresid ], *bgres[ iiresid ], pose, scfxn, scminmap );
-		}
+	}
+	ii_atc->residue_atomtree_collection( iiresid ).update_from_momento( momento );
+	bgres_[ iiresid ] = ResidueOP( new Residue( ii_atc->residue_atomtree_collection( iiresid ).active_residue() ) );
+
+	/// NOW, we must call setup_for_scoring_for_residue for this residue we've just replaced, and
+	/// for the edges adjacent to this residue and to other non-background residues so that the guarantee
+	/// that setup_for_scoring_for_residue has been called on a residue before the next time its score is
+	/// evaluated as a two-body energy
+
+	//scfxn_.reinitialize_minnode_for_residue( * mingraph_.get_minimization_node( iiresid ),
+	// *bgres_[ iiresid ], scminmap_, pose );
+	reinitialize_mingraph_neighborhood_for_residue( pose, scfxn_, bgres_, *scminmap_, *bgres_[ iiresid ], mingraph_ );
+
+	/*for ( graph::Graph::EdgeListIter
+	edgeit = mingraph_.get_node( iiresid )->edge_list_begin(),
+	edgeit_end = mingraph_.get_node( iiresid )->edge_list_end();
+	edgeit != edgeit_end; ++edgeit ) {
+	Size const jjresid = (*edgeit)->get_other_ind( iiresid );
+	if ( residue_is_inactive_neighbor_[ jjresid ] ) continue;
+
+	MinimizationEdge & min_edge = static_cast< MinimizationEdge & > ( (**edgeit) );
+	if ( iiresid < jjresid ) {
+	min_edge.reinitialize_active_energy_methods( *bgres_[ iiresid ], *bgres_[ jjresid ], pose, true);
+	min_edge.setup_for_minimizing( *bgres_[ iiresid ], *bgres_[ jjresid ], pose, scfxn_, scminmap_ );
+	} else {
+	min_edge.reinitialize_active_energy_methods( *bgres_[ jjresid ], *bgres_[ iiresid ], pose, true);
+	min_edge.setup_for_minimizing( *bgres_[ jjresid ], *bgres_[ iiresid ], pose, scfxn_, scminmap_ );
+	}
 
-		}*/
-		active_residue_has_been_visited[ iiresid ] = true;
-		scminmap->clear_active_dofs();
-		pose.replace_residue( iiresid, *bgres[ iiresid ], false );
+	}*/
+	active_residue_has_been_visited_[ iiresid ] = true;
+	scminmap_->clear_active_dofs();
+	pose.replace_residue( iiresid, *bgres_[ iiresid ], false );
 
 #ifdef APL_FULL_DEBUG
-		for ( Size jj = 1; jj <= bgres[ iiresid ]->natoms(); ++jj ) {
-		debug_assert( bgres[ iiresid ]->xyz( jj ).distance( pose.residue( iiresid ).xyz( jj ) ) < 1e-5 );
-		}
-		Real const ii_final_score( scfxn( pose ) );
-	debug_assert( std::abs( best_real_score - ii_final_score ) < 1e-13 );
+	for ( Size jj = 1; jj <= bgres_[ iiresid ]->natoms(); ++jj ) {
+	debug_assert( bgres_[ iiresid ]->xyz( jj ).distance( pose.residue( iiresid ).xyz( jj ) ) < 1e-5 );
+	}
+	Real const ii_final_score( scfxn_( pose ) );
+debug_assert( std::abs( best_real_score - ii_final_score ) < 1e-13 );
 #endif
-		//pose.dump_pdb( "rtmin_selected_" + utility::to_string( iiresid ) + ".pdb" );
-		//std::cout << "Round " << ii << " final score: " << scfxn(pose) << std::endl;
+	//pose.dump_pdb( "rtmin_selected_" + utility::to_string( iiresid ) + ".pdb" );
+	//std::cout << "Round " << iiresid << " final score: " << scfxn_(pose) << std::endl;
+}
+
+/// @details Only a residue with a background copy here needs updating: one this minimizer set up
+/// as a neighbor but has not minimized itself.  Its node has been set up already, so it is
+/// reinitialized.  It stays unvisited, so its edges are set up when a neighbor is minimized here.
+void
+RTMinResidueMinimizer::residue_replaced( pose::Pose & pose, Size seqpos )
+{
+	if ( ! bgres_[ seqpos ] || active_residue_has_been_visited_[ seqpos ] ) return;
+	bgres_[ seqpos ] = conformation::ResidueOP( new conformation::Residue( pose.residue( seqpos ) ) );
+	scminmap_->set_natoms_for_residue( seqpos, bgres_[ seqpos ]->natoms() );
+	scfxn_.reinitialize_minnode_for_residue(
+		* mingraph_.get_minimization_node( seqpos ), *bgres_[ seqpos ], *scminmap_, pose );
+}
+
+/// @brief rtmin at one residue, for run_residue_trials().  Each clone has its own score function and
+/// sets up its RTMinResidueMinimizer once, from its thread's pose, at its first residue.
+class RTMinTrial : public ResidueTrial
+{
+public:
+	RTMinTrial(
+		RTMin const & rtmin,
+		scoring::ScoreFunction const & scfxn,
+		task::PackerTask const & input_task
+	) :
+		rtmin_( rtmin ),
+		scfxn_( scfxn.clone() ),
+		input_task_( input_task.clone() )
+	{}
+
+	virtual ResidueTrialOP clone() const
+	{
+		return ResidueTrialOP( new RTMinTrial( rtmin_, *scfxn_, *input_task_ ) );
 	}
 
+	virtual conformation::ResidueOP trial( pose::Pose & pose, Size resid )
+	{
+		if ( ! minimizer_ ) {
+			minimizer_ = RTMinResidueMinimizerOP( new RTMinResidueMinimizer( pose, *scfxn_, input_task_->clone(),
+				pack::repackable_residues_dup( *input_task_ ), rtmin_.cartesian_, rtmin_.nonideal_ ) );
+		}
+		minimizer_->minimize( pose, resid );
+		return conformation::ResidueOP( new conformation::Residue( pose.residue( resid ) ) );
+	}
+
+	virtual void accept( pose::Pose & pose, Size resid, conformation::Residue const & rsd ) const
+	{
+		pose.replace_residue( resid, rsd, false );
+		if ( minimizer_ ) minimizer_->residue_replaced( pose, resid );
+	}
+
+private:
+	RTMin const & rtmin_;
+	scoring::ScoreFunctionOP scfxn_;
+	task::PackerTaskOP input_task_;
+	RTMinResidueMinimizerOP minimizer_;
+};
+
+void
+RTMin::rtmin(
+	pose::Pose & pose,
+	scoring::ScoreFunction const & scfxn,
+	task::PackerTaskOP input_task
+) const
+{
+	if ( ! use_parallel_residue_trials() ) {
+		serial_rtmin( pose, scfxn, input_task );
+		return;
+	}
+
+	// minimize residues that do not interact with one another at the same time
+	utility::vector1< Size > active_residues = pack::repackable_residues_dup( *input_task );
+	order_residues_for_coloring( active_residues );
+	graph::GraphOP packer_neighbor_graph = pack::create_packer_graph( pose, scfxn, input_task );
+	run_residue_trials( pose,
+		independent_residue_sets( pose, scfxn, *packer_neighbor_graph, active_residues ),
+		RTMinTrial( *this, scfxn, *input_task ) );
+}
+
+void
+RTMin::serial_rtmin(
+	pose::Pose & pose,
+	scoring::ScoreFunction const & scfxn,
+	task::PackerTaskOP input_task
+) const
+{
+	utility::vector1< Size > active_residues = pack::repackable_residues_dup( *input_task );
+	numeric::random::random_permutation( active_residues, numeric::random::rg() );
+
+	RTMinResidueMinimizer minimizer( pose, scfxn, input_task, active_residues, cartesian_, nonideal_ );
+
+	/// in real rtmin, the active residues will be examined in a random order;
+	/// random__shuffle( active_residues );
+
+	for ( Size ii = 1; ii <= active_residues.size(); ++ii ) {
+		minimizer.minimize( pose, active_residues[ ii ] );
+	}
 }
 
 /*{
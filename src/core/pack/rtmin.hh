@@ -60,6 +60,17 @@ public:
 		task::PackerTaskOP input_task
 	) const;
 
+private:
+	friend class RTMinTrial;
+
+	/// @brief visit the residues being packed one after the other, in random order
+	void
+	serial_rtmin(
+		pose::Pose & pose,
+		scoring::ScoreFunction const & sfxn,
+		task::PackerTaskOP input_task
+	) const;
+
 private:
 	// KAB - below line commented out by warnings removal script (-Wunused-private-field) on 2014-09-11
 	// bool minimize_ligand_chis_;
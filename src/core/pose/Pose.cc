@@ -1666,6 +1666,12 @@ Pose::dump_pdb(
 }
 
 
+Size
+Pose::last_copy_bytes() const
+{
+	return conformation_->last_copy_bytes() + energies_->last_copy_bytes();
+}
+
 Pose::ConstraintSetCOP
 Pose::constraint_set() const
 {
@@ -348,6 +348,12 @@ public:
 		return *energies_;
 	}
 
+	/// @brief Bytes of residue data and two-body energies written by the last assignment to this pose.
+	/// @details Assigning from a pose with the same sequence only rewrites the residues and energy
+	/// graph edges that differ, so this is a measure of how much actually changed between the two.
+	Size
+	last_copy_bytes() const;
+
 	ConstraintSetCOP
 	constraint_set() const;
 
@@ -265,6 +265,12 @@ Energies::energy_graph()
 	return *energy_graph_;
 }
 
+Size
+Energies::last_copy_bytes() const
+{
+	return energy_graph_->last_copy_bytes();
+}
+
 /// @details IA: Note derived classes may need access to graph before it has been initalized!
 /// In particular a derived class might overload update_residue_neighbors.
 Energies::EnergyGraph &
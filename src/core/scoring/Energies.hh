@@ -275,6 +275,10 @@ public:
 	EnergyGraph &
 	energy_graph();
 
+	/// @brief Bytes of two-body energies written by the last assignment to this object.
+	Size
+	last_copy_bytes() const;
+
 	/// @brief get the graph encoding # neighbors within 10 Angstroms
 	/// If the graph has not been requested up until this point, then it will
 	/// be instantiated and filled.  If the pose has changed size since the last
@@ -134,6 +134,15 @@ void EnergyEdge::copy_from( parent const * source )
 }
 
 
+bool EnergyEdge::same_data( EnergyEdge const & other ) const
+{
+	if ( energies_not_yet_computed_ != other.energies_not_yet_computed_ || dsqr_ != other.dsqr_ ) return false;
+	for ( Size ii = 0, ii_end = get_energy_owner()->n_active_score_types(); ii < ii_end; ++ii ) {
+		if ( array_[ ii ] != other.array_[ ii ] ) return false;
+	}
+	return true;
+}
+
 /// @brief set energies_computed_ to true for an edge
 void EnergyEdge::mark_energies_computed() { energies_not_yet_computed_ = false; }
 
@@ -197,7 +206,8 @@ EnergyGraph::EnergyGraph()
 	parent(),
 	energy_edge_pool_( new boost::unordered_object_pool< EnergyEdge > ( 256 ) ),
 	energy_array_pool_( 256 ),
-	score_type_2_active_( n_shortranged_2b_score_types, -1 )
+	score_type_2_active_( n_shortranged_2b_score_types, -1 ),
+	last_copy_bytes_( 0 )
 {}
 
 /// @details This does not call the base class parent( Size ) constructor since
@@ -208,7 +218,8 @@ EnergyGraph::EnergyGraph( Size num_nodes )
 	parent(),
 	energy_edge_pool_( new boost::unordered_object_pool< EnergyEdge > ( 256 ) ),
 	energy_array_pool_( 256 ),
-	score_type_2_active_( n_shortranged_2b_score_types, -1 )
+	score_type_2_active_( n_shortranged_2b_score_types, -1 ),
+	last_copy_bytes_( 0 )
 {
 	set_num_nodes( num_nodes );
 }
@@ -222,10 +233,12 @@ EnergyGraph::EnergyGraph( EnergyGraph const & src )
 	parent( ),
 	energy_edge_pool_( new boost::unordered_object_pool< EnergyEdge > ( 256 ) ),
 	energy_array_pool_( 256 ),
-	score_type_2_active_( n_shortranged_2b_score_types, -1 )
+	score_type_2_active_( n_shortranged_2b_score_types, -1 ),
+	last_copy_bytes_( 0 )
 {
 	active_score_types( src.active_2b_score_types_ );
 	parent::operator = ( src );
+	last_copy_bytes_ = num_edges() * ( n_active_score_types() * sizeof( Real ) + sizeof( DistanceSquared ) );
 }
 
 EnergyGraph::~EnergyGraph() {
@@ -257,14 +270,61 @@ EnergyGraph::add_energy_edge(
 
 
 /// @brief assignment operator -- performs a deep copy
+/// @details Graphs of the same size, as when MonteCarlo copies a pose back and forth with its last
+/// accepted state, keep the edges they share instead of dropping and reallocating every edge.
 EnergyGraph &
 EnergyGraph::operator = ( EnergyGraph const & rhs )
 {
+	if ( this == &rhs ) return *this;
+
 	active_score_types( rhs.active_2b_score_types_ );
-	parent::operator = ( rhs );
+	if ( num_nodes() == rhs.num_nodes() ) {
+		copy_changed_edges( rhs );
+	} else {
+		parent::operator = ( rhs );
+		last_copy_bytes_ = num_edges() * ( n_active_score_types() * sizeof( Real ) + sizeof( DistanceSquared ) );
+	}
 	return *this;
 }
 
+void
+EnergyGraph::copy_changed_edges( EnergyGraph const & rhs )
+{
+	Size const edge_bytes( n_active_score_types() * sizeof( Real ) + sizeof( DistanceSquared ) );
+	last_copy_bytes_ = 0;
+
+	for ( Size ii = 1; ii <= num_nodes(); ++ii ) {
+		get_node( ii )->copy_from( rhs.get_node( ii ) );
+	}
+
+	// Keep the run of edges at the head of the edge list that join the same nodes, in the same order,
+	// as rhs's, copying only those whose data differ; replace the rest with rhs's.  A node lists its
+	// upper edges in edge-list order and its lower edges in reverse, so every list ends up in the order
+	// a full copy gives, and the energies are summed in the same order.
+	graph::EdgeListIterator iter = edge_list_begin(), iter_end = edge_list_end();
+	graph::EdgeListConstIterator rhs_iter = rhs.const_edge_list_begin(), rhs_iter_end = rhs.const_edge_list_end();
+	for ( ; iter != iter_end && rhs_iter != rhs_iter_end; ++iter, ++rhs_iter ) {
+		EnergyEdge * edge( static_cast< EnergyEdge * > ( *iter ) );
+		EnergyEdge const * rhs_edge( static_cast< EnergyEdge const * > ( *rhs_iter ) );
+		if ( edge->get_first_node_ind() != rhs_edge->get_first_node_ind() ||
+				edge->get_second_node_ind() != rhs_edge->get_second_node_ind() ) break;
+		if ( ! edge->same_data( *rhs_edge ) ) {
+			edge->copy_from( rhs_edge );
+			last_copy_bytes_ += edge_bytes;
+		}
+	}
+
+	while ( iter != iter_end ) {
+		graph::Edge * edge( *iter );
+		++iter;
+		delete_edge( edge );
+	}
+	for ( ; rhs_iter != rhs_iter_end; ++rhs_iter ) {
+		add_edge( *rhs_iter );
+		last_copy_bytes_ += edge_bytes;
+	}
+}
+
 /// @details The array pool only needs to be resized if the number
 /// of active score types has changed; it doesn't have to be
 /// resized if the actual active types have changed but the number
@@ -96,6 +96,10 @@ public:
 	/// The source edge must be castable to class EnergyEdge.
 	virtual void copy_from( parent const * source );
 
+	/// @brief Does this edge hold the same data as the other edge?  Answering does not write to
+	/// either edge, so an unchanged edge can be left alone instead of being copied over.
+	bool same_data( EnergyEdge const & other ) const;
+
 	/// @brief Store the energies held in the input emap on this edge; only
 	/// those ScoreTypes which are active are stored.
 	inline void store_active_energies( EnergyMap const & emap );
@@ -188,6 +192,10 @@ public:
 
 	EnergyGraph & operator = ( EnergyGraph const & rhs );
 
+	/// @brief Bytes of edge data written by the last assignment to this graph.  Edges that held the
+	/// same data in both graphs are not counted: they are left untouched.
+	Size last_copy_bytes() const { return last_copy_bytes_; }
+
 	//bool energy_exists( scoring::ScoreType const & type ) const;
 
 	Size n_active_score_types() const { return active_2b_score_types_.size(); }
@@ -262,6 +270,12 @@ protected:
 	virtual graph::Edge * create_new_edge( Size index1, Size index2 );
 	virtual graph::Edge * create_new_edge( graph::Edge const * example_edge );
 
+private:
+	/// @brief assignment from a graph with the same number of nodes: keep the leading edges that match
+	/// rhs's edge for edge, copying only those whose data differ, and replace the others with copies
+	/// of rhs's, so that the edge lists come out in rhs's order
+	void copy_changed_edges( EnergyGraph const & rhs );
+
 private:
 
 	boost::unordered_object_pool< EnergyEdge > * energy_edge_pool_;
@@ -270,6 +284,8 @@ private:
 	ScoreTypes              active_2b_score_types_;
 	/// @brief these are flag values; <0 has a special meaning, so they need to be ints
 	utility::vector1< int > score_type_2_active_;
+
+	Size last_copy_bytes_;
 };
 
 
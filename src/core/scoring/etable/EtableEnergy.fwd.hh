@@ -23,6 +23,8 @@ namespace scoring {
 namespace etable {
 
 class EtableEnergy;
+class TableLookupEtableEnergy;
+class AnalyticEtableEnergy;
 
 class EtableEvaluator;
 class TableLookupEvaluator;
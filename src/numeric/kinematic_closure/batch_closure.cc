@@ -0,0 +1,197 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   numeric/kinematic_closure/batch_closure.cc
+/// @brief  Solve many independent kinematic closure problems at once.
+
+// Unit headers
+#include <numeric/kinematic_closure/batch_closure.hh>
+
+// Package headers
+#include <numeric/kinematic_closure/bridgeObjects.hh>
+
+// Utility headers
+#include <utility/thread/parallel_for.hh>
+
+// C++ headers
+#include <ctime>
+#include <ostream>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace numeric {
+namespace kinematic_closure {
+
+BatchClosureStats::BatchClosureStats() :
+	n_attempts_( 0 ),
+	n_solutions_( 0 ),
+	n_threads_( 1 ),
+	seconds_( 0.0 )
+{}
+
+Real
+BatchClosureStats::closures_per_second() const
+{
+	return seconds_ > 0.0 ? Real( n_attempts_ ) / seconds_ : 0.0;
+}
+
+void
+BatchClosureStats::show( std::ostream & os ) const
+{
+	os << "Solved " << n_attempts_ << " closure attempts (" << n_solutions_ << " solutions) on "
+		<< n_threads_ << " thread(s) in " << seconds_ << " s: " << closures_per_second() << " closures/s";
+}
+
+std::ostream &
+operator << ( std::ostream & os, BatchClosureStats const & stats )
+{
+	stats.show( os );
+	return os;
+}
+
+namespace {
+
+/// @brief Sink that keeps the solutions of every attempt, indexed by attempt.
+class StoringClosureSolutionSink : public ClosureSolutionSink {
+public:
+	StoringClosureSolutionSink( utility::vector1< ClosureAttemptSolutions > & solutions ) :
+		solutions_( solutions )
+	{}
+
+	virtual bool accept( Size attempt_index, ClosureAttemptSolutions const & solutions ) {
+		solutions_[ attempt_index ] = solutions;
+		return true;
+	}
+
+private:
+	utility::vector1< ClosureAttemptSolutions > & solutions_;
+};
+
+void
+solve_attempt(
+	CoordinateList const & atoms,
+	ClosureAttempt const & attempt,
+	utility::vector1< int > const & pivots,
+	utility::vector1< int > const & order,
+	ClosureAttemptSolutions & solutions
+)
+{
+	solutions.nsol = 0;
+	bridgeObjects( atoms, attempt.dt, attempt.da, attempt.db, pivots, order,
+		solutions.t_ang, solutions.b_ang, solutions.b_len, solutions.nsol );
+}
+
+#if defined MULTI_THREADED && defined CXX11
+
+/// @brief State shared by the threads solving one batch.
+struct BatchClosureWork {
+	BatchClosureWork() : n_solved( 0 ), n_solutions( 0 ), stop( false ) {}
+
+	Size n_solved;
+	Size n_solutions;
+	std::atomic< bool > stop;
+	std::mutex sink_mutex;
+};
+
+#endif
+
+}
+
+Size
+default_batch_closure_threads()
+{
+#if defined MULTI_THREADED && defined CXX11
+	Size const n_threads = std::thread::hardware_concurrency();
+	return n_threads > 0 ? n_threads : 1;
+#else
+	return 1;
+#endif
+}
+
+BatchClosureStats
+bridgeObjects_batch(
+	CoordinateList const & atoms,
+	utility::vector1< ClosureAttempt > const & attempts,
+	utility::vector1< int > const & pivots,
+	utility::vector1< int > const & order,
+	utility::vector1< ClosureAttemptSolutions > & solutions,
+	Size n_threads
+)
+{
+	solutions.clear();
+	solutions.resize( attempts.size() );
+	StoringClosureSolutionSink sink( solutions );
+	return bridgeObjects_batch( atoms, attempts, pivots, order, sink, n_threads );
+}
+
+BatchClosureStats
+bridgeObjects_batch(
+	CoordinateList const & atoms,
+	utility::vector1< ClosureAttempt > const & attempts,
+	utility::vector1< int > const & pivots,
+	utility::vector1< int > const & order,
+	ClosureSolutionSink & sink,
+	Size n_threads
+)
+{
+	BatchClosureStats stats;
+
+#if defined MULTI_THREADED && defined CXX11
+	std::chrono::steady_clock::time_point const start_time = std::chrono::steady_clock::now();
+
+	n_threads = utility::thread::parallel_thread_count( attempts.size(), n_threads );
+
+	// attempts are handed out one at a time so that slow attempts do not leave threads idle
+	BatchClosureWork work;
+	utility::vector1< ClosureAttemptSolutions > thread_solutions( n_threads );
+	utility::thread::parallel_for( attempts.size(), n_threads, [&]( Size ii, Size thread ) {
+		if ( work.stop ) return;
+		ClosureAttemptSolutions & solutions( thread_solutions[ thread ] );
+		solve_attempt( atoms, attempts[ ii ], pivots, order, solutions );
+
+		std::lock_guard< std::mutex > lock( work.sink_mutex );
+		if ( work.stop ) return;
+		++work.n_solved;
+		work.n_solutions += solutions.nsol;
+		if ( ! sink.accept( ii, solutions ) ) work.stop = true;
+	} );
+
+	stats.n_attempts( work.n_solved );
+	stats.n_solutions( work.n_solutions );
+	stats.n_threads( n_threads );
+	stats.seconds( std::chrono::duration< Real >( std::chrono::steady_clock::now() - start_time ).count() );
+#else
+	std::clock_t const start_time = std::clock();
+
+	Size n_solved( 0 ), n_solutions( 0 );
+	ClosureAttemptSolutions attempt_solutions;
+	for ( Size ii = 1; ii <= attempts.size(); ++ii ) {
+		solve_attempt( atoms, attempts[ ii ], pivots, order, attempt_solutions );
+		++n_solved;
+		n_solutions += attempt_solutions.nsol;
+		if ( ! sink.accept( ii, attempt_solutions ) ) break;
+	}
+
+	stats.n_attempts( n_solved );
+	stats.n_solutions( n_solutions );
+	stats.n_threads( 1 );
+	stats.seconds( Real( std::clock() - start_time ) / CLOCKS_PER_SEC );
+	(void) n_threads;
+#endif
+
+	return stats;
+}
+
+} // end namespace kinematic_closure
+} // end namespace numeric
@@ -0,0 +1,140 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   numeric/kinematic_closure/batch_closure.hh
+/// @brief  Solve many independent kinematic closure problems at once.
+/// @details Loop modeling protocols typically perturb the desired torsions, bond angles
+/// and bond lengths of a chain thousands of times and call bridgeObjects() on each
+/// perturbation.  Those closure problems share the chain's starting coordinates, pivots
+/// and order, and are otherwise independent, so they can be solved concurrently.
+/// In a multithreaded build (MULTI_THREADED and CXX11) the attempts are divided among
+/// worker threads; otherwise they are solved serially in the calling thread.
+
+#ifndef INCLUDED_numeric_kinematic_closure_batch_closure_hh
+#define INCLUDED_numeric_kinematic_closure_batch_closure_hh
+
+// Rosetta Headers
+#include <numeric/types.hh>
+#include <numeric/kinematic_closure/types.hh>
+
+// Utility headers
+#include <utility/vector1.hh>
+
+// C++ headers
+#include <iosfwd>
+
+namespace numeric {
+namespace kinematic_closure {
+
+/// @brief The perturbed inputs for a single closure attempt: desired torsions (dt),
+/// bond angles (da) and bond lengths (db) for every atom in the chain, exactly as
+/// they would be handed to bridgeObjects().
+struct ClosureAttempt {
+	ParameterList dt;
+	ParameterList da;
+	ParameterList db;
+};
+
+/// @brief The solutions bridgeObjects() found for one closure attempt.
+/// t_ang[j], b_ang[j] and b_len[j] describe solution j; nsol is the number of solutions.
+struct ClosureAttemptSolutions {
+	ClosureAttemptSolutions() : nsol( 0 ) {}
+
+	ParameterMatrix t_ang;
+	ParameterMatrix b_ang;
+	ParameterMatrix b_len;
+	int nsol;
+};
+
+/// @brief Receives the solutions for each closure attempt as soon as they are available.
+/// @details Solutions are delivered one attempt at a time, in no particular order when
+/// more than one thread is used; calls to accept() are serialized, so implementations
+/// do not need to be thread safe.  Returning false from accept() asks the solver to stop
+/// handing out attempts that have not yet been started (e.g. once enough solutions have
+/// been collected); attempts already in flight finish but are not delivered.
+class ClosureSolutionSink {
+public:
+	virtual ~ClosureSolutionSink() {}
+
+	/// @brief Handle the solutions for the attempt with the given (1-based) index.
+	virtual bool accept( Size attempt_index, ClosureAttemptSolutions const & solutions ) = 0;
+};
+
+/// @brief Throughput summary for a batch of closure attempts.
+class BatchClosureStats {
+public:
+	BatchClosureStats();
+
+	/// @brief Number of closure attempts that were solved.
+	Size n_attempts() const { return n_attempts_; }
+
+	/// @brief Total number of solutions found across all solved attempts.
+	Size n_solutions() const { return n_solutions_; }
+
+	/// @brief Number of threads that solved attempts.
+	Size n_threads() const { return n_threads_; }
+
+	/// @brief Wall-clock time spent solving the batch.
+	Real seconds() const { return seconds_; }
+
+	/// @brief Closure attempts solved per wall-clock second.
+	Real closures_per_second() const;
+
+	/// @brief Print a one-line summary.
+	void show( std::ostream & os ) const;
+
+	void n_attempts( Size setting ) { n_attempts_ = setting; }
+	void n_solutions( Size setting ) { n_solutions_ = setting; }
+	void n_threads( Size setting ) { n_threads_ = setting; }
+	void seconds( Real setting ) { seconds_ = setting; }
+
+private:
+	Size n_attempts_;
+	Size n_solutions_;
+	Size n_threads_;
+	Real seconds_;
+};
+
+std::ostream & operator << ( std::ostream & os, BatchClosureStats const & stats );
+
+/// @brief The number of threads bridgeObjects_batch() uses when n_threads is 0.
+/// @details Callers that generate their attempts in chunks can use this as the chunk size, so
+/// that each chunk keeps every thread busy.  Always 1 in builds without thread support.
+Size default_batch_closure_threads();
+
+/// @brief Solve every closure attempt in a batch, storing the solutions for attempt i in solutions[i].
+/// @details atoms, pivots and order are shared by all attempts and have the meaning they have
+/// for bridgeObjects().  n_threads of 0 means "use the hardware concurrency"; n_threads is
+/// ignored (and the batch is solved serially) in builds without thread support.
+BatchClosureStats
+bridgeObjects_batch(
+	CoordinateList const & atoms,
+	utility::vector1< ClosureAttempt > const & attempts,
+	utility::vector1< int > const & pivots,
+	utility::vector1< int > const & order,
+	utility::vector1< ClosureAttemptSolutions > & solutions,
+	Size n_threads = 0
+);
+
+/// @brief Solve the closure attempts in a batch, streaming the solutions of each attempt into sink.
+/// @details No per-attempt solutions are retained, so memory use is independent of the batch size.
+BatchClosureStats
+bridgeObjects_batch(
+	CoordinateList const & atoms,
+	utility::vector1< ClosureAttempt > const & attempts,
+	utility::vector1< int > const & pivots,
+	utility::vector1< int > const & order,
+	ClosureSolutionSink & sink,
+	Size n_threads = 0
+);
+
+} // end namespace kinematic_closure
+} // end namespace numeric
+
+#endif
@@ -17,8 +17,9 @@
 namespace numeric {
 namespace kinematic_closure {
 
-double RELERROR;
-int MAXIT, MAX_ITER_SECANT;
+THREAD_LOCAL double RELERROR;
+THREAD_LOCAL int MAXIT;
+THREAD_LOCAL int MAX_ITER_SECANT;
 
 } // end namespace kinematic_closure
 } // end namespace numeric
@@ -27,6 +27,7 @@
 
 
 #include <utility/vector1_bool.hh>
+#include <utility/thread/backwards_thread_local.hh>
 
 
 // Constants
@@ -46,8 +47,11 @@ typedef   struct p {
 	double coef[MAX_ORDER+1];
 } poly;
 
-extern double RELERROR;
-extern int MAXIT, MAX_ITER_SECANT;
+// Solver tolerances are set on every call to solve the closure polynomial; keep them
+// per-thread so that independent closure problems can be solved concurrently.
+extern THREAD_LOCAL double RELERROR;
+extern THREAD_LOCAL int MAXIT;
+extern THREAD_LOCAL int MAX_ITER_SECANT;
 
 /* set termination criteria for polynomial solver */
 inline
@@ -19,6 +19,7 @@
 
 // protocols headers
 #include <protocols/backrub/BackrubMover.hh>
+#include <protocols/jd2/AsyncOutputWriter.hh>
 #include <protocols/jd2/SilentFileJobOutputter.hh>
 #include <protocols/jd2/JobDistributor.hh>
 #include <protocols/jd2/Job.hh>
@@ -78,6 +79,12 @@
 
 // C++ Headers
 #include <vector>
+#include <limits>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <exception>
+#include <thread>
+#endif
 
 using basic::T;
 using basic::Error;
@@ -233,6 +240,13 @@ MetropolisHastingsMover::prepare_simulation( core::pose::Pose & pose ) {
 
 void
 MetropolisHastingsMover::apply( core::pose::Pose& pose ) {
+#if defined MULTI_THREADED && defined CXX11
+	if ( tempering_ && tempering_->n_replica_threads() > 1 ) {
+		run_replica_threads( pose );
+		return;
+	}
+#endif
+
 	output_name_from_job_distributor_ = false;
 
 	Size start_cycle = prepare_simulation( pose );
@@ -261,6 +275,88 @@ MetropolisHastingsMover::apply( core::pose::Pose& pose ) {
 	wind_down_simulation( pose );
 }
 
+#if defined MULTI_THREADED && defined CXX11
+/// @details Every replica gets its own clones of the movers, the observers and
+/// the MonteCarlo object, one of the controllers from
+/// TemperatureController::replica_controllers() and a copy of the current job,
+/// so that jd2::current_replica() and the output of the trajectory recorders
+/// tell the replicas apart as they do for MPI replicas.  The random seeds of
+/// the replica threads are drawn here, in order, so that a run is reproducible.
+/// The AsyncOutputWriter is started so that the replicas do not wait for each
+/// other's trajectory writes, and drained before this returns; if it was not
+/// running before, its thread is stopped again once the replicas joined.
+void
+MetropolisHastingsMover::run_replica_threads( core::pose::Pose & pose ) {
+	using namespace basic::options;
+
+	output_name_from_job_distributor_ = false;
+	if ( output_name() == "" ) {
+		set_output_name( protocols::jd2::JobDistributor::get_instance()->current_output_name() );
+		output_name_from_job_distributor_ = true;
+	}
+
+	utility::vector1< TemperatureControllerOP > const controllers( tempering_->replica_controllers() );
+	core::Size const nreplicas( controllers.size() );
+	tr.Info << "running " << nreplicas << " replicas as threads" << std::endl;
+
+	jd2::JobOP const job( jd2::get_current_job() );
+	utility::vector1< MetropolisHastingsMoverOP > replicas;
+	utility::vector1< core::pose::PoseOP > poses;
+	utility::vector1< jd2::JobOP > jobs;
+	utility::vector1< int > seeds;
+	for ( core::Size r = 1; r <= nreplicas; ++r ) {
+		MetropolisHastingsMoverOP replica( new MetropolisHastingsMover( *this ) );
+		for ( core::Size i = 1; i <= movers_.size(); ++i ) {
+			replica->movers_[i] = utility::pointer::static_pointer_cast< ThermodynamicMover >( movers_[i]->clone() );
+		}
+		for ( core::Size i = 1; i <= observers_.size(); ++i ) {
+			replica->observers_[i] = utility::pointer::static_pointer_cast< ThermodynamicObserver >( observers_[i]->clone() );
+		}
+		replica->tempering_ = controllers[r];
+		replica->tempering_->set_monte_carlo( replica->monte_carlo_ );
+		if ( job_outputter_ ) replica->job_outputter_ = jd2::SilentFileJobOutputterOP( new jd2::SilentFileJobOutputter() );
+		replicas.push_back( replica );
+		poses.push_back( pose.clone() );
+		jobs.push_back( job ? job->clone() : jd2::JobOP() );
+		seeds.push_back( numeric::random::rg().random_range( 1, std::numeric_limits< int >::max() - 1 ) );
+	}
+
+	// trajectory output of all replicas goes through the I/O thread instead of the shared recorder lock
+	bool const started_writer( protocols::jd2::AsyncOutputWriter::get_instance()->start() );
+
+	std::vector< std::exception_ptr > errors( nreplicas );
+	std::vector< std::thread > threads;
+	for ( core::Size r = 1; r <= nreplicas; ++r ) {
+		threads.push_back( std::thread( [&, r]{
+			numeric::random::rg().set_seed( option[ OptionKeys::run::rng ](), seeds[r] );
+			jd2::set_thread_replica( r, jobs[r] );
+			try {
+				replicas[r]->apply( *poses[r] );
+			} catch ( ... ) {
+				errors[r-1] = std::current_exception();
+				replicas[r]->tempering_->abort_replicas();
+			}
+			jd2::set_thread_replica( 0, jd2::JobOP() );
+		} ) );
+	}
+	for ( core::Size r = 0; r < threads.size(); ++r ) threads[r].join();
+	protocols::jd2::AsyncOutputWriter::get_instance()->flush();
+	if ( started_writer ) protocols::jd2::AsyncOutputWriter::get_instance()->shutdown();
+	for ( core::Size r = 0; r < errors.size(); ++r ) {
+		if ( errors[r] ) std::rethrow_exception( errors[r] );
+	}
+
+	core::Size coldest( 1 );
+	for ( core::Size r = 2; r <= nreplicas; ++r ) {
+		if ( replicas[r]->tempering_->temperature() < replicas[coldest]->tempering_->temperature() ) coldest = r;
+	}
+	tr.Info << "replica " << coldest << " ended at the lowest temperature" << std::endl;
+	pose = *poses[coldest];
+	current_trial_ = replicas[coldest]->current_trial_;
+	if ( output_name_from_job_distributor_ ) set_output_name( "" );
+}
+#endif
+
 void
 MetropolisHastingsMover::write_checkpoint( core::pose::Pose const & pose ) {
 	using namespace ObjexxFCL;
@@ -306,6 +306,14 @@ protected:
 	protocols::moves::MonteCarlo& nonconst_monte_carlo();
 private:
 
+#if defined MULTI_THREADED && defined CXX11
+	/// @brief Run the simulation once per replica of the temperature
+	/// controller, each replica on a thread and a copy of the pose of its own,
+	/// and leave the replica at the lowest temperature in the pose.
+	void run_replica_threads( core::pose::Pose & pose );
+#endif
+
+
 	// Configurable
 	protocols::moves::MonteCarloOP monte_carlo_;
 	core::Size ntrials_;
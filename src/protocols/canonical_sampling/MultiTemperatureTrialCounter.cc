@@ -23,8 +23,18 @@
 
 // Utility Headers
 #include <basic/Tracer.hh>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <mutex>
+#endif
+
 static THREAD_LOCAL basic::Tracer tr( "protocols.canonical_sampling.MultiTemperatureTrialCounter" );
 
+#if defined MULTI_THREADED && defined CXX11
+/// @brief replicas run as threads append to the same stats file
+static std::mutex write_to_file_mutex;
+#endif
+
 namespace protocols {
 namespace canonical_sampling {
 
@@ -65,6 +75,9 @@ MultiTemperatureTrialCounter::show( std::ostream& os ) const {
 
 void
 MultiTemperatureTrialCounter::write_to_file( std::string const& file, std::string const& tag ) const {
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( write_to_file_mutex );
+#endif
 	utility::io::ozstream out( file, std::ios::app );
 	_write_to_stream( out, tag );
 }
@@ -53,6 +53,7 @@
 #include <utility/tag/Tag.hh>
 #include <utility/io/ozstream.hh>
 #include <utility/io/izstream.hh>
+#include <utility/excn/Exceptions.hh>
 #include <ObjexxFCL/string.functions.hh>
 
 // basic headers
@@ -61,6 +62,12 @@
 // C++ Headers
 #include <cmath>
 
+#if defined MULTI_THREADED && defined CXX11
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#endif
+
 
 using basic::T;
 using basic::Error;
@@ -68,6 +75,9 @@ using basic::Warning;
 
 static THREAD_LOCAL basic::Tracer tr( "protocols.canonical_sampling.ParallelTempering" );
 
+// cmd-line options
+OPT_1GRP_KEY( Integer, tempering, replica_threads )
+
 
 bool protocols::canonical_sampling::ParallelTempering::options_registered_( false );
 
@@ -76,6 +86,8 @@ void protocols::canonical_sampling::ParallelTempering::register_options() {
 	if ( !options_registered_ ) {
 		options_registered_ = true;
 		Parent::register_options();
+		NEW_OPT( tempering::replica_threads, "run the replicas of a ParallelTempering simulation as threads of one process: "
+			"1 runs them as MPI processes, 0 runs one thread per temperature level (multithreaded builds only)", 1 );
 	}
 }
 
@@ -83,6 +95,34 @@ namespace protocols {
 namespace canonical_sampling {
 using namespace core;
 
+#if defined MULTI_THREADED && defined CXX11
+/// @brief Where the replicas of a simulation that run as threads meet for temperature moves,
+/// in place of the gather to and the scatter from rank 0 of the MPI replicas.
+class ReplicaExchangeBoard {
+public:
+	ReplicaExchangeBoard( core::Size nreplicas ) :
+		energies( nreplicas, 0.0 ),
+		levels( nreplicas, 0 ),
+		arrived( 0 ),
+		generation( 0 ),
+		aborted( false )
+	{}
+
+	std::mutex mutex;
+	/// @brief signalled when all replicas arrived and when replica 1 has shuffled the levels
+	std::condition_variable changed;
+	/// @brief the scores posted by the replicas, by rank
+	std::vector< double > energies;
+	/// @brief the temperature levels after the last exchange, by rank
+	std::vector< int > levels;
+	core::Size arrived;
+	/// @brief number of exchanges completed
+	core::Size generation;
+	/// @brief set when a replica failed: the others must not wait for it
+	bool aborted;
+};
+#endif
+
 std::string
 ParallelTemperingCreator::keyname() const {
 	return ParallelTemperingCreator::mover_name();
@@ -100,14 +140,15 @@ ParallelTemperingCreator::mover_name() {
 
 ParallelTempering::ParallelTempering() :
 	rank_( -1 ),
+	replica_threads_( 1 ),
 	last_energies_( NULL ),
 	rank2tlevel_( NULL ),
 	tlevel2rank_( NULL ),
 	start_time_(0),
 	total_mpi_wait_time_(0)
 {
-#ifndef USEMPI
-	utility_exit_with_message( "ParallelTempering requires MPI build" );
+#if !defined USEMPI && !( defined MULTI_THREADED && defined CXX11 )
+	utility_exit_with_message( "ParallelTempering requires an MPI or a multithreaded build" );
 #endif
 #ifdef USEMPI
 	mpi_comm_ = MPI_COMM_NULL;
@@ -117,6 +158,8 @@ ParallelTempering::ParallelTempering() :
 
 ParallelTempering::ParallelTempering( ParallelTempering const & other ) :
 	Parent( other ),
+	rank_( other.rank_ ),
+	replica_threads_( other.replica_threads_ ),
 	exchange_schedules_( other.exchange_schedules_ ),
 	last_exchange_schedule_( other.last_exchange_schedule_ ),
 	last_energies_( NULL ),
@@ -124,9 +167,12 @@ ParallelTempering::ParallelTempering( ParallelTempering const & other ) :
 	tlevel2rank_( NULL ),
 	start_time_( other.start_time_ ),
 	total_mpi_wait_time_( other.total_mpi_wait_time_ )
+#if defined MULTI_THREADED && defined CXX11
+	, board_( other.board_ )
+#endif
 {
-#ifndef USEMPI
-	utility_exit_with_message( "ParallelTempering requires MPI build" );
+#if !defined USEMPI && !( defined MULTI_THREADED && defined CXX11 )
+	utility_exit_with_message( "ParallelTempering requires an MPI or a multithreaded build" );
 #endif
 #ifdef USEMPI
 	set_mpi_comm( other.mpi_comm() );
@@ -137,6 +183,11 @@ ParallelTempering& ParallelTempering::operator=( ParallelTempering const& other
 	if ( &other == this ) return *this;
 	deallocate_buffers();
 	Parent::operator=( other );
+	rank_ = other.rank_;
+	replica_threads_ = other.replica_threads_;
+#if defined MULTI_THREADED && defined CXX11
+	board_ = other.board_;
+#endif
 #ifdef USEMPI
 	set_mpi_comm( other.mpi_comm() );
 #endif
@@ -161,7 +212,12 @@ ParallelTempering::initialize_simulation(
 	Parent::initialize_simulation(pose, metropolis_hastings_mover,cycle);
 	tr.Trace << "ParallelTempering::initialize_simul2... " << std::endl;
 #ifdef USEMPI
-	set_mpi_comm( jd2::current_mpi_comm() );
+	if ( !replicas_are_threads() ) set_mpi_comm( jd2::current_mpi_comm() );
+#else
+	if ( !replicas_are_threads() ) {
+		utility_exit_with_message( "ParallelTempering without MPI runs its replicas as threads: "
+			"use -tempering:replica_threads 0 or replica_threads=0 in the ParallelTempering tag" );
+	}
 #endif
 	tr.Trace << "ParallelTempering::initialize_simul3... " << std::endl;
 	Size const nlevels( n_temp_levels() );
@@ -186,7 +242,7 @@ ParallelTempering::finalize_simulation(
 	//if replica runs end at different times that leads to hanging in output for some reason
 	// this seems to help.
 #ifdef USEMPI
-	MPI_Barrier( mpi_comm() );
+	if ( !replicas_are_threads() ) MPI_Barrier( mpi_comm() );
 #endif
 
 	if ( rank() == 0 ) {
@@ -213,6 +269,8 @@ ParallelTempering::finalize_simulation(
 		tr.flags(oldflags);
 	}
 
+	if ( replicas_are_threads() ) return;
+
 	core::Real const clock_factor( ( (double) basic::SHRINK_FACTOR ) / CLOCKS_PER_SEC );
 	clock_t total_time(clock()/basic::SHRINK_FACTOR - start_time_);
 	core::Real fraction_waiting = total_mpi_wait_time_*clock_factor / ( total_time*clock_factor );
@@ -274,10 +332,17 @@ void ParallelTempering::deallocate_buffers() {
 }
 
 core::Real
-ParallelTempering::temperature_move( core::Real MPI_ONLY( score ) ) {
+ParallelTempering::temperature_move( core::Real score ) {
 	check_temp_consistency();
 	if ( !time_for_temp_move() ) return temperature();
 
+#if defined MULTI_THREADED && defined CXX11
+	if ( replicas_are_threads() ) {
+		set_current_temp( exchange_between_threads( score ) );
+		return temperature();
+	}
+#endif
+
 	// Size const nlevels( n_temp_levels() );
 #ifdef USEMPI
 	//get infomation
@@ -293,10 +358,103 @@ ParallelTempering::temperature_move( core::Real MPI_ONLY( score ) ) {
 	MPI_Scatter(rank2tlevel_, 1, MPI_INT, &new_tlevel, 1, MPI_INT, 0, mpi_comm() );
 	total_mpi_wait_time_ += ( clock() - time_before_MPI ) / basic::SHRINK_FACTOR;
 	set_current_temp( new_tlevel );
+#endif
+#if !defined USEMPI && !( defined MULTI_THREADED && defined CXX11 )
+	(void) score;
 #endif
 	return temperature();
 }
 
+bool
+ParallelTempering::replicas_are_threads() const {
+#if defined MULTI_THREADED && defined CXX11
+	return board_ != 0;
+#else
+	return false;
+#endif
+}
+
+/// @details Replicas run as threads only if -tempering:replica_threads or the replica_threads
+/// attribute asks for it; there is one thread per temperature level, as there is one MPI process.
+core::Size
+ParallelTempering::n_replica_threads() {
+#if defined MULTI_THREADED && defined CXX11
+	if ( !instance_initialized_ ) init_from_options();
+	// replicas that are processes of their own have a sub-rank within the job
+	if ( !board_ && replica_threads_ != 1 && jd2::current_replica() == 0 ) {
+		if ( replica_threads_ != 0 && replica_threads_ != n_temp_levels() ) {
+			utility_exit_with_message( "ParallelTempering runs one replica thread per temperature level: replica_threads must be 0, 1 or "
+				+ ObjexxFCL::string_of( n_temp_levels() ) );
+		}
+		return n_temp_levels();
+	}
+#endif
+	return 1;
+}
+
+utility::vector1< TemperatureControllerOP >
+ParallelTempering::replica_controllers() {
+	utility::vector1< TemperatureControllerOP > controllers;
+#if defined MULTI_THREADED && defined CXX11
+	Size const nreplicas( n_replica_threads() );
+	ReplicaExchangeBoardOP board( new ReplicaExchangeBoard( nreplicas ) );
+	for ( Size ii = 1; ii <= nreplicas; ++ii ) {
+		ParallelTemperingOP replica( new ParallelTempering( *this ) );
+		replica->board_ = board;
+		replica->rank_ = ii - 1;
+		controllers.push_back( replica );
+	}
+#else
+	controllers.push_back( utility::pointer::static_pointer_cast< TemperatureController >( clone() ) );
+#endif
+	return controllers;
+}
+
+void
+ParallelTempering::abort_replicas() {
+#if defined MULTI_THREADED && defined CXX11
+	if ( !board_ ) return;
+	std::lock_guard< std::mutex > lock( board_->mutex );
+	board_->aborted = true;
+	board_->changed.notify_all();
+#endif
+}
+
+#if defined MULTI_THREADED && defined CXX11
+/// @details Replica 1 (rank 0) waits until every replica posted its score and shuffles the levels
+/// with its own bookkeeping, exactly as rank 0 does with MPI; so with the same seeds the exchanges
+/// do not depend on the order in which the threads arrive.
+core::Size
+ParallelTempering::exchange_between_threads( core::Real score ) {
+	ReplicaExchangeBoard & board( *board_ );
+	Size const nreplicas( board.energies.size() );
+
+	std::unique_lock< std::mutex > lock( board.mutex );
+	board.energies[ rank_ ] = score;
+	++board.arrived;
+	Size const generation( board.generation );
+	if ( rank_ == 0 ) {
+		board.changed.wait( lock, [&]{ return board.arrived == nreplicas || board.aborted; } );
+		if ( !board.aborted ) {
+			shuffle_temperatures( &board.energies[ 0 ] );
+			for ( Size ii = 0; ii < nreplicas; ++ii ) {
+				board.levels[ ii ] = rank2tlevel_[ ii ];
+			}
+			board.arrived = 0;
+			++board.generation;
+			board.changed.notify_all();
+		}
+	} else {
+		if ( board.arrived == nreplicas ) board.changed.notify_all();
+		board.changed.wait( lock, [&]{ return board.generation != generation || board.aborted; } );
+	}
+	if ( board.aborted ) {
+		throw utility::excn::EXCN_Msg_Exception( "ParallelTempering: replica exchange abandoned because another replica failed" );
+	}
+	return board.levels[ rank_ ];
+}
+#endif
+
 void
 ParallelTempering::shuffle_temperatures( double *energies ) {
 	last_exchange_schedule_ = ( last_exchange_schedule_ + 1 ) % 2;
@@ -357,6 +515,7 @@ ParallelTempering::parse_my_tag(
 	pose::Pose const & pose
 ) {
 	Parent::parse_my_tag( tag, data, filters, movers, pose );
+	replica_threads_ = tag->getOption< Size >( "replica_threads", 1 );
 }
 
 
@@ -373,6 +532,7 @@ void ParallelTempering::init_from_options() {
 	using namespace basic::options::OptionKeys;
 	using namespace core;
 	Parent::init_from_options();
+	replica_threads_ = option[ tempering::replica_threads ]();
 }
 
 #ifdef USEMPI
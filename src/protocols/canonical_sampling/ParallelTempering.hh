@@ -41,6 +41,11 @@
 namespace protocols {
 namespace canonical_sampling {
 
+#if defined MULTI_THREADED && defined CXX11
+class ReplicaExchangeBoard;
+typedef utility::pointer::shared_ptr< ReplicaExchangeBoard > ReplicaExchangeBoardOP;
+#endif
+
 
 /// @brief
 /// @details The only way to set the temperature range used for simulated
@@ -50,6 +55,13 @@ namespace canonical_sampling {
 /// -tempering::temp::range <low> <high>
 /// -tempering::temp::low <low> -tempering::temp::high <high>
 /// @endcode
+///
+/// With the MPIMultiCommJobDistributor every replica is a process of its own
+/// and temperatures are exchanged through MPI.  Otherwise, in multithreaded
+/// builds, the MetropolisHastingsMover runs one thread per temperature level
+/// in this process.  The replicas share the score function tables and meet
+/// at a ReplicaExchangeBoard, where replica 1 shuffles the levels as rank 0
+/// does with MPI.
 class ParallelTempering : public protocols::canonical_sampling::TemperingBase {
 	typedef TemperingBase Parent;
 public:
@@ -107,6 +119,21 @@ public:
 		protocols::canonical_sampling::MetropolisHastingsMover const & metropolis_hastings_mover
 	);
 
+	/// @brief Return the number of temperature levels if the replicas are
+	/// to run as threads of this process, and 1 otherwise.
+	/// @details Replica threads are off unless -tempering:replica_threads or
+	/// the replica_threads attribute is 0 or the number of levels.
+	virtual
+	core::Size n_replica_threads();
+
+	/// @brief Return a controller for each replica thread, all meeting at a
+	/// new ReplicaExchangeBoard.
+	virtual
+	utility::vector1< TemperatureControllerOP > replica_controllers();
+
+	virtual
+	void abort_replicas();
+
 protected:
 	void set_defaults();
 	void init_from_options();
@@ -130,6 +157,15 @@ private:
 	void setup_exchange_schedule( Size nlevels );
 	void shuffle_temperatures( double *energies );
 
+	/// @brief Do the replicas of this simulation run as threads of this process?
+	bool replicas_are_threads() const;
+
+#if defined MULTI_THREADED && defined CXX11
+	/// @brief Post the score at the board, wait for the other replica threads
+	/// and return the new temperature level.
+	core::Size exchange_between_threads( core::Real score );
+#endif
+
 private:
 	static bool options_registered_;
 
@@ -143,6 +179,8 @@ private:
 #endif
 	// rank within mpi_comm_
 	int rank_;
+	// 1: replicas are MPI processes; 0 or the number of levels: one thread per level
+	core::Size replica_threads_;
 	typedef utility::vector1<std::pair<int, int> > ExchangeSchedule;
 	utility::vector0< ExchangeSchedule > exchange_schedules_;
 	core::Size last_exchange_schedule_;
@@ -155,6 +193,11 @@ private:
 	clock_t start_time_;
 	clock_t total_mpi_wait_time_;
 
+#if defined MULTI_THREADED && defined CXX11
+	/// @brief shared by the controllers of replicas run as threads
+	ReplicaExchangeBoardOP board_;
+#endif
+
 }; //end ParallelTempering
 
 } //namespace canonical_sampling
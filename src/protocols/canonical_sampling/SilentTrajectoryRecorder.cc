@@ -45,6 +45,10 @@
 // C++ headers
 #include <iomanip>
 
+#if defined MULTI_THREADED && defined CXX11
+#include <mutex>
+#endif
+
 // Operating system headers
 
 // Forward declarations
@@ -52,6 +56,12 @@ OPT_1GRP_KEY( Integer, trajectory, score_stride )
 
 static THREAD_LOCAL basic::Tracer tr( "protocols.canonical_sampling.SilentTrajectoryRecorder" );
 
+#if defined MULTI_THREADED && defined CXX11
+/// @brief replicas run as threads share the job outputter; the lock covers rendering and queuing the
+/// model, the file itself is written by the AsyncOutputWriter that MetropolisHastingsMover starts
+static std::mutex write_model_mutex;
+#endif
+
 bool protocols::canonical_sampling::SilentTrajectoryRecorder::options_registered_( false );
 
 void protocols::canonical_sampling::SilentTrajectoryRecorder::register_options() {
@@ -95,7 +105,8 @@ SilentTrajectoryRecorder::SilentTrajectoryRecorder(
 	SilentTrajectoryRecorder const & other
 ) :
 	TrajectoryRecorder(other),
-	score_stride_(other.score_stride_)
+	score_stride_(other.score_stride_),
+	job_outputter_(other.job_outputter_)
 {}
 
 protocols::moves::MoverOP
@@ -147,6 +158,9 @@ SilentTrajectoryRecorder::write_model(
 	std::string filename( metropolis_hastings_mover ? metropolis_hastings_mover->output_file_name(file_name(), cumulate_jobs(), cumulate_replicas()) : file_name() );
 	core::Size mc = model_count();
 	tr.Debug << "write model " << filename << " count: " << mc << std::endl;
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( write_model_mutex );
+#endif
 	job_outputter_->other_pose( jd2::get_current_job(),  pose, filename, mc,  ( mc % score_stride_ ) != 0 && mc > 1 );
 }
 
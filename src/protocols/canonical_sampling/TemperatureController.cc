@@ -119,6 +119,16 @@ TemperatureController::temperature_move( core::pose::Pose& pose ) {
 	return temperature_move( pose.energies().total_energy() );
 }
 
+utility::vector1< TemperatureControllerOP >
+TemperatureController::replica_controllers()
+{
+	utility::vector1< TemperatureControllerOP > controllers;
+	for ( core::Size ii = 1; ii <= n_replica_threads(); ++ii ) {
+		controllers.push_back( utility::pointer::static_pointer_cast< TemperatureController >( clone() ) );
+	}
+	return controllers;
+}
+
 std::string
 TemperatureController::get_name() const
 {
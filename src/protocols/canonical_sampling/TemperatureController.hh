@@ -181,6 +181,27 @@ public:
 		return trials > ntrials;
 	}
 
+	/// @brief Return the number of replicas of the simulation that the
+	/// MetropolisHastingsMover should run as threads of this process.
+	/// @details Each replica thread runs its own copy of the simulation with
+	/// one of the controllers returned by replica_controllers().  The default
+	/// is 1: the simulation runs on the calling thread, as do replicas that
+	/// are processes of their own.
+	virtual
+	core::Size n_replica_threads() { return 1; }
+
+	/// @brief Return one controller for each of the n_replica_threads()
+	/// replica threads.
+	/// @details Controllers of the same simulation share what they exchange;
+	/// the default returns clones of this controller.
+	virtual
+	utility::vector1< TemperatureControllerOP > replica_controllers();
+
+	/// @brief Release the replica threads waiting in an exchange with the
+	/// replica of this controller after that replica failed.
+	virtual
+	void abort_replicas() {}
+
 	/// @brief Set the MonteCarlo object to be controlled.
 	virtual
 	void set_monte_carlo(
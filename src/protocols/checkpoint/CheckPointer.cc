@@ -37,6 +37,7 @@
 #include <core/io/silent/SilentFileData.hh>
 #include <core/io/silent/silent.fwd.hh>
 #include <core/io/pdb/pdb_writer.hh>
+#include <core/io/serialization/compact_pose.hh>
 
 #if defined(WIN32) || defined(BOINC)
 #include <core/io/silent/SilentStructFactory.hh>
@@ -68,6 +69,9 @@ using basic::T;
 
 #include <basic/options/keys/run.OptionKeys.gen.hh>
 
+#include <fstream>
+#include <iterator>
+
 
 
 using basic::Error;
@@ -85,7 +89,7 @@ void FileBuffer::dump(){
 
 	//std::cerr << "Dumped checkpoint. " << std::endl;
 	if ( !gzipped_ ) {
-		utility::io::ozstream output( filename_ );
+		utility::io::ozstream output( filename_, std::ios_base::out | std::ios_base::binary );
 		if ( !output ) {
 			std::cout << "Cannot write checkpoint! open failed for file: " << filename_ << std::endl;
 			utility::exit( EXIT_FAILURE, __FILE__, __LINE__);
@@ -114,10 +118,36 @@ bool pose_to_binary_silent_file( std::ostream &output, const std::string &tag, c
 	return true;
 }
 
+/// @brief The contents of a checkpoint file of pose: a binary silent file, or a compressed
+/// compact pose record (core/io/serialization/compact_pose.hh) if compact is set.
+std::string checkpoint_file_contents( const std::string &tag, const pose::Pose &pose, bool compact ){
+	if ( compact ) return core::io::serialization::compact_pose( pose, true /*compress*/ );
+	std::stringstream ss_stream;
+	pose_to_binary_silent_file( ss_stream, tag, pose );
+	return ss_stream.str();
+}
+
 bool pose_from_binary_silent_file( const std::string &filename, const std::string &tag, pose::Pose &pose, bool fullatom ){
 	using namespace core::chemical;
 	ResidueTypeSetCOP residue_set;
 	pose::Pose tmppose;
+
+	// checkpoints written with -run:compact_pose_checkpoints
+	{
+		std::ifstream input( filename.c_str(), std::ios_base::in | std::ios_base::binary );
+		char magic[ 4 ];
+		if ( !input.read( magic, 4 ) ) return false;
+		if ( core::io::serialization::is_compact_pose( magic, 4 ) ) {
+			input.seekg( 0 );
+			std::string const contents( ( std::istreambuf_iterator< char >( input ) ), std::istreambuf_iterator< char >() );
+			core::io::serialization::read_compact_pose( contents, tmppose );
+			tmppose.transfer_constraint_set( pose );
+			pose.clear();
+			pose = tmppose;
+			return true;
+		}
+	}
+
 	if ( fullatom ) residue_set = ChemicalManager::get_instance()->residue_type_set( FA_STANDARD );
 	else           residue_set = ChemicalManager::get_instance()->residue_type_set( CENTROID );
 	core::io::silent::SilentFileData sfd("", false, false, "binary" );
@@ -140,6 +170,7 @@ CheckPointer::CheckPointer( std::string const& type ):
 {
 	using namespace basic::options;
 	delete_checkpoints_ = option[ OptionKeys::run::delete_checkpoints ]();
+	compact_poses_ = option[ OptionKeys::run::compact_pose_checkpoints ]();
 	if ( option[ OptionKeys::run::suppress_checkpoints ]() ) disabled_ = true;
 }
 
@@ -258,17 +289,13 @@ void CheckPointer::checkpoint(
 	if ( mc != 0 ) {
 		{
 			FileBuffer new_file(  checkpoint_id + "mc_last.out"  );
-			std::stringstream ss_stream;
-			pose_to_binary_silent_file( ss_stream , checkpoint_id, mc->last_accepted_pose() );
-			new_file.set_contents( ss_stream.str() );
+			new_file.set_contents( checkpoint_file_contents( checkpoint_id, mc->last_accepted_pose(), compact_poses_ ) );
 			file_buffer.push_back( new_file );
 		}
 
 		{
 			FileBuffer new_file(  checkpoint_id + "mc_low.out"  );
-			std::stringstream ss_stream;
-			pose_to_binary_silent_file( ss_stream , checkpoint_id, mc->lowest_score_pose() );
-			new_file.set_contents( ss_stream.str() );
+			new_file.set_contents( checkpoint_file_contents( checkpoint_id, mc->lowest_score_pose(), compact_poses_ ) );
 			file_buffer.push_back( new_file );
 		}
 		//  pose_to_binary_silent_file( checkpoint_id + "mc_last.out", checkpoint_id, mc->last_accepted_pose() );
@@ -277,9 +304,7 @@ void CheckPointer::checkpoint(
 
 	{
 		FileBuffer new_file(  checkpoint_id + ".out"  );
-		std::stringstream ss_stream;
-		pose_to_binary_silent_file( ss_stream , checkpoint_id, pose );
-		new_file.set_contents( ss_stream.str() );
+		new_file.set_contents( checkpoint_file_contents( checkpoint_id, pose, compact_poses_ ) );
 		file_buffer.push_back( new_file );
 	}
 
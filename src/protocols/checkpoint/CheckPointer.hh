@@ -165,6 +165,8 @@ private:
 
 	bool disabled_;
 	bool delete_checkpoints_;
+	/// @brief write poses as compact pose records instead of binary silent files
+	bool compact_poses_;
 	core::Size count_checkpoint_recoveries_;
 
 
@@ -0,0 +1,761 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   protocols/cluster/CoordinateClustering.cc
+/// @brief  coordinate-only all-vs-all RMSD and clustering of large decoy sets
+
+#include <protocols/cluster/CoordinateClustering.hh>
+
+#include <core/conformation/Residue.hh>
+#include <core/pose/Pose.hh>
+
+#include <basic/Tracer.hh>
+#include <numeric/alignment/QCP_Kernel.hh>
+#include <numeric/xyzVector.hh>
+#include <utility/exit.hh>
+#include <utility/string_util.hh>
+#include <utility/thread/parallel_for.hh>
+
+#include <ObjexxFCL/FArray2D.hh>
+
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <chrono>
+#endif
+
+namespace protocols {
+namespace cluster {
+
+static THREAD_LOCAL basic::Tracer TR( "protocols.cluster.CoordinateClustering" );
+
+using core::Size;
+using core::Real;
+
+namespace {
+
+char const RMSD_MATRIX_MAGIC[ 8 ] = { 'R', 'M', 'S', 'D', 'M', 'A', 'T', '1' };
+
+/// @details The nine sums of the QCP inner product are accumulated over the x, y and z runs of
+/// both decoys in one pass with independent accumulators, which compilers turn into packed
+/// multiply-adds.  The squared norms are precomputed per decoy, so only the 3x3 matrix is left.
+inline
+Real
+centered_qcp_rmsd(
+	float const * a,
+	float const * b,
+	Size stride,
+	Size n_atoms,
+	double sq_norm_a,
+	double sq_norm_b
+)
+{
+	float const * ax = a, * ay = a + stride, * az = a + 2 * stride;
+	float const * bx = b, * by = b + stride, * bz = b + 2 * stride;
+	double sxx( 0 ), sxy( 0 ), sxz( 0 ), syx( 0 ), syy( 0 ), syz( 0 ), szx( 0 ), szy( 0 ), szz( 0 );
+	for ( Size k = 0; k < n_atoms; ++k ) {
+		double const x1( ax[ k ] ), y1( ay[ k ] ), z1( az[ k ] );
+		double const x2( bx[ k ] ), y2( by[ k ] ), z2( bz[ k ] );
+		sxx += x1 * x2; sxy += x1 * y2; sxz += x1 * z2;
+		syx += y1 * x2; syy += y1 * y2; syz += y1 * z2;
+		szx += z1 * x2; szy += z1 * y2; szz += z1 * z2;
+	}
+	double A[ 9 ] = { sxx, sxy, sxz, syx, syy, syz, szx, szy, szz };
+	double const E0 = 0.5 * ( sq_norm_a + sq_norm_b );
+	return numeric::alignment::QCP_Kernel< double >::calc_rmsd_Theobald_method( A, E0, int( n_atoms ), NULL );
+}
+
+/// @brief decoys i_begin..i_end against decoys j_begin..j_end; only pairs with i < j are visited
+struct RmsdTile {
+	RmsdTile( Size ib, Size ie, Size jb, Size je ) : i_begin( ib ), i_end( ie ), j_begin( jb ), j_end( je ) {}
+	Size i_begin, i_end, j_begin, j_end;
+};
+
+/// @brief tiles covering rows row_begin..row_end of the upper triangle of an n x n matrix
+utility::vector1< RmsdTile >
+upper_triangle_tiles( Size row_begin, Size row_end, Size n, Size tile_size )
+{
+	utility::vector1< RmsdTile > tiles;
+	for ( Size ib = row_begin; ib <= row_end; ib += tile_size ) {
+		Size const ie = std::min( ib + tile_size - 1, row_end );
+		for ( Size jb = ib; jb <= n; jb += tile_size ) {
+			tiles.push_back( RmsdTile( ib, ie, jb, std::min( jb + tile_size - 1, n ) ) );
+		}
+	}
+	return tiles;
+}
+
+/// @brief receives the RMSD of every pair of a tile; each thread has its own
+class RmsdPairSink {
+public:
+	virtual ~RmsdPairSink() {}
+	virtual void pair( Size i, Size j, Real rmsd ) = 0;
+};
+
+/// @brief stores into a packed upper triangle whose first entry is the pair at offset base
+class PackedTriangleSink : public RmsdPairSink {
+public:
+	PackedTriangleSink( float * packed, Size n, std::size_t base ) : packed_( packed ), n_( n ), base_( base ) {}
+	virtual void pair( Size i, Size j, Real rmsd ) {
+		packed_[ ( i - 1 ) * ( 2 * n_ - i ) / 2 + ( j - i ) - 1 - base_ ] = float( rmsd );
+	}
+private:
+	float * packed_;
+	Size n_;
+	std::size_t base_;
+};
+
+/// @brief collects the pairs closer than the cutoff
+class NeighborPairSink : public RmsdPairSink {
+public:
+	NeighborPairSink( Real cutoff ) : cutoff_( cutoff ) {}
+	virtual void pair( Size i, Size j, Real rmsd ) {
+		if ( rmsd < cutoff_ ) pairs.push_back( std::make_pair( i, j ) );
+	}
+	std::vector< std::pair< Size, Size > > pairs;
+private:
+	Real cutoff_;
+};
+
+void
+compute_tile(
+	DecoyCoordinates const & coords,
+	RmsdTile const & tile,
+	RmsdPairSink & sink
+)
+{
+	for ( Size i = tile.i_begin; i <= tile.i_end; ++i ) {
+		for ( Size j = std::max( tile.j_begin, i + 1 ); j <= tile.j_end; ++j ) {
+			sink.pair( i, j, coords.rmsd( i, j ) );
+		}
+	}
+}
+
+/// @brief compute tiles[ ii ] into the sink of the thread computing it, for utility::thread::parallel_for()
+void
+compute_tile_on_thread(
+	DecoyCoordinates const & coords,
+	utility::vector1< RmsdTile > const & tiles,
+	utility::vector1< RmsdPairSink * > const & sinks,
+	Size ii,
+	Size thread
+)
+{
+	compute_tile( coords, tiles[ ii ], *sinks[ thread ] );
+}
+
+/// @details Tiles are handed out to the threads one at a time; thread ii reports into sinks[ ii ].
+void
+compute_tiles(
+	DecoyCoordinates const & coords,
+	utility::vector1< RmsdTile > const & tiles,
+	utility::vector1< RmsdPairSink * > const & sinks
+)
+{
+	utility::thread::parallel_for( tiles.size(), sinks.size(),
+		boost::bind( &compute_tile_on_thread, boost::cref( coords ), boost::cref( tiles ), boost::cref( sinks ), _1, _2 ) );
+}
+
+/// @brief wall clock in MULTI_THREADED builds, cpu time otherwise
+class Stopwatch {
+public:
+	Stopwatch() :
+#if defined MULTI_THREADED && defined CXX11
+		start_( std::chrono::steady_clock::now() )
+#else
+		start_( std::clock() )
+#endif
+	{}
+
+	Real seconds() const {
+#if defined MULTI_THREADED && defined CXX11
+		return std::chrono::duration< Real >( std::chrono::steady_clock::now() - start_ ).count();
+#else
+		return Real( std::clock() - start_ ) / CLOCKS_PER_SEC;
+#endif
+	}
+
+private:
+#if defined MULTI_THREADED && defined CXX11
+	std::chrono::steady_clock::time_point start_;
+#else
+	std::clock_t start_;
+#endif
+};
+
+void
+report_throughput( std::string const & what, Size n, Size n_threads, Real seconds )
+{
+	Real const n_pairs = Real( n ) * ( Real( n ) - 1 ) / 2;
+	TR << what << ": " << n_pairs << " RMSDs of " << n << " decoys on " << n_threads << " thread(s) in "
+		<< seconds << " s, " << ( seconds > 0.0 ? n_pairs / seconds : 0.0 ) << " RMSDs/s" << std::endl;
+}
+
+/// @brief collects the pairs closer than the cutoff from row blocks of a matrix
+class NeighborBlockVisitor : public RmsdBlockVisitor {
+public:
+	NeighborBlockVisitor( Real cutoff ) : cutoff_( cutoff ) {}
+	virtual void visit( Size n, Size row_begin, Size row_end, float const * block ) {
+		for ( Size i = row_begin; i <= row_end; ++i ) {
+			for ( Size j = i + 1; j <= n; ++j, ++block ) {
+				if ( *block < cutoff_ ) pairs.push_back( std::make_pair( i, j ) );
+			}
+		}
+	}
+	std::vector< std::pair< Size, Size > > pairs;
+private:
+	Real cutoff_;
+};
+
+/// @brief sum over j of rmsd(i,j), for every i
+class RowSumVisitor : public RmsdBlockVisitor {
+public:
+	RowSumVisitor( Size n ) : sums( n, 0.0 ) {}
+	virtual void visit( Size n, Size row_begin, Size row_end, float const * block ) {
+		for ( Size i = row_begin; i <= row_end; ++i ) {
+			for ( Size j = i + 1; j <= n; ++j, ++block ) {
+				sums[ i ] += *block;
+				sums[ j ] += *block;
+			}
+		}
+	}
+	utility::vector1< Real > sums;
+};
+
+/// @brief sum of the RMSDs of every decoy to the other members of its cluster
+class ClusterCostVisitor : public RmsdBlockVisitor {
+public:
+	ClusterCostVisitor( utility::vector1< Size > const & assignment ) : assignment_( assignment ), costs( assignment.size(), 0.0 ) {}
+	virtual void visit( Size n, Size row_begin, Size row_end, float const * block ) {
+		for ( Size i = row_begin; i <= row_end; ++i ) {
+			Size const cluster_i = assignment_[ i ];
+			for ( Size j = i + 1; j <= n; ++j, ++block ) {
+				if ( assignment_[ j ] != cluster_i ) continue;
+				costs[ i ] += *block;
+				costs[ j ] += *block;
+			}
+		}
+	}
+private:
+	utility::vector1< Size > const & assignment_;
+public:
+	utility::vector1< Real > costs;
+};
+
+/// @brief neighbor lists of n decoys from pairs (i,j) closer than the cutoff; the pair lists are emptied
+utility::vector1< utility::vector1< Size > >
+neighbors_from_pairs(
+	Size n,
+	utility::vector1< std::vector< std::pair< Size, Size > > * > const & pair_lists
+)
+{
+	utility::vector1< utility::vector1< Size > > neighbors( n );
+	utility::vector1< Size > counts( n, 0 );
+	for ( Size ii = 1; ii <= pair_lists.size(); ++ii ) {
+		std::vector< std::pair< Size, Size > > const & pairs( *pair_lists[ ii ] );
+		for ( Size jj = 0; jj < pairs.size(); ++jj ) {
+			++counts[ pairs[ jj ].first ];
+			++counts[ pairs[ jj ].second ];
+		}
+	}
+	for ( Size ii = 1; ii <= n; ++ii ) neighbors[ ii ].reserve( counts[ ii ] );
+	for ( Size ii = 1; ii <= pair_lists.size(); ++ii ) {
+		std::vector< std::pair< Size, Size > > & pairs( *pair_lists[ ii ] );
+		for ( Size jj = 0; jj < pairs.size(); ++jj ) {
+			neighbors[ pairs[ jj ].first ].push_back( pairs[ jj ].second );
+			neighbors[ pairs[ jj ].second ].push_back( pairs[ jj ].first );
+		}
+		std::vector< std::pair< Size, Size > >().swap( pairs );
+	}
+	for ( Size ii = 1; ii <= n; ++ii ) std::sort( neighbors[ ii ].begin(), neighbors[ ii ].end() );
+	return neighbors;
+}
+
+/// @brief rmsd of decoy i to medoid m, exactly 0 for the medoid itself
+inline
+Real
+rmsd_to_medoid( DecoyCoordinates const & coords, Size i, Size m )
+{
+	return i == m ? 0.0 : coords.rmsd( i, m );
+}
+
+/// @brief index into medoids of the medoid closest to decoy i
+Size
+closest_medoid( DecoyCoordinates const & coords, utility::vector1< Size > const & medoids, Size i )
+{
+	Size best( 1 );
+	Real best_rmsd( rmsd_to_medoid( coords, i, medoids[ 1 ] ) );
+	for ( Size mm = 2; mm <= medoids.size(); ++mm ) {
+		Real const rmsd( rmsd_to_medoid( coords, i, medoids[ mm ] ) );
+		if ( rmsd < best_rmsd ) { best_rmsd = rmsd; best = mm; }
+	}
+	return best;
+}
+
+/// @brief largest clusters first, ties broken by center
+bool
+larger_cluster( CoordinateCluster const & a, CoordinateCluster const & b )
+{
+	if ( a.members.size() != b.members.size() ) return a.members.size() > b.members.size();
+	return a.center < b.center;
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DecoyCoordinates
+
+DecoyCoordinates::DecoyCoordinates( Size n_atoms ) :
+	n_atoms_( n_atoms ),
+	stride_( ( n_atoms + 7 ) / 8 * 8 )
+{
+	if ( n_atoms_ == 0 ) utility_exit_with_message( "DecoyCoordinates needs at least one atom per decoy" );
+}
+
+DecoyCoordinates::~DecoyCoordinates() {}
+
+void
+DecoyCoordinates::reserve( Size n_decoys )
+{
+	coords_.reserve( n_decoys * 3 * stride_ );
+	sq_norms_.reserve( n_decoys );
+}
+
+Size
+DecoyCoordinates::add( utility::vector1< core::Vector > const & xyz )
+{
+	if ( xyz.size() != n_atoms_ ) {
+		utility_exit_with_message( "DecoyCoordinates: decoy has " + utility::to_string( xyz.size() )
+			+ " atoms, expected " + utility::to_string( n_atoms_ ) );
+	}
+	std::vector< double > runs( 3 * n_atoms_ );
+	for ( Size k = 1; k <= n_atoms_; ++k ) {
+		runs[ k - 1 ] = xyz[ k ].x();
+		runs[ n_atoms_ + k - 1 ] = xyz[ k ].y();
+		runs[ 2 * n_atoms_ + k - 1 ] = xyz[ k ].z();
+	}
+	return add_centered( runs );
+}
+
+Size
+DecoyCoordinates::add( ObjexxFCL::FArray2D< Real > const & xyz )
+{
+	if ( xyz.size1() != 3 || xyz.size2() != n_atoms_ ) {
+		utility_exit_with_message( "DecoyCoordinates: decoy has " + utility::to_string( xyz.size2() )
+			+ " atoms, expected " + utility::to_string( n_atoms_ ) );
+	}
+	std::vector< double > runs( 3 * n_atoms_ );
+	for ( Size k = 1; k <= n_atoms_; ++k ) {
+		for ( Size d = 0; d < 3; ++d ) runs[ d * n_atoms_ + k - 1 ] = xyz( d + 1, k );
+	}
+	return add_centered( runs );
+}
+
+/// @details xyz holds the x, y and z runs of the decoy, each n_atoms_ long
+Size
+DecoyCoordinates::add_centered( std::vector< double > & xyz )
+{
+	double sq_norm( 0.0 );
+	for ( Size d = 0; d < 3; ++d ) {
+		double * run = &xyz[ d * n_atoms_ ];
+		double center( 0.0 );
+		for ( Size k = 0; k < n_atoms_; ++k ) center += run[ k ];
+		center /= n_atoms_;
+		for ( Size k = 0; k < n_atoms_; ++k ) {
+			run[ k ] -= center;
+			// the norm is taken of the stored (float) coordinates so that identical decoys give exactly 0
+			double const stored = float( run[ k ] );
+			sq_norm += stored * stored;
+		}
+	}
+	coords_.resize( coords_.size() + 3 * stride_, 0.0f );
+	float * dest = &coords_[ coords_.size() - 3 * stride_ ];
+	for ( Size d = 0; d < 3; ++d ) {
+		for ( Size k = 0; k < n_atoms_; ++k ) dest[ d * stride_ + k ] = float( xyz[ d * n_atoms_ + k ] );
+	}
+	sq_norms_.push_back( sq_norm );
+	return sq_norms_.size();
+}
+
+Real
+DecoyCoordinates::rmsd( Size i, Size j ) const
+{
+	return centered_qcp_rmsd( coords( i ), coords( j ), stride_, n_atoms_, sq_norms_[ i ], sq_norms_[ j ] );
+}
+
+utility::vector1< core::Vector >
+cluster_coordinates(
+	core::pose::Pose const & pose,
+	bool backbone,
+	utility::vector1< int > const & exclude_res
+)
+{
+	utility::vector1< core::Vector > xyz;
+	for ( Size ii = 1; ii <= pose.total_residue(); ++ii ) {
+		if ( exclude_res.contains( int( ii ) ) ) continue;
+		core::conformation::Residue const & rsd( pose.residue( ii ) );
+		if ( ! rsd.is_protein() || ! rsd.has( "CA" ) ) continue;
+		if ( backbone && rsd.has( "N" ) ) xyz.push_back( rsd.xyz( "N" ) );
+		xyz.push_back( rsd.xyz( "CA" ) );
+		if ( backbone && rsd.has( "C" ) ) xyz.push_back( rsd.xyz( "C" ) );
+	}
+	return xyz;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RmsdMatrix
+
+RmsdMatrix::RmsdMatrix() :
+	size_( 0 )
+{}
+
+RmsdMatrix::~RmsdMatrix() {}
+
+void
+RmsdMatrix::compute( DecoyCoordinates const & coords, Size n_threads, Size tile_size )
+{
+	Stopwatch stopwatch;
+	size_ = coords.size();
+	packed_.assign( size_ * ( size_ - std::min( size_, Size( 1 ) ) ) / 2, 0.0f );
+	if ( size_ < 2 ) return;
+
+	utility::vector1< RmsdTile > const tiles( upper_triangle_tiles( 1, size_, size_, std::max( tile_size, Size( 1 ) ) ) );
+	n_threads = utility::thread::parallel_thread_count( tiles.size(), n_threads );
+	std::vector< PackedTriangleSink > sinks( n_threads, PackedTriangleSink( &packed_[ 0 ], size_, 0 ) );
+	utility::vector1< RmsdPairSink * > sink_ptrs;
+	for ( Size ii = 0; ii < n_threads; ++ii ) sink_ptrs.push_back( &sinks[ ii ] );
+	compute_tiles( coords, tiles, sink_ptrs );
+
+	report_throughput( "RMSD matrix", size_, n_threads, stopwatch.seconds() );
+}
+
+Real
+RmsdMatrix::operator() ( Size i, Size j ) const
+{
+	if ( i == j ) return 0.0;
+	if ( i > j ) std::swap( i, j );
+	return packed_[ index( i, j ) ];
+}
+
+void
+RmsdMatrix::write( std::string const & filename ) const
+{
+	FILE * file = fopen( filename.c_str(), "wb" );
+	if ( file == NULL ) utility_exit_with_message( "Cannot open RMSD matrix file " + filename + " for writing" );
+	boost::uint64_t const n = size_;
+	bool ok = fwrite( RMSD_MATRIX_MAGIC, 1, sizeof( RMSD_MATRIX_MAGIC ), file ) == sizeof( RMSD_MATRIX_MAGIC );
+	ok = ok && fwrite( &n, sizeof( n ), 1, file ) == 1;
+	if ( ok && ! packed_.empty() ) ok = fwrite( &packed_[ 0 ], sizeof( float ), packed_.size(), file ) == packed_.size();
+	if ( fclose( file ) != 0 ) ok = false;
+	if ( ! ok ) utility_exit_with_message( "Error writing RMSD matrix file " + filename );
+}
+
+void
+RmsdMatrix::read( std::string const & filename )
+{
+	FILE * file = fopen( filename.c_str(), "rb" );
+	if ( file == NULL ) utility_exit_with_message( "Cannot open RMSD matrix file " + filename );
+	char magic[ sizeof( RMSD_MATRIX_MAGIC ) ];
+	boost::uint64_t n( 0 );
+	bool ok = fread( magic, 1, sizeof( magic ), file ) == sizeof( magic )
+		&& std::memcmp( magic, RMSD_MATRIX_MAGIC, sizeof( magic ) ) == 0
+		&& fread( &n, sizeof( n ), 1, file ) == 1;
+	if ( ok ) {
+		size_ = n;
+		packed_.resize( size_ * ( size_ - std::min( size_, Size( 1 ) ) ) / 2 );
+		if ( ! packed_.empty() ) ok = fread( &packed_[ 0 ], sizeof( float ), packed_.size(), file ) == packed_.size();
+	}
+	fclose( file );
+	if ( ! ok ) {
+		size_ = 0;
+		packed_.clear();
+		utility_exit_with_message( "RMSD matrix file " + filename + " is truncated or not an RMSD matrix" );
+	}
+}
+
+void
+RmsdMatrix::visit_blocks( RmsdBlockVisitor & visitor ) const
+{
+	if ( size_ < 2 ) return;
+	visitor.visit( size_, 1, size_ - 1, &packed_[ 0 ] );
+}
+
+void
+RmsdMatrix::compute_to_file(
+	DecoyCoordinates const & coords,
+	std::string const & filename,
+	Size n_threads,
+	Size block_rows
+)
+{
+	Stopwatch stopwatch;
+	Size const n = coords.size();
+	block_rows = std::max( block_rows, Size( 1 ) );
+
+	FILE * file = fopen( filename.c_str(), "wb" );
+	if ( file == NULL ) utility_exit_with_message( "Cannot open RMSD matrix file " + filename + " for writing" );
+	boost::uint64_t const n64 = n;
+	bool ok = fwrite( RMSD_MATRIX_MAGIC, 1, sizeof( RMSD_MATRIX_MAGIC ), file ) == sizeof( RMSD_MATRIX_MAGIC );
+	ok = ok && fwrite( &n64, sizeof( n64 ), 1, file ) == 1;
+
+	// rows row_begin..row_end of the upper triangle are one contiguous run of the packed matrix
+	Size used_threads( 1 );
+	std::vector< float > block;
+	for ( Size row_begin = 1; ok && row_begin < n; row_begin += block_rows ) {
+		Size const row_end = std::min( row_begin + block_rows - 1, n - 1 );
+		std::size_t const base = ( row_begin - 1 ) * ( 2 * n - row_begin ) / 2;
+		std::size_t const end = row_end * ( 2 * n - row_end - 1 ) / 2;
+		block.assign( end - base, 0.0f );
+
+		utility::vector1< RmsdTile > const tiles( upper_triangle_tiles( row_begin, row_end, n, 64 ) );
+		used_threads = utility::thread::parallel_thread_count( tiles.size(), n_threads );
+		std::vector< PackedTriangleSink > sinks( used_threads, PackedTriangleSink( &block[ 0 ], n, base ) );
+		utility::vector1< RmsdPairSink * > sink_ptrs;
+		for ( Size ii = 0; ii < used_threads; ++ii ) sink_ptrs.push_back( &sinks[ ii ] );
+		compute_tiles( coords, tiles, sink_ptrs );
+
+		ok = fwrite( &block[ 0 ], sizeof( float ), block.size(), file ) == block.size();
+	}
+	if ( fclose( file ) != 0 ) ok = false;
+	if ( ! ok ) utility_exit_with_message( "Error writing RMSD matrix file " + filename );
+
+	report_throughput( "RMSD matrix to " + filename, n, used_threads, stopwatch.seconds() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RmsdMatrixFile
+
+RmsdMatrixFile::RmsdMatrixFile( std::string const & filename, Size block_rows ) :
+	filename_( filename ),
+	block_rows_( std::max( block_rows, Size( 1 ) ) ),
+	size_( 0 )
+{
+	FILE * file = fopen( filename_.c_str(), "rb" );
+	if ( file == NULL ) utility_exit_with_message( "Cannot open RMSD matrix file " + filename_ );
+	char magic[ sizeof( RMSD_MATRIX_MAGIC ) ];
+	boost::uint64_t n( 0 );
+	bool const ok = fread( magic, 1, sizeof( magic ), file ) == sizeof( magic )
+		&& std::memcmp( magic, RMSD_MATRIX_MAGIC, sizeof( magic ) ) == 0
+		&& fread( &n, sizeof( n ), 1, file ) == 1;
+	fclose( file );
+	if ( ! ok ) utility_exit_with_message( "RMSD matrix file " + filename_ + " is truncated or not an RMSD matrix" );
+	size_ = n;
+}
+
+RmsdMatrixFile::~RmsdMatrixFile() {}
+
+void
+RmsdMatrixFile::visit_blocks( RmsdBlockVisitor & visitor ) const
+{
+	Size const n = size_;
+	if ( n < 2 ) return;
+
+	FILE * file = fopen( filename_.c_str(), "rb" );
+	if ( file == NULL ) utility_exit_with_message( "Cannot open RMSD matrix file " + filename_ );
+	bool ok = fseek( file, long( sizeof( RMSD_MATRIX_MAGIC ) + sizeof( boost::uint64_t ) ), SEEK_SET ) == 0;
+
+	std::vector< float > block;
+	for ( Size row_begin = 1; ok && row_begin < n; row_begin += block_rows_ ) {
+		Size const row_end = std::min( row_begin + block_rows_ - 1, n - 1 );
+		std::size_t const base = ( row_begin - 1 ) * ( 2 * n - row_begin ) / 2;
+		std::size_t const end = row_end * ( 2 * n - row_end - 1 ) / 2;
+		block.resize( end - base );
+		ok = fread( &block[ 0 ], sizeof( float ), block.size(), file ) == block.size();
+		if ( ok ) visitor.visit( n, row_begin, row_end, &block[ 0 ] );
+	}
+	fclose( file );
+	if ( ! ok ) utility_exit_with_message( "RMSD matrix file " + filename_ + " is truncated" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// clustering
+
+utility::vector1< utility::vector1< Size > >
+neighbor_lists(
+	DecoyCoordinates const & coords,
+	Real cutoff,
+	Size n_threads,
+	Size tile_size
+)
+{
+	Stopwatch stopwatch;
+	Size const n = coords.size();
+	utility::vector1< utility::vector1< Size > > neighbors( n );
+	if ( n < 2 ) return neighbors;
+
+	utility::vector1< RmsdTile > const tiles( upper_triangle_tiles( 1, n, n, std::max( tile_size, Size( 1 ) ) ) );
+	n_threads = utility::thread::parallel_thread_count( tiles.size(), n_threads );
+	std::vector< NeighborPairSink > sinks( n_threads, NeighborPairSink( cutoff ) );
+	utility::vector1< RmsdPairSink * > sink_ptrs;
+	for ( Size ii = 0; ii < n_threads; ++ii ) sink_ptrs.push_back( &sinks[ ii ] );
+	compute_tiles( coords, tiles, sink_ptrs );
+
+	utility::vector1< std::vector< std::pair< Size, Size > > * > pair_lists;
+	for ( Size ii = 0; ii < sinks.size(); ++ii ) pair_lists.push_back( &sinks[ ii ].pairs );
+	neighbors = neighbors_from_pairs( n, pair_lists );
+
+	report_throughput( "Neighbor lists", n, n_threads, stopwatch.seconds() );
+	return neighbors;
+}
+
+utility::vector1< utility::vector1< Size > >
+neighbor_lists(
+	RmsdBlockSource const & rmsd,
+	Real cutoff
+)
+{
+	Stopwatch stopwatch;
+	NeighborBlockVisitor visitor( cutoff );
+	rmsd.visit_blocks( visitor );
+	utility::vector1< std::vector< std::pair< Size, Size > > * > pair_lists( 1, &visitor.pairs );
+	utility::vector1< utility::vector1< Size > > neighbors( neighbors_from_pairs( rmsd.size(), pair_lists ) );
+	TR << "Neighbor lists of " << rmsd.size() << " decoys from a precomputed matrix in " << stopwatch.seconds() << " s" << std::endl;
+	return neighbors;
+}
+
+utility::vector1< CoordinateCluster >
+taylor_butina_clusters(
+	DecoyCoordinates const & coords,
+	Real cutoff,
+	Size n_threads
+)
+{
+	utility::vector1< CoordinateCluster > const clusters( taylor_butina_clusters( neighbor_lists( coords, cutoff, n_threads ) ) );
+	TR << "Taylor-Butina: " << clusters.size() << " clusters of " << coords.size() << " decoys at " << cutoff << " A" << std::endl;
+	return clusters;
+}
+
+utility::vector1< CoordinateCluster >
+taylor_butina_clusters(
+	RmsdBlockSource const & rmsd,
+	Real cutoff
+)
+{
+	utility::vector1< CoordinateCluster > const clusters( taylor_butina_clusters( neighbor_lists( rmsd, cutoff ) ) );
+	TR << "Taylor-Butina: " << clusters.size() << " clusters of " << rmsd.size() << " decoys at " << cutoff << " A" << std::endl;
+	return clusters;
+}
+
+utility::vector1< CoordinateCluster >
+taylor_butina_clusters(
+	utility::vector1< utility::vector1< Size > > const & neighbors
+)
+{
+	Size const n = neighbors.size();
+
+	// most neighbors first, lower index first among equals
+	std::vector< std::pair< Size, Size > > order;
+	order.reserve( n );
+	for ( Size ii = 1; ii <= n; ++ii ) order.push_back( std::make_pair( n - neighbors[ ii ].size(), ii ) );
+	std::sort( order.begin(), order.end() );
+
+	utility::vector1< CoordinateCluster > clusters;
+	utility::vector1< bool > clustered( n, false );
+	for ( Size ii = 0; ii < order.size(); ++ii ) {
+		Size const center = order[ ii ].second;
+		if ( clustered[ center ] ) continue;
+		CoordinateCluster cluster;
+		cluster.center = center;
+		cluster.members.push_back( center );
+		clustered[ center ] = true;
+		for ( Size jj = 1; jj <= neighbors[ center ].size(); ++jj ) {
+			Size const member = neighbors[ center ][ jj ];
+			if ( clustered[ member ] ) continue;
+			clustered[ member ] = true;
+			cluster.members.push_back( member );
+		}
+		clusters.push_back( cluster );
+	}
+	std::stable_sort( clusters.begin(), clusters.end(), larger_cluster );
+	return clusters;
+}
+
+utility::vector1< CoordinateCluster >
+k_medoids_clusters(
+	DecoyCoordinates const & coords,
+	RmsdBlockSource const & rmsd,
+	Size k,
+	Size max_iterations
+)
+{
+	Size const n = rmsd.size();
+	if ( coords.size() != n ) {
+		utility_exit_with_message( "k_medoids_clusters: " + utility::to_string( coords.size() ) + " decoys but an RMSD matrix of "
+			+ utility::to_string( n ) );
+	}
+	k = std::min( k, n );
+	utility::vector1< CoordinateCluster > clusters;
+	if ( k == 0 ) return clusters;
+
+	// seed with the most central decoy, then repeatedly with the decoy farthest from all seeds
+	utility::vector1< Size > medoids;
+	RowSumVisitor row_sums( n );
+	rmsd.visit_blocks( row_sums );
+	Size first( 1 );
+	for ( Size ii = 2; ii <= n; ++ii ) if ( row_sums.sums[ ii ] < row_sums.sums[ first ] ) first = ii;
+	medoids.push_back( first );
+	utility::vector1< Real > nearest( n, 0.0 );
+	for ( Size ii = 1; ii <= n; ++ii ) nearest[ ii ] = rmsd_to_medoid( coords, ii, first );
+	while ( medoids.size() < k ) {
+		Size farthest( 1 );
+		for ( Size ii = 2; ii <= n; ++ii ) if ( nearest[ ii ] > nearest[ farthest ] ) farthest = ii;
+		if ( nearest[ farthest ] <= 0.0 ) break; // fewer distinct decoys than k
+		medoids.push_back( farthest );
+		for ( Size ii = 1; ii <= n; ++ii ) nearest[ ii ] = std::min( nearest[ ii ], rmsd_to_medoid( coords, ii, farthest ) );
+	}
+
+	k = medoids.size();
+
+	utility::vector1< Size > assignment( n, 0 );
+	for ( Size iter = 1; iter <= max_iterations; ++iter ) {
+		for ( Size ii = 1; ii <= n; ++ii ) assignment[ ii ] = closest_medoid( coords, medoids, ii );
+
+		// the new medoid of each cluster is the member with the smallest summed RMSD to the other members
+		ClusterCostVisitor cluster_costs( assignment );
+		rmsd.visit_blocks( cluster_costs );
+		utility::vector1< Size > best( medoids );
+		for ( Size ii = 1; ii <= n; ++ii ) {
+			Size const mm = assignment[ ii ];
+			if ( cluster_costs.costs[ ii ] < cluster_costs.costs[ best[ mm ] ] ) best[ mm ] = ii;
+		}
+
+		bool const changed( best != medoids );
+		medoids = best;
+		if ( ! changed ) {
+			TR << "k-medoids converged after " << iter << " iterations" << std::endl;
+			break;
+		}
+	}
+
+	// final assignment to the final medoids
+	clusters.resize( k );
+	utility::vector1< bool > is_medoid( n, false );
+	for ( Size mm = 1; mm <= k; ++mm ) {
+		clusters[ mm ].center = medoids[ mm ];
+		clusters[ mm ].members.push_back( medoids[ mm ] );
+		is_medoid[ medoids[ mm ] ] = true;
+	}
+	for ( Size ii = 1; ii <= n; ++ii ) {
+		if ( is_medoid[ ii ] ) continue;
+		clusters[ closest_medoid( coords, medoids, ii ) ].members.push_back( ii );
+	}
+	std::stable_sort( clusters.begin(), clusters.end(), larger_cluster );
+	TR << "k-medoids: " << k << " clusters of " << n << " decoys" << std::endl;
+	return clusters;
+}
+
+} // namespace cluster
+} // namespace protocols
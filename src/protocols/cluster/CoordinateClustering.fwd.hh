@@ -0,0 +1,45 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   protocols/cluster/CoordinateClustering.fwd.hh
+/// @brief  forward declarations for coordinate-only RMSD clustering
+
+
+#ifndef INCLUDED_protocols_cluster_CoordinateClustering_fwd_hh
+#define INCLUDED_protocols_cluster_CoordinateClustering_fwd_hh
+
+#include <utility/pointer/owning_ptr.hh>
+
+namespace protocols {
+namespace cluster {
+
+class DecoyCoordinates;
+typedef utility::pointer::shared_ptr< DecoyCoordinates > DecoyCoordinatesOP;
+typedef utility::pointer::shared_ptr< DecoyCoordinates const > DecoyCoordinatesCOP;
+
+class RmsdBlockSource;
+typedef utility::pointer::shared_ptr< RmsdBlockSource > RmsdBlockSourceOP;
+typedef utility::pointer::shared_ptr< RmsdBlockSource const > RmsdBlockSourceCOP;
+
+class RmsdMatrix;
+typedef utility::pointer::shared_ptr< RmsdMatrix > RmsdMatrixOP;
+typedef utility::pointer::shared_ptr< RmsdMatrix const > RmsdMatrixCOP;
+
+class RmsdMatrixFile;
+typedef utility::pointer::shared_ptr< RmsdMatrixFile > RmsdMatrixFileOP;
+typedef utility::pointer::shared_ptr< RmsdMatrixFile const > RmsdMatrixFileCOP;
+
+class RmsdBlockVisitor;
+
+struct CoordinateCluster;
+
+} // namespace cluster
+} // namespace protocols
+
+#endif // INCLUDED_protocols_cluster_CoordinateClustering_fwd_hh
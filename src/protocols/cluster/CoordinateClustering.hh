@@ -0,0 +1,237 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   protocols/cluster/CoordinateClustering.hh
+/// @brief  coordinate-only all-vs-all RMSD and clustering of large decoy sets
+/// @details Poses are reduced to the coordinates of the atoms being compared (CA or backbone)
+/// as soon as they are read, so memory is a few floats per atom per decoy instead of a Pose.
+/// Coordinates are stored centered and split into x, y and z runs so that the inner product
+/// of the QCP superposition (numeric/alignment/QCP_Kernel.hh) vectorizes.  The all-vs-all
+/// matrix is computed in square tiles handed out to threads in MULTI_THREADED builds; it can be
+/// kept in memory (RmsdMatrix) or streamed to disk row block by row block (RmsdMatrixFile).
+/// The clustering methods read a matrix through RmsdBlockSource one row block at a time, so a
+/// matrix on disk is clustered without loading it.  Taylor-Butina clustering straight from the
+/// coordinates only keeps the pairs closer than the cutoff and never stores the full matrix.
+
+#ifndef INCLUDED_protocols_cluster_CoordinateClustering_hh
+#define INCLUDED_protocols_cluster_CoordinateClustering_hh
+
+#include <protocols/cluster/CoordinateClustering.fwd.hh>
+
+#include <core/pose/Pose.fwd.hh>
+#include <core/types.hh>
+
+#include <utility/pointer/ReferenceCount.hh>
+#include <utility/vector1.hh>
+
+#include <ObjexxFCL/FArray2D.fwd.hh>
+
+#include <string>
+#include <vector>
+
+namespace protocols {
+namespace cluster {
+
+/// @brief The coordinates of the compared atoms of every decoy, centered, in one contiguous float array.
+class DecoyCoordinates : public utility::pointer::ReferenceCount {
+public:
+	/// @brief every decoy added must have n_atoms atoms
+	DecoyCoordinates( core::Size n_atoms );
+
+	virtual ~DecoyCoordinates();
+
+	core::Size n_atoms() const { return n_atoms_; }
+
+	/// @brief number of decoys
+	core::Size size() const { return sq_norms_.size(); }
+
+	/// @brief add a decoy; returns its (1-based) index
+	core::Size add( utility::vector1< core::Vector > const & xyz );
+
+	/// @brief add a decoy from a 3 x n_atoms array, e.g. SilentStruct::get_CA_xyz()
+	core::Size add( ObjexxFCL::FArray2D< core::Real > const & xyz );
+
+	/// @brief RMSD after optimal superposition of decoys i and j
+	core::Real rmsd( core::Size i, core::Size j ) const;
+
+	void reserve( core::Size n_decoys );
+
+private:
+	core::Size add_centered( std::vector< double > & xyz );
+
+	/// @brief x coordinates of decoy i; y and z follow at offsets stride_ and 2*stride_
+	float const * coords( core::Size i ) const { return &coords_[ ( i - 1 ) * 3 * stride_ ]; }
+
+private:
+	core::Size n_atoms_;
+	/// @brief n_atoms_ rounded up to a multiple of 8 so every run starts on a 32 byte boundary of the array
+	core::Size stride_;
+	std::vector< float > coords_;
+	/// @brief sum of squared centered coordinates of each decoy (the G term of QCP)
+	utility::vector1< double > sq_norms_;
+};
+
+/// @brief The atoms compared when clustering a pose: protein CA, or N, CA and C when backbone is true.
+/// Residues listed in exclude_res (as for -cluster:exclude_res) are skipped.
+utility::vector1< core::Vector >
+cluster_coordinates(
+	core::pose::Pose const & pose,
+	bool backbone,
+	utility::vector1< int > const & exclude_res
+);
+
+/// @brief Receives the strict upper triangle of an all-vs-all RMSD matrix one block of rows at a time.
+/// @details A block holds rows row_begin..row_end; each row i holds rmsd(i,j) for j = i+1..size,
+/// and the rows follow each other without gaps, as in the file format of RmsdMatrix::write().
+class RmsdBlockVisitor {
+public:
+	virtual ~RmsdBlockVisitor() {}
+
+	virtual void visit( core::Size size, core::Size row_begin, core::Size row_end, float const * block ) = 0;
+};
+
+/// @brief An all-vs-all RMSD matrix that can be read one block of rows at a time.
+class RmsdBlockSource : public utility::pointer::ReferenceCount {
+public:
+	virtual ~RmsdBlockSource() {}
+
+	/// @brief number of decoys
+	virtual core::Size size() const = 0;
+
+	/// @brief hand every row of the upper triangle to visitor, in order, one block at a time
+	virtual void visit_blocks( RmsdBlockVisitor & visitor ) const = 0;
+};
+
+/// @brief Symmetric all-vs-all RMSD matrix, storing only the strict upper triangle as floats.
+class RmsdMatrix : public RmsdBlockSource {
+public:
+	RmsdMatrix();
+
+	virtual ~RmsdMatrix();
+
+	/// @brief compute every pairwise RMSD of coords, in tiles of tile_size x tile_size decoys.
+	/// n_threads of 0 means hardware concurrency; ignored in builds without thread support.
+	void compute( DecoyCoordinates const & coords, core::Size n_threads = 1, core::Size tile_size = 64 );
+
+	/// @brief number of decoys
+	virtual core::Size size() const { return size_; }
+
+	core::Real operator() ( core::Size i, core::Size j ) const;
+
+	/// @brief the whole matrix as a single block
+	virtual void visit_blocks( RmsdBlockVisitor & visitor ) const;
+
+	/// @brief binary file: magic, decoy count, then the upper triangle row by row
+	void write( std::string const & filename ) const;
+
+	void read( std::string const & filename );
+
+	/// @brief compute the matrix of coords straight to a file in the format of write(), block_rows
+	/// rows at a time, so the full matrix never has to fit in memory; read it back with RmsdMatrixFile
+	static void
+	compute_to_file(
+		DecoyCoordinates const & coords,
+		std::string const & filename,
+		core::Size n_threads = 1,
+		core::Size block_rows = 256
+	);
+
+private:
+	/// @brief offset of (i,j), i < j, in the packed upper triangle
+	std::size_t index( core::Size i, core::Size j ) const {
+		return ( i - 1 ) * ( 2 * size_ - i ) / 2 + ( j - i ) - 1;
+	}
+
+private:
+	core::Size size_;
+	std::vector< float > packed_;
+};
+
+/// @brief An RMSD matrix file written by RmsdMatrix::write() or RmsdMatrix::compute_to_file(),
+/// read block_rows rows at a time on every visit_blocks() instead of being loaded.
+class RmsdMatrixFile : public RmsdBlockSource {
+public:
+	RmsdMatrixFile( std::string const & filename, core::Size block_rows = 256 );
+
+	virtual ~RmsdMatrixFile();
+
+	virtual core::Size size() const { return size_; }
+
+	virtual void visit_blocks( RmsdBlockVisitor & visitor ) const;
+
+private:
+	std::string filename_;
+	core::Size block_rows_;
+	core::Size size_;
+};
+
+/// @brief A cluster of decoys, identified by their 1-based indices; the center is also members[1].
+struct CoordinateCluster {
+	CoordinateCluster() : center( 0 ) {}
+	core::Size center;
+	utility::vector1< core::Size > members;
+};
+
+/// @brief for every decoy, the decoys within cutoff of it (excluding itself), in increasing order
+utility::vector1< utility::vector1< core::Size > >
+neighbor_lists(
+	DecoyCoordinates const & coords,
+	core::Real cutoff,
+	core::Size n_threads = 1,
+	core::Size tile_size = 64
+);
+
+/// @brief for every decoy, the decoys within cutoff of it (excluding itself), in increasing order,
+/// from one pass over the row blocks of a precomputed matrix
+utility::vector1< utility::vector1< core::Size > >
+neighbor_lists(
+	RmsdBlockSource const & rmsd,
+	core::Real cutoff
+);
+
+/// @brief Taylor-Butina clustering: in order of decreasing number of neighbors within cutoff, every
+/// decoy not yet clustered becomes a center and takes all of its unclustered neighbors.  Clusters
+/// come out largest first.
+utility::vector1< CoordinateCluster >
+taylor_butina_clusters(
+	DecoyCoordinates const & coords,
+	core::Real cutoff,
+	core::Size n_threads = 1
+);
+
+/// @brief Taylor-Butina clustering of a precomputed matrix, read in one pass
+utility::vector1< CoordinateCluster >
+taylor_butina_clusters(
+	RmsdBlockSource const & rmsd,
+	core::Real cutoff
+);
+
+/// @brief Taylor-Butina clustering of the neighbor lists of neighbor_lists()
+utility::vector1< CoordinateCluster >
+taylor_butina_clusters(
+	utility::vector1< utility::vector1< core::Size > > const & neighbors
+);
+
+/// @brief k-medoids clustering (farthest-first seeding, then alternating assignment and medoid
+/// update until the medoids stop changing or max_iterations is reached).  Clusters come out largest first.
+/// @details The distances of every decoy to the current medoids are computed from coords; only the
+/// seeding and each medoid update read the all-pairs matrix, one pass over its row blocks each, so
+/// rmsd may be a matrix on disk.
+utility::vector1< CoordinateCluster >
+k_medoids_clusters(
+	DecoyCoordinates const & coords,
+	RmsdBlockSource const & rmsd,
+	core::Size k,
+	core::Size max_iterations = 100
+);
+
+} // namespace cluster
+} // namespace protocols
+
+#endif
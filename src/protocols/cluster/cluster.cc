@@ -23,6 +23,7 @@
 #include <core/scoring/rms_util.tmpl.hh>
 #include <core/scoring/ScoreFunction.hh>
 #include <protocols/cluster/cluster.hh>
+#include <protocols/cluster/CoordinateClustering.hh>
 #include <protocols/idealize/IdealizeMover.hh>
 #include <protocols/jobdist/standard_mains.hh>
 #include <protocols/moves/Mover.hh>
@@ -197,6 +198,31 @@ GatherPosesMover::get_distance_measure(
 
 } // native_CA_rmsd
 
+bool
+GatherPosesMover::coordinate_rmsd_compatible( Pose const & pose ) const {
+	using namespace basic::options;
+	using namespace basic::options::OptionKeys;
+
+	// mirrors the choices made in get_distance_measure()
+	if ( option[ OptionKeys::cluster::hotspot_hash ]() || option[ OptionKeys::cluster::gdtmm ]() ) return false;
+	if ( option[ basic::options::OptionKeys::symmetry::symmetric_rmsd ]() ) return false;
+	if ( pose.total_residue() == 0 || pose.residue(1).is_RNA() ) return false;
+	if ( option[ OptionKeys::cluster::exclude_res ].user() ) return true;
+	if ( option[ basic::options::OptionKeys::cluster::skip_align ].user() || cluster_by_all_atom_ ) return false;
+	return true;
+}
+
+utility::vector1< core::Vector >
+GatherPosesMover::coordinate_rmsd_atoms( Pose const & pose ) const {
+	using namespace basic::options;
+	using namespace basic::options::OptionKeys;
+
+	if ( option[ OptionKeys::cluster::exclude_res ].user() ) {
+		return cluster_coordinates( pose, false, option[ OptionKeys::cluster::exclude_res ]() );
+	}
+	return cluster_coordinates( pose, cluster_by_protein_backbone_, utility::vector1< int >() );
+}
+
 
 void GatherPosesMover::set_score_function(  scoring::ScoreFunctionOP sfxn ) {
 	sfxn_ = sfxn;
@@ -317,10 +343,17 @@ void ClusterBase::calculate_distance_matrix() {
 
 	std::vector<int> histcount(hist_size,0);
 
+	bool const coordinate_rmsd = option[ basic::options::OptionKeys::cluster::coordinate_rmsd ]() && calculate_coordinate_distance_matrix();
+
 	for ( Size i = 0; i < poselist.size(); i++ ) {
 		for ( Size j = i; j < poselist.size(); j++ ) {
 			// only do comparisons once
 			if ( i < j ) {
+				if ( coordinate_rmsd ) {
+					int histbin = int( distance_matrix( i+1, j+1 ) / hist_resolution );
+					if ( histbin < hist_size ) histcount[histbin]+=1;
+					continue;
+				}
 				// get the similarity between structure with index i and with index j
 				Real dist  = get_distance_measure( poselist[i],poselist[j]);
 				distance_matrix( i+1, j+1 ) = dist;
@@ -359,6 +392,33 @@ void ClusterBase::calculate_distance_matrix() {
 
 } // calculate_distance_matrix
 
+bool ClusterBase::calculate_coordinate_distance_matrix() {
+	if ( poselist.empty() || ! coordinate_rmsd_compatible( poselist[0] ) ) return false;
+
+	// reduce every pose to the superimposed atoms once, instead of once per pair
+	utility::vector1< core::Vector > xyz( coordinate_rmsd_atoms( poselist[0] ) );
+	if ( xyz.empty() ) return false;
+	DecoyCoordinates coords( xyz.size() );
+	coords.reserve( poselist.size() );
+	for ( Size i = 0; i < poselist.size(); i++ ) {
+		if ( i > 0 ) xyz = coordinate_rmsd_atoms( poselist[i] );
+		if ( xyz.size() != coords.n_atoms() ) {
+			tr.Warning << "Structures differ in the number of atoms to superimpose; not using coordinate RMSDs" << std::endl;
+			return false;
+		}
+		coords.add( xyz );
+	}
+
+	RmsdMatrix rmsd;
+	rmsd.compute( coords, option[ basic::options::OptionKeys::cluster::nthreads ]() );
+	for ( Size i = 1; i <= poselist.size(); i++ ) {
+		for ( Size j = i+1; j <= poselist.size(); j++ ) {
+			distance_matrix( i, j ) = distance_matrix( j, i ) = rmsd( i, j );
+		}
+	}
+	return true;
+}
+
 // PostProcessing ---------------------------------------------------------
 void ClusterBase::add_structure( Pose & pose ) {
 
@@ -78,6 +78,13 @@ public:
 		const core::pose::Pose & pose2
 	) const;
 
+	/// @brief Is get_distance_measure() for pose the RMSD after superposition of the atoms
+	/// returned by coordinate_rmsd_atoms(), so that it can be computed from coordinates alone?
+	virtual bool coordinate_rmsd_compatible( core::pose::Pose const & pose ) const;
+
+	/// @brief The atoms get_distance_measure() superimposes (CA, or backbone when clustering by protein backbone)
+	utility::vector1< core::Vector > coordinate_rmsd_atoms( core::pose::Pose const & pose ) const;
+
 protected:
 	std::vector< core::pose::Pose > poselist;
 
@@ -235,6 +242,11 @@ public:
 
 	std::vector < Cluster >  const & get_cluster_list() const{ return clusterlist; }
 
+protected:
+	/// @brief fill distance_matrix with the coordinate RMSD engine (CoordinateClustering.hh);
+	/// returns false, leaving it untouched, if the distance measure cannot be computed that way
+	bool calculate_coordinate_distance_matrix();
+
 protected:
 	ObjexxFCL::FArray2D< core::Real >    distance_matrix;
 	std::vector < Cluster >    clusterlist;
@@ -280,6 +292,9 @@ public:
 		const core::pose::Pose & pose2
 	) const;
 
+	/// @brief this distance measure is not a plain coordinate RMSD
+	virtual bool coordinate_rmsd_compatible( core::pose::Pose const & ) const { return false; }
+
 private:
 	protocols::loops::Loops loop_def_;
 };
@@ -302,6 +317,9 @@ public:
 		const core::pose::Pose & pose2
 	) const;
 
+	/// @brief this distance measure is not a plain coordinate RMSD
+	virtual bool coordinate_rmsd_compatible( core::pose::Pose const & ) const { return false; }
+
 private:
 	protocols::rosetta_scripts::PosePropertyReporterOP reporter_;
 };
@@ -55,6 +55,10 @@ void CustomScoreSelector::select_fragments(
 		ExtraScoreVector::value_type p(input_canditates[i], v);
 		tmp.push_back( p );
 	}
+	// the chunk columns built by do_caching() serve every candidate from the same chunk; free them once all are scored
+	for ( Size i=1; i<=input_canditates.size(); i++ ) {
+		input_canditates[i].first->get_chunk()->release_columns();
+	}
 
 	std::sort(tmp.begin(), tmp.end(), sort_function);
 	for ( Size i = 1; i <= n; i++ ) {
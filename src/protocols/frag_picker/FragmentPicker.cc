@@ -81,6 +81,7 @@
 #include <utility/io/ozstream.hh>
 #include <utility/file/FileName.hh>
 #include <utility/file/file_sys_util.hh>
+#include <utility/thread/parallel_for.hh>
 
 #include <utility>
 #include <sstream>
@@ -91,7 +92,7 @@
 
 
 #if defined MULTI_THREADED && defined CXX11
-#include <thread>
+#include <boost/bind.hpp>
 #elif defined USE_BOOST_THREAD
 // Boost headers
 #include <boost/thread.hpp>
@@ -110,6 +111,25 @@ using namespace basic::options::OptionKeys;
 
 static THREAD_LOCAL basic::Tracer tr( "protocols.frag_picker.FragmentPicker" );
 
+#if defined MULTI_THREADED && defined CXX11
+namespace {
+
+/// @brief  scores chunk i into the collectors of thread index, for utility::thread::parallel_for()
+void pick_chunk_candidates_on_thread( FragmentPicker & picker, utility::vector1<VallChunkOP> const & chunks,
+	Size i, Size index ) {
+	picker.pick_candidates_from_chunk( chunks[i], index );
+}
+
+/// @brief  finds the nonlocal pairs of slice j of the query positions, for utility::thread::parallel_for()
+void nonlocal_pairs_on_thread( FragmentPicker & picker, utility::vector1<utility::vector1<Size> > const & positions,
+	Size fragment_size, utility::vector1<bool> const & skip, utility::vector1<Candidates> const & fragment_set,
+	utility::vector1<utility::vector1<nonlocal::NonlocalPairOP> > & pairs, Size j, Size ) {
+	if ( positions[j].size() > 0 ) picker.nonlocal_pairs_at_positions( positions[j], fragment_size, skip, fragment_set, pairs[j] );
+}
+
+}
+#endif
+
 FragmentPicker::~FragmentPicker() {}
 
 void FragmentPicker::bounded_protocol() {
@@ -619,36 +639,27 @@ void FragmentPicker::nonlocal_pairs( Size const fragment_size, utility::vector1<
 
 #if (defined MULTI_THREADED && defined CXX11) || defined USE_BOOST_THREAD
 
-#if defined MULTI_THREADED && defined CXX11
-	utility::vector1<std::thread> threads;
-#elif defined USE_BOOST_THREAD
-	boost::thread_group threads;
-#endif
 	tr.super_mute(true); // lets suppress tracer output when running multi threads
 	for ( Size j = 1; j <= max_threads_; ++j ) {
 		if ( qPosi_to_run[j].size() > 0 ) {
 			std::cout << "thread: " << j << " - " << qPosi_to_run[j].size() << " positions -";
 			for ( Size pos = 1; pos <= qPosi_to_run[j].size(); ++pos ) std::cout << " " << qPosi_to_run[j][pos];
 			std::cout << std::endl;
+		}
+	}
 #if defined MULTI_THREADED && defined CXX11
-			threads.push_back( std::thread( boost::bind(
-				&FragmentPicker::nonlocal_pairs_at_positions,
-				this,
-				boost::ref(qPosi_to_run[j]),
-				fragment_size,
-				boost::ref(skip_position),
-				boost::ref(fragment_set),
-				boost::ref(thread_pairs[j]))));
-			//&FragmentPicker::nonlocal_pairs_at_positions, this, qPosi_to_run[j], fragment_size, skip_position, fragment_set, thread_pairs[j]));
+	// one slice of the query positions per item, on the same pool as pick_candidates()
+	utility::thread::parallel_for( max_threads_, max_threads_,
+		boost::bind( &nonlocal_pairs_on_thread, boost::ref(*this), boost::cref(qPosi_to_run), fragment_size,
+		boost::cref(skip_position), boost::cref(fragment_set), boost::ref(thread_pairs), _1, _2 ) );
 #elif defined USE_BOOST_THREAD
+	boost::thread_group threads;
+	for ( Size j = 1; j <= max_threads_; ++j ) {
+		if ( qPosi_to_run[j].size() > 0 ) {
 			threads.create_thread(boost::bind(&FragmentPicker::nonlocal_pairs_at_positions, this, boost::ref(qPosi_to_run[j]), fragment_size, boost::ref(skip_position),
 				boost::ref(fragment_set), boost::ref(thread_pairs[j])));
-#endif
 		}
 	}
-#if defined MULTI_THREADED && defined CXX11
-	for ( auto& th : threads ) th.join();
-#elif defined USE_BOOST_THREAD
 	threads.join_all();
 #endif
 	tr.super_mute(false);
@@ -976,30 +987,35 @@ FragmentPicker::output_pair_counts(
 	}
 }
 
+// should be thread safe
+void FragmentPicker::pick_candidates_from_chunk(VallChunkOP chunk, Size const & index) {
+	scores_[index]->do_caching(chunk);
+	scores::FragmentScoreMapOP empty_map = scores_[index]->create_empty_map();
+	for ( Size iFragSize = 1; iFragSize <= frag_sizes_.size(); ++iFragSize ) { // Loop over various sizes of fragments
+		Size fragment_size = frag_sizes_[iFragSize];
+		if ( chunk->size() < fragment_size ) continue; // This fragment is too short
+		CandidatesCollectorOP sink = candidates_sinks_[index][fragment_size];
+		for ( Size iqpos = 1; iqpos <= query_positions_.size(); ++iqpos ) { // loop over positions in a query
+			Size iPos = query_positions_[iqpos];
+			if ( iPos > size_of_query() - fragment_size + 1 ) continue;
+			// split chunk into fragment candidates and score them
+			for ( Size j = 1; j <= chunk->size() - fragment_size + 1; j++ ) {
+				FragmentCandidateOP f( new FragmentCandidate(iPos, j, chunk, fragment_size) );
+				if ( scores_[index]->score_fragment_from_cache(f, empty_map) ) {
+					std::pair<FragmentCandidateOP,scores::FragmentScoreMapOP> p(f,empty_map);
+					if ( sink->add(p) ) empty_map  = scores_[index]->create_empty_map();
+				}
+			}
+		} // all query positions done
+	} // all fragment sizes done
+	scores_[index]->clean_up();
+	chunk->release_columns();
+}
+
 // should be thread safe
 void FragmentPicker::pick_chunk_candidates(utility::vector1<VallChunkOP> const & chunks, Size const & index) {
 	for ( Size i=1; i<=chunks.size(); ++i ) {
-		VallChunkOP chunk = chunks[i];
-		scores_[index]->do_caching(chunk);
-		scores::FragmentScoreMapOP empty_map = scores_[index]->create_empty_map();
-		for ( Size iFragSize = 1; iFragSize <= frag_sizes_.size(); ++iFragSize ) { // Loop over various sizes of fragments
-			Size fragment_size = frag_sizes_[iFragSize];
-			if ( chunk->size() < fragment_size ) continue; // This fragment is too short
-			CandidatesCollectorOP sink = candidates_sinks_[index][fragment_size];
-			for ( Size iqpos = 1; iqpos <= query_positions_.size(); ++iqpos ) { // loop over positions in a query
-				Size iPos = query_positions_[iqpos];
-				if ( iPos > size_of_query() - fragment_size + 1 ) continue;
-				// split chunk into fragment candidates and score them
-				for ( Size j = 1; j <= chunk->size() - fragment_size + 1; j++ ) {
-					FragmentCandidateOP f( new FragmentCandidate(iPos, j, chunk, fragment_size) );
-					if ( scores_[index]->score_fragment_from_cache(f, empty_map) ) {
-						std::pair<FragmentCandidateOP,scores::FragmentScoreMapOP> p(f,empty_map);
-						if ( sink->add(p) ) empty_map  = scores_[index]->create_empty_map();
-					}
-				}
-			} // all query positions done
-		} // all fragment sizes done
-		scores_[index]->clean_up();
+		pick_candidates_from_chunk( chunks[i], index );
 	} // all chunks
 }
 
@@ -1015,47 +1031,41 @@ void FragmentPicker::pick_candidates() {
 #if (defined MULTI_THREADED && defined CXX11) || defined USE_BOOST_THREAD
 
 	if ( max_threads_ > 1 ) {
-		utility::vector1<utility::vector1<VallChunkOP> > chunks_to_run( max_threads_ );
-		Size valid_chunks_cnt = 0;
+		utility::vector1<VallChunkOP> valid_chunks;
 		for ( Size i = 1; i <= chunks_->size(); ++i ) { // loop over provided chunks
 			VallChunkOP chunk = chunks_->at(i);
 			if ( !is_valid_chunk( chunk ) ) continue;
-			valid_chunks_cnt++;
+			valid_chunks.push_back( chunk );
 		}
-		const Size chunks_per_thread = valid_chunks_cnt/max_threads_;
+		tr.super_mute(true); // lets suppress tracer output when running multi threads
+#if defined MULTI_THREADED && defined CXX11
+		// every thread scores whole chunks into its own score manager and candidate collectors,
+		// which are merged once all chunks are done; chunks differ a lot in length, so they are
+		// handed out one at a time rather than in equal-count slices fixed up front
+		utility::thread::parallel_for( valid_chunks.size(), max_threads_,
+			boost::bind( &pick_chunk_candidates_on_thread, boost::ref(*this), boost::cref(valid_chunks), _1, _2 ) );
+#elif defined USE_BOOST_THREAD
+		utility::vector1<utility::vector1<VallChunkOP> > chunks_to_run( max_threads_ );
+		const Size chunks_per_thread = valid_chunks.size()/max_threads_;
 		Size thread = 1;
-		for ( Size i = 1; i <= chunks_->size(); ++i ) { // loop over provided chunks
-			VallChunkOP chunk = chunks_->at(i);
-			if ( !is_valid_chunk( chunk ) ) continue;
-			chunks_to_run[thread].push_back( chunk );
+		for ( Size i = 1; i <= valid_chunks.size(); ++i ) {
+			chunks_to_run[thread].push_back( valid_chunks[i] );
 			if ( chunks_to_run[thread].size() >= chunks_per_thread && thread < max_threads_ ) ++thread;
 		}
-#if defined MULTI_THREADED && defined CXX11
-		utility::vector1<std::thread> threads;
-#elif defined USE_BOOST_THREAD
 		boost::thread_group threads;
-#endif
-		tr.super_mute(true); // lets suppress tracer output when running multi threads
 		for ( Size j = 1; j <= max_threads_; ++j ) {
 			if ( chunks_to_run[j].size() > 0 ) {
 				std::cout << "thread: " << j << " - " << chunks_to_run[j].size() << " chunks" << std::endl;
-#if defined MULTI_THREADED && defined CXX11
-				threads.push_back(std::thread(&FragmentPicker::pick_chunk_candidates,this,chunks_to_run[j],j));
-#elif defined USE_BOOST_THREAD
 				threads.create_thread(boost::bind(&FragmentPicker::pick_chunk_candidates, this, boost::ref(chunks_to_run[j]), j));
-#endif
 			}
 		}
-#if defined MULTI_THREADED && defined CXX11
-		for ( auto& th : threads ) th.join();
-#elif defined USE_BOOST_THREAD
 		threads.join_all();
 #endif
 		tr.super_mute(false);
 
 		time_t time_end = time(NULL);
-		tr.Info << "... done.  Processed " << chunks_->size() << " chunks.  Time elapsed: "
-			<< (time_end - time_start) << " seconds." << std::endl;
+		tr.Info << "... done.  Processed " << chunks_->size() << " chunks on " << max_threads_
+			<< " threads.  Time elapsed: " << (time_end - time_start) << " seconds." << std::endl;
 		tr.flush();
 
 		PROF_STOP( basic::FRAGMENTPICKING );
@@ -1065,39 +1075,13 @@ void FragmentPicker::pick_candidates() {
 
 #endif  // (defined MULTI_THREADED && defined CXX11) || defined USE_BOOST_THREAD
 
-	scores::FragmentScoreMapOP empty_map = scores_[1]->create_empty_map();
-
 	for ( Size i = 1; i <= chunks_->size(); i++ ) { // loop over provided chunks
 		VallChunkOP chunk = chunks_->at(i); // For each chunk from a provider...
 		if ( !is_valid_chunk( chunk ) ) continue;
 		tr.Trace << "Processing sequence from vall: " << chunk->get_sequence() << std::endl;
 
-		// cache the new chunk
-		scores_[1]->do_caching(chunk);
-
-		for ( Size iFragSize = 1; iFragSize <= frag_sizes_.size(); ++iFragSize ) { // Loop over various sizes of fragments
-			Size fragment_size = frag_sizes_[iFragSize];
-			if ( chunk->size() < fragment_size ) continue; // This fragment is too short
-
-			Size maxqpos = size_of_query() - fragment_size + 1;
-			CandidatesCollectorOP sink = candidates_sinks_[1][fragment_size];
-			tr.Trace << "Picking fragments of size "<<fragment_size<<
-				" at "<<query_positions_.size()<<" query positions"<<std::endl;
-			for ( Size iqpos = 1; iqpos <= query_positions_.size(); ++iqpos ) { // loop over positions in a query
-				Size iPos = query_positions_[iqpos];
-				if ( iPos > maxqpos ) continue;
-
-				// split chunk into fragment candidates and score them
-				for ( Size j = 1; j <= chunk->size() - fragment_size + 1; ++j ) {
-					FragmentCandidateOP f( new FragmentCandidate(iPos, j, chunk, fragment_size) );
-					if ( scores_[1]->score_fragment_from_cache(f, empty_map) ) {
-						std::pair<FragmentCandidateOP,scores::FragmentScoreMapOP> p(f,empty_map);
-						if ( sink->add(p) ) empty_map  = scores_[1]->create_empty_map();
-					}
-				}
-			} // all query positions done
-		} // all fragment sizes done
-		scores_[1]->clean_up();
+		pick_candidates_from_chunk( chunk, 1 );
+
 		tr.Trace << chunk->get_pdb_id() << " done" << std::endl;
 		if ( (i*100) % (chunks_->size()/100*100) == 0 ) {
 			tr.Info << (i*100) / chunks_->size()
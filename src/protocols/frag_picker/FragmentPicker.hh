@@ -289,6 +289,10 @@ public:
 	/// multi-threaded task
 	void pick_chunk_candidates(utility::vector1<VallChunkOP> const & chunks, Size const & index);
 
+	/// @brief scores every candidate of a single chunk with score manager index into the
+	/// candidate collectors of the same index (one per thread)
+	void pick_candidates_from_chunk(VallChunkOP chunk, Size const & index);
+
 	void pick_candidates();
 
 	void pick_candidates(Size i_pos,Size frag_len);
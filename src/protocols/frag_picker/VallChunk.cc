@@ -38,6 +38,34 @@ VallChunk::VallChunk(VallProviderAP provider) {
 	sequence_ = "";
 	my_provider_ = provider;
 	has_key_ = false;
+	has_columns_ = false;
+}
+
+void VallChunk::build_columns() {
+
+	Size const n = residues_.size();
+	columns_.profile.assign(n * 20, 0.0);
+	columns_.profile_struct.assign(n * 20, 0.0);
+	columns_.ss.assign(n, 3);
+	for ( Size i = 1; i <= n; ++i ) {
+		VallResidue const & r = *residues_[i];
+		utility::vector1<core::Real> const & prof = r.profile();
+		for ( Size k = 1; k <= 20 && k <= prof.size(); ++k ) columns_.profile[(i-1)*20 + k-1] = prof[k];
+		utility::vector1<core::Real> const & prof_struct = r.profile_struct();
+		for ( Size k = 1; k <= 20 && k <= prof_struct.size(); ++k ) columns_.profile_struct[(i-1)*20 + k-1] = prof_struct[k];
+		if ( r.ss() == 'H' ) columns_.ss[i-1] = 1;
+		if ( r.ss() == 'E' ) columns_.ss[i-1] = 2;
+	}
+	has_columns_ = true;
+}
+
+void VallChunk::release_columns() {
+
+	// swap with empty vectors: clear() alone would keep the memory
+	std::vector<core::Real>().swap(columns_.profile);
+	std::vector<core::Real>().swap(columns_.profile_struct);
+	std::vector<unsigned char>().swap(columns_.ss);
+	has_columns_ = false;
 }
 
 
@@ -29,9 +29,22 @@
 #include <utility/vector1.hh>
 #include <utility/exit.hh>
 
+#include <vector>
+
 namespace protocols {
 namespace frag_picker {
 
+/// @brief  the per-residue data of a VallChunk that fragment scores read in their inner loops,
+/// stored column by column in contiguous arrays. Residue i of the chunk is at index i-1.
+struct VallChunkColumns {
+	/// @brief  residue profiles, 20 values per residue
+	std::vector<core::Real> profile;
+	/// @brief  residue structure profiles, 20 values per residue (zeros if the vall has none)
+	std::vector<core::Real> profile_struct;
+	/// @brief  secondary structure: 1 for H, 2 for E, 3 for L (and anything else)
+	std::vector<unsigned char> ss;
+};
+
 /// @brief  represents a chunk of residues extracted from a vall.
 /// @details VallChunk contains a vector of VallResidue objects and provides a basic ways to access them
 class VallChunk: public utility::pointer::ReferenceCount, public utility::pointer::enable_shared_from_this< VallChunk >
@@ -110,6 +123,18 @@ public:
 	/// @brief  returns a string that is unique for each chunk in vall
 	std::string & chunk_key() { if ( !has_key_ ) { create_key(); } return chunk_key_; }
 
+	/// @brief  returns the data of this chunk's residues as contiguous columns
+	/// @details the columns are built when this function is called for the first time and kept
+	/// with the chunk until release_columns(). They are not locked: the picker hands every chunk
+	/// to a single thread.
+	VallChunkColumns const & columns() {
+		if ( !has_columns_ ) build_columns();
+		return columns_;
+	}
+
+	/// @brief  frees the columns once the chunk has been scored; columns() rebuilds them if asked again
+	void release_columns();
+
 private:
 	utility::vector1<VallResidueOP> residues_;
 	std::string sequence_;
@@ -117,8 +142,11 @@ private:
 	std::string chunk_key_;
 	Size vall_key_;
 	bool has_key_;
+	VallChunkColumns columns_;
+	bool has_columns_;
 
 	void create_key();
+	void build_columns();
 };
 
 } // frag_picker
@@ -27,6 +27,8 @@
 #include <utility/vector1.hh>
 
 
+#include <vector>
+
 namespace protocols {
 namespace frag_picker {
 namespace scores {
@@ -56,6 +58,8 @@ protected:
 
 private:
 	sequence::SequenceProfileOP query_profile_;
+	/// @brief the query profile, 20 contiguous values per residue
+	std::vector<Real> query_rows_;
 	std::string cached_scores_id_;
 	void clear();
 };
@@ -22,6 +22,7 @@
 #include <protocols/frag_picker/FragmentPicker.hh>
 #include <protocols/frag_picker/FragmentCandidate.hh>
 #include <protocols/frag_picker/VallChunk.hh>
+#include <protocols/frag_picker/scores/fragment_scoring_utilities.hh>
 #include <protocols/frag_picker/scores/FragmentScoreMap.hh>
 
 // mini headers
@@ -56,6 +57,8 @@ ProfileScoreStructL1::ProfileScoreStructL1(Size priority, Real lowest_acceptable
 	for ( Size i = 1; i <= query_profile->length(); ++i ) {
 		utility::vector1<Real> row(longest_vall_chunk);
 		scores_.push_back(row);
+		utility::vector1<Real> const & prof_row = query_profile->prof_row(i);
+		for ( Size k = 1; k <= 20; ++k ) query_rows_.push_back( k <= prof_row.size() ? prof_row[k] : 0.0 );
 	}
 	create_cache(frag_sizes,query_profile->length(),longest_vall_chunk,cache_);
 	if ( trProfScoreL1.visible() ) {
@@ -83,7 +86,7 @@ void ProfileScoreStructL1::do_caching(VallChunkOP chunk) {
 		if ( cache_[fl].size() != 0 ) {
 			trProfScoreL1.Debug << "caching profile score for " << chunk->get_pdb_id()
 				<< " of size " << chunk->size() << " for fragment size "<<fl<<std::endl;
-			rolling_score(scores_,fl,cache_[fl]);
+			rolling_score(scores_,fl,cache_[fl],chunk->size());
 		}
 	}
 }
@@ -95,16 +98,10 @@ void ProfileScoreStructL1::do_caching_simple(VallChunkOP chunk) {
 
 	trProfScoreL1.Debug << "caching profile score for " << chunk->get_pdb_id()
 		<< " of size " << chunk->size() << std::endl;
+	// contiguous query and chunk profiles instead of a profile vector per residue pair
+	std::vector<Real> const & chunk_rows = chunk->columns().profile_struct;
 	for ( Size i = 1; i <= size_q; ++i ) {
-		utility::vector1<Real> query_prof_row = query_profile_->prof_row(i);
-		for ( Size j = 1; j <= chunk->size(); ++j ) {
-			utility::vector1<Real> tmplt_prof_row = chunk->at(j)->profile_struct();
-			Real score = 0.0;
-			for ( Size k = 1; k <= 20; k++ ) {
-				score += std::abs(tmplt_prof_row[k] - query_prof_row[k]);
-			}
-			scores_[i][j] = score;
-		}
+		l1_profile_row(&query_rows_[(i-1)*20], &chunk_rows[0], chunk->size(), scores_[i]);
 	}
 
 	trProfScoreL1.Debug << "precomputed matrix of L1 scores " << scores_.size()
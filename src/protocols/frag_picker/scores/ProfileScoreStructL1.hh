@@ -26,6 +26,8 @@
 
 #include <core/sequence/SequenceProfile.hh>
 
+#include <vector>
+
 namespace protocols {
 namespace frag_picker {
 namespace scores {
@@ -51,6 +53,8 @@ protected:
 
 private:
 	sequence::SequenceProfileOP query_profile_;
+	/// @brief the query profile, 20 contiguous values per residue
+	std::vector<Real> query_rows_;
 	std::string cached_scores_id_;
 	void clear();
 };
@@ -21,6 +21,7 @@
 #include <protocols/frag_picker/FragmentCandidate.hh>
 #include <protocols/frag_picker/scores/FragmentScoreMap.hh>
 #include <protocols/frag_picker/scores/fragment_scoring_utilities.hh>
+#include <protocols/frag_picker/VallChunk.hh>
 
 #include <core/fragment/SecondaryStructure.hh>
 
@@ -100,7 +101,7 @@ void TalosSSSimilarity::do_caching(VallChunkOP chunk) {
 		if ( cache_[fl].size() != 0 ) {
 			trTalosSSSimilarity.Trace << "caching secondary score for " << chunk->get_pdb_id()
 				<< " of size " << chunk->size() << " for fragment size "<<fl<<std::endl;
-			rolling_score(scores_,fl,cache_[fl]);
+			rolling_score(scores_,fl,cache_[fl],chunk->size());
 		}
 	}
 }
@@ -108,17 +109,14 @@ void TalosSSSimilarity::do_caching(VallChunkOP chunk) {
 void TalosSSSimilarity::do_caching_simple(VallChunkOP chunk) {
 
 	assert(query_ss_);
-	utility::vector1<Size> chunk_ss_id( chunk->size() );
-	for ( Size j = 1; j <= chunk->size(); ++j ) {
-		char s(chunk->at(j)->ss());
-		if ( s == 'H' ) chunk_ss_id[j] = 1;
-		if ( s == 'E' ) chunk_ss_id[j] = 2;
-		if ( s == 'L' ) chunk_ss_id[j] = 3;
-	}
+	std::vector<unsigned char> const & chunk_ss_id = chunk->columns().ss;
+	Size const n = chunk->size();
 
 	for ( Size i = 1; i <= query_len_; ++i ) {
-		for ( Size j = 1; j <= chunk->size(); ++j ) {
-			scores_[i][j] = raw_probs_[i][chunk_ss_id[j]];
+		Real const probs[4] = { 0.0, raw_probs_[i][1], raw_probs_[i][2], raw_probs_[i][3] };
+		utility::vector1<Real> & row = scores_[i];
+		for ( Size j = 0; j < n; ++j ) {
+			row[j+1] = probs[chunk_ss_id[j]];
 		}
 	}
 	trTalosSSSimilarity.Debug << "precomputed matrix of scores " << scores_.size()
@@ -15,6 +15,8 @@
 
 #include <utility/vector1.hh>
 
+#include <cmath>
+
 
 namespace protocols {
 namespace frag_picker {
@@ -42,6 +44,11 @@ void allocate_matrix(Size i_size,Size j_size,Matrix & dst) {
 
 void do_one_line(Size start_i,Size start_j,Matrix & small_scores,Size frag_len,Matrix & frag_scores) {
 
+	do_one_line(start_i,start_j,small_scores,frag_len,frag_scores,small_scores[1].size());
+}
+
+void do_one_line(Size start_i,Size start_j,Matrix & small_scores,Size frag_len,Matrix & frag_scores,Size n_cols) {
+
 	Size stop_i = start_i + frag_len - 1;
 	Size stop_j = start_j + frag_len - 1;
 	Real last_score = small_scores[start_i][start_j];
@@ -51,7 +58,7 @@ void do_one_line(Size start_i,Size start_j,Matrix & small_scores,Size frag_len,M
 	}
 	frag_scores[start_i][start_j] = last_score;
 	int max_steps = std::min((int) small_scores.size() - (int) start_i - (int) frag_len,
-		(int) small_scores[1].size() - (int) start_j - (int) frag_len) + 1;
+		(int) n_cols - (int) start_j - (int) frag_len) + 1;
 	int cnt = 1;
 	while ( cnt<=max_steps ) {
 		stop_i++;
@@ -66,12 +73,30 @@ void do_one_line(Size start_i,Size start_j,Matrix & small_scores,Size frag_len,M
 
 void rolling_score(Matrix & small_scores,Size frag_len,Matrix & frag_scores) {
 
-	do_one_line(1,1,small_scores,frag_len,frag_scores);
+	rolling_score(small_scores,frag_len,frag_scores,small_scores[1].size());
+}
+
+void rolling_score(Matrix & small_scores,Size frag_len,Matrix & frag_scores,Size n_cols) {
+
+	if ( small_scores.size() < frag_len || n_cols < frag_len ) return;
+	do_one_line(1,1,small_scores,frag_len,frag_scores,n_cols);
 	for ( Size i=2; i<=small_scores.size()-frag_len+1; i++ ) {
-		do_one_line(i,1,small_scores,frag_len,frag_scores);
+		do_one_line(i,1,small_scores,frag_len,frag_scores,n_cols);
+	}
+	for ( Size i=2; i<=n_cols-frag_len+1; i++ ) {
+		do_one_line(1,i,small_scores,frag_len,frag_scores,n_cols);
 	}
-	for ( Size i=2; i<=small_scores[1].size()-frag_len+1; i++ ) {
-		do_one_line(1,i,small_scores,frag_len,frag_scores);
+}
+
+void l1_profile_row(Real const * query_row,Real const * profiles,Size n,utility::vector1<Real> & scores) {
+
+	for ( Size j = 0; j < n; ++j ) {
+		Real const * row = profiles + 20*j;
+		Real score = 0.0;
+		for ( Size k = 0; k < 20; ++k ) {
+			score += std::abs(row[k] - query_row[k]);
+		}
+		scores[j+1] = score;
 	}
 }
 
@@ -31,7 +31,18 @@ typedef utility::vector1< utility::vector1 < Real > > Matrix;
 
 
 void do_one_line(Size start_i,Size start_j,Matrix & small_scores,Size frag_len,Matrix & frag_scores);
+void do_one_line(Size start_i,Size start_j,Matrix & small_scores,Size frag_len,Matrix & frag_scores,Size n_cols);
 void rolling_score(Matrix & small_scores,Size frag_len,Matrix & frag_scores);
+
+/// @brief rolling_score() restricted to the first n_cols columns of small_scores,
+/// i.e. to the residues of the chunk that is currently cached
+void rolling_score(Matrix & small_scores,Size frag_len,Matrix & frag_scores,Size n_cols);
+
+/// @brief L1 distance between a query profile row and n chunk profile rows:
+/// scores[j] = sum over k of |query_row[k] - profiles[20*(j-1)+k]| for j = 1..n
+/// @details both profiles are 20 contiguous values per residue (see VallChunkColumns),
+/// so the fixed-length inner loop is unrolled and vectorized by the compiler
+void l1_profile_row(Real const * query_row,Real const * profiles,Size n,utility::vector1<Real> & scores);
 void create_cache(utility::vector1<Size> & frag_sizes,Size query_len,Size longest_vall_chunk,utility::vector1<Matrix> & cache);
 void allocate_matrix(Size i_size,Size j_size,Matrix & dst);
 
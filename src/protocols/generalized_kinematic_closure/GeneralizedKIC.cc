@@ -31,6 +31,8 @@
 #include <utility/exit.hh>
 #include <utility/string_util.hh>
 #include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/loops.OptionKeys.gen.hh>
 #include <core/types.hh>
 #include <utility/tag/Tag.hh>
 #include <core/id/AtomID.hh>
@@ -44,6 +46,7 @@
 #include <numeric/xyzVector.hh>
 #include <numeric/xyzVector.io.hh>
 #include <numeric/kinematic_closure/bridgeObjects.hh>
+#include <numeric/kinematic_closure/batch_closure.hh>
 #include <numeric/kinematic_closure/kinematic_closure_helpers.hh>
 #include <numeric/conversions.hh>
 
@@ -111,6 +114,7 @@ GeneralizedKIC::GeneralizedKIC():
 	attach_boinc_ghost_observer_(false),
 	low_memory_mode_(false),
 	dont_fail_if_no_solution_found_(false),
+	closure_threads_( basic::options::option[ basic::options::OptionKeys::loops::kic_closure_threads ]() ),
 	bondangle_solutions_(),
 	bondlength_solutions_()
 	//TODO -- make sure above data are copied properly when duplicating this mover.
@@ -147,6 +151,7 @@ GeneralizedKIC::GeneralizedKIC( GeneralizedKIC const &src ):
 	attach_boinc_ghost_observer_(src.attach_boinc_ghost_observer_),
 	low_memory_mode_(src.low_memory_mode_),
 	dont_fail_if_no_solution_found_(src.dont_fail_if_no_solution_found_),
+	closure_threads_(src.closure_threads_),
 	bondangle_solutions_(src.bondangle_solutions_),
 	bondlength_solutions_(src.bondlength_solutions_)
 	//TODO -- make sure above data are copied properly when duplicating this mover.
@@ -287,6 +292,7 @@ GeneralizedKIC::parse_my_tag(
 	}
 
 	set_dont_fail_if_no_solution_found( tag->getOption<bool>( "dont_fail_if_no_solution_found", dont_fail_if_no_solution_found_ ) );
+	set_closure_threads( tag->getOption<core::Size>( "closure_threads", closure_threads_ ) );
 
 	runtime_assert_string_msg( tag->hasOption("selector"), "RosettaScript parsing error: the <GeneralizedKIC> mover must have a selector specfied with the selector=<selector_name> statement." );
 	set_selector_type( tag->getOption<std::string>("selector", "") );
@@ -1570,110 +1576,132 @@ GeneralizedKIC::doKIC(
 	//Total solutions found:
 	core::Size total_solution_count=0;
 
-	for ( core::Size iattempt = 1; (n_closure_attempts_>0 ? iattempt<=n_closure_attempts_ : true); ++iattempt ) { //Loop for closure attempts
-		TR.Debug << "Generalized kinematic closure attempt " << iattempt << "." << std::endl;
-
-		t_ang.push_back( utility::vector1 < utility::vector1<core::Real> > () );
-		b_ang.push_back( utility::vector1 < utility::vector1<core::Real> > () );
-		b_len.push_back( utility::vector1 < utility::vector1<core::Real> > () );
-		nsol_for_attempt.push_back(0);
+	//Translate atomlist_ into the data vectors that the kinematic closure bridgeObjects() function uses.  The atom
+	//coordinates and order are the same for every attempt; only the perturbed dt, da and db differ between attempts.
+	utility::vector1< utility::vector1< core::Real > > atoms; //atom xyz
+	utility::vector1< core::Size > order; //use 1, 2, 3
+	ClosureAttempt unperturbed_attempt; //desired torsions, bond angles and bond lengths for each atom
+	generate_bridgeobjects_data_from_atomlist(atoms, unperturbed_attempt.dt, unperturbed_attempt.da, unperturbed_attempt.db, order);
+
+	//Closure attempts are perturbed serially (perturbers may draw random numbers), solved concurrently in chunks of
+	//one attempt per thread by bridgeObjects_batch(), and then filtered serially in attempt order.  With one closure
+	//thread (the default), each chunk is a single attempt, so every attempt is perturbed, closed and filtered before
+	//the next is perturbed, as in the serial loop.
+	core::Size const attempts_per_chunk( closure_threads_ == 0 ? default_batch_closure_threads() : closure_threads_ );
+	bool stop_seeking(false);
+
+	for ( core::Size chunk_start = 1; !stop_seeking && (n_closure_attempts_>0 ? chunk_start<=n_closure_attempts_ : true); chunk_start += attempts_per_chunk ) { //Loop for chunks of closure attempts
+		core::Size chunk_end( chunk_start + attempts_per_chunk - 1 );
+		if ( n_closure_attempts_>0 && chunk_end > n_closure_attempts_ ) chunk_end = n_closure_attempts_;
+
+		utility::vector1< ClosureAttempt > attempts;
+		for ( core::Size iattempt = chunk_start; iattempt <= chunk_end; ++iattempt ) {
+			attempts.push_back( unperturbed_attempt );
+			//Perturb the lists of desired torsions, bond angles, and bond lengths using the perturberlist_.
+			apply_perturbations(pose, original_pose, residue_map, tail_residue_map, attempts.back().dt, attempts.back().da, attempts.back().db);
+		}
 
-		//Translate atomlist_ into the data vectors that the kinematic closure bridgeObjects() function uses:
-		utility::vector1< utility::vector1< core::Real > > atoms; //atom xyz
-		utility::vector1< core::Real > dt; //desired torsions for each atom
-		utility::vector1< core::Real > da; //desired bond angle for each atom
-		utility::vector1< core::Real > db; //desired bond length for each atom
-		utility::vector1< core::Size > order; //use 1, 2, 3
-		generate_bridgeobjects_data_from_atomlist(atoms, dt, da, db, order);
+		//Do the actual closure:
+		utility::vector1< ClosureAttemptSolutions > chunk_solutions;
+		bridgeObjects_batch(atoms, attempts, pivots, order, chunk_solutions, attempts_per_chunk);
 
-		int nsol=0; //The number of solutions found.  This has to be an int.
+		for ( core::Size iattempt = chunk_start; iattempt <= chunk_end; ++iattempt ) { //Loop for closure attempts
+			TR.Debug << "Generalized kinematic closure attempt " << iattempt << "." << std::endl;
 
-		//Perturb the lists of desired torsions, bond angles, and bond lengths using the perturberlist_.
-		apply_perturbations(pose, original_pose, residue_map, tail_residue_map, dt, da, db);
+			ClosureAttemptSolutions & attempt_solutions( chunk_solutions[ iattempt - chunk_start + 1 ] );
+			t_ang.push_back( utility::vector1 < utility::vector1<core::Real> > () );
+			b_ang.push_back( utility::vector1 < utility::vector1<core::Real> > () );
+			b_len.push_back( utility::vector1 < utility::vector1<core::Real> > () );
+			t_ang[iattempt].swap( attempt_solutions.t_ang );
+			b_ang[iattempt].swap( attempt_solutions.b_ang );
+			b_len[iattempt].swap( attempt_solutions.b_len );
+			nsol_for_attempt.push_back(0);
 
-		//Do the actual closure:
-		bridgeObjects(atoms, dt, da, db, pivots, order, t_ang[iattempt], b_ang[iattempt], b_len[iattempt], nsol);
+			int nsol=attempt_solutions.nsol; //The number of solutions found.  This has to be an int.
 
-		//Filter solutions found.  This decrements nsol as solutions are eliminated, and deletes solutions from the t_ang, b_ang, and b_len vectors.
-		if ( nsol>0 ) filter_solutions(original_pose, pose, residue_map, tail_residue_map, atomlist_, t_ang[iattempt], b_ang[iattempt], b_len[iattempt], nsol );
+			//Filter solutions found.  This decrements nsol as solutions are eliminated, and deletes solutions from the t_ang, b_ang, and b_len vectors.
+			if ( nsol>0 ) filter_solutions(original_pose, pose, residue_map, tail_residue_map, atomlist_, t_ang[iattempt], b_ang[iattempt], b_len[iattempt], nsol );
 
-		//Flag certain solutions for deletion based on whether preselection movers fail.
-		utility::vector1< bool > solutions_to_delete( nsol, false );
+			//Flag certain solutions for deletion based on whether preselection movers fail.
+			utility::vector1< bool > solutions_to_delete( nsol, false );
 
-		//Only at this point do we actually build poses:
-		for ( core::Size j=1, jmax=nsol; j<=jmax; ++j ) {
-			core::pose::PoseOP curpose( original_pose.clone() ); //Clone the original pose.
-			core::pose::PoseOP looppose( pose.clone() ); //Clone the loop pose.
-			set_loop_pose( *looppose, atomlist_, t_ang[iattempt][j], b_ang[iattempt][j], b_len[iattempt][j]);
-			copy_loop_pose_to_original( *curpose, *looppose, residue_map, tail_residue_map);
+			//Only at this point do we actually build poses:
+			for ( core::Size j=1, jmax=nsol; j<=jmax; ++j ) {
+				core::pose::PoseOP curpose( original_pose.clone() ); //Clone the original pose.
+				core::pose::PoseOP looppose( pose.clone() ); //Clone the loop pose.
+				set_loop_pose( *looppose, atomlist_, t_ang[iattempt][j], b_ang[iattempt][j], b_len[iattempt][j]);
+				copy_loop_pose_to_original( *curpose, *looppose, residue_map, tail_residue_map);
 
-			//If this is the BOINC graphics build, and we're using the ghost pose observer, attach the observer now:
+				//If this is the BOINC graphics build, and we're using the ghost pose observer, attach the observer now:
 #ifdef BOINC_GRAPHICS
-			if ( attach_boinc_ghost_observer() ) {
-				protocols::boinc::Boinc::attach_graphics_current_pose_ghost_observer( *curpose );
-				protocols::boinc::Boinc::update_graphics_current_ghost( *curpose );
-				//std::cerr << "GenKIC attached a BOINC ghost observer." << std::endl;
-				//std::cerr.flush();
-			}
+				if ( attach_boinc_ghost_observer() ) {
+					protocols::boinc::Boinc::attach_graphics_current_pose_ghost_observer( *curpose );
+					protocols::boinc::Boinc::update_graphics_current_ghost( *curpose );
+					//std::cerr << "GenKIC attached a BOINC ghost observer." << std::endl;
+					//std::cerr.flush();
+				}
 #endif
 
-			//Apply preselection movers.
-			if ( preselection_mover_exists() ) {
-				TR << "Applying pre-selection mover to solution " << j << " from attempt " << iattempt << "." << std::endl;
-				pre_selection_mover_->apply( *curpose );
-				if ( pre_selection_mover_->get_last_move_status()!=protocols::moves::MS_SUCCESS ) {
-					TR << "Preselection mover failed!  Continuing to next solution." << std::endl;
-					--nsol;
-					solutions_to_delete[j] = true;
-					continue;
+				//Apply preselection movers.
+				if ( preselection_mover_exists() ) {
+					TR << "Applying pre-selection mover to solution " << j << " from attempt " << iattempt << "." << std::endl;
+					pre_selection_mover_->apply( *curpose );
+					if ( pre_selection_mover_->get_last_move_status()!=protocols::moves::MS_SUCCESS ) {
+						TR << "Preselection mover failed!  Continuing to next solution." << std::endl;
+						--nsol;
+						solutions_to_delete[j] = true;
+						continue;
+					}
+				}
+				if ( !low_memory_mode() ) {
+					add_solution(curpose);
+					TR << "Storing solution " << j << " from attempt " << iattempt << "." << std::endl;
+				} else {
+					( *( selector_->scorefunction() ) )( *curpose );
+					energies_for_solution.push_back( curpose->energies().total_energy() );
 				}
 			}
-			if ( !low_memory_mode() ) {
-				add_solution(curpose);
-				TR << "Storing solution " << j << " from attempt " << iattempt << "." << std::endl;
-			} else {
-				( *( selector_->scorefunction() ) )( *curpose );
-				energies_for_solution.push_back( curpose->energies().total_energy() );
-			}
-		}
 
-		//Delete solutions for which the preselection mover failed:
-		core::Size solcount(0);
-		for ( utility::vector1< utility::vector1< core::Real > >::iterator it=t_ang[iattempt].begin(); it!=t_ang[iattempt].end(); ) {
-			++solcount;
-			if ( solutions_to_delete[solcount] ) { t_ang[iattempt].erase( it ); }
-			else { ++it; }
-		}
-		solcount=0;
-		for ( utility::vector1< utility::vector1< core::Real > >::iterator it=b_ang[iattempt].begin(); it!=b_ang[iattempt].end(); ) {
-			++solcount;
-			if ( solutions_to_delete[solcount] ) { b_ang[iattempt].erase( it ); }
-			else { ++it; }
-		}
-		solcount=0;
-		for ( utility::vector1< utility::vector1< core::Real > >::iterator it=b_len[iattempt].begin(); it!=b_len[iattempt].end(); ) {
-			++solcount;
-			if ( solutions_to_delete[solcount] ) { b_len[iattempt].erase( it ); }
-			else { ++it; }
-		}
+			//Delete solutions for which the preselection mover failed:
+			core::Size solcount(0);
+			for ( utility::vector1< utility::vector1< core::Real > >::iterator it=t_ang[iattempt].begin(); it!=t_ang[iattempt].end(); ) {
+				++solcount;
+				if ( solutions_to_delete[solcount] ) { t_ang[iattempt].erase( it ); }
+				else { ++it; }
+			}
+			solcount=0;
+			for ( utility::vector1< utility::vector1< core::Real > >::iterator it=b_ang[iattempt].begin(); it!=b_ang[iattempt].end(); ) {
+				++solcount;
+				if ( solutions_to_delete[solcount] ) { b_ang[iattempt].erase( it ); }
+				else { ++it; }
+			}
+			solcount=0;
+			for ( utility::vector1< utility::vector1< core::Real > >::iterator it=b_len[iattempt].begin(); it!=b_len[iattempt].end(); ) {
+				++solcount;
+				if ( solutions_to_delete[solcount] ) { b_len[iattempt].erase( it ); }
+				else { ++it; }
+			}
 
-		total_solution_count += static_cast<core::Size>(nsol);
-		if ( !low_memory_mode() ) {
-			debug_assert(total_solution_count == total_stored_solutions());
-		}
-		nsol_for_attempt[iattempt] = static_cast<core::Size>(nsol);
+			total_solution_count += static_cast<core::Size>(nsol);
+			if ( !low_memory_mode() ) {
+				debug_assert(total_solution_count == total_stored_solutions());
+			}
+			nsol_for_attempt[iattempt] = static_cast<core::Size>(nsol);
 
-		if ( min_solution_count()!=0 && total_solution_count >= min_solution_count() ) {
-			TR.Debug << "Total solutions=" << total_solution_count << " and min_solution_count=" << min_solution_count() << ".  Breaking from solution-seeking loop." << std::endl;
-			break;
-		}
+			if ( min_solution_count()!=0 && total_solution_count >= min_solution_count() ) {
+				TR.Debug << "Total solutions=" << total_solution_count << " and min_solution_count=" << min_solution_count() << ".  Breaking from solution-seeking loop." << std::endl;
+				stop_seeking = true;
+				break;
+			}
 
-		if ( get_ntries_before_giving_up()==iattempt && total_solution_count==0 ) {
-			TR.Debug << "GenKIC is set to give up after " << get_ntries_before_giving_up() << " tries without a solution.  This is attempt " << iattempt << " and solution count is " << total_solution_count << ".  Giving up." << std::endl;
-			break; //Give up now if we've attempted a certain number of tries and found nothing.
-		}
+			if ( get_ntries_before_giving_up()==iattempt && total_solution_count==0 ) {
+				TR.Debug << "GenKIC is set to give up after " << get_ntries_before_giving_up() << " tries without a solution.  This is attempt " << iattempt << " and solution count is " << total_solution_count << ".  Giving up." << std::endl;
+				stop_seeking = true;
+				break; //Give up now if we've attempted a certain number of tries and found nothing.
+			}
 
-	} //End loop for closure attempts
+		} //End loop for closure attempts
+	} //End loop for chunks of closure attempts
 
 	// Apply the selector here.  This ultimately picks a single solution and sets pose (the loop pose) to the conformation for that solution, but doesn't touch the original pose.
 	bool selector_success(false);
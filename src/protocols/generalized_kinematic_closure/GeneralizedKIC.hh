@@ -449,6 +449,16 @@ public:
 	/// If true, then only loop DOFs are stored.  This loses the results of applying any preselection movers, though.
 	inline bool low_memory_mode() const { return low_memory_mode_; }
 
+	/// @brief Sets the number of threads that solve closure attempts at once.
+	/// @details Attempts are perturbed serially, solved in chunks of this many attempts, and filtered
+	/// serially in attempt order.  1 (the default, from -loops:kic_closure_threads) perturbs, closes
+	/// and filters each attempt before the next; 0 uses the hardware concurrency.
+	inline void set_closure_threads( core::Size const setting ) { closure_threads_=setting; return; }
+
+	/// @brief Gets the number of threads that solve closure attempts at once.
+	/// @details 0 means the hardware concurrency.
+	inline core::Size closure_threads() const { return closure_threads_; }
+
 	/// @brief Sets whether the mover sets its status to failure of no solution is found.
 	/// @details True means it does NOT fail if no solution is found.  False is the default (fail if no solution found).
 	inline void set_dont_fail_if_no_solution_found( bool const setting ) { dont_fail_if_no_solution_found_=setting; return; }
@@ -583,6 +593,11 @@ private:
 	/// the default) then this doesn't happen.
 	bool dont_fail_if_no_solution_found_;
 
+	/// @brief The number of threads that solve closure attempts at once.  0 means the hardware concurrency.
+	/// @details Default from -loops:kic_closure_threads (1, so that each attempt is perturbed, closed and
+	/// filtered before the next is perturbed).
+	core::Size closure_threads_;
+
 	/// @brief Vector of loop bond angles from final solutions.
 	/// @details Only stored in low-memory mode.
 	utility::vector1 < utility::vector1 < core::Real > > bondangle_solutions_;
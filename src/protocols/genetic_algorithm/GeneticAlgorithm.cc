@@ -613,7 +613,7 @@ GeneticAlgorithmBase::read_generations_checkpoint()
 
 	file.close();
 
-	return false;
+	return true;
 }
 
 bool
@@ -0,0 +1,282 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   protocols/jd2/AsyncOutputWriter.cc
+/// @brief  hands finished output to a dedicated I/O thread so that workers do not wait for the filesystem
+
+// Unit headers
+#include <protocols/jd2/AsyncOutputWriter.hh>
+
+// Basic headers
+#include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/jd2.OptionKeys.gen.hh>
+
+// Utility headers
+#include <utility/exit.hh>
+#include <utility/io/ozstream.hh>
+
+// C++ headers
+#include <sstream>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Singleton instance and mutex static data members
+namespace utility {
+
+using protocols::jd2::AsyncOutputWriter;
+
+#if defined MULTI_THREADED && defined CXX11
+template <> std::mutex utility::SingletonBase< AsyncOutputWriter >::singleton_mutex_{};
+template <> std::atomic< AsyncOutputWriter * > utility::SingletonBase< AsyncOutputWriter >::instance_( 0 );
+#else
+template <> AsyncOutputWriter * utility::SingletonBase< AsyncOutputWriter >::instance_( 0 );
+#endif
+
+}
+
+namespace protocols {
+namespace jd2 {
+
+static THREAD_LOCAL basic::Tracer TR( "protocols.jd2.AsyncOutputWriter" );
+
+/// @brief close out and, if sync, make sure the file has reached the disk
+static void
+close_file( utility::io::ozstream & out, std::string const & filename, bool sync )
+{
+	out.close();
+#ifndef WIN32
+	if ( sync && !filename.empty() ) {
+		int const fd = ::open( filename.c_str(), O_RDONLY );
+		if ( fd >= 0 ) {
+			::fsync( fd );
+			::close( fd );
+		}
+	}
+#endif
+}
+
+AsyncOutputWriter *
+AsyncOutputWriter::create_singleton_instance()
+{
+	return new AsyncOutputWriter;
+}
+
+AsyncOutputWriter::AsyncOutputWriter() :
+	active_( false ),
+	fsync_( false ),
+	max_queued_bytes_( 0 )
+{
+	using namespace basic::options;
+
+	fsync_ = option[ OptionKeys::jd2::async_output_fsync ]();
+	max_queued_bytes_ = core::Size( option[ OptionKeys::jd2::async_output_buffer_mb ]() ) * 1024 * 1024;
+
+#if defined MULTI_THREADED && defined CXX11
+	queued_bytes_ = 0;
+	writing_ = false;
+	stop_ = false;
+	exit_callback_added_ = false;
+	start_if_requested();
+#else
+	if ( option[ OptionKeys::jd2::async_output ]() ) {
+		TR.Warning << "-jd2:async_output needs a multithreaded build; output is written synchronously." << std::endl;
+	}
+#endif
+}
+
+AsyncOutputWriter::~AsyncOutputWriter()
+{
+	shutdown();
+}
+
+void
+AsyncOutputWriter::shutdown_at_exit()
+{
+	get_instance()->shutdown();
+}
+
+bool
+AsyncOutputWriter::start()
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( utility::io::ozstream::MPI_reroute_rank() >= 0 ) return false;
+	std::lock_guard< std::mutex > lock( mutex_ );
+	if ( active_ ) return false;
+	TR.Debug << "writing output on a dedicated I/O thread, buffering up to " << max_queued_bytes_ << " bytes" << std::endl;
+	io_thread_ = std::thread( &AsyncOutputWriter::io_thread_loop, this );
+	active_ = true;
+	if ( !exit_callback_added_ ) {
+		utility::add_exit_callback( &AsyncOutputWriter::shutdown_at_exit );
+		exit_callback_added_ = true;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void
+AsyncOutputWriter::start_if_requested()
+{
+	if ( basic::options::option[ basic::options::OptionKeys::jd2::async_output ]() ) start();
+}
+
+void
+AsyncOutputWriter::shutdown()
+{
+#if defined MULTI_THREADED && defined CXX11
+	std::unique_lock< std::mutex > lock( mutex_ );
+	if ( !active_ || stop_ || std::this_thread::get_id() == io_thread_.get_id() ) return;
+	stop_ = true;
+	work_.notify_one();
+	lock.unlock();
+	io_thread_.join();
+
+	lock.lock();
+	active_ = false;
+	stop_ = false;
+	std::string const error( error_ );
+	error_.clear();
+	// writers waiting for room write on their own thread now
+	done_.notify_all();
+	lock.unlock();
+	if ( !error.empty() ) TR.Error << error << std::endl;
+	TR.Debug << "stopped the I/O thread" << std::endl;
+#endif
+}
+
+void
+AsyncOutputWriter::write(
+	std::string const & filename,
+	std::string const & contents,
+	WriteMode mode,
+	std::string const & header
+)
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( active_ ) {
+		core::Size const bytes( contents.size() + header.size() );
+		std::unique_lock< std::mutex > lock( mutex_ );
+		// backpressure: wait for room, but always accept a piece larger than the whole buffer once the queue is
+		// empty; while the I/O thread shuts down, wait until it is done and then write on this thread
+		done_.wait( lock, [&]{ return stop_ ? !active_ : ( queued_bytes_ == 0 || queued_bytes_ + bytes <= max_queued_bytes_ ); } );
+		if ( active_ ) {
+			if ( !error_.empty() ) {
+				// utility_exit() shuts the writer down, which needs the lock
+				std::string const error( error_ );
+				lock.unlock();
+				utility_exit_with_message( error );
+			}
+			queue_.push_back( Request() );
+			Request & request( queue_.back() );
+			request.filename = filename;
+			request.header = header;
+			request.contents = contents;
+			request.mode = mode;
+			queued_bytes_ += bytes;
+			work_.notify_one();
+			return;
+		}
+	}
+#endif
+
+	Requests requests( 1 );
+	requests[ 0 ].filename = filename;
+	requests[ 0 ].header = header;
+	requests[ 0 ].contents = contents;
+	requests[ 0 ].mode = mode;
+	std::string const error( write_requests( requests ) );
+	if ( !error.empty() ) utility_exit_with_message( error );
+}
+
+void
+AsyncOutputWriter::flush()
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( !active_ ) return;
+	std::unique_lock< std::mutex > lock( mutex_ );
+	done_.wait( lock, [this]{ return queue_.empty() && !writing_; } );
+	if ( !error_.empty() ) {
+		// utility_exit() shuts the writer down, which needs the lock
+		std::string const error( error_ );
+		lock.unlock();
+		utility_exit_with_message( error );
+	}
+#endif
+}
+
+std::string
+AsyncOutputWriter::write_requests( Requests const & requests ) const
+{
+	std::string error;
+	utility::io::ozstream out;
+	std::string open_filename;
+	for ( Requests::const_iterator it = requests.begin(); it != requests.end(); ++it ) {
+		// a run of appends to the same file shares one open
+		if ( it->filename != open_filename || it->mode == overwrite ) {
+			close_file( out, open_filename, fsync_ );
+			open_filename = it->filename;
+			if ( it->mode == overwrite ) {
+				out.open( it->filename );
+			} else {
+				std::stringstream header( it->header );
+				out.open_append_if_existed( it->filename, header );
+			}
+			if ( !out.good() ) {
+				if ( error.empty() ) error = "Unable to open file: " + it->filename + "\n";
+				out.close();
+				open_filename.clear();
+				continue;
+			}
+		}
+		out << it->contents;
+		if ( !out.good() && error.empty() ) error = "Error writing file: " + it->filename + "\n";
+	}
+	close_file( out, open_filename, fsync_ );
+	return error;
+}
+
+#if defined MULTI_THREADED && defined CXX11
+void
+AsyncOutputWriter::io_thread_loop()
+{
+	std::unique_lock< std::mutex > lock( mutex_ );
+	while ( true ) {
+		work_.wait( lock, [this]{ return !queue_.empty() || stop_; } );
+		// shutdown() waits for everything queued to be written
+		if ( queue_.empty() ) break;
+
+		Requests batch;
+		batch.swap( queue_ );
+		writing_ = true;
+		lock.unlock();
+
+		core::Size bytes( 0 );
+		for ( Requests::const_iterator it = batch.begin(); it != batch.end(); ++it ) {
+			bytes += it->contents.size() + it->header.size();
+		}
+		std::string const error( write_requests( batch ) );
+		TR.Trace << "wrote " << batch.size() << " pieces, " << bytes << " bytes" << std::endl;
+		batch.clear();
+
+		lock.lock();
+		if ( error_.empty() ) error_ = error;
+		queued_bytes_ -= bytes;
+		writing_ = false;
+		done_.notify_all();
+	}
+}
+#endif
+
+} // jd2
+} // protocols
@@ -0,0 +1,150 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   protocols/jd2/AsyncOutputWriter.hh
+/// @brief  hands finished output to a dedicated I/O thread so that workers do not wait for the filesystem
+/// @details With -jd2:async_output the JobOutputters serialize a finished structure on the thread that
+/// produced it and queue the text here; one I/O thread takes everything queued so far, writes consecutive
+/// pieces for the same file through a single open (and optionally fsyncs it), and goes back to waiting.
+/// The queue is bounded by -jd2:async_output_buffer_mb: write() blocks while it is full.
+/// Writes go straight to disk on the calling thread if the option is off, in builds without thread
+/// support, and on MPI ranks whose ozstreams are rerouted to a file buffer node.  Protocols that run
+/// threads of their own and write from all of them may start() the I/O thread without the option.
+/// The JobDistributors shutdown() the I/O thread when their jobs are done, and utility_exit() shuts it
+/// down before exiting, so that nothing queued is lost and no thread outlives the run.
+
+#ifndef INCLUDED_protocols_jd2_AsyncOutputWriter_hh
+#define INCLUDED_protocols_jd2_AsyncOutputWriter_hh
+
+// Unit headers
+#include <protocols/jd2/AsyncOutputWriter.fwd.hh>
+
+// Project headers
+#include <core/types.hh>
+
+// Utility headers
+#include <utility/SingletonBase.hh>
+
+// C++ headers
+#include <string>
+#include <deque>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace protocols {
+namespace jd2 {
+
+class AsyncOutputWriter : public utility::SingletonBase< AsyncOutputWriter >
+{
+public:
+	friend class utility::SingletonBase< AsyncOutputWriter >;
+
+	enum WriteMode {
+		overwrite = 1,
+		append
+	};
+
+public:
+	/// @brief Is output handed to the I/O thread?  If not, write() writes before it returns.
+	bool active() const { return active_; }
+
+	/// @brief Hand output to the I/O thread from now on, even without -jd2:async_output.  Does nothing if
+	/// the writer is active already, in builds without thread support, and on rerouted MPI ranks.
+	/// Returns true if this call started the I/O thread, so that the caller knows to shutdown() it.
+	bool start();
+
+	/// @brief start() if -jd2:async_output is set.  The JobDistributors call this when a run begins, so
+	/// that a writer shut down at the end of an earlier run starts again.
+	void start_if_requested();
+
+	/// @brief Write everything queued, stop the I/O thread, and write on the calling thread from then on
+	/// until start() is called again.  Unlike flush(), a failed write is reported but does not exit, so
+	/// that this can be called on the way out of a failed run.
+	void shutdown();
+
+	/// @brief Write contents to filename (gzipped if the name ends in .gz, as by utility::io::ozstream).
+	/// In append mode a non-empty header is written first if the file does not exist yet at the time of
+	/// the write, as by ozstream::open_append_if_existed().  Writes to a file happen in the order queued.
+	void
+	write(
+		std::string const & filename,
+		std::string const & contents,
+		WriteMode mode = append,
+		std::string const & header = ""
+	);
+
+	/// @brief Block until everything queued so far is written.  Exits if a write failed.
+	void flush();
+
+private:
+	struct Request {
+		std::string filename;
+		std::string header;
+		std::string contents;
+		WriteMode mode;
+	};
+	typedef std::deque< Request > Requests;
+
+private:
+	AsyncOutputWriter();
+
+	/// @brief never called: the instance lives until the process ends; shuts the I/O thread down
+	~AsyncOutputWriter();
+
+	static AsyncOutputWriter * create_singleton_instance();
+
+	/// @brief exit callback, so that utility_exit() does not leave queued output unwritten
+	static void shutdown_at_exit();
+
+	/// @brief write requests, opening each file once for a run of appends to it; returns the
+	/// first error, or an empty string
+	std::string write_requests( Requests const & requests ) const;
+
+#if defined MULTI_THREADED && defined CXX11
+	void io_thread_loop();
+#endif
+
+private:
+#if defined MULTI_THREADED && defined CXX11
+	std::atomic< bool > active_;
+#else
+	bool active_;
+#endif
+	bool fsync_;
+	core::Size max_queued_bytes_;
+
+#if defined MULTI_THREADED && defined CXX11
+	std::mutex mutex_;
+	/// @brief signalled when requests are queued
+	std::condition_variable work_;
+	/// @brief signalled when the I/O thread finished a batch
+	std::condition_variable done_;
+
+	Requests queue_;
+	/// @brief bytes queued or being written
+	core::Size queued_bytes_;
+	bool writing_;
+	/// @brief set by shutdown(): the I/O thread writes what is queued and ends
+	bool stop_;
+	bool exit_callback_added_;
+	std::string error_;
+
+	std::thread io_thread_;
+#endif
+};
+
+} // jd2
+} // protocols
+
+#endif // INCLUDED_protocols_jd2_AsyncOutputWriter_hh
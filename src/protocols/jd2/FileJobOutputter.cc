@@ -14,6 +14,7 @@
 ///Unit headers
 #include <protocols/jd2/FileJobOutputter.hh>
 #include <protocols/jd2/Job.hh>
+#include <protocols/jd2/AsyncOutputWriter.hh>
 
 ///Project headers
 #include <core/pose/Pose.hh>
@@ -190,9 +191,14 @@ void FileJobOutputter::file(
 	if ( data.empty() ) return; //who needs empty files?
 
 	//this almost certainly needs some sort of error handling - what do you think Andrew?
-	utility::io::ozstream out;
 	std::string const & miscfile_ext(option[ run::jobdist_miscfile_ext ].value());
-	out.open_append( output_name(job) + (miscfile_ext[0] == '.' ? "" : ".") + miscfile_ext );
+	std::string const filename( output_name(job) + (miscfile_ext[0] == '.' ? "" : ".") + miscfile_ext );
+	if ( AsyncOutputWriter::get_instance()->active() ) {
+		AsyncOutputWriter::get_instance()->write( filename, data, AsyncOutputWriter::append );
+		return;
+	}
+	utility::io::ozstream out;
+	out.open_append( filename );
 	out << data << std::flush;
 	out.close();
 }
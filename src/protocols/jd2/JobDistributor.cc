@@ -31,6 +31,7 @@
 #include <protocols/jd2/Job.hh>
 #include <protocols/jd2/InnerJob.hh>
 #include <protocols/jd2/NoOutputJobOutputter.hh>
+#include <protocols/jd2/AsyncOutputWriter.hh>
 
 // Project headers
 #include <core/pose/Pose.hh>
@@ -294,15 +295,30 @@ void JobDistributor::go_main(protocols::moves::MoverOP mover)
 	bool first_job(true);
 
 	check_for_parser_in_go_main();
+	AsyncOutputWriter::get_instance()->start_if_requested();
 	PROF_START( basic::JD2);
 
-	while ( obtain_new_job() ) {
-		++tried_jobs; //yes, we tried at least one job
-		bool keep_going =
-			run_one_job( mover, allstarttime, last_inner_job_tag, last_output_tag, last_batch_id, retries_this_job, first_job );
-		first_job = false; //we've finished one by now, and are no longer on the first job edge case
-		if ( ! keep_going ) break;
-	} PROF_STOP( basic::JD2);
+	try {
+		while ( obtain_new_job() ) {
+			++tried_jobs; //yes, we tried at least one job
+			bool keep_going =
+				run_one_job( mover, allstarttime, last_inner_job_tag, last_output_tag, last_batch_id, retries_this_job, first_job );
+			first_job = false; //we've finished one by now, and are no longer on the first job edge case
+			if ( ! keep_going ) break;
+		}
+	} catch ( ... ) {
+		// write the output of the jobs that finished before passing the error on
+		AsyncOutputWriter::get_instance()->shutdown();
+		throw;
+	}
+	PROF_STOP( basic::JD2);
+
+	finish_go_main( allstarttime, tried_jobs );
+}
+
+void JobDistributor::finish_go_main( time_t const allstarttime, core::Size const tried_jobs )
+{
+	using namespace basic::options;
 
 	note_all_jobs_finished();
 	if ( batches_.size() ) {
@@ -318,6 +334,8 @@ void JobDistributor::go_main(protocols::moves::MoverOP mover)
 	}
 
 	job_outputter_->flush(); //This call forces out any unprinted data
+	AsyncOutputWriter::get_instance()->flush(); // and waits until it is on disk
+	AsyncOutputWriter::get_instance()->shutdown(); // the I/O thread does not outlive the run
 
 	// If some jobs have failed, we throw an exception here
 	// The result in most applications will be a non-zero exit code
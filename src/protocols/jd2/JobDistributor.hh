@@ -162,6 +162,12 @@ protected:
 	void
 	go_main( protocols::moves::MoverOP mover );
 
+	/// @brief Tail of go_main: tell the subclass all jobs are done, report how many were attempted, flush
+	/// the output and throw if jobs failed and -jd2:failed_job_exception is set.  For subclasses that run
+	/// jobs with their own loop.
+	void
+	finish_go_main( time_t allstarttime, core::Size tried_jobs );
+
 	/// Read access to private data for derived classes.
 
 	/// @brief Jobs is the container of Job objects
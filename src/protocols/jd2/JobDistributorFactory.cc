@@ -23,7 +23,7 @@
 #include <protocols/jd2/MPIWorkPoolJobDistributor.hh>
 #include <protocols/jd2/MPIFileBufJobDistributor.hh>
 #include <protocols/jd2/MPIMultiCommJobDistributor.hh>
-//#include <protocols/jd2/MultiThreadedJobDistributor.hh>
+#include <protocols/jd2/ThreadPoolJobDistributor.hh>
 #include <protocols/jd2/archive/MPIArchiveJobDistributor.hh>
 #include <protocols/jd2/MSDJobDistributor.hh>
 
@@ -124,13 +124,11 @@ JobDistributorFactory::create_job_distributor() {
 		return new MPIWorkPartitionJobDistributor;
 	}
 
-	// #else
-	//  if ( option[ n_worker_threads ].user() ) {
-	//   return new MultiThreadedJobDistributor;
-	//  } else {
-	//   return new FileSystemJobDistributor;
-	//  }
-	return new FileSystemJobDistributor; //SML override until we have other child classes
+	if ( option[ OptionKeys::jd2::nthreads ]() != 1 ) {
+		return new ThreadPoolJobDistributor;
+	}
+
+	return new FileSystemJobDistributor;
 }
 
 
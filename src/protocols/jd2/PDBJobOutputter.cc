@@ -15,6 +15,7 @@
 #include <protocols/jd2/PDBJobOutputter.hh>
 #include <protocols/jd2/PDBJobOutputterCreator.hh>
 #include <protocols/jd2/Job.hh>
+#include <protocols/jd2/AsyncOutputWriter.hh>
 
 ///Project headers
 #include <core/pose/Pose.hh>
@@ -93,10 +94,7 @@ void protocols::jd2::PDBJobOutputter::final_pose(
 	call_output_observers( pose, job );
 	std::string const base_file ( extended_name(job, tag) );
 	std::string const file(path_ + base_file );
-	utility::io::ozstream out( file );
-	if ( !out.good() ) utility_exit_with_message( "Unable to open file: " + file + "\n" );
-	dump_pose(job, pose, out, base_file );
-	out.close();
+	write_pose( job, pose, file, base_file );
 	scorefile(job, pose, "", (tag.empty() ? "" : std::string("_") + tag));
 }
 
@@ -113,10 +111,7 @@ void protocols::jd2::PDBJobOutputter::other_pose(
 	call_output_observers( pose, job );
 	std::string const base_file( tag + "_" + extended_name(job) );
 	std::string const file(path_ + base_file );
-	utility::io::ozstream out( file );
-	if ( !out.good() ) utility_exit_with_message( "Unable to open file: " + file + "\n" );
-	dump_pose(job, pose, out, base_file );
-	out.close();
+	write_pose( job, pose, file, base_file );
 
 	//these are separate options because leaving the default on other_pose_scorefile is totally valid, but you can't both specify it on the command line and leave it blank
 	//THIS FUNCTIONALITY IS GOING TO BE DEPRECATED SOON. WHY???
@@ -125,24 +120,60 @@ void protocols::jd2::PDBJobOutputter::other_pose(
 	}
 }
 
-/// @details private function (just prevents code duplication) to fill ozstream
+/// @details writes the pdb of pose to file, through the AsyncOutputWriter with -jd2:async_output
+void protocols::jd2::PDBJobOutputter::write_pose(
+	JobCOP job,
+	core::pose::Pose const & pose,
+	std::string const & file,
+	std::string const & base_file
+)
+{
+	AsyncOutputWriter * writer( AsyncOutputWriter::get_instance() );
+	if ( writer->active() ) {
+		std::ostringstream contents;
+		dump_pose( job, pose, contents, base_file );
+		writer->write( file, contents.str(), AsyncOutputWriter::overwrite );
+		return;
+	}
+
+	utility::io::ozstream out( file );
+	if ( !out.good() ) utility_exit_with_message( "Unable to open file: " + file + "\n" );
+	dump_pose(job, pose, out, base_file );
+	out.close();
+}
+
+/// @details private function (just prevents code duplication) to fill the stream
 void protocols::jd2::PDBJobOutputter::dump_pose(
 	JobCOP job,
 	core::pose::Pose const & pose,
-	utility::io::ozstream & out,
+	std::ostream & out,
 	std::string const &filename
 )
 {
 	bool no_scores_in_pdb( basic::options::option[ basic::options::OptionKeys::out::file::no_scores_in_pdb ] );
 
+	std::string contents;
 	core::io::pdb::dump_pdb(
 		pose,
 		no_scores_in_pdb ? "" : extract_data_from_Job(job),
 		!no_scores_in_pdb,
 		!no_scores_in_pdb,
-		out,
+		contents,
 		filename
 	);
+	out << contents;
+}
+
+void protocols::jd2::PDBJobOutputter::dump_pose(
+	JobCOP job,
+	core::pose::Pose const & pose,
+	utility::io::ozstream & out,
+	std::string const &filename
+)
+{
+	std::ostringstream contents;
+	dump_pose( job, pose, contents, filename );
+	out << contents.str();
 }
 
 /////////////////////////////////state of output functions/////////////////////////////////
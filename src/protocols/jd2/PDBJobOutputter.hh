@@ -94,10 +94,16 @@ protected:
 	std::string extract_data_from_Job( JobCOP job );
 
 	//////////////////////////////////////protected PDB output/////////////////////////////////////
-	/// @brief handles ozstream output; shared by both pdb output functions
+	/// @brief renders the pdb of pose into out; shared by both pdb output functions
 	virtual
+	void dump_pose( JobCOP job, core::pose::Pose const & pose, std::ostream & out, std::string const &filename="" );
+
+	/// @brief handles ozstream output through the dump_pose above
 	void dump_pose( JobCOP job, core::pose::Pose const & pose, utility::io::ozstream & out, std::string const &filename="" );
 
+	/// @brief writes the pdb of pose to file, or hands it to the AsyncOutputWriter with -jd2:async_output
+	void write_pose( JobCOP job, core::pose::Pose const & pose, std::string const & file, std::string const & base_file );
+
 	////////////////////////////////////////data////////////////////////////////////////
 private:
 	std::string extension_;
@@ -20,6 +20,7 @@
 #include <protocols/jd2/SilentFileJobOutputter.hh>
 #include <protocols/jd2/SilentFileJobOutputterCreator.hh>
 #include <protocols/jd2/Job.hh>
+#include <protocols/jd2/AsyncOutputWriter.hh>
 #include <protocols/jd2/util.hh>
 
 #include <core/io/silent/SilentFileData.hh>
@@ -85,8 +86,21 @@ void SilentFileJobOutputter::write_all_structs() {
 			//SilentStructOP ss = it->first;
 			sfds[ it->second ].add_structure( (*it->first) );
 		}
+		AsyncOutputWriter * writer( AsyncOutputWriter::get_instance() );
 		for ( SFD_MAP::iterator it = sfds.begin(); it!=sfds.end(); ++it ) {
-			it->second.write_all( it->first );
+			if ( !writer->active() ) {
+				it->second.write_all( it->first );
+				continue;
+			}
+			// as write_all(), but only the disk write is left to the I/O thread
+			core::io::silent::SilentFileData const & sfd( it->second );
+			if ( sfd.begin() == sfd.end() ) continue;
+			std::ostringstream header, contents;
+			sfd.begin()->print_header( header );
+			for ( core::io::silent::SilentFileData::const_iterator ss = sfd.begin(); ss != sfd.end(); ++ss ) {
+				sfd.write_silent_struct( **ss, contents, false );
+			}
+			writer->write( it->first, contents.str(), AsyncOutputWriter::append, header.str() );
 		}
 	}
 	// very important to clear after writing!
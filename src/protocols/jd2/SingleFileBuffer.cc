@@ -13,6 +13,7 @@
 /// @author Oliver Lange olange@u.washington.edu
 
 #include <protocols/jd2/SingleFileBuffer.hh>
+#include <protocols/jd2/AsyncOutputWriter.hh>
 //#include <protocols/jd2/MpiFileBuffer.hh> //only needed for the runtime_assert grumpf.
 #include <iostream>
 #include <utility/io/mpistream.hh>
@@ -157,6 +158,8 @@ WriteFileSFB::WriteFileSFB( std::string const& filename, core::Size channel, boo
 }
 
 WriteFileSFB::~WriteFileSFB() {
+	// let the I/O thread finish its appends before this handle lets go of the file
+	AsyncOutputWriter::get_instance()->flush();
 	tr.Debug << "close file " << filename() << std::endl;
 	out_.close();
 }
@@ -170,7 +173,15 @@ void WriteFileSFB::write_lines( LineBuffer const& buf ) {
 	else tr.Debug << -1.0*(all_start_time-ntime)/CLOCKS_PER_SEC << " " <<1.0*( ntime-last_time )/CLOCKS_PER_SEC << " seconds: write " << buf.size() << " blocks of data to file " << filename() << std::endl;
 	last_time = ntime;
 
-	copy( buf.begin(), buf.end(), std::ostream_iterator< std::string>( out_ ) );
+	AsyncOutputWriter * writer( AsyncOutputWriter::get_instance() );
+	if ( writer->active() ) {
+		// leave the disk write to the I/O thread so the buffer node can go on receiving
+		std::string contents;
+		for ( LineBuffer::const_iterator it = buf.begin(); it != buf.end(); ++it ) contents += *it;
+		writer->write( filename(), contents, AsyncOutputWriter::append );
+	} else {
+		copy( buf.begin(), buf.end(), std::ostream_iterator< std::string>( out_ ) );
+	}
 	if ( tr.Trace.visible() ) {
 		copy( buf.begin(), buf.end(), std::ostream_iterator< std::string>( tr.Trace ) );
 		tr.Trace << std::endl;
@@ -178,6 +189,7 @@ void WriteFileSFB::write_lines( LineBuffer const& buf ) {
 }
 
 void WriteFileSFB::block( core::Size slave ) {
+	AsyncOutputWriter::get_instance()->flush(); // the slave writes to the file itself while it is blocked
 	out_.close();
 	tr.Debug << "block file " << filename() << std::endl;
 	//out_.flush();
@@ -0,0 +1,424 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   protocols/jd2/ThreadPoolJobDistributor.cc
+/// @brief  runs several jd2 jobs at once in one process, one per worker thread
+
+// Unit headers
+#include <protocols/jd2/ThreadPoolJobDistributor.hh>
+
+// Package headers
+#include <protocols/jd2/AsyncOutputWriter.hh>
+#include <protocols/jd2/Job.hh>
+#include <protocols/jd2/JobInputter.hh>
+#include <protocols/jd2/JobOutputter.hh>
+#include <protocols/jd2/JobsContainer.hh>
+#include <protocols/jd2/Parser.hh>
+
+#include <protocols/moves/Mover.hh>
+
+// Project headers
+#include <core/pose/Pose.hh>
+
+// Basic headers
+#include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/jd2.OptionKeys.gen.hh>
+#include <basic/options/keys/out.OptionKeys.gen.hh>
+#include <basic/options/keys/run.OptionKeys.gen.hh>
+
+// Numeric headers
+#include <numeric/random/random.hh>
+
+// Utility headers
+#include <utility/excn/Exceptions.hh>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <limits>
+#include <thread>
+#include <vector>
+#endif
+
+static THREAD_LOCAL basic::Tracer TR( "protocols.jd2.ThreadPoolJobDistributor" );
+
+namespace protocols {
+namespace jd2 {
+
+#if defined MULTI_THREADED && defined CXX11
+/// @brief the worker the calling thread is, counted from 1; 0 outside the workers
+static THREAD_LOCAL core::Size worker_index( 0 );
+/// @brief the job the calling worker is running
+static THREAD_LOCAL JobOP worker_job;
+static THREAD_LOCAL core::Size worker_job_id( 0 );
+/// @brief repetitions of worker_job_id, checked against -run:max_retry_job
+static THREAD_LOCAL core::Size worker_retries( 0 );
+#endif
+
+ThreadPoolJobDistributor::ThreadPoolJobDistributor() :
+	FileSystemJobDistributor(),
+	n_workers_( 1 )
+{
+	using namespace basic::options;
+
+	int const nthreads( option[ OptionKeys::jd2::nthreads ]() );
+#if defined MULTI_THREADED && defined CXX11
+	n_workers_ = nthreads > 0 ? core::Size( nthreads ) : core::Size( std::thread::hardware_concurrency() );
+	if ( n_workers_ == 0 ) n_workers_ = 1;
+	base_seed_ = 0;
+	tried_jobs_ = 0;
+	stop_ = false;
+#else
+	if ( nthreads != 1 ) {
+		TR.Warning << "-jd2:nthreads needs a multithreaded build; jobs run one after the other." << std::endl;
+	}
+#endif
+}
+
+/// @brief dtor
+///WARNING WARNING!  SINGLETONS' DESTRUCTORS ARE NEVER CALLED IN MINI!  DO NOT TRY TO PUT THINGS IN THIS FUNCTION!
+ThreadPoolJobDistributor::~ThreadPoolJobDistributor()
+{}
+
+void
+ThreadPoolJobDistributor::go( protocols::moves::MoverOP mover )
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( can_run_threaded() ) {
+		setup_system_signal_handler();
+		go_threads( mover );
+		remove_system_signal_handler();
+		return;
+	}
+#endif
+	FileSystemJobDistributor::go( mover );
+}
+
+JobOP
+ThreadPoolJobDistributor::current_job() const
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( worker_job ) return worker_job;
+#endif
+	return FileSystemJobDistributor::current_job();
+}
+
+std::string
+ThreadPoolJobDistributor::current_output_name() const
+{
+	return job_outputter()->output_name( current_job() );
+}
+
+/// @details Same limit on repetitions as the FileSystemJobDistributor, counted per job: the job goes back
+/// to the front of the deque of the worker that ran it, so that this worker runs it again next.
+void
+ThreadPoolJobDistributor::mark_current_job_id_for_repetition()
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( worker_index != 0 ) {
+		using namespace basic::options;
+		++worker_retries;
+		if ( int( worker_retries ) <= option[ OptionKeys::run::max_retry_job ]() ) {
+			if ( !option[ OptionKeys::run::write_failures ]() ) {
+				clear_current_job_output();
+			}
+			WorkerQueue & queue( *queues_[ worker_index ] );
+			std::lock_guard< std::mutex > lock( queue.mutex );
+			queue.job_ids.push_front( current_job_id() );
+		} else {
+			worker_retries = 0;
+			TR << "Too many retries (max_retry_job = " << option[ OptionKeys::run::max_retry_job ]() << ") " << std::endl;
+		}
+		return;
+	}
+#endif
+	FileSystemJobDistributor::mark_current_job_id_for_repetition();
+}
+
+#if defined MULTI_THREADED && defined CXX11
+
+bool
+ThreadPoolJobDistributor::can_run_threaded() const
+{
+	using namespace basic::options;
+
+	if ( n_workers_ < 2 ) return false;
+	if ( nr_batches() > 0 ) {
+		TR.Warning << "-jd2:nthreads is not used with batches; jobs run one after the other." << std::endl;
+		return false;
+	}
+	if ( option[ OptionKeys::jd2::checkpoint_file ].user() ) {
+		TR.Warning << "-jd2:nthreads is not used with -jd2:checkpoint_file, which needs jobs to finish in order;"
+			<< " jobs run one after the other." << std::endl;
+		return false;
+	}
+	if ( option[ OptionKeys::run::multiple_processes_writing_to_one_directory ]() ) {
+		TR.Warning << "-jd2:nthreads is not used with -run:multiple_processes_writing_to_one_directory;"
+			<< " jobs run one after the other." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void
+ThreadPoolJobDistributor::go_threads( protocols::moves::MoverOP mover )
+{
+	time_t const allstarttime = time( NULL );
+
+	check_for_parser_in_go_main();
+	AsyncOutputWriter::get_instance()->start_if_requested();
+	fill_worker_queues();
+	tried_jobs_ = 0;
+	stop_ = false;
+	error_ = std::exception_ptr();
+
+	// every job seeds the random generator of its thread from this one seed and its job index, so the
+	// results do not depend on which worker ends up running which job
+	base_seed_ = numeric::random::rg().random_range( 1, std::numeric_limits< int >::max() - 1 );
+
+	// clone in this thread, before any worker runs: clone() of a mover need not be thread safe
+	std::vector< std::thread > workers;
+	for ( core::Size worker = 1; worker <= n_workers_; ++worker ) {
+		protocols::moves::MoverOP worker_mover;
+		if ( mover ) worker_mover = mover->clone();
+		workers.push_back( std::thread( &ThreadPoolJobDistributor::worker_loop, this, worker, worker_mover, allstarttime ) );
+	}
+	for ( core::Size ii = 0; ii < workers.size(); ++ii ) {
+		workers[ ii ].join();
+	}
+
+	if ( error_ ) {
+		// write the output of the jobs that finished before passing the error on
+		AsyncOutputWriter::get_instance()->shutdown();
+		std::rethrow_exception( error_ );
+	}
+
+	finish_go_main( allstarttime, tried_jobs_ );
+}
+
+void
+ThreadPoolJobDistributor::fill_worker_queues()
+{
+	using namespace basic::options;
+
+	JobsContainer & jobs( get_jobs_nonconst() );
+	JobOutputterOP outputter( job_outputter() );
+	bool const overwrite( option[ OptionKeys::out::overwrite ]() );
+
+	utility::vector1< core::Size > pending;
+	for ( core::Size ii = 1; ii <= jobs.size(); ++ii ) {
+		if ( jobs[ ii ]->bad() ) continue;
+		if ( !overwrite && outputter->job_has_completed( jobs[ ii ] ) ) continue;
+		pending.push_back( ii );
+	}
+
+	queues_.clear();
+	for ( core::Size worker = 1; worker <= n_workers_; ++worker ) {
+		queues_.push_back( WorkerQueueOP( new WorkerQueue ) );
+	}
+	for ( core::Size ii = 1; ii <= pending.size(); ++ii ) {
+		queues_[ ( ii - 1 ) * n_workers_ / pending.size() + 1 ]->job_ids.push_back( pending[ ii ] );
+	}
+	TR << pending.size() << " jobs to run on " << n_workers_ << " threads" << std::endl;
+}
+
+core::Size
+ThreadPoolJobDistributor::claim_job( core::Size const worker )
+{
+	WorkerQueue & own( *queues_[ worker ] );
+	{
+		std::lock_guard< std::mutex > lock( own.mutex );
+		if ( !own.job_ids.empty() ) {
+			core::Size const job_id( own.job_ids.front() );
+			own.job_ids.pop_front();
+			return job_id;
+		}
+	}
+
+	// steal the back half of the fullest deque; another thief may get there first, so look again if
+	// the victim turns out to be empty
+	while ( true ) {
+		core::Size victim( 0 ), most( 0 );
+		for ( core::Size ii = 1; ii <= queues_.size(); ++ii ) {
+			if ( ii == worker ) continue;
+			std::lock_guard< std::mutex > lock( queues_[ ii ]->mutex );
+			if ( queues_[ ii ]->job_ids.size() > most ) {
+				most = queues_[ ii ]->job_ids.size();
+				victim = ii;
+			}
+		}
+		if ( victim == 0 ) return 0;
+
+		std::deque< core::Size > stolen;
+		{
+			std::deque< core::Size > & victim_ids( queues_[ victim ]->job_ids );
+			std::lock_guard< std::mutex > lock( queues_[ victim ]->mutex );
+			if ( victim_ids.empty() ) continue;
+			std::deque< core::Size >::iterator const first( victim_ids.end() - ( victim_ids.size() + 1 ) / 2 );
+			stolen.assign( first, victim_ids.end() );
+			victim_ids.erase( first, victim_ids.end() );
+		}
+		TR.Debug << "worker " << worker << " took " << stolen.size() << " jobs from worker " << victim << std::endl;
+
+		core::Size const job_id( stolen.front() );
+		stolen.pop_front();
+		std::lock_guard< std::mutex > lock( own.mutex );
+		own.job_ids.insert( own.job_ids.end(), stolen.begin(), stolen.end() );
+		return job_id;
+	}
+}
+
+void
+ThreadPoolJobDistributor::worker_loop(
+	core::Size const worker,
+	protocols::moves::MoverOP mover,
+	time_t const allstarttime
+)
+{
+	using namespace basic::options;
+
+	worker_index = worker;
+	std::string last_inner_job_tag;
+	core::Size retries_this_job( 0 );
+	try {
+		while ( !stop_ ) {
+			if ( option[ OptionKeys::run::maxruntime ].user() && option[ OptionKeys::run::maxruntime ]() > 0
+					&& time( NULL ) - allstarttime > option[ OptionKeys::run::maxruntime ]() ) {
+				basic::Error() << "Run terminating because runtime exceeded maxruntime of "
+					<< option[ OptionKeys::run::maxruntime ]() << " s" << std::endl;
+				stop_ = true;
+				break;
+			}
+			core::Size const job_id( claim_job( worker ) );
+			if ( job_id == 0 ) break;
+			run_job( job_id, mover, last_inner_job_tag, retries_this_job );
+		}
+	} catch ( ... ) {
+		std::lock_guard< std::mutex > lock( error_mutex_ );
+		if ( !error_ ) error_ = std::current_exception();
+		stop_ = true;
+	}
+	worker_job.reset();
+	worker_job_id = 0;
+	worker_index = 0;
+}
+
+void
+ThreadPoolJobDistributor::run_job(
+	core::Size const job_id,
+	protocols::moves::MoverOP & mover,
+	std::string & last_inner_job_tag,
+	core::Size & retries_this_job
+)
+{
+	using namespace basic::options;
+
+	std::unique_lock< std::mutex > lock( mutex_ );
+
+	JobOP job( get_jobs_nonconst()[ job_id ] );
+	if ( job->bad() ) return; // another worker found its input bad
+	++tried_jobs_;
+	worker_job = job;
+	if ( job_id != worker_job_id ) {
+		worker_job_id = job_id;
+		retries_this_job = 0;
+		worker_retries = 0;
+	}
+	// a retry gets a seed of its own; jobs.size() keeps it clear of the seeds of the other jobs
+	core::Size const seed_index( job_id + retries_this_job * get_jobs_nonconst().size() );
+	numeric::random::rg().set_seed( option[ OptionKeys::run::rng ](),
+		int( ( core::Size( base_seed_ ) + seed_index ) % core::Size( std::numeric_limits< int >::max() - 1 ) ) + 1 );
+	job->start_timing();
+
+	core::pose::Pose pose;
+	try {
+		job_inputter()->pose_from_job( pose, job );
+		setup_pymol_observer( pose );
+	} catch ( utility::excn::EXCN_RosettaScriptsOption & excn ) {
+		throw;
+	} catch ( utility::excn::EXCN_Base & excn ) {
+		basic::Error()
+			<< "ERROR: Exception caught by ThreadPoolJobDistributor while trying to get pose from job "
+			<< "'" << job_outputter()->output_name( job ) << "'" << std::endl
+			<< excn << std::endl;
+		fail_bad_input( job_id, pose );
+		return;
+	}
+
+	bool new_input( false ), reinitialize_new_input( false );
+	if ( job->input_tag() != last_inner_job_tag ) {
+		last_inner_job_tag = job->input_tag();
+		new_input = true;
+		reinitialize_new_input = mover
+			&& ( mover->reinitialize_for_new_input() || option[ OptionKeys::run::reinitialize_mover_for_new_input ]() );
+	}
+
+	if ( !using_parser()
+			&& ( reinitialize_new_input || mover->reinitialize_for_each_job()
+			|| option[ OptionKeys::run::reinitialize_mover_for_each_job ]() ) ) {
+		mover = mover->fresh_instance();
+	} else if ( using_parser() ) {
+		try {
+			parser()->generate_mover_from_job( job, pose, mover, new_input );
+		} catch ( utility::excn::EXCN_RosettaScriptsOption & excn ) {
+			throw;
+		} catch ( utility::excn::EXCN_Base & excn ) {
+			basic::Error()
+				<< "ERROR: Exception caught by ThreadPoolJobDistributor while trying to get mover from job "
+				<< "'" << job_outputter()->output_name( job ) << "'" << std::endl
+				<< excn << std::endl;
+			fail_bad_input( job_id, pose );
+			return;
+		}
+		// the Parser might have modified the starting pose
+		job_inputter()->pose_from_job( pose, job );
+	}
+
+	mover->reset_status();
+	mover->clear_info();
+	job_outputter()->starting_pose( pose );
+	mover->set_current_tag( job_outputter()->output_name( job ) );
+	lock.unlock();
+
+	protocols::moves::MoverStatus status;
+	try {
+		mover->apply( pose );
+		status = mover->get_last_move_status();
+	} catch ( utility::excn::EXCN_BadInput & excn ) {
+		TR.Error << "\n\n[ERROR] Exception caught by ThreadPoolJobDistributor for job "
+			<< mover->get_current_tag() << excn << std::endl;
+		status = protocols::moves::FAIL_BAD_INPUT;
+	} catch ( utility::excn::EXCN_Base & excn ) {
+		TR.Error << "\n\n[ERROR] Exception caught by ThreadPoolJobDistributor for job "
+			<< mover->get_current_tag() << excn << std::endl;
+		status = protocols::moves::FAIL_DO_NOT_RETRY;
+	}
+	job->end_timing();
+
+	lock.lock();
+	job->add_strings( mover->info() );
+	set_current_job_by_index( job_id );
+	write_output_from_job( pose, mover, status, job->elapsed_time(), retries_this_job );
+	current_job_finished();
+}
+
+void
+ThreadPoolJobDistributor::fail_bad_input( core::Size const job_id, core::pose::Pose & pose )
+{
+	basic::Error() << "Treating failure as bad input; canceling similar jobs" << std::endl;
+	set_current_job_by_index( job_id );
+	remove_bad_inputs_from_job_list();
+	job_failed( pose, false );
+	worker_job->end_timing();
+}
+
+#endif
+
+} // jd2
+} // protocols
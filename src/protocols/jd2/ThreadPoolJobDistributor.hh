@@ -0,0 +1,153 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   protocols/jd2/ThreadPoolJobDistributor.hh
+/// @brief  runs several jd2 jobs at once in one process, one per worker thread
+/// @details With -jd2:nthreads N the jobs left to run are split into N contiguous blocks, one deque per
+/// worker, so that consecutive nstructs of the same input stay on one thread.  A worker takes jobs from
+/// the front of its own deque; when it runs dry it steals the back half of the fullest other deque.
+/// Every worker applies its own clone() of the mover (or the mover the Parser made for it), so movers
+/// are never shared between threads; the poses of the inputs, the JobInputter, the Parser and the
+/// options are.  Building a job's starting pose and mover, and everything from write_output_from_job()
+/// on, happen under one lock, so the JobsContainer, the JobOutputter and the bookkeeping of the base
+/// classes only ever see one job at a time; Mover::apply() runs outside it.  current_job() answers for
+/// the calling thread.  Runs with batches, -jd2:checkpoint_file or
+/// -run:multiple_processes_writing_to_one_directory, and builds without thread support, run the jobs
+/// one after the other as the FileSystemJobDistributor does.
+
+#ifndef INCLUDED_protocols_jd2_ThreadPoolJobDistributor_hh
+#define INCLUDED_protocols_jd2_ThreadPoolJobDistributor_hh
+
+// Unit headers
+#include <protocols/jd2/ThreadPoolJobDistributor.fwd.hh>
+
+// Package headers
+#include <protocols/jd2/FileSystemJobDistributor.hh>
+#include <protocols/jd2/Job.fwd.hh>
+
+#include <protocols/moves/Mover.fwd.hh>
+
+#include <core/pose/Pose.fwd.hh>
+
+// Utility headers
+#include <core/types.hh>
+#include <utility/pointer/owning_ptr.hh>
+#include <utility/vector1.hh>
+
+// C++ headers
+#include <ctime>
+#include <string>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#endif
+
+namespace protocols {
+namespace jd2 {
+
+class ThreadPoolJobDistributor : public FileSystemJobDistributor
+{
+protected:
+	ThreadPoolJobDistributor();
+
+public:
+	///WARNING WARNING!  SINGLETONS' DESTRUCTORS ARE NEVER CALLED IN MINI!  DO NOT TRY TO PUT THINGS IN THIS FUNCTION!
+	virtual ~ThreadPoolJobDistributor();
+
+	friend class JobDistributorFactory; // calls protected ctor
+
+	virtual
+	void
+	go( protocols::moves::MoverOP mover );
+
+	/// @brief the job the calling worker thread is running; the base class answer outside the workers
+	virtual
+	JobOP
+	current_job() const;
+
+	virtual
+	std::string
+	current_output_name() const;
+
+	/// @brief number of worker threads go() will start
+	core::Size n_workers() const { return n_workers_; }
+
+protected:
+	/// @brief on a worker, put the job back at the front of the worker's deque
+	virtual
+	void
+	mark_current_job_id_for_repetition();
+
+#if defined MULTI_THREADED && defined CXX11
+private:
+	/// @brief jobs one worker will run, in order; other workers steal from the back
+	struct WorkerQueue {
+		std::deque< core::Size > job_ids;
+		std::mutex mutex;
+	};
+	typedef utility::pointer::shared_ptr< WorkerQueue > WorkerQueueOP;
+
+	/// @brief can this run be split over threads?  Says why not, if it cannot.
+	bool can_run_threaded() const;
+
+	/// @brief start the workers and wait for them
+	void go_threads( protocols::moves::MoverOP mover );
+
+	/// @brief split the jobs that still have to run into one contiguous block per worker
+	void fill_worker_queues();
+
+	/// @brief next job for worker: the front of its own deque, else one stolen from the fullest other
+	/// deque; 0 when there is nothing left anywhere
+	core::Size claim_job( core::Size worker );
+
+	void
+	worker_loop( core::Size worker, protocols::moves::MoverOP mover, time_t allstarttime );
+
+	/// @brief run_one_job for a worker
+	void
+	run_job(
+		core::Size job_id,
+		protocols::moves::MoverOP & mover,
+		std::string & last_inner_job_tag,
+		core::Size & retries_this_job
+	);
+
+	/// @brief report a job whose pose or mover could not be built as bad input; needs mutex_
+	void fail_bad_input( core::Size job_id, core::pose::Pose & pose );
+#endif
+
+private:
+	core::Size n_workers_;
+
+#if defined MULTI_THREADED && defined CXX11
+	utility::vector1< WorkerQueueOP > queues_;
+
+	/// @brief guards everything the workers share: the JobsContainer, the JobInputter, the Parser, the
+	/// JobOutputter and the bookkeeping of the base classes
+	std::mutex mutex_;
+
+	/// @brief a job seeds the random generator of its thread with this plus its job index
+	int base_seed_;
+
+	std::atomic< core::Size > tried_jobs_;
+	std::atomic< bool > stop_;
+	std::mutex error_mutex_;
+	/// @brief the first exception a worker did not handle; go() rethrows it
+	std::exception_ptr error_;
+#endif
+};
+
+} // jd2
+} // protocols
+
+#endif // INCLUDED_protocols_jd2_ThreadPoolJobDistributor_hh
@@ -78,6 +78,17 @@ void register_options() {
 
 static THREAD_LOCAL basic::Tracer TR( "protocols.jd2.JobDistributor" );
 
+/// @brief replica number and job of a replica run as a thread of this process; see set_thread_replica()
+static THREAD_LOCAL core::Size thread_replica( 0 );
+static THREAD_LOCAL JobOP thread_replica_job;
+
+/// @brief the job of the replica run by this thread, or else the job distributor's current job
+static JobOP
+current_job_of_thread( JobDistributor * jd )
+{
+	return thread_replica_job ? thread_replica_job : jd->current_job();
+}
+
 utility::vector1< utility::file::FileName >
 input_pdb_files_from_command_line()
 {
@@ -129,8 +140,8 @@ void output_intermediate_pose(
 ) {
 	JobDistributor* jd
 		= JobDistributor::get_instance();
-	if ( jd && jd->job_outputter() && jd->current_job() ) {
-		jd->job_outputter()->other_pose( jd->current_job(), pose, stage_tag, copy_count, score_only );
+	if ( jd && jd->job_outputter() && current_job_of_thread( jd ) ) {
+		jd->job_outputter()->other_pose( current_job_of_thread( jd ), pose, stage_tag, copy_count, score_only );
 	} else {
 		TR.Warning << "can't output intermediate pose if not running with  jobdistributor ( jd2 / 2008 )" << std::endl;
 	}
@@ -139,8 +150,8 @@ void output_intermediate_pose(
 std::string current_output_name() {
 	JobDistributor* jd
 		= JobDistributor::get_instance();
-	if ( jd && jd->job_outputter() && jd->current_job() ) {
-		return jd->job_outputter()->output_name( jd->current_job() );
+	if ( jd && jd->job_outputter() && current_job_of_thread( jd ) ) {
+		return jd->job_outputter()->output_name( current_job_of_thread( jd ) );
 	} else return "NoTag";
 }
 
@@ -207,7 +218,7 @@ JobOP get_current_job() {
 	JobDistributor* jd
 		= JobDistributor::get_instance();
 	if ( jd && jd->job_inputter() ) {
-		return jd->current_job();
+		return current_job_of_thread( jd );
 	} else return NULL;
 }
 
@@ -286,6 +297,7 @@ MPI_Comm const& current_mpi_comm() {
 #endif
 
 core::Size current_replica() {
+	if ( thread_replica ) return thread_replica;
 	JobDistributor* jd
 		= JobDistributor::get_instance();
 	if ( jd ) {
@@ -297,5 +309,10 @@ core::Size current_replica() {
 	return 0;
 }
 
+void set_thread_replica( core::Size replica, JobOP job ) {
+	thread_replica = replica;
+	thread_replica_job = replica ? job : JobOP();
+}
+
 } // jd2
 } // protocols
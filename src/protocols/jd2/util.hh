@@ -81,6 +81,11 @@ MPI_Comm const& current_mpi_comm();
 /// otherwise it returns the sub-rank of the process within the job starting at 1
 core::Size current_replica();
 
+/// @brief For replicas of a job run as threads of one process: from now on, on the calling thread,
+/// current_replica() returns replica, and get_current_job() and current_output_name() use job, a copy
+/// of the job private to the replica.  Replica 0 goes back to asking the JobDistributor.
+void set_thread_replica( core::Size replica, JobOP job );
+
 }  //jd2
 }  //protocols
 
@@ -16,8 +16,11 @@
 
 // Package headers
 #include <protocols/jd3/JobDistributor.hh>
+#include <protocols/jd3/job_distributors/HybridJobDistributor.hh>
 
-//#include <protocols/jd3/job_distributors/FileSystemJobDistributor.hh>
+// Basic headers
+#include <basic/options/option.hh>
+#include <basic/options/keys/jd3.OptionKeys.gen.hh>
 
 namespace protocols {
 namespace jd3 {
@@ -25,7 +28,11 @@ namespace jd3 {
 JobDistributorOP
 JobDistributorFactory::create_job_distributor()
 {
-	// TEMP!
+	using namespace basic::options;
+
+	if ( option[ OptionKeys::jd3::n_threads_per_rank ]() != 1 ) {
+		return JobDistributorOP( new job_distributors::HybridJobDistributor );
+	}
 	return JobDistributorOP( new JobDistributor );
 }
 
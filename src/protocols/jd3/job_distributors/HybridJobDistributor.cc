@@ -0,0 +1,322 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   protocols/jd3/job_distributors/HybridJobDistributor.cc
+/// @brief  runs jd3 jobs on a pool of threads in a single process
+
+// Unit headers
+#include <protocols/jd3/job_distributors/HybridJobDistributor.hh>
+
+// Package headers
+#include <protocols/jd3/Job.hh>
+#include <protocols/jd3/JobQueen.hh>
+#include <protocols/jd3/JobResult.hh>
+#include <protocols/jd3/LarvalJob.hh>
+
+// Basic headers
+#include <basic/Tracer.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/jd3.OptionKeys.gen.hh>
+#include <basic/options/keys/run.OptionKeys.gen.hh>
+
+// Numeric headers
+#include <numeric/random/random.hh>
+
+// Utility headers
+#include <utility/excn/EXCN_Base.hh>
+#include <utility/exit.hh>
+#include <utility/mpi_util.hh>
+
+// C++ headers
+#include <limits>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <chrono>
+#endif
+
+namespace protocols {
+namespace jd3 {
+namespace job_distributors {
+
+static THREAD_LOCAL basic::Tracer TR( "protocols.jd3.job_distributors.HybridJobDistributor" );
+
+HybridJobDistributor::HybridJobDistributor() :
+	n_threads_( 1 ),
+	base_seed_( 0 ),
+	seed_offset_( 0 ),
+	n_running_( 0 ),
+	threads_stop_( false )
+{
+	using namespace basic::options;
+
+	int const n_threads( option[ OptionKeys::jd3::n_threads_per_rank ]() );
+#if defined MULTI_THREADED && defined CXX11
+	n_threads_ = n_threads > 0 ? core::Size( n_threads ) : core::Size( std::thread::hardware_concurrency() );
+	if ( n_threads_ == 0 ) n_threads_ = 1;
+#else
+	if ( n_threads != 1 ) {
+		TR.Warning << "-jd3:n_threads_per_rank needs a multithreaded build; each process runs one job at a time." << std::endl;
+	}
+#endif
+	rng_type_ = option[ OptionKeys::run::rng ]();
+}
+
+HybridJobDistributor::~HybridJobDistributor() {}
+
+void
+HybridJobDistributor::go( JobQueenOP queen )
+{
+	set_job_queen( queen );
+
+	if ( utility::mpi_nprocs() > 1 ) {
+		utility_exit_with_message( "HybridJobDistributor runs the jobs of a single process on -jd3:n_threads_per_rank"
+			" threads; it does not hand out jobs between MPI processes." );
+	}
+
+	// every job seeds the random generator of its thread from this one seed and its index over all
+	// rounds, so the results do not depend on which thread runs which job
+	base_seed_ = numeric::random::rg().random_range( 1, std::numeric_limits< int >::max() - 1 );
+	seed_offset_ = 0;
+
+	do {
+		LarvalJobs const jobs( determine_jobs_for_next_round() );
+		store_jobs_for_current_round( jobs );
+		round_jobs_.assign( jobs.begin(), jobs.end() );
+		round_retries_.assign( round_jobs_.size(), 0 );
+		run_round_locally();
+		note_round_completed();
+		seed_offset_ += round_jobs_.size();
+	} while ( another_round_remains() );
+}
+
+void
+HybridJobDistributor::run_round_locally()
+{
+	utility::vector1< core::Size > job_indices;
+	for ( core::Size ii = 1; ii <= round_jobs_.size(); ++ii ) {
+		if ( round_jobs_[ ii ]->bad() || job_queen().has_job_completed( round_jobs_[ ii ] ) ) continue;
+		job_queen().mark_job_as_having_begun( round_jobs_[ ii ] );
+		job_indices.push_back( ii );
+	}
+	TR << "running " << job_indices.size() << " jobs, " << n_threads_ << " at a time" << std::endl;
+	queue_local_jobs( job_indices, false );
+	start_threads();
+
+	while ( true ) {
+		if ( n_threads_ == 1 ) run_next_local_job();
+
+		FinishedJobs const finished( take_finished_jobs() );
+		for ( core::Size ii = 1; ii <= finished.size(); ++ii ) {
+			LarvalJobOP job( round_jobs_[ finished[ ii ].first ] );
+			if ( finished[ ii ].second == jd3_job_status_failed_retry ) {
+				queue_local_jobs( utility::vector1< core::Size >( 1, finished[ ii ].first ), true );
+			} else if ( finished[ ii ].second == jd3_job_status_inputs_were_bad ) {
+#if defined MULTI_THREADED && defined CXX11
+				std::lock_guard< std::mutex > lock( queen_mutex_ );
+#endif
+				// a job flagged bad before it ran has been reported to the JobQueen already
+				if ( ! job->bad() ) purge_similar_jobs_which_have_bad_inputs( job );
+			} else {
+				job->completed( true );
+			}
+		}
+		if ( finished.empty() && n_queued_or_running() == 0 ) break;
+		wait_for_finished_jobs();
+	}
+	stop_threads();
+}
+
+void
+HybridJobDistributor::queue_local_jobs( utility::vector1< core::Size > const & job_indices, bool const at_front )
+{
+	{
+#if defined MULTI_THREADED && defined CXX11
+		std::lock_guard< std::mutex > lock( mutex_ );
+#endif
+		if ( at_front ) {
+			queue_.insert( queue_.begin(), job_indices.begin(), job_indices.end() );
+		} else {
+			queue_.insert( queue_.end(), job_indices.begin(), job_indices.end() );
+		}
+	}
+#if defined MULTI_THREADED && defined CXX11
+	work_cv_.notify_all();
+#endif
+}
+
+void
+HybridJobDistributor::start_threads()
+{
+	threads_stop_ = false;
+#if defined MULTI_THREADED && defined CXX11
+	error_ = std::exception_ptr();
+	if ( n_threads_ == 1 ) return;
+	for ( core::Size ii = 1; ii <= n_threads_; ++ii ) {
+		threads_.push_back( std::thread( &HybridJobDistributor::thread_loop, this ) );
+	}
+#endif
+}
+
+void
+HybridJobDistributor::stop_threads()
+{
+#if defined MULTI_THREADED && defined CXX11
+	{
+		std::lock_guard< std::mutex > lock( mutex_ );
+		threads_stop_ = true;
+	}
+	work_cv_.notify_all();
+	for ( core::Size ii = 0; ii < threads_.size(); ++ii ) {
+		threads_[ ii ].join();
+	}
+	threads_.clear();
+	if ( error_ ) std::rethrow_exception( error_ );
+#else
+	threads_stop_ = true;
+#endif
+}
+
+bool
+HybridJobDistributor::run_next_local_job()
+{
+	core::Size job_index( 0 ), retries( 0 );
+	{
+#if defined MULTI_THREADED && defined CXX11
+		std::lock_guard< std::mutex > lock( mutex_ );
+#endif
+		if ( queue_.empty() ) return false;
+		job_index = queue_.front();
+		queue_.pop_front();
+		retries = round_retries_[ job_index ];
+		++n_running_;
+	}
+
+	// a retry gets a seed of its own; round_jobs_.size() keeps it clear of the seeds of the other jobs
+	core::Size const seed_index( seed_offset_ + job_index + retries * round_jobs_.size() );
+	numeric::random::rg().set_seed( rng_type_,
+		int( ( core::Size( base_seed_ ) + seed_index ) % core::Size( std::numeric_limits< int >::max() - 1 ) ) + 1 );
+
+	JobStatus status( jd3_job_status_failed_w_exception );
+#if defined MULTI_THREADED && defined CXX11
+	try {
+		status = run_job( job_index );
+	} catch ( ... ) {
+		std::lock_guard< std::mutex > lock( mutex_ );
+		if ( ! error_ ) error_ = std::current_exception();
+	}
+#else
+	status = run_job( job_index );
+#endif
+
+	{
+#if defined MULTI_THREADED && defined CXX11
+		std::lock_guard< std::mutex > lock( mutex_ );
+#endif
+		finished_.push_back( FinishedJob( job_index, status ) );
+		if ( status == jd3_job_status_failed_retry ) ++round_retries_[ job_index ];
+		--n_running_;
+	}
+#if defined MULTI_THREADED && defined CXX11
+	done_cv_.notify_all();
+#endif
+	return true;
+}
+
+/// @details Failed retries and bad inputs are left to the caller, which queues the job again or
+/// tells the JobQueen about the other jobs of the same input.
+JobStatus
+HybridJobDistributor::run_job( core::Size const job_index )
+{
+	LarvalJobOP larval_job( round_jobs_[ job_index ] );
+
+	JobOP mature_job;
+	{
+#if defined MULTI_THREADED && defined CXX11
+		std::lock_guard< std::mutex > lock( queen_mutex_ );
+#endif
+		// another job of the same input turned out bad after this one was queued
+		if ( larval_job->bad() ) return jd3_job_status_inputs_were_bad;
+		mature_job = job_queen().mature_larval_job( larval_job );
+	}
+	if ( ! mature_job ) return jd3_job_status_inputs_were_bad;
+
+	JobResultOP result;
+	try {
+		result = mature_job->run();
+	} catch ( utility::excn::EXCN_Base const & exception ) {
+#if defined MULTI_THREADED && defined CXX11
+		std::lock_guard< std::mutex > lock( queen_mutex_ );
+#endif
+		process_exception_from_job( larval_job, exception );
+		return jd3_job_status_failed_w_exception;
+	}
+
+	JobStatus const status( result->status() );
+	if ( status == jd3_job_status_failed_retry || status == jd3_job_status_inputs_were_bad ) return status;
+
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( queen_mutex_ );
+#endif
+	if ( status == jd3_job_status_success ) {
+		job_queen().completed_job_result( larval_job, result );
+	} else {
+		job_queen().note_job_completed( larval_job, status );
+	}
+	return status;
+}
+
+HybridJobDistributor::FinishedJobs
+HybridJobDistributor::take_finished_jobs()
+{
+	FinishedJobs finished;
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( mutex_ );
+#endif
+	finished.swap( finished_ );
+	return finished;
+}
+
+core::Size
+HybridJobDistributor::n_queued_or_running()
+{
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( mutex_ );
+#endif
+	return queue_.size() + n_running_ + finished_.size();
+}
+
+void
+HybridJobDistributor::wait_for_finished_jobs()
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( n_threads_ == 1 ) return;
+	std::unique_lock< std::mutex > lock( mutex_ );
+	done_cv_.wait_for( lock, std::chrono::milliseconds( 5 ), [this]{ return ! finished_.empty(); } );
+#endif
+}
+
+#if defined MULTI_THREADED && defined CXX11
+void
+HybridJobDistributor::thread_loop()
+{
+	while ( true ) {
+		{
+			std::unique_lock< std::mutex > lock( mutex_ );
+			work_cv_.wait( lock, [this]{ return ! queue_.empty() || threads_stop_; } );
+			if ( queue_.empty() ) return;
+		}
+		run_next_local_job();
+	}
+}
+#endif
+
+} // job_distributors
+} // jd3
+} // protocols
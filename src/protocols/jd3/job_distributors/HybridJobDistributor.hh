@@ -0,0 +1,142 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+
+/// @file   protocols/jd3/job_distributors/HybridJobDistributor.hh
+/// @brief  runs jd3 jobs on a pool of threads in a single process
+/// @details The process runs -jd3:n_threads_per_rank jobs at once, so a node needs one process (and one
+/// copy of the database) instead of one per core.  All calls into the JobQueen are serialized; only
+/// Job::run() runs concurrently.  Jobs are not handed out between MPI processes: runs of more than one
+/// process stop with an error.
+
+#ifndef INCLUDED_protocols_jd3_job_distributors_HybridJobDistributor_hh
+#define INCLUDED_protocols_jd3_job_distributors_HybridJobDistributor_hh
+
+// Unit headers
+#include <protocols/jd3/job_distributors/HybridJobDistributor.fwd.hh>
+
+// Package headers
+#include <protocols/jd3/JobDistributor.hh>
+#include <protocols/jd3/Job.fwd.hh>
+#include <protocols/jd3/JobQueen.fwd.hh>
+#include <protocols/jd3/LarvalJob.fwd.hh>
+
+// Project headers
+#include <core/types.hh>
+
+// Utility headers
+#include <utility/vector1.hh>
+
+// C++ headers
+#include <deque>
+#include <string>
+#include <utility>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace protocols {
+namespace jd3 {
+namespace job_distributors {
+
+class HybridJobDistributor : public JobDistributor {
+public:
+	HybridJobDistributor();
+	virtual ~HybridJobDistributor();
+
+	virtual
+	void
+	go( JobQueenOP queen );
+
+	/// @brief number of jobs this process runs at once
+	core::Size n_threads() const { return n_threads_; }
+
+private:
+	/// @brief index of a job in the round's job list, and how it ended
+	typedef std::pair< core::Size, JobStatus > FinishedJob;
+	typedef utility::vector1< FinishedJob > FinishedJobs;
+
+	/// @brief run the round's jobs in this process
+	void run_round_locally();
+
+	/// @brief add jobs to the local queue, at its front for jobs to repeat
+	void queue_local_jobs( utility::vector1< core::Size > const & job_indices, bool at_front );
+
+	/// @brief start the threads for a round; with a single thread the caller runs the jobs itself
+	void start_threads();
+
+	/// @brief wait for the threads to work through the local queue and join them
+	void stop_threads();
+
+	/// @brief take the next job off the local queue and run it; false if the queue is empty
+	bool run_next_local_job();
+
+	/// @brief mature and run one job and hand its result to the JobQueen
+	JobStatus run_job( core::Size job_index );
+
+	/// @brief the jobs that finished since the last call
+	FinishedJobs take_finished_jobs();
+
+	/// @brief jobs waiting in the local queue, running, or finished but not taken yet
+	core::Size n_queued_or_running();
+
+	/// @brief block for a short while unless finished jobs are waiting to be taken
+	void wait_for_finished_jobs();
+
+#if defined MULTI_THREADED && defined CXX11
+	void thread_loop();
+#endif
+
+private:
+	core::Size n_threads_;
+
+	/// @brief the jobs of the current round
+	LarvalJobVector round_jobs_;
+	/// @brief how often each job of the round failed and was queued again
+	utility::vector1< core::Size > round_retries_;
+
+	/// @brief -run:rng, read once here rather than by the job threads
+	std::string rng_type_;
+	/// @brief a job seeds the random generator of its thread with this plus its index over all rounds
+	int base_seed_;
+	/// @brief the number of jobs in the earlier rounds
+	core::Size seed_offset_;
+
+	std::deque< core::Size > queue_;
+	FinishedJobs finished_;
+	core::Size n_running_;
+	/// @brief no more jobs will be queued: threads leave once the queue is empty
+	bool threads_stop_;
+
+#if defined MULTI_THREADED && defined CXX11
+	/// @brief guards queue_, finished_, n_running_, threads_stop_ and error_
+	std::mutex mutex_;
+	/// @brief signalled when jobs are queued or the threads should stop
+	std::condition_variable work_cv_;
+	/// @brief signalled when a job finishes
+	std::condition_variable done_cv_;
+	/// @brief serializes the calls into the JobQueen and the bad-input flags of the round's jobs
+	std::mutex queen_mutex_;
+
+	std::vector< std::thread > threads_;
+	/// @brief the first exception other than EXCN_Base a job threw; rethrown once the round is over
+	std::exception_ptr error_;
+#endif
+};
+
+} // job_distributors
+} // jd3
+} // protocols
+
+#endif // INCLUDED_protocols_jd3_job_distributors_HybridJobDistributor_hh
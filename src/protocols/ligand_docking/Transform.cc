@@ -41,6 +41,8 @@
 #include <ObjexxFCL/format.hh>
 #include <utility/io/ozstream.hh>
 
+#include <algorithm>
+
 namespace protocols {
 namespace ligand_docking {
 
@@ -62,7 +64,7 @@ std::string TransformCreator::mover_name()
 	return "Transform";
 }
 
-Transform::Transform(): Mover("Transform"), transform_info_(),optimize_until_score_is_negative_(false), output_sampled_space_(false),check_rmsd_(false),initial_perturb_(0.0)
+Transform::Transform(): Mover("Transform"), transform_info_(),optimize_until_score_is_negative_(false), output_sampled_space_(false),check_rmsd_(false),initial_perturb_(0.0),grid_minimization_steps_(0)
 {
 
 }
@@ -76,7 +78,8 @@ Transform::Transform(Transform const & other) :
 	output_sampled_space_(other.output_sampled_space_),
 	check_rmsd_(other.check_rmsd_),
 	sampled_space_file_(other.sampled_space_file_),
-	initial_perturb_(other.initial_perturb_)
+	initial_perturb_(other.initial_perturb_),
+	grid_minimization_steps_(other.grid_minimization_steps_)
 {}
 
 Transform::Transform(
@@ -86,7 +89,7 @@ Transform::Transform(
 	core::Real const & angle,
 	core::Size const & cycles,
 	core::Real const & temp
-) : Mover("Transform"), transform_info_(),optimize_until_score_is_negative_(false),output_sampled_space_(false),check_rmsd_(false)
+) : Mover("Transform"), transform_info_(),optimize_until_score_is_negative_(false),output_sampled_space_(false),check_rmsd_(false),initial_perturb_(0.0),grid_minimization_steps_(0)
 {
 	transform_info_.chain = chain;
 	transform_info_.box_size = box_size;
@@ -144,6 +147,7 @@ void Transform::parse_my_tag
 	transform_info_.repeats = tag->getOption<core::Size>("repeats",1);
 	optimize_until_score_is_negative_ = tag->getOption<bool>("optimize_until_score_is_negative",false);
 	initial_perturb_ = tag->getOption<core::Real>("initial_perturb",0.0);
+	grid_minimization_steps_ = tag->getOption<core::Size>("grid_minimization_steps",0);
 
 
 	if ( tag->hasOption("rmsd") ) {
@@ -300,6 +304,12 @@ void Transform::apply(core::pose::Pose & pose)
 		best_ligand.update_conformation(best_pose.conformation());
 	}
 
+	if ( grid_minimization_steps_ > 0 ) {
+		core::Real const minimized_score(minimize_ligand(best_ligand,original_ligand,original_center));
+		transform_tracer << "Minimized best pose against the interpolated grids to grid score: " << minimized_score << std::endl;
+		best_ligand.update_conformation(best_pose.conformation());
+	}
+
 	if ( output_sampled_space_ ) {
 		sampled_space.close();
 	}
@@ -369,6 +379,60 @@ void Transform::dump_conformer(core::conformation::UltraLightResidue & residue,
 	}
 }
 
+core::Real Transform::minimize_ligand(
+	core::conformation::UltraLightResidue & residue,
+	core::conformation::UltraLightResidue const & original_ligand,
+	core::Vector const & original_center) const
+{
+	qsar::scoring_grid::GridManager* grid_manager(qsar::scoring_grid::GridManager::get_instance());
+
+	utility::vector1<core::Vector> gradients;
+	core::Real score(grid_manager->total_score_and_gradients(residue,gradients));
+
+	// largest displacement of any atom in one step, in angstroms
+	core::Real const max_step(0.5);
+	core::Real const min_step(0.001);
+	core::Real step(max_step);
+	for ( core::Size iteration = 1; iteration <= grid_minimization_steps_ && step >= min_step; ++iteration ) {
+		// the force and the torque about the center of mass, which UltraLightResidue::transform rotates around
+		core::Vector const center(numeric::center_of_mass(residue.coords_vector()));
+		core::Vector force(0.0);
+		core::Vector torque(0.0);
+		core::Real radius(0.0);
+		for ( core::Size atom_index = 1; atom_index <= residue.natoms(); ++atom_index ) {
+			core::Vector const arm(residue[atom_index]-center);
+			force -= gradients[atom_index];
+			torque -= arm.cross(gradients[atom_index]);
+			radius = std::max(radius,arm.length());
+		}
+		core::Real const displacement(force.length() + torque.length()*radius);
+		if ( displacement < 1e-8 ) break;
+
+		core::Real const scale(step/displacement);
+		numeric::xyzMatrix<core::Real> rotation(numeric::xyzMatrix<core::Real>::identity());
+		if ( torque.length() > 0.0 ) {
+			rotation = numeric::rotation_matrix(torque*scale);
+		}
+		core::conformation::UltraLightResidue trial(residue);
+		trial.transform(rotation,force*scale);
+
+		utility::vector1<core::Vector> trial_gradients;
+		if ( grid_manager->is_in_grid(trial) && trial.center().distance(original_center) <= transform_info_.box_size &&
+				( !check_rmsd_ || check_rmsd(original_ligand,trial) ) ) {
+			core::Real const trial_score(grid_manager->total_score_and_gradients(trial,trial_gradients));
+			if ( trial_score < score ) {
+				residue = trial;
+				score = trial_score;
+				gradients.swap(trial_gradients);
+				step = std::min(step*1.5,max_step);
+				continue;
+			}
+		}
+		step *= 0.5;
+	}
+	return score;
+}
+
 bool Transform::check_rmsd(core::conformation::UltraLightResidue const & start, core::conformation::UltraLightResidue const& current) const
 {
 	assert(start.natoms() == current.natoms());
@@ -109,6 +109,13 @@ private:
 	/// @brief return true if the rmsd is within the specified cutoff
 	bool check_rmsd(core::conformation::UltraLightResidue const & start, core::conformation::UltraLightResidue const& current) const;
 
+	/// @brief minimize the rigid body position of the ligand against the tricubically interpolated grids by steepest
+	/// descent, keeping it in the grid, in the box and within the rmsd cutoff; returns the interpolated grid score
+	core::Real minimize_ligand(
+		core::conformation::UltraLightResidue & residue,
+		core::conformation::UltraLightResidue const & original_ligand,
+		core::Vector const & original_center) const;
+
 private:
 	//qsar::scoring_grid::GridManagerOP grid_manager_;
 	Transform_info transform_info_;
@@ -118,6 +125,7 @@ private:
 	bool check_rmsd_;
 	std::string sampled_space_file_;
 	core::Real initial_perturb_;
+	core::Size grid_minimization_steps_;
 
 };
 
@@ -62,6 +62,10 @@
 #include <ctime>
 #endif
 
+#include <utility/thread/parallel_for.hh>
+
+#include <boost/bind.hpp>
+
 using namespace core::scoring;
 using namespace core;
 using namespace core::pose;
@@ -96,6 +100,8 @@ LoopHashLibrary::LoopHashLibrary( const utility::vector1< core::Size > &init_siz
 	loopdb_range_.first = 0;
 	loopdb_range_.second = 0;
 	db_path_ = basic::options::option[basic::options::OptionKeys::lh::db_path]();
+	sorted_db_ = basic::options::option[basic::options::OptionKeys::lh::sorted_db]();
+	n_threads_ = basic::options::option[basic::options::OptionKeys::lh::threads]();
 	assigned_string_ = ""; // This is because I don't know if an initialized string is null or empty
 	// we don't want db names like "part0of20" so we increment assigned_num by one to get "part1of20"
 	if ( num_partitions_ > 1 ) {
@@ -143,6 +149,12 @@ LoopHashLibrary::sort() {
 	}
 }
 
+std::string
+LoopHashLibrary::loopdb_filename( core::Size loop_size, std::string const & assigned_string ) const
+{
+	return db_path_ + "loopdb." + utility::to_string( loop_size ) + assigned_string + ( sorted_db_ ? ".sorted.db" : ".db" );
+}
+
 void
 LoopHashLibrary::save_db()
 {
@@ -151,7 +163,11 @@ LoopHashLibrary::save_db()
 	bbdb_.write_db( db_path_ + "backbone" + assigned_string_ + ".db" );
 	for ( std::vector< core::Size >::const_iterator it = hash_sizes_.begin(); it != hash_sizes_.end(); ++it ) {
 		TR.Info << "Saving loopdb (LoopHashDatabase) " << assigned_string_ << " with loop size " << *it << std::endl;
-		hash_[ *it ].write_db(db_path_ + "loopdb." + utility::to_string( *it ) + assigned_string_ + ".db" );
+		if ( sorted_db_ ) {
+			hash_[ *it ].write_sorted_db( loopdb_filename( *it, assigned_string_ ) );
+		} else {
+			hash_[ *it ].write_db( loopdb_filename( *it, assigned_string_ ) );
+		}
 	}
 	long endtime = time(NULL);
 	TR << "Save LoopHash Library: " << endtime - starttime << " seconds " << std::endl;
@@ -166,7 +182,7 @@ LoopHashLibrary::delete_db()
 	if ( remove( dbstring.c_str() ) != 0 ) throw EXCN_DB_IO_Failed( dbstring , "delete" );
 	TR.Info << "bbdb deletion successful" << std::endl;
 	for ( std::vector< core::Size >::const_iterator it = hash_sizes_.begin(); it != hash_sizes_.end(); ++it ) {
-		std::string dbstring = db_path_ + "loopdb." + utility::to_string( *it ) + assigned_string_ + ".db" ;
+		std::string dbstring = loopdb_filename( *it, assigned_string_ );
 		if ( remove( dbstring.c_str() ) != 0 ) throw EXCN_DB_IO_Failed( dbstring, "delete" );
 		TR.Info << "loopdb size " << utility::to_string( *it ) << " deletion successful" << std::endl;
 	}
@@ -182,7 +198,11 @@ LoopHashLibrary::load_db()
 	bbdb_.read_db( db_path_ + "backbone" + assigned_string_ + ".db", extra_ );
 	for ( std::vector< core::Size >::const_iterator it = hash_sizes_.begin(); it != hash_sizes_.end(); ++it ) {
 		TR.Info << "Reading loopdb (LoopHashDatabase) " << assigned_string_ << " with loop size " << *it << std::endl;
-		hash_[ *it ].read_db( db_path_ + "loopdb." + utility::to_string( *it ) + assigned_string_ + ".db" );
+		if ( sorted_db_ ) {
+			hash_[ *it ].read_sorted_db( loopdb_filename( *it, assigned_string_ ) );
+		} else {
+			hash_[ *it ].read_db( loopdb_filename( *it, assigned_string_ ) );
+		}
 	}
 	long endtime = time(NULL);
 	TR << "Read LoopHash Library from disk: " << endtime - starttime << " seconds " << std::endl;
@@ -207,8 +227,12 @@ LoopHashLibrary::load_mergeddb()
 		TR.Info << "Reading loopdb (LoopHashDatabase) " << assigned_string_ << " with loop size " << *it << std::endl;
 		// pass the range to the loophashmap so it knows which loops to read
 		// also pass the map of homologs
-		db_filename = db_path_ + "loopdb." + utility::to_string( *it ) + ".db";
-		hash_[ *it ].read_db(db_filename, loopdb_range_, homolog_map );
+		db_filename = loopdb_filename( *it, "" );
+		if ( sorted_db_ ) {
+			hash_[ *it ].read_sorted_db( db_filename, loopdb_range_, homolog_map );
+		} else {
+			hash_[ *it ].read_db( db_filename, loopdb_range_, homolog_map );
+		}
 	}
 	long endtime = time(NULL);
 	TR << "Read MergedLoopHash Library from disk: " << endtime - starttime << " seconds " << std::endl;
@@ -365,13 +389,25 @@ LoopHashLibrary::create_db()
 		// Read Vall
 		chunks->vallChunksFromLibrary(option[in::file::vall]()[1], startline, endline );
 
+		// Poses are built here, their leaps are found in batches on several threads and
+		// everything is added to the library in vall order, so the result does not depend on the thread count
+		core::Size const n_threads = utility::thread::parallel_thread_count( chunks->size(), n_threads_ );
+		core::Size const batch_size = 4 * n_threads;
+
 		core::Size nchunks = chunks->size();
+		utility::vector1< core::pose::PoseOP > poses;
+		utility::vector1< VallChunkOP > batch_chunks;
 		for ( core::Size i=1; i <= nchunks; ++i ) {
 			// Now the total number refers to within in partition
 			TR.Info << i << "/" << nchunks << " in " << assigned_string_ << std::endl;
 			VallChunkOP chunk = chunks->at(i);
-			core::pose::PoseOP newpose = chunk->get_pose();
-			extract_data_from_pose( *newpose, chunk->size(), chunk );
+			poses.push_back( chunk->get_pose() );
+			batch_chunks.push_back( chunk );
+			if ( poses.size() == batch_size || i == nchunks ) {
+				extract_data_from_chunks( poses, batch_chunks );
+				poses.clear();
+				batch_chunks.clear();
+			}
 		}
 	}
 
@@ -879,61 +915,118 @@ LoopHashLibrary::extract_data_from_pose( core::pose::Pose& pose, core::Size nres
 	using namespace kinematics;
 	using namespace numeric::geometry::hashing;
 
-	Size ir, jr;
 	//Size newpep_index = 0;
 	core::Size index;
 	bbdb_.add_pose( pose, nres, index, chunk );
 
-	static int runcount=0;
-	runcount++;
+	utility::vector1< PoseLeap > leaps;
+	bool const complete = compute_pose_leaps( pose, nres, leaps );
+	add_pose_leaps( index, leaps );
+	if ( !complete ) return;
+
+	reset_fold_tree( pose );
+}
+
+
+void
+LoopHashLibrary::reset_fold_tree( core::pose::Pose& pose ) const
+{
+	using namespace kinematics;
+
+	// reset the fold tree
+	FoldTree f;
+	f.add_edge( 1, pose.total_residue() , Edge::PEPTIDE );
+	if ( f.reorder(1) == false ) {
+		TR.Error << "ERROR During resetting reordering of fold tree - am ignoring this LOOP ! Cannot continue " << std::endl;
+		return; // continuing leads to a segfault - instead ignore this loop !
+	}
+	pose.fold_tree( f );
+}
+
+
+bool
+LoopHashLibrary::compute_pose_leaps( core::pose::Pose& pose, core::Size nres, utility::vector1< PoseLeap > & leaps ) const
+{
+	using namespace numeric::geometry::hashing;
 
 	for ( std::vector< core::Size >::const_iterator it = hash_sizes_.begin(); it != hash_sizes_.end(); ++it ) {
 		TR.Info << "Setting up hash: Size:  " << *it << std::endl;
 		Size loop_size = *it;
 
-		LoopHashMap &hashmap = gethash( loop_size );
 		if ( loop_size + 2 > nres ) continue;
-		for ( ir = 2; ir < ( nres - loop_size ); ir ++ ) {
+		for ( Size ir = 2; ir < ( nres - loop_size ); ir ++ ) {
+			PoseLeap leap;
+			leap.loop_size = loop_size;
+			leap.offset = (ir-1)*3;
+			if ( !get_rt_over_leap_fast( pose, ir, ir+loop_size, leap.transform ) ) return false;
+			leaps.push_back( leap );
+		}
+	}
+	return true;
+}
 
-			jr = ir+loop_size;
+void
+LoopHashLibrary::add_pose_leaps( core::Size index, utility::vector1< PoseLeap > const & leaps )
+{
+	static int runcount=0;
+	runcount++;
 
-			Real6 t;
-			if ( !get_rt_over_leap_fast( pose, ir, jr, t ) ) return;
-			LeapIndex leap_index;
-			leap_index.index  = index;
-			leap_index.offset = (ir-1)*3;
+	for ( core::Size i = 1; i <= leaps.size(); ++i ) {
+		numeric::geometry::hashing::Real6 t = leaps[i].transform;
+		LeapIndex leap_index;
+		leap_index.index  = index;
+		leap_index.offset = leaps[i].offset;
+
+		TR.Debug << "ADD: "
+			<< runcount << " "
+			<< leap_index.offset/3 + 1 << " "
+			<< leap_index.offset/3 + 1 + leaps[i].loop_size << " "
+			<< t[1] <<  " "
+			<< t[2] <<  " "
+			<< t[3] <<  " "
+			<< t[4] <<  " "
+			<< t[5] <<  " "
+			<< t[6] << " "
+			<< leap_index.index << " "
+			<< leap_index.offset;
+		TR.Debug << std::endl;
+		gethash( leaps[i].loop_size ).add_leap( leap_index, t );
+	}
+}
 
+void
+LoopHashLibrary::compute_chunk_leaps(
+	utility::vector1< core::pose::PoseOP > & poses,
+	utility::vector1< VallChunkOP > const & chunks,
+	utility::vector1< utility::vector1< PoseLeap > > & leaps,
+	core::Size i
+) const
+{
+	// a pose whose leaps could not all be determined keeps the ones found before and its fold tree,
+	// as in extract_data_from_pose
+	if ( !compute_pose_leaps( *poses[i], chunks[i]->size(), leaps[i] ) ) return;
 
-			TR.Debug << "ADD: "
-				<< runcount << " "
-				<< ir << " "
-				<< jr << " "
-				<< t[1] <<  " "
-				<< t[2] <<  " "
-				<< t[3] <<  " "
-				<< t[4] <<  " "
-				<< t[5] <<  " "
-				<< t[6] << " "
-				<< leap_index.index << " "
-				<< leap_index.offset;
-			TR.Debug << std::endl;
-			hashmap.add_leap( leap_index, t );
+	reset_fold_tree( *poses[i] );
+}
 
-			BackboneSegment pose_bs;
-			pose_bs.read_from_pose( pose, ir, loop_size );
-		}
-	}
+void
+LoopHashLibrary::extract_data_from_chunks(
+	utility::vector1< core::pose::PoseOP > & poses,
+	utility::vector1< VallChunkOP > const & chunks
+)
+{
+	utility::vector1< utility::vector1< PoseLeap > > leaps( poses.size() );
 
+	// every pose is handled by a single thread, so get_rt_over_leap_fast may change its fold tree
+	utility::thread::parallel_for( poses.size(), n_threads_, boost::bind( &LoopHashLibrary::compute_chunk_leaps, this,
+		boost::ref( poses ), boost::cref( chunks ), boost::ref( leaps ), _1 ) );
 
-	// reset the fold tree
-	FoldTree f;
-	f.add_edge( 1, pose.total_residue() , Edge::PEPTIDE );
-	if ( f.reorder(1) == false ) {
-		TR.Error << "ERROR During resetting reordering of fold tree - am ignoring this LOOP ! Cannot continue " << std::endl;
-		return; // continuing leads to a segfault - instead ignore this loop !
+	// add to the library in vall order
+	for ( core::Size i = 1; i <= poses.size(); ++i ) {
+		core::Size index;
+		bbdb_.add_pose( *poses[i], chunks[i]->size(), index, chunks[i] );
+		add_pose_leaps( index, leaps[i] );
 	}
-	pose.fold_tree( f );
-
 }
 
 
@@ -99,14 +99,15 @@ public:
 
 	const std::pair< core::Size, core::Size > loopdb_range() { return loopdb_range_; }
 
-	// Only support writing to text, always include extra data
+	// Writes text, always include extra data
+	// With -lh:sorted_db the hash maps are written in the compact sorted-key format instead
 	void save_db();
 
-	// Only support reading from text, extra data is mandatory
+	// Reads text (or sorted-key hash maps with -lh:sorted_db), extra data is mandatory
 	// used when created merged text db
 	void load_db();
 
-	// Only support reading from merged text
+	// Reads merged text (or sorted-key hash maps with -lh:sorted_db)
 	// Extra data is optional and handled by extra_
 	void load_mergeddb();
 
@@ -150,6 +151,40 @@ public:
 
 private:
 
+	/// @brief A leap found in a pose, before it is added to the hash map of its loop size
+	struct PoseLeap {
+		core::Size loop_size;
+		core::Size offset;
+		numeric::geometry::hashing::Real6 transform;
+	};
+
+	/// @brief File name of the hash map of one loop size (text or sorted-key, following -lh:sorted_db)
+	std::string loopdb_filename( core::Size loop_size, std::string const & assigned_string ) const;
+
+	/// @brief Find the leaps of every hash size in the first nres residues of pose; returns false if
+	/// a leap could not be determined, in which case leaps holds the ones found before it
+	bool compute_pose_leaps( core::pose::Pose & pose, core::Size nres, utility::vector1< PoseLeap > & leaps ) const;
+
+	/// @brief Give pose a simple fold tree again after its leaps have been found
+	void reset_fold_tree( core::pose::Pose & pose ) const;
+
+	/// @brief Add the leaps of the protein with the given backbone database index to the hash maps
+	void add_pose_leaps( core::Size index, utility::vector1< PoseLeap > const & leaps );
+
+	/// @brief Find the leaps of pose i of a batch, for utility::thread::parallel_for()
+	void compute_chunk_leaps(
+		utility::vector1< core::pose::PoseOP > & poses,
+		utility::vector1< protocols::frag_picker::VallChunkOP > const & chunks,
+		utility::vector1< utility::vector1< PoseLeap > > & leaps,
+		core::Size i
+	) const;
+
+	/// @brief Add a batch of vall chunk poses, finding their leaps on several threads
+	void extract_data_from_chunks(
+		utility::vector1< core::pose::PoseOP > & poses,
+		utility::vector1< protocols::frag_picker::VallChunkOP > const & chunks
+	);
+
 	// The backbone library for this HashLibrary (the actual data)
 	BackboneDB bbdb_;
 
@@ -181,6 +216,12 @@ private:
 	bool do_sanity_check_;
 	bool create_db_;
 
+	// Read and write the hash maps in the sorted-key format
+	bool sorted_db_;
+
+	// Threads used to build the library, 0 for the hardware concurrency
+	core::Size n_threads_;
+
 	// Used for grafting - ultimately to move into a separate Mover class.
 
 	core::scoring::ScoreFunctionOP scorefxn_rama_cst;
@@ -58,6 +58,16 @@
 #include <ctime>
 #endif
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
 
 using namespace protocols::moves;
 using namespace core::scoring;
@@ -74,6 +84,64 @@ namespace loophash {
 
 static THREAD_LOCAL basic::Tracer TR( "LoopHashMap" );
 
+/// @brief Magic header of the sorted-key loop database; followed by the loop size and record count (uint64 each)
+static char const SORTED_DB_MAGIC[ 8 ] = { 'L', 'H', 'S', 'O', 'R', 'T', '0', '1' };
+static core::Size const SORTED_DB_HEADER_SIZE = 8 + 2 * sizeof( boost::uint64_t );
+
+struct SortedLeapRecordKeyLess {
+	bool operator()( SortedLeapRecord const & a, SortedLeapRecord const & b ) const { return a.key < b.key; }
+	bool operator()( SortedLeapRecord const & a, boost::uint64_t key ) const { return a.key < key; }
+	bool operator()( boost::uint64_t key, SortedLeapRecord const & b ) const { return key < b.key; }
+};
+
+struct SortedLeapRecordLess {
+	bool operator()( SortedLeapRecord const & a, SortedLeapRecord const & b ) const {
+		if ( a.key != b.key ) return a.key < b.key;
+		if ( a.index != b.index ) return a.index < b.index;
+		return a.offset < b.offset;
+	}
+};
+
+/// @brief Records of a sorted-key database, either owned or living in a read-only memory mapping of the file
+class SortedLeapStore {
+public:
+	/// @brief Take ownership of records (which must already be sorted by key)
+	SortedLeapStore( std::vector< SortedLeapRecord > & records ) :
+		mapping_( 0 ), mapping_size_( 0 ), records_( 0 ), n_records_( 0 )
+	{
+		owned_.swap( records );
+		records_ = owned_.empty() ? 0 : &owned_[ 0 ];
+		n_records_ = owned_.size();
+	}
+
+	/// @brief Use records that live inside a memory mapping; the mapping is released on destruction
+	SortedLeapStore( void * mapping, core::Size mapping_size, SortedLeapRecord const * records, core::Size n_records ) :
+		mapping_( mapping ), mapping_size_( mapping_size ), records_( records ), n_records_( n_records )
+	{}
+
+	~SortedLeapStore() {
+#ifndef WIN32
+		if ( mapping_ ) munmap( mapping_, mapping_size_ );
+#endif
+	}
+
+	SortedLeapRecord const * begin() const { return records_; }
+	SortedLeapRecord const * end() const { return records_ + n_records_; }
+	core::Size size() const { return n_records_; }
+	SortedLeapRecord const & operator[]( core::Size i ) const { return records_[ i ]; }
+	bool is_mapped() const { return mapping_ != 0; }
+
+private:
+	SortedLeapStore( SortedLeapStore const & );
+	SortedLeapStore & operator=( SortedLeapStore const & );
+
+	std::vector< SortedLeapRecord > owned_;
+	void * mapping_;
+	core::Size mapping_size_;
+	SortedLeapRecord const * records_;
+	core::Size n_records_;
+};
+
 
 /// @brief This takes a pose and two residue positions and determines the rigid body transform of the Leap described by those two residues.
 ///        Returns true is successful or false if something went haywire and one should just ignore this loop (this can happen at the ends)
@@ -353,8 +421,8 @@ LoopHashMap::LoopHashMap(LoopHashMap const & other ) :
 	hash_(other.hash_),
 	backbone_index_map_(other.backbone_index_map_),
 	loopdb_(other.loopdb_),
-	loop_size_(other.loop_size_)
-
+	loop_size_(other.loop_size_),
+	sorted_store_(other.sorted_store_)
 { }
 
 LoopHashMap & LoopHashMap::operator=(LoopHashMap const & other)
@@ -364,20 +432,75 @@ LoopHashMap & LoopHashMap::operator=(LoopHashMap const & other)
 		backbone_index_map_ = other.backbone_index_map_;
 		loopdb_ = other.loopdb_;
 		loop_size_ = other.loop_size_;
+		sorted_store_ = other.sorted_store_;
 	}
 	return *this;
 
 }
 
 void LoopHashMap::mem_foot_print(){
+	if ( sorted_store_ ) {
+		TR << "SortedLeapStore: " << sorted_store_->size() << " Size: " << sorted_store_->size() * sizeof( SortedLeapRecord )
+			<< ( sorted_store_->is_mapped() ? " (memory mapped, shared)" : "" ) << std::endl;
+		return;
+	}
 	TR << "loopdb_: " << loopdb_.size() << " Size: " << loopdb_.size() * sizeof( LeapIndex ) << std::endl;
 	TR << "BackboneIndexMap: " << backbone_index_map_.size() << " Size: " << backbone_index_map_.size() * (sizeof(boost::uint64_t) + sizeof(core::Size) ) << std::endl;
 }
 
 void LoopHashMap::sort() {
+	require_mutable( "sort" );
 	std::sort( loopdb_.begin(), loopdb_.end(), by_index() );
 }
 
+LeapIndex LoopHashMap::get_peptide( core::Size index ) const {
+	if ( sorted_store_ ) {
+		runtime_assert( index < sorted_store_->size() );
+		SortedLeapRecord const & record( (*sorted_store_)[ index ] );
+		LeapIndex leap_index;
+		leap_index.index = record.index;
+		leap_index.offset = record.offset;
+		leap_index.key = record.key;
+		return leap_index;
+	}
+	runtime_assert( index < loopdb_.size() );
+	return loopdb_[ index ];
+}
+
+core::Size LoopHashMap::n_loops() const {
+	return sorted_store_ ? sorted_store_->size() : loopdb_.size();
+}
+
+void LoopHashMap::require_mutable( std::string const & action ) const {
+	if ( sorted_store_ ) {
+		utility_exit_with_message( "LoopHashMap: cannot " + action + " a read-only sorted-key loop database" );
+	}
+}
+
+void LoopHashMap::append_bucket( boost::uint64_t key, std::vector < core::Size > &result ) const {
+	if ( sorted_store_ ) {
+		std::pair< SortedLeapRecord const *, SortedLeapRecord const * > range =
+			std::equal_range( sorted_store_->begin(), sorted_store_->end(), key, SortedLeapRecordKeyLess() );
+		for ( SortedLeapRecord const * it = range.first; it != range.second; ++it ) {
+			result.push_back( it - sorted_store_->begin() );
+		}
+		return;
+	}
+	std::pair< BackboneIndexMap::const_iterator, BackboneIndexMap::const_iterator > range = backbone_index_map_.equal_range( key );
+	for ( BackboneIndexMap::const_iterator it = range.first; it != range.second; ++it ) {
+		result.push_back( it->second );
+	}
+}
+
+core::Size LoopHashMap::bucket_size( boost::uint64_t key ) const {
+	if ( sorted_store_ ) {
+		std::pair< SortedLeapRecord const *, SortedLeapRecord const * > range =
+			std::equal_range( sorted_store_->begin(), sorted_store_->end(), key, SortedLeapRecordKeyLess() );
+		return range.second - range.first;
+	}
+	return backbone_index_map_.count( key );
+}
+
 void
 LoopHashMap::setup( core::Size loop_size)
 {
@@ -448,6 +571,7 @@ LoopHashMap::add_legacyleap( const LegacyLeapIndex & legacyleap_index)
 }
 
 void LoopHashMap::add_leap( const LeapIndex &leap_index, boost::uint64_t key ) {
+	require_mutable( "add leaps to" );
 	core::Size cpindex = loopdb_.size();
 	loopdb_.push_back( leap_index );
 	// No check to see if it is in hash because this data is already processed
@@ -455,6 +579,7 @@ void LoopHashMap::add_leap( const LeapIndex &leap_index, boost::uint64_t key ) {
 }
 
 void LoopHashMap::add_leap( const LeapIndex &leap_index, numeric::geometry::hashing::Real6 & transform ){
+	require_mutable( "add leaps to" );
 	core::Size cpindex = loopdb_.size();
 	loopdb_.push_back( leap_index );
 	numeric::geometry::hashing::Real6 rt_6;
@@ -492,6 +617,7 @@ void LoopHashMap::hash_index( numeric::geometry::hashing::Real6 transform, core:
 
 
 void LoopHashMap::bbdb_range( std::pair< BackboneIndexMap::iterator, BackboneIndexMap::iterator > & range ){
+	require_mutable( "iterate the hash map of" );
 	range.first = backbone_index_map_.begin();
 	range.second = backbone_index_map_.end();
 }
@@ -512,21 +638,12 @@ LoopHashMap::lookup(  numeric::geometry::hashing::Real6 transform, std::vector <
 
 	// now get an iterator over that map entry
 
-	TR.Info << "backbone bucket size:  " << backbone_index_map_.bucket_count() << std::endl;
-	TR.Info << "backbone_index_map_.find(bin_index):  " << backbone_index_map_.count(bin_index) << std::endl;
-	std::pair<  BackboneIndexMap::iterator,
-		BackboneIndexMap::iterator> range = backbone_index_map_.equal_range( bin_index );
-
-	for ( BackboneIndexMap::iterator it = range.first;
-			it != range.second;
-			++it ) {
-		TR.Info << it->second << std::endl;
-		TR.Info << "bucket_size:  " << result.size() << std::endl;
-		result.push_back( it->second );
-	}
+	TR.Info << "backbone_index_map_.find(bin_index):  " << bucket_size(bin_index) << std::endl;
+	append_bucket( bin_index, result );
+	TR.Info << "bucket_size:  " << result.size() << std::endl;
 }
 
-void LoopHashMap::radial_lookup( core::Size radius,  numeric::geometry::hashing::Real6 center, std::vector < core::Size > &result )
+void LoopHashMap::radial_lookup( core::Size radius,  numeric::geometry::hashing::Real6 center, std::vector < core::Size > &result ) const
 {
 
 	center[4] = numeric::nonnegative_principal_angle_degrees(center[4] );
@@ -536,12 +653,7 @@ void LoopHashMap::radial_lookup( core::Size radius,  numeric::geometry::hashing:
 
 	for ( core::Size i = 0; i < bin_index_vec.size(); ++i ) {
 		//TR.Info << "bin_index_vec[i]:  " << bin_index_vec[i] << std::endl;
-		// now get an iterator over that map entry
-		std::pair< BackboneIndexMap::iterator,BackboneIndexMap::iterator> range = backbone_index_map_.equal_range( bin_index_vec[i] );
-		for ( BackboneIndexMap::iterator it = range.first; it != range.second; ++it ) {
-			//TR.Info << "result:  " << result << std::endl;
-			result.push_back( it->second );
-		}
+		append_bucket( bin_index_vec[i], result );
 	}
 }
 
@@ -552,7 +664,7 @@ Size LoopHashMap::radial_count( core::Size radius, numeric::geometry::hashing::R
 	std::vector< boost::uint64_t > bin_index_vec = hash_->radial_bin_index( radius, center );
 	Size count = 0;
 	for ( core::Size i = 0; i < bin_index_vec.size(); ++i ) {
-		count += backbone_index_map_.count( bin_index_vec[i] );
+		count += bucket_size( bin_index_vec[i] );
 	}
 	return count;
 }
@@ -563,6 +675,7 @@ LoopHashMap::lookup(
 	std::vector < core::Size > &result
 )
 {
+	require_mutable( "look up a hash bucket of" );
 	if ( index > backbone_index_map_.bucket_count() ) {
 		//TR.Error << "OutofBOIUNDS! " << std::endl;
 		return;
@@ -577,14 +690,14 @@ LoopHashMap::lookup(
 }
 
 boost::uint64_t
-LoopHashMap::return_key( core::Size bb_index )
+LoopHashMap::return_key( core::Size bb_index ) const
 {
 	LeapIndex leap_index = get_peptide( bb_index );
 	return leap_index.key;
 }
 
 void
-LoopHashMap::radial_lookup_withkey( boost::uint64_t key, core::Size radius, std::vector < core::Size > &result )
+LoopHashMap::radial_lookup_withkey( boost::uint64_t key, core::Size radius, std::vector < core::Size > &result ) const
 {
 	// get center of bin from key
 	numeric::geometry::hashing::Real6 center = hash_->bin_center_point( hash_->bin_from_index( key ) );
@@ -592,19 +705,14 @@ LoopHashMap::radial_lookup_withkey( boost::uint64_t key, core::Size radius, std:
 }
 
 void
-LoopHashMap::lookup_withkey( boost::uint64_t key, std::vector < core::Size > &result )
+LoopHashMap::lookup_withkey( boost::uint64_t key, std::vector < core::Size > &result ) const
 {
-	std::pair<  BackboneIndexMap::iterator,
-		BackboneIndexMap::iterator> range = backbone_index_map_.equal_range( key );
-
-	for ( BackboneIndexMap::iterator it = range.first; it != range.second; ++it ) {
-		result.push_back( it->second );
-	}
-	return;
+	append_bucket( key, result );
 }
 
 void LoopHashMap::read_legacydb(std::string filename )
 {
+	require_mutable( "read a legacy database into" );
 	// use basic C input - C++ are too memory hungry to deal with these potentially v large files
 	FILE *file = fopen( filename.c_str(), "r" );
 	if ( file == NULL ) throw EXCN_DB_IO_Failed( filename, "read" );
@@ -626,6 +734,7 @@ void LoopHashMap::read_legacydb(std::string filename )
 }
 
 void LoopHashMap::write_db( std::string filename ){
+	require_mutable( "write the text format of" );
 	std::ofstream file( filename.c_str() );
 	if ( !file ) throw EXCN_DB_IO_Failed( filename, "write" );
 	for ( core::Size i = 0; i < loopdb_.size(); i++ ) {
@@ -639,6 +748,7 @@ LoopHashMap::read_db(
 	std::string filename, std::pair< core::Size, core::Size > loopdb_range,
 	std::map< core::Size, bool > & homolog_index
 ){
+	require_mutable( "read a text database into" );
 	std::ifstream file( filename.c_str() );
 	if ( !file ) throw EXCN_DB_IO_Failed( filename, "read" );
 	std::string line;
@@ -664,6 +774,126 @@ LoopHashMap::read_db(
 	file.close();
 }
 
+void
+LoopHashMap::write_sorted_db( std::string const & filename ) const
+{
+	std::vector< SortedLeapRecord > records;
+	if ( sorted_store_ ) {
+		records.assign( sorted_store_->begin(), sorted_store_->end() );
+	} else {
+		// only leaps that made it into the hash (out-of-bounds leaps have no key)
+		records.reserve( backbone_index_map_.size() );
+		for ( BackboneIndexMap::const_iterator it = backbone_index_map_.begin(); it != backbone_index_map_.end(); ++it ) {
+			LeapIndex const & leap_index( loopdb_[ it->second ] );
+			if ( leap_index.index > 0xFFFFFFFFu || leap_index.offset > 0xFFFFFFFFu ) {
+				throw EXCN_DB_IO_Failed( filename, "write (leap index does not fit the sorted format)" );
+			}
+			SortedLeapRecord record;
+			record.key = it->first;
+			record.index = static_cast< boost::uint32_t >( leap_index.index );
+			record.offset = static_cast< boost::uint32_t >( leap_index.offset );
+			records.push_back( record );
+		}
+		std::sort( records.begin(), records.end(), SortedLeapRecordLess() );
+	}
+
+	FILE *file = fopen( filename.c_str(), "wb" );
+	if ( file == NULL ) throw EXCN_DB_IO_Failed( filename, "write" );
+	boost::uint64_t const header[ 2 ] = { loop_size_, records.size() };
+	bool ok = fwrite( SORTED_DB_MAGIC, 1, sizeof( SORTED_DB_MAGIC ), file ) == sizeof( SORTED_DB_MAGIC );
+	ok = ok && fwrite( header, sizeof( boost::uint64_t ), 2, file ) == 2;
+	if ( ok && ! records.empty() ) {
+		ok = fwrite( &records[ 0 ], sizeof( SortedLeapRecord ), records.size(), file ) == records.size();
+	}
+	if ( fclose( file ) != 0 ) ok = false;
+	if ( ! ok ) throw EXCN_DB_IO_Failed( filename, "write" );
+	TR.Info << "Wrote " << records.size() << " sorted leaps of loop size " << loop_size_ << " to " << filename << std::endl;
+}
+
+void
+LoopHashMap::read_sorted_db(
+	std::string const & filename,
+	std::pair< core::Size, core::Size > loopdb_range,
+	std::map< core::Size, bool > const & homolog_index
+)
+{
+	FILE *file = fopen( filename.c_str(), "rb" );
+	if ( file == NULL ) throw EXCN_DB_IO_Failed( filename, "read" );
+
+	char magic[ sizeof( SORTED_DB_MAGIC ) ];
+	boost::uint64_t header[ 2 ];
+	if ( fread( magic, 1, sizeof( magic ), file ) != sizeof( magic ) ||
+			std::memcmp( magic, SORTED_DB_MAGIC, sizeof( magic ) ) != 0 ||
+			fread( header, sizeof( boost::uint64_t ), 2, file ) != 2 ) {
+		fclose( file );
+		throw EXCN_Wrong_DB_Format( filename );
+	}
+	if ( header[ 0 ] != loop_size_ ) {
+		fclose( file );
+		throw EXCN_Wrong_DB_Format( filename + " (loop size " + utility::to_string( header[ 0 ] ) + ", expected " + utility::to_string( loop_size_ ) + ")" );
+	}
+	core::Size const n_records = header[ 1 ];
+
+	bool const whole_file = loopdb_range.first == 0 && loopdb_range.second == 0 && homolog_index.empty();
+	SortedLeapStoreCOP store;
+
+#ifndef WIN32
+	if ( whole_file && n_records > 0 ) {
+		core::Size const mapping_size = SORTED_DB_HEADER_SIZE + n_records * sizeof( SortedLeapRecord );
+		struct stat file_stat;
+		if ( fstat( fileno( file ), &file_stat ) != 0 || (core::Size) file_stat.st_size < mapping_size ) {
+			fclose( file );
+			throw EXCN_Wrong_DB_Format( filename );
+		}
+		void * mapping = mmap( 0, mapping_size, PROT_READ, MAP_SHARED, fileno( file ), 0 );
+		if ( mapping != MAP_FAILED ) {
+			SortedLeapRecord const * records = reinterpret_cast< SortedLeapRecord const * >(
+				static_cast< char const * >( mapping ) + SORTED_DB_HEADER_SIZE );
+			store = SortedLeapStoreCOP( new SortedLeapStore( mapping, mapping_size, records, n_records ) );
+		} else {
+			TR.Warning << "Could not memory map " << filename << "; reading it into memory instead" << std::endl;
+		}
+	}
+#endif
+
+	if ( ! store ) {
+		std::vector< SortedLeapRecord > records;
+		records.reserve( whole_file ? n_records : 0 );
+		const unsigned int bufsize = 4096;
+		SortedLeapRecord bufferdata[ bufsize ];
+		core::Size remaining = n_records;
+		while ( remaining > 0 ) {
+			core::Size const nread = fread( bufferdata, sizeof( SortedLeapRecord ), std::min( remaining, (core::Size) bufsize ), file );
+			if ( nread == 0 ) {
+				fclose( file );
+				throw EXCN_Wrong_DB_Format( filename );
+			}
+			remaining -= nread;
+			for ( core::Size i = 0; i < nread; ++i ) {
+				SortedLeapRecord record = bufferdata[ i ];
+				if ( record.index < loopdb_range.first ) continue;
+				if ( record.index >= loopdb_range.second && loopdb_range.second != 0 ) continue;
+				// Since we're reading in partitions of the bbdb
+				// We also have to offset where the leap_index.index points
+				record.index -= loopdb_range.first;
+				if ( homolog_index.find( record.index ) != homolog_index.end() ) continue;
+				records.push_back( record );
+			}
+		}
+		store = SortedLeapStoreCOP( new SortedLeapStore( records ) );
+	}
+	fclose( file );
+
+	// the sorted records replace the hash map entirely
+	loopdb_.clear();
+	std::vector< LeapIndex >().swap( loopdb_ );
+	BackboneIndexMap().swap( backbone_index_map_ );
+	sorted_store_ = store;
+
+	TR.Info << "Read " << sorted_store_->size() << " of " << n_records << " sorted leaps of loop size " << loop_size_
+		<< " from " << filename << ( sorted_store_->is_mapped() ? " (memory mapped)" : "" ) << std::endl;
+}
+
 
 } // namespace loops
 } // namespace protocols
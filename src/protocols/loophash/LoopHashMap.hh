@@ -20,6 +20,7 @@
 //#include <protocols/match/Hit.fwd.hh>
 //#include <protocols/match/SixDHasher.hh>
 #include <boost/unordered_map.hpp>
+#include <boost/cstdint.hpp>
 #include <utility/pointer/ReferenceCount.hh>
 #include <protocols/loophash/BackboneDB.hh>
 
@@ -31,6 +32,7 @@
 
 #include <utility/exit.hh>
 #include <utility/vector1.hh>
+#include <utility/pointer/owning_ptr.hh>
 
 namespace protocols {
 namespace loophash {
@@ -80,7 +82,23 @@ struct LegacyLeapIndex{
 	unsigned int ba;
 };
 
+/// @brief On-disk (and in-memory) record of the sorted-key loop database format. Records are stored sorted by
+/// key so that a bucket is a contiguous range found by binary search; no hash map needs to be built on load.
+/// 16 bytes per leap, versus a LeapIndex plus a BackboneIndexMap node for the text format.
+struct SortedLeapRecord{
+	boost::uint64_t key;
+	boost::uint32_t index;
+	boost::uint32_t offset;
+};
+
+/// @brief Read-only storage for a sorted-key loop database. When the whole file is used it is memory mapped,
+/// so all processes (and all threads and LoopHashMap copies) on a node share one copy through the page cache.
+class SortedLeapStore;
+typedef utility::pointer::shared_ptr< SortedLeapStore const > SortedLeapStoreCOP;
+
 /// @brief the loop hash map stores LeapIndexes and a hashmap to access those LeapIndexes quickly by their 6D coordinates.
+/// A map read with read_sorted_db() instead holds a read-only SortedLeapStore and looks up buckets by binary search;
+/// such a map cannot have leaps added to it.
 
 
 class LoopHashMap{
@@ -110,28 +128,23 @@ public:
 	void add_legacyleap( const LegacyLeapIndex &legacyleap_index );
 
 	/// @brief Obtain an index to a given peptide saved
-	inline const LeapIndex & get_peptide( core::Size index ){
-		runtime_assert( index < loopdb_.size() );
-		return loopdb_[ index ];
-	}
+	LeapIndex get_peptide( core::Size index ) const;
 
-	inline core::Size n_loops() const {
-		return loopdb_.size();
-	}
+	core::Size n_loops() const;
 
 	/// @brief Return a vector of loops with equal keys  given a key
 	//  And any keys within a radius around the original key
-	void radial_lookup_withkey( boost::uint64_t key, core::Size radius, std::vector < core::Size > &result );
+	void radial_lookup_withkey( boost::uint64_t key, core::Size radius, std::vector < core::Size > &result ) const;
 
 	/// @brief Return a vector of loops with equal keys  given a key
 	//  Identical to radial_lookup_withkey(radius=0), but faster
-	void lookup_withkey( boost::uint64_t key, std::vector < core::Size > &result );
+	void lookup_withkey( boost::uint64_t key, std::vector < core::Size > &result ) const;
 
 	/// @brief Append to a bucket of vectors in the appropriate bin, lookup by transform
 	void lookup(  numeric::geometry::hashing::Real6 transform, std::vector < core::Size > &result );
 
 	/// @brief Append to a bucket of vectors in the appropriate bin, radial lookup by transform
-	void radial_lookup( core::Size radius,  numeric::geometry::hashing::Real6 transform, std::vector < core::Size > &result );
+	void radial_lookup( core::Size radius,  numeric::geometry::hashing::Real6 transform, std::vector < core::Size > &result ) const;
 
 	/// @brief count hits in the appropriate bin, radial lookup by transform
 	core::Size radial_count( core::Size radius, numeric::geometry::hashing::Real6 center ) const;
@@ -145,7 +158,7 @@ public:
 
 	/// @brief Returns a hashmap key given a member of a bucket
 	/// Don't think boost implements this, have to manually look it up
-	boost::uint64_t return_key( core::Size bb_index );
+	boost::uint64_t return_key( core::Size bb_index ) const;
 
 	/// @brief Query the loopsize of this LoopHashMap
 	inline core::Size get_loop_size() const { return loop_size_; }
@@ -166,12 +179,37 @@ public:
 		read_db( filename, range, homolog_index );
 	}
 
+	/// @brief Write the compact binary sorted-key format (see SortedLeapRecord)
+	void write_sorted_db( std::string const & filename ) const;
+
+	/// @brief Read the compact binary sorted-key format. With the default (0,0) range and no homologs
+	/// the file is memory mapped and shared; otherwise the selected records are copied (still sorted).
+	void read_sorted_db( std::string const & filename, std::pair< core::Size, core::Size > loopdb_range,
+		std::map< core::Size, bool > const & homolog_index );
+
+	inline void read_sorted_db( std::string const & filename ) {
+		read_sorted_db( filename, std::pair< core::Size, core::Size >( 0, 0 ), std::map< core::Size, bool >() );
+	}
+
+	/// @brief Was this map loaded from a sorted-key database (and therefore read-only)?
+	inline bool is_sorted_db() const { return sorted_store_ != 0; }
+
 	/// @brief Return the memory usage of this class
 	void mem_foot_print();
 
 	/// @brief Sorts the loopdb_ by leap_index.index
 	void sort();
 
+private:
+	/// @brief Append all loops with exactly this key to result
+	void append_bucket( boost::uint64_t key, std::vector < core::Size > &result ) const;
+
+	/// @brief Number of loops with exactly this key
+	core::Size bucket_size( boost::uint64_t key ) const;
+
+	/// @brief Die if this map is a read-only sorted-key database
+	void require_mutable( std::string const & action ) const;
+
 private:  // Private data
 
 	/// @brief  A class that will take a 6D rigid body transform and turn it into a serial hashbin
@@ -187,6 +225,9 @@ private:  // Private data
 	/// @brief The length of the the loops in number of residues
 	core::Size                                loop_size_;
 
+	/// @brief Sorted-key records, replacing backbone_index_map_ and loopdb_ when set
+	SortedLeapStoreCOP                        sorted_store_;
+
 	/// @brief A functor for sort()
 	struct by_index {
 		bool operator()( LeapIndex const &a, LeapIndex const &b ) const {
@@ -28,6 +28,7 @@
 #include <basic/options/option.hh>
 #include <basic/options/keys/lh.OptionKeys.gen.hh>
 
+#include <utility/thread/parallel_for.hh>
 #include <utility/vector1.hh>
 
 #include <numeric/random/random.hh>
@@ -59,6 +60,7 @@ LoopHashSampler::LoopHashSampler(
 	max_struct_ (10),
 	max_struct_per_radius_ (10),
 	nonideal_ ( false ),
+	n_threads_ ( 1 ),
 	nprefilter_ ( 0 ) // OBSOLETE?
 {
 	set_defaults();
@@ -82,6 +84,46 @@ LoopHashSampler::set_defaults(){
 	set_max_nstruct( 10000000 ); // OBSOLETE?
 
 	filter_by_phipsi_ = option[ lh::filter_by_phipsi ]();
+	n_threads_ = option[ lh::threads ]();
+}
+
+namespace {
+
+/// @brief computes the transform of one position, for utility::thread::parallel_for(); every thread
+/// works on its own copy of the pose, which get_rt_over_leap copies again
+struct PositionTransform {
+	PositionTransform(
+		utility::vector1< core::pose::Pose > & poses_in,
+		utility::vector1< LoopHashPosition > & positions_in
+	) :
+		poses( poses_in ),
+		positions( positions_in )
+	{}
+
+	void
+	operator() ( core::Size ii, core::Size thread ) const
+	{
+		LoopHashPosition & position( positions[ ii ] );
+		position.valid = get_rt_over_leap( poses[ thread ], position.ir, position.ir + position.loop_size, position.transform );
+	}
+
+	utility::vector1< core::pose::Pose > & poses;
+	utility::vector1< LoopHashPosition > & positions;
+};
+
+}
+
+void
+LoopHashSampler::compute_transforms(
+	const core::pose::Pose& pose,
+	utility::vector1< LoopHashPosition > & positions
+) const
+{
+	core::Size const n_threads = utility::thread::parallel_thread_count( positions.size(), n_threads_ );
+	utility::vector1< core::pose::Pose > poses( n_threads, pose );
+	utility::thread::parallel_for( positions.size(), n_threads, PositionTransform( poses, positions ) );
+
+	TR.Debug << "Computed the transforms of " << positions.size() << " loop positions on " << n_threads << " thread(s)" << std::endl;
 }
 
 bool cmp( core::pose::Pose a, core::pose::Pose b) {
@@ -172,6 +214,84 @@ struct FilterBucket {
 	bool filter_gly;
 };
 
+namespace {
+
+/// @brief the result of checking one fragment from a radial lookup against the segment it would replace
+struct FragmentCheck {
+	FragmentCheck() : bbrms_ok( false ), is_valid( false ) {}
+
+	/// @brief is the backbone rms within the limits?  If not, bucket is not filled in
+	bool bbrms_ok;
+	bool is_valid;
+	FilterBucket bucket;
+};
+
+/// @brief checks a block of the fragments of one radial lookup, for utility::thread::parallel_for().
+/// Only the library is read, so the fragments can be checked concurrently.
+struct FragmentChecker {
+	FragmentChecker(
+		LoopHashLibrary const & library_in,
+		LoopHashMap const & hashmap_in,
+		BackboneSegment const & pose_bs_in,
+		std::string const & sequence_in,
+		core::Size ir_in,
+		core::Real min_bbrms_in,
+		core::Real max_bbrms_in,
+		std::vector < core::Size > const & leap_index_bucket_in,
+		core::Size block_begin_in,
+		std::vector < FragmentCheck > & checks_in
+	) :
+		library( library_in ),
+		hashmap( hashmap_in ),
+		pose_bs( pose_bs_in ),
+		sequence( sequence_in ),
+		ir( ir_in ),
+		min_bbrms( min_bbrms_in ),
+		max_bbrms( max_bbrms_in ),
+		leap_index_bucket( leap_index_bucket_in ),
+		block_begin( block_begin_in ),
+		checks( checks_in )
+	{}
+
+	void
+	operator() ( core::Size ii, core::Size ) const
+	{
+		FragmentCheck & check( checks[ ii - 1 ] );
+
+		// Get the actual strucure index (not just the bin index)
+		core::Size retrieve_index = leap_index_bucket[ block_begin + ii - 1 ];
+		LeapIndex cp = hashmap.get_peptide( retrieve_index );
+
+		// Retrieve the actual backbone structure
+		BackboneSegment new_bs;
+		library.backbone_database().get_backbone_segment( cp.index, cp.offset, hashmap.get_loop_size() , new_bs );
+
+		core::Real BBrms = get_rmsd( pose_bs, new_bs );
+		if ( ( BBrms < min_bbrms) || ( BBrms > max_bbrms ) ) return;
+		check.bbrms_ok = true;
+
+		check.bucket.retrieve_index = retrieve_index;  // save the bucket index for the next step later
+		check.bucket.BBrms = BBrms;         // also save the back bone RMS for later analysis & stats
+
+		check.is_valid =
+			is_valid_backbone( sequence, ir, new_bs.phi(), new_bs.psi(),    // input is sequence, current position in sequence, and the phi/psi's of the proposed angles.
+			check.bucket.filter_pro, check.bucket.filter_beta, check.bucket.filter_gly );  // output is a bunch of booleans giving information about any clashes.
+	}
+
+	LoopHashLibrary const & library;
+	LoopHashMap const & hashmap;
+	BackboneSegment const & pose_bs;
+	std::string const & sequence;
+	core::Size ir;
+	core::Real min_bbrms;
+	core::Real max_bbrms;
+	std::vector < core::Size > const & leap_index_bucket;
+	core::Size block_begin;
+	std::vector < FragmentCheck > & checks;
+};
+
+}
+
 // @brief create a set of structures for a the given range of residues and other parameters
 void
 LoopHashSampler::build_structures(
@@ -233,6 +353,21 @@ LoopHashSampler::build_structures(
 	if ( start_res > stop_res ) stop_res = start_res;
 
 	TR << "Running: Start:" << start_res << "  End: " << stop_res << std::endl;
+
+	// The rigid body transforms of all segments are computed at once, in the order they are used below
+	utility::vector1< LoopHashPosition > positions;
+	for ( ir = start_res; ir <= stop_res; ir ++ ) {
+		for ( core::Size k = 0; k < library_->hash_sizes().size(); k ++ ) {
+			core::Size loop_size = library_->hash_sizes()[ k ];
+			jr = ir + loop_size;
+			if ( ir > nres ) continue;
+			if ( jr > nres ) continue;
+			positions.push_back( LoopHashPosition( ir, loop_size ) );
+		}
+	}
+	compute_transforms( original_pose, positions );
+
+	core::Size ipos = 0;
 	for ( ir = start_res; ir <= stop_res; ir ++ ) {
 
 		// Loop over loopsizes in library
@@ -242,12 +377,13 @@ LoopHashSampler::build_structures(
 			jr = ir + loop_size;
 			if ( ir > nres ) continue;
 			if ( jr > nres ) continue;
+			LoopHashPosition const & position( positions[ ++ipos ] );
 
 			// get the rigid body transform for the current segment
 			BackboneSegment pose_bs;
 			pose_bs.read_from_pose( start_pose, ir, loop_size );
-			Real6 loop_transform;
-			if ( !get_rt_over_leap( original_pose, ir, jr, loop_transform ) ) continue;
+			if ( !position.valid ) continue;
+			Real6 const & loop_transform( position.transform );
 
 			LoopHashMap &hashmap = library_->gethash( loop_size );
 
@@ -272,50 +408,44 @@ LoopHashSampler::build_structures(
 				if ( leap_index_bucket.size() == 0 )  continue;                           // no fragments found
 
 				// Now for every hit, get the internal coordinates and make a short list of replacement loops
-				// according to the RMS criteria
-				for (  std::vector < core::Size >::const_iterator it = leap_index_bucket.begin();
-						it != leap_index_bucket.end();
-						++it ) {
-
-					// Get the actual strucure index (not just the bin index)
-					core::Size retrieve_index = (core::Size) (*it);
-					LeapIndex cp = hashmap.get_peptide( retrieve_index );
-
-					// Retrieve the actual backbone structure
-					BackboneSegment new_bs;
-					library_->backbone_database().get_backbone_segment( cp.index, cp.offset, hashmap.get_loop_size() , new_bs );
-
-					// Check the values against against any RMS limitations
-					// if violated then skip rest of loop
-					core::Real BBrms = get_rmsd( pose_bs, new_bs );
-					if ( ( BBrms < min_bbrms_) || ( BBrms > max_bbrms_ ) ) {
-						count_rejected_bbrms ++;
-						continue;
-					}
-
-
-					FilterBucket bucket;
-					bucket.retrieve_index = *it;  // save the bucket index for the next step later
-					bucket.BBrms = BBrms;         // also save the back bone RMS for later analysis & stats
+				// according to the RMS criteria.  The hits are checked on several threads a block at a time,
+				// and the results counted in lookup order, so the short list is the same as checking one by one.
+				core::Size const block_size = 64 * utility::thread::parallel_thread_count( leap_index_bucket.size(), n_threads_ );
+				bool fragment_limit_reached = false;
+				for ( core::Size block_begin = 0; block_begin < leap_index_bucket.size() && !fragment_limit_reached; block_begin += block_size ) {
+					std::vector < FragmentCheck > checks( std::min( block_size, leap_index_bucket.size() - block_begin ) );
+					utility::thread::parallel_for( checks.size(), n_threads_, FragmentChecker( *library_, hashmap, pose_bs,
+						sequence, ir, min_bbrms_, max_bbrms_, leap_index_bucket, block_begin, checks ) );
+
+					for (  std::vector < FragmentCheck >::const_iterator it = checks.begin();
+							it != checks.end();
+							++it ) {
+
+						// Check the values against against any RMS limitations
+						// if violated then skip rest of loop
+						if ( !it->bbrms_ok ) {
+							count_rejected_bbrms ++;
+							continue;
+						}
 
-					bool is_valid =
-						is_valid_backbone( sequence, ir, new_bs.phi(), new_bs.psi(),    // input is sequence, current position in sequence, and the phi/psi's of the proposed angles.
-						bucket.filter_pro, bucket.filter_beta, bucket.filter_gly );  // output is a bunch of booleans giving information about any clashes.
+						// count rejection stats
+						if ( it->bucket.filter_pro )  count_filter_pro ++;
+						if ( it->bucket.filter_beta ) count_filter_beta ++;
+						if ( it->bucket.filter_gly )  count_filter_gly ++;
 
-					// count rejection stats
-					if ( bucket.filter_pro )  count_filter_pro ++;
-					if ( bucket.filter_beta ) count_filter_beta ++;
-					if ( bucket.filter_gly )  count_filter_gly ++;
+						if ( (!get_filter_by_phipsi()) || it->is_valid ) { // should we filter at all and if so is it valid.
+							filter_leap_index_bucket.push_back( it->bucket ); // add to our short list of good fragments
+						} else {
+							count_filter_rejects++;            // or increment reject counter
+						}
 
-					if ( (!get_filter_by_phipsi()) || is_valid ) { // should we filter at all and if so is it valid.
-						filter_leap_index_bucket.push_back( bucket ); // add to our short list of good fragments
-					} else {
-						count_filter_rejects++;            // or increment reject counter
+						count_total_loops++;
+						fragments_tried_this_loopsize++;
+						if ( fragments_tried_this_loopsize > fragments_tried_this_loopsize_max ) { // continue with however many are in the bucket now, and break at end
+							fragment_limit_reached = true;
+							break;
+						}
 					}
-
-					count_total_loops++;
-					fragments_tried_this_loopsize++;
-					if ( fragments_tried_this_loopsize > fragments_tried_this_loopsize_max ) break; // continue with however many are in the bucket now, and break at end
 				}
 
 				// treat the fragments in a random order so shuffle them up
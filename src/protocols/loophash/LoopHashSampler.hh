@@ -23,6 +23,7 @@
 #include <core/pose/Pose.fwd.hh>
 #include <core/scoring/ScoreFunction.hh>
 #include <core/io/silent/SilentStruct.fwd.hh>
+#include <numeric/geometry/hashing/SixDHasher.hh>
 #include <utility/pointer/ReferenceCount.hh>
 #include <string>
 #include <vector>
@@ -33,6 +34,22 @@
 namespace protocols {
 namespace loophash {
 
+/// @brief One loop position (the segment ir..ir+loop_size of a pose) and its rigid body transform
+struct LoopHashPosition {
+	LoopHashPosition( core::Size ir_in = 0, core::Size loop_size_in = 0 ) :
+		ir( ir_in ), loop_size( loop_size_in ), valid( false )
+	{}
+
+	core::Size ir;
+	core::Size loop_size;
+
+	/// @brief false if no rigid body transform could be determined over the segment
+	bool valid;
+
+	/// @brief the rigid body transform over the segment, the key for radial lookups
+	numeric::geometry::hashing::Real6 transform;
+};
+
 
 class LoopHashSampler : public utility::pointer::ReferenceCount  {
 public:
@@ -52,6 +69,16 @@ public:
 		std::vector< core::io::silent::SilentStructOP > &lib_structs
 	);
 
+	/// @brief compute the rigid body transforms of many loop positions at once
+	/// @details positions must hold the ir and loop_size of every position; transform and valid are
+	/// filled in. In multithreaded builds the positions are divided among n_threads threads, each
+	/// working on its own copy of the pose. build_structures() also checks the fragments of each
+	/// radial lookup on n_threads threads, but builds the models in the same order as on one thread.
+	void compute_transforms(
+		const core::pose::Pose& pose,
+		utility::vector1< LoopHashPosition > & positions
+	) const;
+
 	/// @brief create a set of structures with closed gaps
 	void close_gaps(
 		const core::pose::Pose& start_pose,
@@ -71,6 +98,7 @@ public:
 	void set_max_nstruct  ( core::Size  value ) {  max_nstruct_    = value; }
 	void set_nonideal  ( bool value ) {  nonideal_  = value; }
 	void set_filter_by_phipsi ( bool value) {  filter_by_phipsi_ = value; }
+	void set_n_threads ( core::Size value ) {  n_threads_ = value; }
 	// This is meant for model creation, not mpi refinement!
 
 	core::Size get_start_res() { return  start_res_ ; }
@@ -81,6 +109,7 @@ public:
 	core::Real get_max_rms  () { return  max_rms_   ; }
 	core::Size get_max_nstruct() { return  max_nstruct_; }
 	bool       get_filter_by_phipsi() { return  filter_by_phipsi_; }
+	core::Size n_threads() const { return  n_threads_; }
 
 	//fpd pre-filter structures with a scorefunction
 	//fpd   this is done using a chainbroken pose (before constraint minimization!)
@@ -112,6 +141,9 @@ private:
 	bool nonideal_;
 	bool filter_by_phipsi_;
 
+	/// @brief threads used by compute_transforms() and the fragment checks, 0 for the hardware concurrency
+	core::Size n_threads_;
+
 	/// @brief (fpd) pre-filtering options
 	core::Size nprefilter_;
 	core::scoring::ScoreFunctionOP score_filt_;
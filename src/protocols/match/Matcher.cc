@@ -88,7 +88,8 @@ Matcher::Matcher() :
 	dynamic_grid_refinement_( false ),
 	output_matches_as_singular_downstream_positioning_( false ),
 	check_potential_dsbuilder_incompatibility_( false ),
-	build_round1_hits_twice_( false )
+	build_round1_hits_twice_( false ),
+	n_threads_( 1 )
 {
 	relevant_downstream_atoms_.clear();
 }
@@ -528,6 +529,11 @@ void Matcher::set_hash_euler_bin_widths( Vector widths )
 	euler_bin_widths_ = widths;
 }
 
+void Matcher::set_n_threads( Size n_threads )
+{
+	n_threads_ = n_threads;
+}
+
 void Matcher::set_bump_tolerance( Real permitted_overlap )
 {
 	runtime_assert( upstream_pose_.get() );
@@ -606,6 +612,8 @@ Matcher::initialize_from_task(
 	}
 
 	if ( mtask.build_round1_hits_twice() ) build_round1_hits_twice_ = true;
+
+	n_threads_ = mtask.n_threads();
 }
 
 /// @details Inside the CST::BEGIN blocks, The following ALGORITHM_INFO:: match input data
@@ -1311,6 +1319,12 @@ Matcher::occ_space_hash() const {
 	return occ_space_hash_;
 }
 
+Matcher::Size
+Matcher::n_threads() const
+{
+	return n_threads_;
+}
+
 utility::vector1< upstream::ScaffoldBuildPointCOP > const &
 Matcher::per_constraint_build_points( Size cst_id ) const
 {
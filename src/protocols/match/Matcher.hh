@@ -161,6 +161,13 @@ namespace match {
 ///
 /// find_hits() is the main worker function.  After the matcher finishes find_hits(),
 /// the matches can be read by a MatchProcessor in a call to process_matches.
+///
+/// Matches are handed to the MatchProcessor as they are enumerated, so they are never all
+/// held at once; the MatchConsolidator holds only the best few per group and, given
+/// -match:max_resident_matches, writes those out whenever it holds more than that many.
+/// The hits are not streamed: every hit that survives the occupied-space checks of
+/// find_hits() stays in memory until the Matcher is destroyed, so memory grows with the
+/// number of hits.
 class Matcher : public utility::pointer::ReferenceCount {
 public:
 	typedef core::Real                               Real;
@@ -265,6 +272,10 @@ public:
 
 	void set_bump_tolerance( Real permitted_overlap );
 
+	/// @brief Build hits at the scaffold build points on this many threads (0 for the
+	/// hardware concurrency).  Ignored in builds without thread support.
+	void set_n_threads( Size n_threads );
+
 	/// @brief The primary way to initialize a Matcher is through a MatcherTask.
 	void
 	initialize_from_task(
@@ -333,6 +344,10 @@ public:
 	utility::vector1< upstream::ScaffoldBuildPointCOP > const &
 	per_constraint_build_points( Size cst_id ) const;
 
+	/// @brief The number of threads to build hits with; 0 for the hardware concurrency
+	Size
+	n_threads() const;
+
 	/// Non-const access
 
 	upstream::ScaffoldBuildPointOP
@@ -566,6 +581,8 @@ private:
 	utility::vector1< bool > output_match_dspos1_for_geomcst_;
 
 	bool build_round1_hits_twice_;
+
+	Size n_threads_;
 };
 
 class MatcherOutputStats
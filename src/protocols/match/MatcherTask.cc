@@ -73,6 +73,7 @@ MatcherTask::MatcherTask() :
 	dynamic_grid_refinement_( false ),
 	consolidate_matches_( true ),
 	n_to_output_per_group_( 5 ),
+	max_resident_matches_( 0 ),
 	grouper_name_( "SameChiBinComboGrouper" ),
 	evaluator_name_( "DownstreamRMSEvaluator" ),
 	output_writer_name_( "PDB" ),
@@ -96,7 +97,8 @@ MatcherTask::MatcherTask() :
 	upstream_downstream_residue_collision_Wfa_rep_( 1.0 ),
 	upstream_downstream_residue_collision_Wfa_sol_( 1.0 ),
 	define_match_by_single_downstream_positioning_( false ),
-	build_round1_hits_twice_( false )
+	build_round1_hits_twice_( false ),
+	n_threads_( 1 )
 {}
 
 MatcherTask::MatcherTask( MatcherTask const & other ) :
@@ -137,6 +139,7 @@ MatcherTask::operator = ( MatcherTask const & rhs )
 		dynamic_grid_refinement_ = rhs.dynamic_grid_refinement_;
 		consolidate_matches_ = rhs.consolidate_matches_;
 		n_to_output_per_group_ = rhs.n_to_output_per_group_;
+		max_resident_matches_ = rhs.max_resident_matches_;
 		filter_names_ = rhs.filter_names_;
 		grouper_name_ = rhs.grouper_name_;
 		evaluator_name_ = rhs.evaluator_name_;
@@ -164,6 +167,7 @@ MatcherTask::operator = ( MatcherTask const & rhs )
 		upstream_downstream_residue_collision_Wfa_rep_ = rhs.upstream_downstream_residue_collision_Wfa_rep_;
 		upstream_downstream_residue_collision_Wfa_sol_ = rhs.upstream_downstream_residue_collision_Wfa_sol_;
 		build_round1_hits_twice_ = rhs.build_round1_hits_twice_;
+		n_threads_ = rhs.n_threads_;
 	}
 	return *this;
 }
@@ -411,6 +415,7 @@ MatcherTask::initialize_from_command_line()
 
 	consolidate_matches_ = option[ OptionKeys::match::consolidate_matches ];
 	n_to_output_per_group_ = option[ output_matches_per_group ];
+	max_resident_matches_ = option[ OptionKeys::match::max_resident_matches ];
 
 	initialize_active_site_definition_from_command_line();
 	initialize_upstream_residue_collision_filter_data_from_command_line();
@@ -422,6 +427,7 @@ MatcherTask::initialize_from_command_line()
 	only_enumerate_non_match_redundant_ligand_rotamers_ =  option[ OptionKeys::match::only_enumerate_non_match_redundant_ligand_rotamers ];
 
 	build_round1_hits_twice_ = option[ OptionKeys::match::build_round1_hits_twice ];
+	n_threads_ = option[ OptionKeys::match::nthreads ];
 }
 
 void
@@ -511,6 +517,11 @@ void MatcherTask::n_to_output_per_group( Size setting )
 	n_to_output_per_group_ = setting;
 }
 
+void MatcherTask::max_resident_matches( Size setting )
+{
+	max_resident_matches_ = setting;
+}
+
 void
 MatcherTask::add_filter( std::string const & filter_name )
 {
@@ -685,6 +696,12 @@ MatcherTask::n_to_output_per_group() const
 	return n_to_output_per_group_;
 }
 
+MatcherTask::Size
+MatcherTask::max_resident_matches() const
+{
+	return max_resident_matches_;
+}
+
 
 std::list< std::string > const &
 MatcherTask::filter_names() const
@@ -851,6 +868,16 @@ MatcherTask::build_round1_hits_twice() const {
 	return build_round1_hits_twice_;
 }
 
+MatcherTask::Size
+MatcherTask::n_threads() const {
+	return n_threads_;
+}
+
+void
+MatcherTask::n_threads( Size setting ) {
+	n_threads_ = setting;
+}
+
 void
 MatcherTask::validate_downstream_orientation_atoms() const
 {
@@ -160,6 +160,9 @@ public:
 	/// @brief For use with the match consolidator; specify the number of output matches that the
 	/// consolidator should select for each group.
 	void n_to_output_per_group( Size setting );
+	/// @brief For use with the match consolidator; the most matches it may hold at once before
+	/// writing out the ones it has kept.  0 for no limit.
+	void max_resident_matches( Size setting );
 	/// @brief Add a filter by name to the set of filters being included.  If that filter requires
 	/// extra data (as, for example, the UpstreamCollisionFilter) then the task should be expanded
 	/// to include all the data necessary to create and initialize that filter.  No valid options
@@ -261,6 +264,8 @@ public:  // Accessors
 
 	Size n_to_output_per_group() const;
 
+	Size max_resident_matches() const;
+
 	std::list< std::string > const &
 	filter_names() const;
 
@@ -302,6 +307,10 @@ public:  // Accessors
 
 	bool build_round1_hits_twice() const;
 
+	/// @brief Number of threads the Matcher should use to generate hits; 0 for the hardware concurrency
+	Size n_threads() const;
+	void n_threads( Size setting );
+
 private:
 
 	void
@@ -396,6 +405,7 @@ private:
 	bool dynamic_grid_refinement_;
 	bool consolidate_matches_; /// MatchConsolidator vs MatchOutputter
 	Size n_to_output_per_group_;
+	Size max_resident_matches_;
 	std::list< std::string > filter_names_;
 	std::string grouper_name_;
 	std::string evaluator_name_;
@@ -433,6 +443,8 @@ private:
 
 	bool build_round1_hits_twice_;
 
+	Size n_threads_;
+
 };
 
 
@@ -18,6 +18,7 @@
 // Package headers
 #include <protocols/match/VoxelSetIterator.hh>
 #include <protocols/match/BumpGrid.hh>
+#include <protocols/match/Hit.hh>
 
 //numeric headers
 #include <numeric/geometry/hashing/SixDHasher.hh>
@@ -25,15 +26,33 @@
 // Utility headers
 
 // C++ headers
+#include <algorithm>
 #include <fstream>
 
 #include <utility/vector1.hh>
+#include <utility/thread/parallel_for.hh>
 
 
 namespace protocols {
 namespace match {
 
-OccupiedSpaceHash::OccupiedSpaceHash() : initialized_( false ), revision_id_( 1 ) {}
+/// Only one shard is needed when the hash is never updated concurrently
+#if defined MULTI_THREADED && defined CXX11
+static core::Size const N_SHARDS = 64;
+#else
+static core::Size const N_SHARDS = 1;
+#endif
+
+OccupiedSpaceHash::OccupiedSpaceHash() :
+	initialized_( false ),
+	shards_( N_SHARDS ),
+	revision_id_( 1 )
+{
+#if defined MULTI_THREADED && defined CXX11
+	shard_mutexes_.reset( new std::mutex[ N_SHARDS ] );
+#endif
+}
+
 OccupiedSpaceHash::~OccupiedSpaceHash() {}
 
 void
@@ -136,7 +155,15 @@ OccupiedSpaceHash::insert_hit_geometry( Real6 const & geom )
 {
 	assert( initialized_ );
 
-	if ( revision_id_ == 1 ) { ++revision_id_; } /// round 1 is over.
+	if ( revision_id_ == 1 ) {
+#if defined MULTI_THREADED && defined CXX11
+		/// several threads may see round 1 at once; only one of them may end it
+		Size first_round( 1 );
+		revision_id_.compare_exchange_strong( first_round, 2 ); /// round 1 is over.
+#else
+		++revision_id_; /// round 1 is over.
+#endif
+	}
 
 	Vector point( Vector( geom[ 1 ], geom[ 2 ], geom[ 3 ] ));
 	if ( ! bb_.contains( point ) ) return;
@@ -150,11 +177,18 @@ OccupiedSpaceHash::insert_hit_geometry( Real6 const & geom )
 	while ( ! voxiter.at_end() ) {
 		voxiter.get_bin_and_pos( bin, pos );
 		bin_index = calc_bin_index( bin );
-		ActiveVoxelSet::iterator iter = hash_.find( bin_index );
-		if ( iter == hash_.end() ) {
-			hash_.insert( std::make_pair( bin_index, bitmask_for_position( pos ) ));
-		} else {
-			iter->second |= bitmask_for_position( pos );
+		Size const shard = shard_for_bin( bin_index );
+		{
+#if defined MULTI_THREADED && defined CXX11
+			std::lock_guard< std::mutex > lock( shard_mutexes_[ shard - 1 ] );
+#endif
+			ActiveVoxelSet & hash( shards_[ shard ] );
+			ActiveVoxelSet::iterator iter = hash.find( bin_index );
+			if ( iter == hash.end() ) {
+				hash.insert( std::make_pair( bin_index, bitmask_for_position( pos ) ));
+			} else {
+				iter->second |= bitmask_for_position( pos );
+			}
 		}
 		++voxiter;
 	}
@@ -162,6 +196,12 @@ OccupiedSpaceHash::insert_hit_geometry( Real6 const & geom )
 	project_point_to_3d( geom );
 }
 
+void
+OccupiedSpaceHash::insert_hits( std::list< Hit > const & hits, Size n_threads )
+{
+	process_hits( hits, &OccupiedSpaceHash::insert_hit_geometry, n_threads );
+}
+
 void
 OccupiedSpaceHash::prepare_to_note_hits_for_completed_round()
 {
@@ -173,9 +213,11 @@ OccupiedSpaceHash::prepare_to_note_hits_for_completed_round()
 	/// Rounds that use secondary matching on upstream residues will not
 	++revision_id_;
 
-	for ( ActiveVoxelSet::iterator iter = hash_.begin(), iter_end = hash_.end();
-			iter != iter_end; ++iter ) {
-		iter->second = 0;
+	for ( Size ii = 1; ii <= shards_.size(); ++ii ) {
+		for ( ActiveVoxelSet::iterator iter = shards_[ ii ].begin(), iter_end = shards_[ ii ].end();
+				iter != iter_end; ++iter ) {
+			iter->second = 0;
+		}
 	}
 
 	reset_3d_projection();
@@ -214,11 +256,18 @@ OccupiedSpaceHash::note_hit_geometry( Real6 const & geom )
 	while ( ! voxiter.at_end() ) {
 		voxiter.get_bin_and_pos( bin, pos );
 		bin_index = calc_bin_index( bin );
-		ActiveVoxelSet::iterator iter = hash_.find( bin_index );
-		if ( iter != hash_.end() ) {
-			boost::uint64_t mask = bitmask_for_position( pos );
-			if ( ! (iter->second & mask) ) {
-				iter->second |= mask;
+		Size const shard = shard_for_bin( bin_index );
+		{
+#if defined MULTI_THREADED && defined CXX11
+			std::lock_guard< std::mutex > lock( shard_mutexes_[ shard - 1 ] );
+#endif
+			ActiveVoxelSet & hash( shards_[ shard ] );
+			ActiveVoxelSet::iterator iter = hash.find( bin_index );
+			if ( iter != hash.end() ) {
+				boost::uint64_t mask = bitmask_for_position( pos );
+				if ( ! (iter->second & mask) ) {
+					iter->second |= mask;
+				}
 			}
 		}
 		++voxiter;
@@ -227,6 +276,12 @@ OccupiedSpaceHash::note_hit_geometry( Real6 const & geom )
 	project_point_to_3d( geom );
 }
 
+void
+OccupiedSpaceHash::note_hits( std::list< Hit > const & hits, Size n_threads )
+{
+	process_hits( hits, &OccupiedSpaceHash::note_hit_geometry, n_threads );
+}
+
 /// @details It must be safe for multiple threads to call function simultaneously
 bool
 OccupiedSpaceHash::match_possible_for_hit_geometry( Real6 const & geom ) const
@@ -253,8 +308,9 @@ OccupiedSpaceHash::match_possible_for_hit_geometry( Real6 const & geom ) const
 	while ( ! voxiter.at_end() ) {
 		voxiter.get_bin_and_pos( bin, pos );
 		bin_index = calc_bin_index( bin );
-		ActiveVoxelSet::const_iterator iter = hash_.find( bin_index );
-		if ( iter != hash_.end() && iter->second & bitmask_for_position( pos ) ) {
+		ActiveVoxelSet const & hash( shards_[ shard_for_bin( bin_index ) ] );
+		ActiveVoxelSet::const_iterator iter = hash.find( bin_index );
+		if ( iter != hash.end() && iter->second & bitmask_for_position( pos ) ) {
 			return true;
 		}
 		++voxiter;
@@ -284,16 +340,19 @@ OccupiedSpaceHash::drop_unsatisfied_voxels()
 	assert( initialized_ );
 	//threeD_projection_->clear();
 
-	for ( ActiveVoxelSet::iterator
-			iter = hash_.begin(),
-			iter_end = hash_.end();
-			iter != iter_end; /* no increment */ ) {
-		ActiveVoxelSet::iterator iter_next = iter;
-		++iter_next;
-		if ( iter->second == 0 ) {
-			hash_.erase( iter );
+	for ( Size ii = 1; ii <= shards_.size(); ++ii ) {
+		ActiveVoxelSet & hash( shards_[ ii ] );
+		for ( ActiveVoxelSet::iterator
+				iter = hash.begin(),
+				iter_end = hash.end();
+				iter != iter_end; /* no increment */ ) {
+			ActiveVoxelSet::iterator iter_next = iter;
+			++iter_next;
+			if ( iter->second == 0 ) {
+				hash.erase( iter );
+			}
+			iter = iter_next;
 		}
-		iter = iter_next;
 	}
 
 }
@@ -315,6 +374,73 @@ OccupiedSpaceHash::revision_id() const
 	return revision_id_;
 }
 
+OccupiedSpaceHash::Size
+OccupiedSpaceHash::n_voxels() const
+{
+	Size count( 0 );
+	for ( Size ii = 1; ii <= shards_.size(); ++ii ) count += shards_[ ii ].size();
+	return count;
+}
+
+namespace {
+
+/// @details The hits in [ begin, end )
+void
+process_hit_range(
+	OccupiedSpaceHash & occspace,
+	void (OccupiedSpaceHash::*process)( OccupiedSpaceHash::Real6 const & ),
+	std::list< Hit >::const_iterator begin,
+	std::list< Hit >::const_iterator end
+)
+{
+	for ( std::list< Hit >::const_iterator iter = begin; iter != end; ++iter ) {
+		(occspace.*process)( iter->second() );
+	}
+}
+
+}
+
+void
+OccupiedSpaceHash::process_hits(
+	std::list< Hit > const & hits,
+	void (OccupiedSpaceHash::*process)( Real6 const & ),
+	Size n_threads
+)
+{
+#if defined MULTI_THREADED && defined CXX11
+	n_threads = utility::thread::parallel_thread_count( hits.size(), n_threads );
+	if ( n_threads > 1 ) {
+		/// Split the list into n_threads contiguous ranges of nearly equal size; range ii
+		/// is [ range_begins[ ii ], range_begins[ ii + 1 ] ).
+		utility::vector1< std::list< Hit >::const_iterator > range_begins;
+		Size const n_hits( hits.size() );
+		std::list< Hit >::const_iterator iter = hits.begin();
+		Size count( 0 );
+		for ( Size ii = 0; ii < n_threads; ++ii ) {
+			Size const range_begin( ii * n_hits / n_threads );
+			for ( ; count < range_begin; ++count ) ++iter;
+			range_begins.push_back( iter );
+		}
+		range_begins.push_back( hits.end() );
+
+		utility::thread::parallel_for( n_threads, n_threads, [&]( Size ii, Size ) {
+			process_hit_range( *this, process, range_begins[ ii ], range_begins[ ii + 1 ] );
+		} );
+		return;
+	}
+#else
+	(void) n_threads;
+#endif
+	process_hit_range( *this, process, hits.begin(), hits.end() );
+}
+
+/// @details Fibonacci hashing of the bin index; neighboring voxels land in different shards
+OccupiedSpaceHash::Size
+OccupiedSpaceHash::shard_for_bin( boost::uint64_t bin_index ) const
+{
+	return ( ( bin_index * 0x9E3779B97F4A7C15ULL ) >> 40 ) % shards_.size() + 1;
+}
+
 
 void
 OccupiedSpaceHash::project_point_to_3d( Real6 const & geom )
@@ -358,6 +484,9 @@ OccupiedSpaceHash::project_point_to_3d( Real6 const & geom )
 	for ( Size ii = 1; ii <= 3; ++ii ) if ( upper( ii ) > bb_.upper()( ii ) ) upper( ii ) = bb_.upper()( ii );
 
 
+#if defined MULTI_THREADED && defined CXX11
+	std::lock_guard< std::mutex > lock( projection_mutex_ );
+#endif
 	threeD_projection_->or_by_box_liberal( BoundingBox( lower, upper ) );
 
 }
@@ -20,6 +20,7 @@
 
 // Package headers
 #include <protocols/match/BumpGrid.fwd.hh>
+#include <protocols/match/Hit.fwd.hh>
 
 // project headers
 #include <core/types.hh>
@@ -32,11 +33,21 @@
 // Utility headers
 #include <utility/pointer/ReferenceCount.hh>
 #include <utility/fixedsizearray1.hh>
+#include <utility/vector1.hh>
 
 
 /// Boost headers
 #include <boost/unordered_map.hpp>
 
+/// C++ headers
+#include <list>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <atomic>
+#include <memory>
+#include <mutex>
+#endif
+
 namespace protocols {
 namespace match {
 
@@ -68,9 +79,12 @@ namespace match {
 ///
 /// This class is intended to be accessed by multiple threads but in a controlled way:
 /// read access function "match_possible_for_hit_geometry" is accessible to all threads
-/// during the "building" stage. However, the functions note_hit_geometry and
-/// drop_unsatisfied_voxels should be called by single thread only, and no other thread
-/// should try to access the ActiveVoxelHashes object at that time.
+/// during the "building" stage.  The voxels are split by bin index over several independent
+/// hash tables (shards), each with its own lock, so insert_hit_geometry and note_hit_geometry
+/// may be called by several threads at once (see insert_hits and note_hits); they must not
+/// overlap with calls to match_possible_for_hit_geometry.  The functions
+/// prepare_to_note_hits_for_completed_round and drop_unsatisfied_voxels should be called by
+/// single thread only, and no other thread should try to access the object at that time.
 class OccupiedSpaceHash : public utility::pointer::ReferenceCount {
 public:
 	typedef core::Real                               Real;
@@ -112,12 +126,22 @@ public:
 	void
 	insert_hit_geometry( Real6 const & geom );
 
+	/// @brief insert_hit_geometry for the downstream geometry of every hit in the list,
+	/// dividing the hits among n_threads threads (0 for the hardware concurrency)
+	void
+	insert_hits( std::list< Hit > const & hits, Size n_threads );
+
 	void
 	prepare_to_note_hits_for_completed_round();
 
 	void
 	note_hit_geometry( Real6 const & );
 
+	/// @brief note_hit_geometry for the downstream geometry of every hit in the list,
+	/// dividing the hits among n_threads threads (0 for the hardware concurrency)
+	void
+	note_hits( std::list< Hit > const & hits, Size n_threads );
+
 	void
 	reset_3d_projection();
 
@@ -135,8 +159,24 @@ public:
 	Size
 	revision_id() const;
 
+	/// @brief The number of voxels currently held
+	Size
+	n_voxels() const;
+
 private:
 
+	/// @brief Apply process to the downstream geometry of every hit in the list on n_threads threads
+	void
+	process_hits(
+		std::list< Hit > const & hits,
+		void (OccupiedSpaceHash::*process)( Real6 const & ),
+		Size n_threads
+	);
+
+	/// @brief The shard that holds (or would hold) the voxel with this bin index
+	Size
+	shard_for_bin( boost::uint64_t bin_index ) const;
+
 	void
 	project_point_to_3d( Real6 const & geom );
 
@@ -164,11 +204,18 @@ private:
 
 	//utility::fixedsizearray1< Real, 3 > xyz_width_root3_;
 
-	ActiveVoxelSet hash_;
+	/// @brief The voxels, split by bin index over independent hash tables
+	utility::vector1< ActiveVoxelSet > shards_;
 
 	Bool3DGridOP threeD_projection_;
 
+#if defined MULTI_THREADED && defined CXX11
+	std::atomic< Size > revision_id_;
+	std::unique_ptr< std::mutex[] > shard_mutexes_;
+	std::mutex projection_mutex_;
+#else
 	Size revision_id_;
+#endif
 
 };
 
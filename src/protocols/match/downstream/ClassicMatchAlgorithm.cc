@@ -30,8 +30,13 @@
 
 // Utility headers
 #include <utility/pointer/ReferenceCount.hh>
+#include <utility/thread/parallel_for.hh>
+
+// Boost headers
+#include <boost/bind.hpp>
 
 // C++ headers
+#include <algorithm>
 #include <list>
 
 #include <protocols/match/Hit.hh>
@@ -45,6 +50,29 @@ namespace downstream {
 
 static THREAD_LOCAL basic::Tracer TR( "protocols.match.downstream.ClassicMatchAlgorithm" );
 
+namespace {
+
+/// @details Builds the hits of build point ii, inserts them into the occupied space hash and keeps
+/// only the first of them, for utility::thread::parallel_for().
+void
+build_and_discard_hits_at_position(
+	upstream::UpstreamBuilder const & builder,
+	utility::vector1< upstream::ScaffoldBuildPointCOP > const & launch_points,
+	OccupiedSpaceHash & occspace,
+	utility::vector1< std::list< Hit > > & first_hits,
+	core::Size ii
+)
+{
+	std::list< Hit > iihits = builder.build( * launch_points[ ii ] );
+	for ( std::list< Hit >::const_iterator iter = iihits.begin(), iter_end = iihits.end();
+			iter != iter_end; ++iter ) {
+		occspace.insert_hit_geometry( iter->second() );
+	}
+	if ( ! iihits.empty() ) first_hits[ ii ].push_back( *iihits.begin() );
+}
+
+}
+
 ClassicMatchAlgorithm::ClassicMatchAlgorithm( Size geom_cst_id ) :
 	parent( geom_cst_id ),
 	occspace_rev_id_at_last_update_( 0 ),
@@ -125,17 +153,21 @@ ClassicMatchAlgorithm::build_and_discard_first_round_hits_at_all_positions(
 
 	std::list< Hit > return_hits; // Only return a single hit from this function
 	OccupiedSpaceHashOP occspace = matcher.occ_space_hash();
+	upstream::UpstreamBuilderCOP builder = matcher.upstream_builder( geom_cst_id() );
+
+	// generate hits for each build point, and insert them into the occspace hash,
+	// but throw them out once inserted since usually there are too
+	// many that get generated; the occspace hash accepts insertions from several threads at once
+	utility::vector1< std::list< Hit > > first_hits( n_build_points );
+	utility::thread::parallel_for( n_build_points, matcher.n_threads(), boost::bind( &build_and_discard_hits_at_position,
+		boost::cref( *builder ), boost::cref( launch_points ), boost::ref( *occspace ), boost::ref( first_hits ), _1 ) );
+
+	// save one hit so that the Matcher doesn't exit early (it will if we return 0 hits)
 	for ( Size ii = 1; ii <= n_build_points; ++ii ) {
-		// generate hits for build point ii, and insert them into the occspace hash,
-		// but throw them out at the end of this iteration since usually there are too
-		// many that get generated
-		std::list< Hit > iihits = matcher.upstream_builder( geom_cst_id() )->build( * launch_points[ ii ] );
-		for ( std::list< Hit >::const_iterator iter = iihits.begin(), iter_end = iihits.end();
-				iter != iter_end; ++iter ) {
-			occspace->insert_hit_geometry( iter->second() );
+		if ( ! first_hits[ ii ].empty() ) {
+			return_hits.splice( return_hits.end(), first_hits[ ii ] );
+			break;
 		}
-		// save one hit so that the Matcher doesn't exit early (it will if we return 0 hits)
-		if ( return_hits.empty() && ! iihits.empty() ) { return_hits.push_back( *iihits.begin() ); }
 	}
 	return return_hits;
 }
@@ -166,12 +198,7 @@ ClassicMatchAlgorithm::respond_to_primary_hitlist_change(
 		/// The first geometric constraint inserts hits into the occupied space grid;
 		/// the later geometric constraints merely mark voxels already present in the
 		/// occupied space grid with 1.
-		for ( Matcher::HitListConstIterator
-				iter = matcher.hits( geom_cst_id() ).begin(),
-				iter_end = matcher.hits( geom_cst_id() ).end();
-				iter != iter_end; ++iter ) {
-			occspace->insert_hit_geometry( iter->second() );
-		}
+		occspace->insert_hits( matcher.hits( geom_cst_id() ), matcher.n_threads() );
 
 	} else {
 
@@ -184,12 +211,7 @@ ClassicMatchAlgorithm::respond_to_primary_hitlist_change(
 
 		/// Prepare to clear the cobwebs.  Note which voxels in the occ_space_hash_
 		/// could lead to matches, and which voxels could not possibly lead to matches.
-		for ( Matcher::HitListConstIterator
-				iter = matcher.hits( geom_cst_id() ).begin(),
-				iter_end = matcher.hits( geom_cst_id() ).end();
-				iter != iter_end; ++iter ) {
-			occspace->note_hit_geometry( iter->second() );
-		}
+		occspace->note_hits( matcher.hits( geom_cst_id() ), matcher.n_threads() );
 
 		occspace->drop_unsatisfied_voxels();
 	}
@@ -27,9 +27,14 @@
 
 // Utility headers
 #include <utility/pointer/ReferenceCount.hh>
+#include <utility/thread/parallel_for.hh>
 #include <basic/Tracer.hh>
 
+// Boost headers
+#include <boost/bind.hpp>
+
 // C++ headers
+#include <algorithm>
 #include <list>
 
 #include <core/id/AtomID.hh>
@@ -43,6 +48,25 @@ namespace downstream {
 
 static THREAD_LOCAL basic::Tracer TR( "protocols.match.downstream.DownstreamAlgorithm" );
 
+#if defined MULTI_THREADED && defined CXX11
+namespace {
+
+/// @brief the hits of build point ii, for utility::thread::parallel_for()
+void
+build_hits_at_position(
+	upstream::UpstreamBuilder const & builder,
+	utility::vector1< upstream::ScaffoldBuildPointCOP > const & launch_points,
+	utility::vector1< std::list< Hit > > & hits,
+	core::Size ii
+)
+{
+	std::list< Hit > iihits = builder.build( * launch_points[ ii ] );
+	hits[ ii ].splice( hits[ ii ].end(), iihits );
+}
+
+}
+#endif
+
 DownstreamAlgorithm::DownstreamAlgorithm( Size geom_cst_id ) : geom_cst_id_( geom_cst_id ) {}
 DownstreamAlgorithm::DownstreamAlgorithm( DownstreamAlgorithm const & other ) :
 	utility::pointer::ReferenceCount(),
@@ -184,8 +208,17 @@ DownstreamAlgorithm::default_build_hits_at_all_positions(
 
 	/// Generate conformations for the upstream and downstream partners for each of the
 	/// possible scaffold build points for this geometric constraint.
-	/// This loop will be parallelized.  Everything down stream of this call is const,
+	/// This loop is parallelized.  Everything down stream of this call is const,
 	/// in spite of the fact that the matcher is handed as a non-const reference.
+	/// The hits of each build point are kept apart and spliced together in build-point
+	/// order below, so the hit order does not depend on the number of threads.
+#if defined MULTI_THREADED && defined CXX11
+	// build points are handed out one at a time, since the number of hits (and
+	// the time spent) per build point varies enormously
+	upstream::UpstreamBuilderCOP builder = matcher.upstream_builder( geom_cst_id_ );
+	utility::thread::parallel_for( n_build_points, matcher.n_threads(), boost::bind( &build_hits_at_position,
+		boost::cref( *builder ), boost::cref( launch_points ), boost::ref( hits ), _1 ) );
+#else
 #ifdef USE_OPENMP
 	#pragma omp parallel for schedule(dynamic,1)
 #endif
@@ -193,6 +226,7 @@ DownstreamAlgorithm::default_build_hits_at_all_positions(
 		std::list< Hit > iihits = matcher.upstream_builder( geom_cst_id_ )->build( * launch_points[ ii ] );
 		hits[ ii ].splice( hits[ ii ].end(), iihits );
 	}
+#endif
 
 	for ( Size ii = 1; ii <= n_build_points; ++ii ) {
 		all_hits.splice( all_hits.end(), hits[ ii ] );
@@ -149,12 +149,7 @@ SecondaryMatcherToDownstreamResidue::respond_to_primary_hitlist_change(
 
 	/// Prepare to clear the cobwebs.  Note which voxels in the occ_space_hash_
 	/// could lead to matches, and which voxels could not possibly lead to matches.
-	for ( Matcher::HitListConstIterator
-			iter = matcher.hits( geom_cst_id() ).begin(),
-			iter_end = matcher.hits( geom_cst_id() ).end();
-			iter != iter_end; ++iter ) {
-		occspace->note_hit_geometry( iter->second() );
-	}
+	occspace->note_hits( matcher.hits( geom_cst_id() ), matcher.n_threads() );
 
 	occspace->drop_unsatisfied_voxels();
 
@@ -37,7 +37,11 @@ namespace protocols {
 namespace match {
 namespace output {
 
-MatchConsolidator::MatchConsolidator() : n_to_output_per_group_( 5 ) {}
+MatchConsolidator::MatchConsolidator() :
+	n_to_output_per_group_( 5 ),
+	max_resident_matches_( 0 ),
+	n_resident_matches_( 0 )
+{}
 
 MatchConsolidator::~MatchConsolidator() {}
 
@@ -48,6 +52,7 @@ MatchConsolidator::begin_processing()
 	runtime_assert( evaluator_ != 0 );
 	MatchProcessor::begin_processing();
 	match_groups_.clear();
+	n_resident_matches_ = 0;
 	grouper_->reset();
 
 }
@@ -67,12 +72,14 @@ MatchConsolidator::process_match(
 
 	Size group = grouper_->assign_group_for_match( m );
 
-	if ( group > match_groups_.size() ) {
-		match_groups_.resize( group );
-		match_groups_[ group ] = protocols::match::output::BestMatchesCollectionOP( new BestMatchesCollection( n_to_output_per_group_, false ) );
-	}
+	BestMatchesCollection & collection = group_collection( group, false );
+	Size const n_kept_before = collection.n_kept_matches();
 	Real score = evaluator_->score( m );
-	match_groups_[ group ]->add_match( m, score );
+	collection.add_match( m, score );
+	n_resident_matches_ += collection.n_kept_matches() - n_kept_before;
+	if ( max_resident_matches_ != 0 && n_resident_matches_ > max_resident_matches_ ) {
+		write_kept_matches();
+	}
 	//std::cout << ".";
 }
 
@@ -91,12 +98,14 @@ MatchConsolidator::process_match(
 
 	Size group = grouper_->assign_group_for_match( m );
 
-	if ( group > match_groups_.size() ) {
-		match_groups_.resize( group );
-		match_groups_[ group ] = protocols::match::output::BestMatchesCollectionOP( new BestMatchesCollection( n_to_output_per_group_, true ) );
-	}
+	BestMatchesCollection & collection = group_collection( group, true );
+	Size const n_kept_before = collection.n_kept_matches();
 	Real score = evaluator_->score( m );
-	match_groups_[ group ]->add_match_dspos1( m, score );
+	collection.add_match_dspos1( m, score );
+	n_resident_matches_ += collection.n_kept_matches() - n_kept_before;
+	if ( max_resident_matches_ != 0 && n_resident_matches_ > max_resident_matches_ ) {
+		write_kept_matches();
+	}
 	//std::cout << ".";
 }
 
@@ -114,7 +123,31 @@ MatchConsolidator::end_processing()
 	//std::cout << std::endl;
 	//std::cout << "match groups: " << match_groups_.size() << std::endl;
 
+	write_kept_matches();
+	match_score_writer_->write_match_scores();
+	MatchProcessor::end_processing();
+}
+
+/// @details Groups emptied by write_kept_matches() leave null entries behind; the
+/// collection for such a group is created afresh the next time one of its matches arrives.
+BestMatchesCollection &
+MatchConsolidator::group_collection( Size group, bool dspos1_mode )
+{
+	if ( group > match_groups_.size() ) {
+		match_groups_.resize( group );
+	}
+	if ( ! match_groups_[ group ] ) {
+		match_groups_[ group ] = protocols::match::output::BestMatchesCollectionOP( new BestMatchesCollection( n_to_output_per_group_, dspos1_mode ) );
+	}
+	return *match_groups_[ group ];
+}
+
+/// @details Hand every kept match to the writer and drop the collections that held them.
+void
+MatchConsolidator::write_kept_matches()
+{
 	for ( Size ii = 1; ii <= match_groups_.size(); ++ii ) {
+		if ( ! match_groups_[ ii ] ) continue;
 		//std::cout << ":";
 		for ( Size jj = 1; jj <= match_groups_[ ii ]->n_kept_matches(); ++jj ) {
 			if ( ! match_groups_[ ii ]->dspos1_mode() ) {
@@ -123,9 +156,9 @@ MatchConsolidator::end_processing()
 				writer_->record_match( match_groups_[ ii ]->kept_match_dspos1( jj ) );
 			}
 		}
+		match_groups_[ ii ].reset();
 	}
-	match_score_writer_->write_match_scores();
-	MatchProcessor::end_processing();
+	n_resident_matches_ = 0;
 }
 
 void
@@ -211,6 +244,12 @@ MatchConsolidator::set_n_to_output_per_group( Size setting )
 	n_to_output_per_group_ = setting;
 }
 
+void
+MatchConsolidator::set_max_resident_matches( Size setting )
+{
+	max_resident_matches_ = setting;
+}
+
 void
 MatchConsolidator::set_grouper( MatchGrouperOP grouper )
 {
@@ -76,6 +76,12 @@ public:
 	void
 	set_n_to_output_per_group( Size setting );
 
+	/// @brief Write out the kept matches whenever more than this many are held across all
+	/// groups, instead of holding them until end_processing().  A group written out early
+	/// starts over, so it may output more than n_to_output_per_group matches.  0 for no limit.
+	void
+	set_max_resident_matches( Size setting );
+
 	void
 	set_grouper( MatchGrouperOP grouper );
 
@@ -83,6 +89,11 @@ public:
 	reset_grouper();
 
 private:
+	BestMatchesCollection &
+	group_collection( Size group, bool dspos1_mode );
+
+	void write_kept_matches();
+
 	void end_processing_of_regular_match_groups();
 	void end_processing_of_match_dspos1_groups();
 
@@ -91,6 +102,8 @@ private:
 	MatchGrouperOP   grouper_;
 
 	Size n_to_output_per_group_;
+	Size max_resident_matches_;
+	Size n_resident_matches_;
 
 	utility::vector1< BestMatchesCollectionOP > match_groups_;
 
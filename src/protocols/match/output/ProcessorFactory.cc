@@ -91,6 +91,7 @@ ProcessorFactory::create_processor(
 		consolidator->set_grouper( create_grouper( matcher, mtask, cacher ) );
 		consolidator->set_output_writer( create_output_writer( matcher, mtask, cacher ) );
 		consolidator->set_n_to_output_per_group( mtask->n_to_output_per_group() );
+		consolidator->set_max_resident_matches( mtask->max_resident_matches() );
 
 		processor = consolidator;
 	} else {
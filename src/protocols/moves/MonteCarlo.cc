@@ -74,6 +74,8 @@ MonteCarlo::MonteCarlo( MonteCarlo const & src ) :
 	total_score_of_last_considered_pose_( src.total_score_of_last_considered_pose_ ),
 	last_accepted_score_( src.last_accepted_score_ ),
 	lowest_score_( src.lowest_score_ ),
+	last_copy_bytes_( src.last_copy_bytes_ ),
+	total_copy_bytes_( src.total_copy_bytes_ ),
 	heat_after_cycles_( src.heat_after_cycles_ ),
 	convergence_checks_( src.convergence_checks_ ),
 	last_check_( src.last_check_ ),
@@ -98,6 +100,8 @@ MonteCarlo::MonteCarlo(
 	total_score_of_last_considered_pose_( 0.0 ),
 	last_accepted_score_( 0.0 ),
 	lowest_score_( 0.0 ),
+	last_copy_bytes_( 0 ),
+	total_copy_bytes_( 0 ),
 	heat_after_cycles_( 150 )
 {
 	last_accepted_pose_ = PoseOP( new Pose() );
@@ -124,6 +128,8 @@ MonteCarlo::MonteCarlo(
 	total_score_of_last_considered_pose_( 0.0 ),
 	last_accepted_score_( 0.0 ),
 	lowest_score_( 0.0 ),
+	last_copy_bytes_( 0 ),
+	total_copy_bytes_( 0 ),
 	heat_after_cycles_( 150 )
 {
 	last_accepted_pose_ = PoseOP( new Pose() );
@@ -201,6 +207,7 @@ void
 MonteCarlo::reset_counters()
 {
 	counter_->reset();
+	total_copy_bytes_ = 0;
 }
 
 /// @detail return number of trials since last reset
@@ -212,6 +219,10 @@ MonteCarlo::total_trials() const {
 void
 MonteCarlo::show_counters() const {
 	counter_->show();
+	core::Size const trials( counter_->total_trials() );
+	if ( trials > 0 ) {
+		TR << "pose bytes copied: " << total_copy_bytes_ << " (" << total_copy_bytes_ / trials << " per trial)" << std::endl;
+	}
 }
 
 void
@@ -360,12 +371,15 @@ MonteCarlo::boltzmann(
 	if ( !accept ) {
 		evaluate_convergence_checks( pose, true /*reject*/, false /* not final*/ );
 		pose = ( *last_accepted_pose_ );
+		last_copy_bytes_ = pose.last_copy_bytes();
+		total_copy_bytes_ += last_copy_bytes_;
 		return false; // rejected
 	}
 
 	//accepted !
 	PROF_START( basic::MC_ACCEPT );
 	*last_accepted_pose_ = pose;
+	last_copy_bytes_ = last_accepted_pose_->last_copy_bytes();
 
 	// print out the scores for each decoy to cmd out, if you pass a flag
 	// nice for testing
@@ -381,6 +395,7 @@ MonteCarlo::boltzmann(
 
 	if ( mc_accepted_ == MCA_accepted_score_beat_low ) {
 		*lowest_score_pose_ = pose;
+		last_copy_bytes_ += lowest_score_pose_->last_copy_bytes();
 		evaluate_convergence_checks( pose, false /*not reject*/, false /*not final*/ );
 
 #ifdef BOINC_GRAPHICS
@@ -390,6 +405,7 @@ MonteCarlo::boltzmann(
 #endif
 
 	} //MCA_accepted_score_beat_low
+	total_copy_bytes_ += last_copy_bytes_;
 
 	PROF_STOP( basic::MC_ACCEPT );
 	return true; // accept!
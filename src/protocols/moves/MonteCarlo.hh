@@ -461,6 +461,14 @@ public:
 	///     MonteCarlo.show_state
 	Size total_trials() const;
 
+	/// @brief Returns the bytes of pose data copied between the working pose and the last accepted and
+	/// lowest score poses by the last call to boltzmann(pose).  Only the residues and energy graph edges
+	/// that differ between the two poses are copied.
+	Size last_copy_bytes() const { return last_copy_bytes_; }
+
+	/// @brief Returns the bytes of pose data copied by boltzmann(pose) since the last reset of the counters
+	Size total_copy_bytes() const { return total_copy_bytes_; }
+
 	/// @brief Manually record that a move was attempted.
 	/// @details This is intended for moves that are made outside to context of
 	/// MonteCarlo itself.  Temperature moves are a good example.
@@ -639,6 +647,10 @@ private:
 	Real last_accepted_score_;
 	Real lowest_score_;
 
+	/// @brief pose data copied by the last boltzmann(pose) call and since the last reset_counters()
+	Size last_copy_bytes_;
+	Size total_copy_bytes_;
+
 	Size heat_after_cycles_;
 
 	utility::vector1< moves::MonteCarloExceptionConvergeOP > convergence_checks_;
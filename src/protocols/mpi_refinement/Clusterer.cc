@@ -14,6 +14,7 @@
 #include <protocols/mpi_refinement/util.hh>
 #include <protocols/mpi_refinement/Clusterer.hh>
 #include <protocols/wum/SilentStructStore.hh>
+#include <protocols/cluster/CoordinateClustering.hh>
 #include <core/import_pose/import_pose.hh>
 
 #include <core/io/silent/SilentStruct.hh>
@@ -31,6 +32,28 @@ namespace mpi_refinement {
 
 static basic::Tracer TR("MPI.LHR.C");
 
+namespace {
+
+/// @brief the CA coordinates of every structure, or a null pointer if they do not all have the same number of CAs
+protocols::cluster::DecoyCoordinatesOP
+ca_coordinates( protocols::wum::SilentStructStore & structs )
+{
+	protocols::cluster::DecoyCoordinatesOP coords;
+	for ( core::Size i = 0; i < structs.size(); ++i ) {
+		ObjexxFCL::FArray2D< core::Real > const crd = structs.get_struct( i )->get_CA_xyz();
+		if ( crd.size2() == 0 ) return protocols::cluster::DecoyCoordinatesOP();
+		if ( ! coords ) {
+			coords = protocols::cluster::DecoyCoordinatesOP( new protocols::cluster::DecoyCoordinates( crd.size2() ) );
+			coords->reserve( structs.size() );
+		}
+		if ( crd.size2() != coords->n_atoms() ) return protocols::cluster::DecoyCoordinatesOP();
+		coords->add( crd );
+	}
+	return coords;
+}
+
+}
+
 Clusterer::Clusterer()
 {
 	set_defaults();
@@ -123,6 +146,11 @@ Clusterer::energy_sort_cluster( protocols::wum::SilentStructStore structs,
 	// First sort based on score
 	structs.sort_by( sim_replace_obj_ );
 
+	// The CA rmsd needs nothing but the CA coordinates: extract them once instead of
+	// filling two poses for every comparison
+	protocols::cluster::DecoyCoordinatesOP coords;
+	if ( similarity_measure_.compare( "rmsd" ) == 0 ) coords = ca_coordinates( structs );
+
 	protocols::wum::SilentStructStore selected;
 	utility::vector1< core::Size > selected_id;
 
@@ -131,10 +159,14 @@ Clusterer::energy_sort_cluster( protocols::wum::SilentStructStore structs,
 
 		bool is_close( false );
 		for ( core::Size j = 0; j < selected.size(); ++j ) {
-			core::io::silent::SilentStructOP ss2 = selected.get_struct( j );
-
 			core::Real distance;
-			is_close = get_distance( ss1, ss2, distance, dist_cut );
+			if ( coords ) {
+				distance = coords->rmsd( i+1, selected_id[ j+1 ]+1 );
+				is_close = ( distance < dist_cut );
+			} else {
+				core::io::silent::SilentStructOP ss2 = selected.get_struct( j );
+				is_close = get_distance( ss1, ss2, distance, dist_cut );
+			}
 			if ( is_close ) break;
 		}
 
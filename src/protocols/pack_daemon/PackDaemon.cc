@@ -64,17 +64,48 @@
 #include <core/pose/annotated_sequence.hh>
 #include <utility/vector0.hh>
 #include <utility/vector1.hh>
+#include <utility/thread/parallel_for.hh>
+
+#include <numeric/random/random.hh>
+#include <basic/options/option.hh>
+#include <basic/options/keys/run.OptionKeys.gen.hh>
 
 #ifdef USEMPI
 #include <utility/mpi_util.hh>
 #endif
 
+// C++ headers
+#include <limits>
+#include <sstream>
+
+#ifdef APL_MEASURE_MSD_LOAD_BALANCE
+#include <ctime>
+#if defined MULTI_THREADED && defined CXX11
+#include <chrono>
+#endif
+#endif
+
 
 namespace protocols {
 namespace pack_daemon {
 
 static THREAD_LOCAL basic::Tracer TR( "protocols.pack_daemon.PackDaemon" );
 
+#ifdef APL_MEASURE_MSD_LOAD_BALANCE
+/// @brief Seconds on a clock that times the work of one thread: wall-clock time in multithreaded
+/// builds, where clock() adds up the processor time of every thread, and processor time otherwise.
+static
+core::Real
+runtime_seconds()
+{
+#if defined MULTI_THREADED && defined CXX11
+	return std::chrono::duration< core::Real >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+#else
+	return ((double) clock() ) / CLOCKS_PER_SEC;
+#endif
+}
+#endif
+
 PackDaemon::PackDaemon() :
 	include_background_energies_( true ),
 	background_energies_( 0.0 ),
@@ -460,6 +491,7 @@ DaemonSet::DaemonSet() :
 	include_background_energies_( true ),
 	limit_dlig_mem_usage_( false ),
 	dlig_nmeg_limit_( 0 ),
+	n_threads_( 1 ),
 	ndaemons_( 0 ),
 	n_npd_properties_( 0 )
 {}
@@ -521,6 +553,11 @@ void DaemonSet::set_dlig_nmeg_limit( Size setting )
 	}
 }
 
+void DaemonSet::set_n_threads( Size setting )
+{
+	n_threads_ = setting;
+}
+
 void DaemonSet::add_npdpro_calculator_creator(
 	NPDPropCalculatorCreatorOP creator
 )
@@ -755,42 +792,96 @@ core::Size DaemonSet::n_npd_properties() const { return n_npd_properties_; }
 DaemonSet::StateEsAndNPDs
 DaemonSet::compute_energy_for_assignment( Entity const & entity )
 {
+	utility::vector1< core::Real > energies( daemons_.size(), 0.0 );
+	utility::vector1< SizeRealPairs > daemon_npd_properties( daemons_.size() );
 #ifdef APL_MEASURE_MSD_LOAD_BALANCE
-	std::clock_t starttime = clock();
+	daemon_packing_runtimes_.assign( daemons_.size(), 0.0 );
+	daemon_npd_runtimes_.assign( daemons_.size(), 0.0 );
 #endif
 
+#if defined MULTI_THREADED && defined CXX11
+	Size const n_threads = utility::thread::parallel_thread_count( daemons_.size(), n_threads_ );
+	if ( n_threads > 1 ) {
+		// one seed per state, drawn here, so that the repacking of each state does not
+		// depend on which thread picks it up
+		utility::vector1< int > seeds( daemons_.size() );
+		for ( Size ii = 1; ii <= daemons_.size(); ++ii ) {
+			seeds[ ii ] = numeric::random::rg().random_range( 1, std::numeric_limits< int >::max() - 1 );
+		}
+		// the options are not read from the worker threads
+		std::string const rng_type( basic::options::option[ basic::options::OptionKeys::run::rng ]() );
+		// the calling thread repacks states too, and reseeding it would leave its stream
+		// at whichever state it ran last; put its generator back afterwards
+		std::ostringstream caller_rng_state;
+		numeric::random::rg().saveState( caller_rng_state );
+		utility::thread::parallel_for( daemons_.size(), n_threads, [&]( Size ii, Size ) {
+			numeric::random::rg().set_seed( rng_type, seeds[ ii ] );
+			compute_daemon_energy_for_assignment( ii, entity, energies[ ii ], daemon_npd_properties[ ii ] );
+		} );
+		std::istringstream caller_rng_in( caller_rng_state.str() );
+		numeric::random::rg().restoreState( caller_rng_in );
+	} else
+#endif
+	{
+		for ( Size ii = 1; ii <= daemons_.size(); ++ii ) {
+			compute_daemon_energy_for_assignment( ii, entity, energies[ ii ], daemon_npd_properties[ ii ] );
+		}
+	}
 
 	SizeRealPairs daemon_scores;
-	for ( DaemonListIter iter = daemons_.begin(), iter_end = daemons_.end();
-			iter != iter_end; ++iter ) {
-		core::Real energy = iter->second->compute_energy_for_assignment( entity );
-		daemon_scores.push_back( std::make_pair( iter->first, energy ) );
-		//std::cout << "Computed energy " << energy << " for state " << iter->first << std::endl;
+	SizeRealPairs npd_properties;
+	for ( Size ii = 1; ii <= daemons_.size(); ++ii ) {
+		daemon_scores.push_back( std::make_pair( daemons_[ ii ].first, energies[ ii ] ) );
+		npd_properties.splice( npd_properties.end(), daemon_npd_properties[ ii ] );
 	}
+
 #ifdef APL_MEASURE_MSD_LOAD_BALANCE
-	std::clock_t midtime = clock();
+	packing_runtime_ = 0.0;
+	npd_runtime_     = 0.0;
+	for ( Size ii = 1; ii <= daemons_.size(); ++ii ) {
+		packing_runtime_ += daemon_packing_runtimes_[ ii ];
+		npd_runtime_     += daemon_npd_runtimes_[ ii ];
+	}
 #endif
-	SizeRealPairs npd_properties;
-	if ( n_npd_properties_ != 0 ) {
-		for ( Size ii = 1; ii <= npd_calcs_for_poses_.size(); ++ii ) {
-			if ( npd_calcs_for_poses_[ ii ].empty() ) continue;
-			daemons_[ ii ].second->assign_last_rotamers_to_pose( *daemon_poses_[ ii ] );
-			for ( std::list< NPDIndAndCalc >::const_iterator
-					npditer = npd_calcs_for_poses_[ ii ].begin(),
-					npditer_end = npd_calcs_for_poses_[ ii ].end();
-					npditer != npditer_end; ++npditer ) {
-				core::Real const npd_property = npditer->second->calculate( *daemon_poses_[ ii ] );
-				npd_properties.push_back( std::make_pair( npditer->first, npd_property ));
-				//std::cout << "Computed non-pairwise decomposable property " << npd_property << " for npdindex " << npditer->first << std::endl;
-			}
-		}
+	return std::make_pair( daemon_scores, npd_properties );
+}
+
+/// @details Touches nothing but daemon ii, its pose and its calculators, so that
+/// different daemons can be evaluated on different threads.
+void
+DaemonSet::compute_daemon_energy_for_assignment(
+	Size ii,
+	Entity const & entity,
+	core::Real & energy,
+	SizeRealPairs & npd_properties
+)
+{
+#ifdef APL_MEASURE_MSD_LOAD_BALANCE
+	core::Real const starttime = runtime_seconds();
+#endif
+
+	energy = daemons_[ ii ].second->compute_energy_for_assignment( entity );
+	//std::cout << "Computed energy " << energy << " for state " << daemons_[ ii ].first << std::endl;
+
+#ifdef APL_MEASURE_MSD_LOAD_BALANCE
+	core::Real const midtime = runtime_seconds();
+	daemon_packing_runtimes_[ ii ] = midtime - starttime;
+#endif
+
+	if ( n_npd_properties_ == 0 || npd_calcs_for_poses_[ ii ].empty() ) return;
+	daemons_[ ii ].second->assign_last_rotamers_to_pose( *daemon_poses_[ ii ] );
+	for ( std::list< NPDIndAndCalc >::const_iterator
+			npditer = npd_calcs_for_poses_[ ii ].begin(),
+			npditer_end = npd_calcs_for_poses_[ ii ].end();
+			npditer != npditer_end; ++npditer ) {
+		core::Real const npd_property = npditer->second->calculate( *daemon_poses_[ ii ] );
+		npd_properties.push_back( std::make_pair( npditer->first, npd_property ));
+		//std::cout << "Computed non-pairwise decomposable property " << npd_property << " for npdindex " << npditer->first << std::endl;
 	}
+
 #ifdef APL_MEASURE_MSD_LOAD_BALANCE
-	std::clock_t stoptime = clock();
-	packing_runtime_ = ((double) midtime  - starttime ) / CLOCKS_PER_SEC;
-	npd_runtime_     = ((double) stoptime - midtime   ) / CLOCKS_PER_SEC;
+	daemon_npd_runtimes_[ ii ] = runtime_seconds() - midtime;
 #endif
-	return std::make_pair( daemon_scores, npd_properties );
 }
 
 DaemonSet::ConstDaemonList
@@ -231,6 +231,11 @@ public:
 	/// DoubleLazyInteractionGraph;
 	void set_dlig_nmeg_limit( Size setting );
 
+	/// @brief the number of threads that repack the states of an entity at once
+	/// (0 = hardware concurrency; multithreaded builds only).  Each state is repacked
+	/// by one thread at a time with the interaction graph built by setup_daemons().
+	void set_n_threads( Size setting );
+
 	void add_npdpro_calculator_creator( NPDPropCalculatorCreatorOP );
 
 	/// @brief Each daemon is associated with an index representing its position in
@@ -332,6 +337,16 @@ private:
 	/// @brief Call MPI_Finalize and exit.
 	void graceful_exit() const;
 
+	/// @brief Repack daemon ii for the entity and compute the non-pairwise decomposable
+	/// properties of its pose.
+	void
+	compute_daemon_energy_for_assignment(
+		Size ii,
+		Entity const & entity,
+		core::Real & energy,
+		SizeRealPairs & npd_properties
+	);
+
 private:
 	ScoreFunctionOP                                      score_function_;
 	core::Size                                           num_entities_;
@@ -341,6 +356,7 @@ private:
 
 	bool                                                 limit_dlig_mem_usage_;
 	Size                                                 dlig_nmeg_limit_;
+	Size                                                 n_threads_;
 
 
 	core::pack::task::PackerTaskOP                       entity_task_;
@@ -356,8 +372,14 @@ private:
 	Size                                                 n_npd_properties_;
 
 #ifdef APL_MEASURE_MSD_LOAD_BALANCE
+	/// @brief seconds spent repacking and computing the non-pairwise decomposable properties
+	/// for the last entity, summed over the daemons; with several threads, the sums can exceed
+	/// the time the entity took
 	core::Real packing_runtime_;
 	core::Real npd_runtime_;
+	/// @brief the same, for each daemon; each daemon's thread writes only its own entries
+	utility::vector1< core::Real > daemon_packing_runtimes_;
+	utility::vector1< core::Real > daemon_npd_runtimes_;
 #endif
 
 };
@@ -38,9 +38,12 @@
 #include <utility/json_spirit/json_spirit_writer.h>
 #include <utility/json_spirit/json_spirit_reader.h>
 #include <utility/file/file_sys_util.hh>
+#include <utility/thread/parallel_for.hh>
 #include <utility/thread/threadsafe_creation.hh>
 
 //STL headers
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <map>
@@ -49,6 +52,7 @@
 // Boost headers
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <boost/cstdint.hpp>
 
 namespace protocols {
 namespace qsar {
@@ -56,6 +60,122 @@ namespace scoring_grid {
 
 static THREAD_LOCAL basic::Tracer GridManagerTracer( "protocols.qsar.scoring_grid.GridManager" );
 
+namespace {
+
+/// @brief how update_grids() fills each grid: without excluding a chain, excluding one chain or excluding a list of chains
+struct GridRefresh {
+	enum Exclusion { no_chain, one_chain, chain_list };
+
+	GridRefresh(core::pose::Pose const & pose_in, core::Vector const & center_in, core::Real width_in, core::Real resolution_in, char chain_in) :
+		pose(pose_in),
+		center(center_in),
+		width(width_in),
+		resolution(resolution_in),
+		chain(chain_in),
+		exclusion(no_chain),
+		chain_id_to_exclude(0)
+	{}
+
+	void operator()(GridBase & grid) const
+	{
+		grid.initialize(center,width,resolution);
+		grid.set_chain(chain);
+		switch ( exclusion ) {
+		case one_chain :
+			grid.refresh(pose,center,chain_id_to_exclude);
+			break;
+		case chain_list :
+			grid.refresh(pose,center,chain_ids_to_exclude);
+			break;
+		default :
+			grid.refresh(pose,center);
+		}
+	}
+
+	core::pose::Pose const & pose;
+	core::Vector center;
+	core::Real width;
+	core::Real resolution;
+	char chain;
+	Exclusion exclusion;
+	core::Size chain_id_to_exclude;
+	utility::vector1<core::Size> chain_ids_to_exclude;
+};
+
+/// @brief refresh the ii-th grid of grid_list, for utility::thread::parallel_for()
+void refresh_grid(GridRefresh const & refresh, utility::vector1<GridBaseOP> const & grid_list, core::Size ii)
+{
+	refresh(*grid_list[ii]);
+}
+
+/// @brief initialize and refresh every grid of grids, each on its own thread with -qsar:grid_threads
+void refresh_grids(GridMap const & grids, GridRefresh const & refresh)
+{
+	utility::vector1<GridBaseOP> grid_list;
+	for ( GridMap::const_iterator it = grids.begin(); it != grids.end(); ++it ) {
+		grid_list.push_back(it->second);
+	}
+	core::Size const n = grid_list.size();
+	int const thread_option(basic::options::option[basic::options::OptionKeys::qsar::grid_threads]());
+	core::Size n_threads(thread_option < 0 ? 1 : thread_option);
+
+#if defined MULTI_THREADED && defined CXX11
+	n_threads = utility::thread::parallel_thread_count(n, n_threads);
+	if ( n_threads > 1 ) {
+		GridManagerTracer.Debug << "computing " << n << " grids on " << n_threads << " threads" << std::endl;
+	}
+#else
+	if ( n_threads != 1 && n > 1 ) {
+		static bool warned( false );
+		if ( !warned ) {
+			GridManagerTracer.Warning << "-qsar:grid_threads needs a multithreaded build; grids are computed one at a time." << std::endl;
+			warned = true;
+		}
+	}
+#endif
+	utility::thread::parallel_for(n, n_threads, boost::bind(&refresh_grid, boost::cref(refresh), boost::cref(grid_list), _1));
+}
+
+/// @brief start of a compact grid cache file, followed by the format version and the number of grids
+char const compact_grids_magic[8] = { 'R', 'Q', 'S', 'A', 'R', 'G', 'R', 'D' };
+boost::uint32_t const compact_grids_version = 1;
+
+void write_uint32(std::ostream & out, boost::uint32_t value)
+{
+	char bytes[4];
+	for ( int byte = 0; byte < 4; ++byte ) {
+		bytes[byte] = static_cast<char>((value >> (8*byte)) & 0xff);
+	}
+	out.write(bytes,4);
+}
+
+bool read_uint32(std::istream & in, boost::uint32_t & value)
+{
+	char bytes[4];
+	if ( !in.read(bytes,4) ) return false;
+	value = 0;
+	for ( int byte = 0; byte < 4; ++byte ) {
+		value |= boost::uint32_t(static_cast<unsigned char>(bytes[byte])) << (8*byte);
+	}
+	return true;
+}
+
+void write_string(std::ostream & out, std::string const & value)
+{
+	write_uint32(out,value.size());
+	out.write(value.data(),value.size());
+}
+
+bool read_string(std::istream & in, std::string & value)
+{
+	boost::uint32_t size(0);
+	if ( !read_uint32(in,size) ) return false;
+	value.resize(size);
+	return size == 0 || in.read(&value[0],size);
+}
+
+} // anonymous namespace
+
 #if defined MULTI_THREADED && defined CXX11
 std::atomic< GridManager * > GridManager::instance_( 0 );
 #else
@@ -289,6 +409,43 @@ core::Real GridManager::total_score(core::pose::Pose const & pose, core::Size co
 	}
 }
 
+core::Real GridManager::total_score_and_gradients(core::conformation::UltraLightResidue const & residue, utility::vector1<core::Vector> & atom_gradients)
+{
+	score_map_.clear();
+	atom_gradients.assign(residue.natoms(),core::Vector(0.0));
+
+	core::Real total_score = 0.0;
+	const core::Real max_score = 9999.0;
+	utility::vector1<core::Real> atom_energies;
+	utility::vector1<core::Vector> grid_gradients;
+	for ( GridMap::iterator map_iterator(grid_map_.begin()); map_iterator != grid_map_.end(); ++map_iterator ) {
+		GridBaseOP current_grid(map_iterator->second);
+		core::Real component_score = 0.0;
+		SingleGridOP single_grid(utility::pointer::dynamic_pointer_cast<SingleGrid>(current_grid));
+		if ( single_grid ) {
+			single_grid->atom_energies_and_gradients(residue.coords_vector(),atom_energies,grid_gradients);
+			for ( core::Size atom_index = 1; atom_index <= atom_energies.size(); ++atom_index ) {
+				component_score += atom_energies[atom_index];
+				atom_gradients[atom_index] += grid_gradients[atom_index];
+			}
+		} else {
+			component_score = current_grid->score(residue,max_score,qsar_map_);
+		}
+		total_score += component_score;
+		score_map_.insert(std::make_pair(current_grid->get_type(),component_score));
+	}
+
+	if ( norm_function_ ) {
+		// all normalizations divide the score by a property of the residue
+		core::Real const scale = (*norm_function_)(1.0,*residue.residue());
+		for ( core::Size atom_index = 1; atom_index <= atom_gradients.size(); ++atom_index ) {
+			atom_gradients[atom_index] *= scale;
+		}
+		return total_score*scale;
+	} else {
+		return total_score;
+	}
+}
 
 std::map<std::string,core::Real> GridManager::atom_score(core::pose::Pose const & /*pose*/, core::conformation::Residue const & residue, core::Size atomindex )
 {
@@ -306,25 +463,19 @@ std::map<std::string,core::Real> GridManager::atom_score(core::pose::Pose const
 
 void GridManager::update_grids(core::pose::Pose const & pose, core::Vector const & center,utility::vector1<core::Size> ligand_chain_ids_to_exclude)
 {
-	std::map<std::string,GridBaseOP>::iterator map_iterator(grid_map_.begin());
-	for ( ; map_iterator != grid_map_.end(); ++map_iterator ) {
-		GridBaseOP current_grid(map_iterator->second);
-		current_grid->initialize(center,width_,resolution_);
-		current_grid->set_chain(chain_);
-		current_grid->refresh(pose,center,ligand_chain_ids_to_exclude);
-	}
+	GridRefresh refresh(pose,center,width_,resolution_,chain_);
+	refresh.exclusion = GridRefresh::chain_list;
+	refresh.chain_ids_to_exclude = ligand_chain_ids_to_exclude;
+	refresh_grids(grid_map_,refresh);
 }
 
 
 void GridManager::update_grids(core::pose::Pose const & pose, core::Vector const & center, core::Size const & ligand_chain_id_to_exclude)
 {
-	std::map<std::string,GridBaseOP>::iterator map_iterator(grid_map_.begin());
-	for ( ; map_iterator != grid_map_.end(); ++map_iterator ) {
-		GridBaseOP current_grid(map_iterator->second);
-		current_grid->initialize(center,width_,resolution_);
-		current_grid->set_chain(chain_);
-		current_grid->refresh(pose,center,ligand_chain_id_to_exclude);
-	}
+	GridRefresh refresh(pose,center,width_,resolution_,chain_);
+	refresh.exclusion = GridRefresh::one_chain;
+	refresh.chain_id_to_exclude = ligand_chain_id_to_exclude;
+	refresh_grids(grid_map_,refresh);
 }
 
 
@@ -349,8 +500,13 @@ void GridManager::update_grids(core::pose::Pose const & pose,  core::Vector cons
 
 		//Try to read it off the disk
 		if ( grid_directory_active ) {
-			//files are in the format grid_directory/hash.json.gz
+			//files are in the format grid_directory/hash.grids.gz, or grid_directory/hash.json.gz if written without -qsar:compact_grid_cache
 			std::string directory_path(basic::options::option[basic::options::OptionKeys::qsar::grid_dir]());
+			if ( read_compact_grids(directory_path+"/"+chain_hash+".grids.gz") ) {
+				GridManagerTracer << "successfully read grids from the disk for conformation matching hash" << chain_hash <<std::endl;
+				grid_map_cache_.insert(std::make_pair(chain_hash,grid_map_));
+				return;
+			}
 			utility::io::izstream grid_file(directory_path+"/"+chain_hash+".json.gz");
 			if ( grid_file ) {
 				utility::json_spirit::mValue gridmap_data;
@@ -366,17 +522,7 @@ void GridManager::update_grids(core::pose::Pose const & pose,  core::Vector cons
 
 		GridManagerTracer << "No conformation matching hash: " << chain_hash << " Updating grid and adding it to the cache" <<std::endl;
 
-		std::map<std::string,GridBaseOP>::iterator map_iterator(grid_map_.begin());
-
-		for ( ; map_iterator != grid_map_.end(); ++map_iterator ) {
-
-			GridBaseOP current_grid(map_iterator->second);
-			GridManagerTracer.Debug <<"updating grid " << map_iterator->first << std::endl;
-			current_grid->initialize(center,width_,resolution_);
-			current_grid->set_chain(chain_);
-			current_grid->refresh(pose,center);
-			GridManagerTracer.Debug <<"done updating grid" <<std::endl;
-		}
+		refresh_grids(grid_map_,GridRefresh(pose,center,width_,resolution_,chain_));
 
 		if ( basic::options::option[basic::options::OptionKeys::qsar::max_grid_cache_size].user() &&
 				grid_map_cache_.size() >= core::Size(basic::options::option[basic::options::OptionKeys::qsar::max_grid_cache_size]() ) ) {
@@ -394,10 +540,14 @@ void GridManager::update_grids(core::pose::Pose const & pose,  core::Vector cons
 				progress_file << "temp" <<std::endl;
 				progress_file.close();
 
-				utility::io::ozstream grid_file(directory_path+"/"+chain_hash+".json.gz");
+				if ( basic::options::option[basic::options::OptionKeys::qsar::compact_grid_cache]() ) {
+					write_compact_grids(directory_path+"/"+chain_hash+".grids.gz");
+				} else {
+					utility::io::ozstream grid_file(directory_path+"/"+chain_hash+".json.gz");
 
-				grid_file << utility::json_spirit::write(serialize()) << std::endl;
-				grid_file.close();
+					grid_file << utility::json_spirit::write(serialize()) << std::endl;
+					grid_file.close();
+				}
 				utility::file::file_delete(temp_path);
 
 				GridManagerTracer << "wrote grid matching hash: " << chain_hash << " to disk" <<std::endl;
@@ -487,6 +637,77 @@ void GridManager::deserialize(utility::json_spirit::mArray data)
 	}
 }
 
+void GridManager::write_compact_grids(std::string const & filename)
+{
+	// readers only ever see a complete file: write it under another name and move it into place
+	std::string const partial_filename(filename+".partial.gz");
+	utility::io::ozstream grid_file(partial_filename);
+	std::ostream & out(grid_file);
+	out.write(compact_grids_magic,sizeof(compact_grids_magic));
+	write_uint32(out,compact_grids_version);
+	write_uint32(out,grid_map_.size());
+	for ( GridMap::iterator it = grid_map_.begin(); it != grid_map_.end(); ++it ) {
+		write_string(out,it->first);
+		SingleGridOP single_grid(utility::pointer::dynamic_pointer_cast<SingleGrid>(it->second));
+		if ( single_grid ) {
+			single_grid->set_serialize_values(false);
+			write_string(out,utility::json_spirit::write(single_grid->serialize()));
+			single_grid->set_serialize_values(true);
+			out.put(1);
+			single_grid->write_values(out);
+		} else {
+			write_string(out,utility::json_spirit::write(it->second->serialize()));
+			out.put(0);
+		}
+	}
+	bool const good(out.good());
+	grid_file.close();
+
+	if ( !good || std::rename(partial_filename.c_str(),filename.c_str()) != 0 ) {
+		GridManagerTracer.Warning << "could not write grids to " << filename << std::endl;
+		utility::file::file_delete(partial_filename);
+	}
+}
+
+bool GridManager::read_compact_grids(std::string const & filename)
+{
+	if ( !utility::file::file_exists(filename) ) return false;
+	utility::io::izstream grid_file(filename);
+	if ( !grid_file ) return false;
+	std::istream & in(grid_file);
+
+	char magic[sizeof(compact_grids_magic)];
+	boost::uint32_t version(0);
+	boost::uint32_t n_grids(0);
+	if ( !in.read(magic,sizeof(magic)) || std::memcmp(magic,compact_grids_magic,sizeof(magic)) != 0 ||
+			!read_uint32(in,version) || version != compact_grids_version || !read_uint32(in,n_grids) ) {
+		GridManagerTracer.Warning << filename << " is not a grid cache file of this version, ignoring it" << std::endl;
+		return false;
+	}
+
+	GridMap grids;
+	for ( core::Size grid_index = 1; grid_index <= n_grids; ++grid_index ) {
+		std::string grid_name;
+		std::string record;
+		utility::json_spirit::mValue grid_data;
+		if ( !read_string(in,grid_name) || !read_string(in,record) || !utility::json_spirit::read(record,grid_data) ) {
+			GridManagerTracer.Warning << filename << " is incomplete, ignoring it" << std::endl;
+			return false;
+		}
+		GridBaseOP grid(GridFactory::get_instance()->new_grid(grid_data.get_obj()));
+		if ( in.get() == 1 ) {
+			SingleGridOP single_grid(utility::pointer::dynamic_pointer_cast<SingleGrid>(grid));
+			if ( !single_grid || !single_grid->read_values(in) ) {
+				GridManagerTracer.Warning << filename << " is incomplete, ignoring it" << std::endl;
+				return false;
+			}
+		}
+		grids[grid_name] = grid;
+	}
+	grid_map_ = grids;
+	return true;
+}
+
 bool GridManager::is_in_grid(core::conformation::UltraLightResidue const & residue)
 {
 	std::map<std::string,GridBaseOP>::iterator map_iterator(grid_map_.begin());
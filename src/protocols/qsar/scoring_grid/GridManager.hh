@@ -85,6 +85,10 @@ public:
 	core::Real total_score(core::conformation::Residue const & residue);
 	/// @brief return the total score of a chain on the grid
 	core::Real total_score(core::pose::Pose const & pose, core::Size const chain_id);
+	/// @brief return the total score of a residue on the grid with the SingleGrids interpolated tricubically,
+	/// and fill atom_gradients with the derivative of that score with respect to each atom position.
+	/// Grids that are not SingleGrids add their score without a gradient.
+	core::Real total_score_and_gradients(core::conformation::UltraLightResidue const & residue, utility::vector1<core::Vector> & atom_gradients);
 	/// @brief get a map of scoring terms and scores for each term given a residue and atom number
 	std::map<std::string,core::Real> atom_score(core::pose::Pose const & pose, core::conformation::Residue const & residue, core::Size atomindex );
 	/// @brief recalculate all grids for a pose.  This must be called if the backbone or sidechain conformations change!
@@ -123,6 +127,11 @@ private:
 	utility::json_spirit::Value serialize();
 	/// @brief deserialize the JSON object to a map.  There is no public interface for this because the grid manager takes care of it on its own
 	void deserialize(utility::json_spirit::mArray data);
+	/// @brief write the current map to a compact grid cache file: per grid its name and JSON record, with the
+	/// values of SingleGrids stored as binary floats after the record instead of inside it
+	void write_compact_grids(std::string const & filename);
+	/// @brief read a compact grid cache file into the current map; false if the file is missing or incomplete
+	bool read_compact_grids(std::string const & filename);
 
 
 #ifdef MULTI_THREADED
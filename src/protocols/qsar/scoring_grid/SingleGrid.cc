@@ -28,6 +28,13 @@
 #include <numeric/xyz.json.hh>
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <boost/cstdint.hpp>
 
 namespace protocols {
 namespace qsar {
@@ -36,7 +43,33 @@ namespace scoring_grid {
 static THREAD_LOCAL basic::Tracer GridBaseTracer( "protocols.qsar.scoring_grid.SingleGrid" );
 
 
-SingleGrid::SingleGrid(std::string type) : type_(type),chain_('A')
+/// @brief the Catmull-Rom weights of the four voxels around a point at fraction t between the middle two,
+/// and their derivatives with respect to t
+static void catmull_rom_weights(core::Real t, core::Real weights[4], core::Real derivatives[4])
+{
+	core::Real const t2 = t*t;
+	core::Real const t3 = t2*t;
+	weights[0] = 0.5*(-t3 + 2*t2 - t);
+	weights[1] = 0.5*(3*t3 - 5*t2 + 2);
+	weights[2] = 0.5*(-3*t3 + 4*t2 + t);
+	weights[3] = 0.5*(t3 - t2);
+	derivatives[0] = 0.5*(-3*t2 + 4*t - 1);
+	derivatives[1] = 0.5*(9*t2 - 10*t);
+	derivatives[2] = 0.5*(-9*t2 + 8*t + 1);
+	derivatives[3] = 0.5*(3*t2 - 2*t);
+}
+
+/// @brief the first of the four voxels used along one axis and the fraction of the way between the middle two
+static int tricubic_stencil(core::Real coordinate, core::Real base, core::Real length, core::Real & t)
+{
+	// voxel values sit at the voxel centers
+	core::Real const u = (coordinate - base)/length - 0.5;
+	core::Real const lower = std::floor(u);
+	t = u - lower;
+	return static_cast<int>(lower) - 1;
+}
+
+SingleGrid::SingleGrid(std::string type) : type_(type),chain_('A'),serialize_values_(true)
 {
 
 }
@@ -72,7 +105,15 @@ utility::json_spirit::Value SingleGrid::serialize()
 	Pair type_record("type",Value(type_));
 	Pair center_record("center",numeric::serialize(center_));
 	Pair chain_record("chain",Value(chain_));
-	Pair grid_record("grid_data",grid_.serialize());
+	Value grid_data(grid_.serialize());
+	if ( !serialize_values_ ) {
+		utility::json_spirit::Object grid_fields(grid_data.get_obj());
+		for ( utility::json_spirit::Object::iterator it = grid_fields.begin(); it != grid_fields.end(); ++it ) {
+			if ( it->name_ == "data" ) it->value_ = Value(std::string());
+		}
+		grid_data = Value(grid_fields);
+	}
+	Pair grid_record("grid_data",grid_data);
 
 	return Value(utility::tools::make_vector(type_record,center_record,chain_record,grid_record));
 
@@ -89,6 +130,59 @@ void SingleGrid::deserialize(utility::json_spirit::mObject data)
 
 }
 
+void SingleGrid::set_serialize_values(bool setting)
+{
+	serialize_values_ = setting;
+}
+
+void SingleGrid::write_values(std::ostream & out) const
+{
+	int x_size(0);
+	int y_size(0);
+	int z_size(0);
+	grid_.getNumberOfPoints(x_size,y_size,z_size);
+
+	std::vector<char> buffer(4*z_size);
+	for ( int x_index = 0; x_index < x_size; ++x_index ) {
+		for ( int y_index = 0; y_index < y_size; ++y_index ) {
+			for ( int z_index = 0; z_index < z_size; ++z_index ) {
+				float const value = static_cast<float>(grid_.getValue(x_index,y_index,z_index));
+				boost::uint32_t bits;
+				std::memcpy(&bits,&value,4);
+				for ( int byte = 0; byte < 4; ++byte ) {
+					buffer[4*z_index+byte] = static_cast<char>((bits >> (8*byte)) & 0xff);
+				}
+			}
+			out.write(&buffer[0],buffer.size());
+		}
+	}
+}
+
+bool SingleGrid::read_values(std::istream & in)
+{
+	int x_size(0);
+	int y_size(0);
+	int z_size(0);
+	grid_.getNumberOfPoints(x_size,y_size,z_size);
+
+	std::vector<char> buffer(4*z_size);
+	for ( int x_index = 0; x_index < x_size; ++x_index ) {
+		for ( int y_index = 0; y_index < y_size; ++y_index ) {
+			if ( !in.read(&buffer[0],buffer.size()) ) return false;
+			for ( int z_index = 0; z_index < z_size; ++z_index ) {
+				boost::uint32_t bits(0);
+				for ( int byte = 0; byte < 4; ++byte ) {
+					bits |= boost::uint32_t(static_cast<unsigned char>(buffer[4*z_index+byte])) << (8*byte);
+				}
+				float value;
+				std::memcpy(&value,&bits,4);
+				grid_.setValue(x_index,y_index,z_index,value);
+			}
+		}
+	}
+	return true;
+}
+
 void SingleGrid::set_chain(char chain)
 {
 	chain_ = chain;
@@ -241,6 +335,98 @@ core::Real SingleGrid::atom_score(core::conformation::Residue const & residue, c
 
 }
 
+core::Real SingleGrid::tricubic_value(core::Vector const & xyz, core::Vector & gradient) const
+{
+	gradient = core::Vector(0.0);
+	if ( !grid_.is_in_grid(xyz.x(),xyz.y(),xyz.z()) ) {
+		return 0.0;
+	}
+
+	int n[3];
+	grid_.getNumberOfPoints(n[0],n[1],n[2]);
+	core::Vector const base(grid_.getBase());
+	core::Vector const extent(grid_.getTop()-base);
+	core::Vector const length(extent.x()/n[0],extent.y()/n[1],extent.z()/n[2]);
+
+	// per axis: the indices of the four voxels of the stencil, clamped to the grid, and their weights
+	int index[3][4];
+	core::Real weight[3][4];
+	core::Real derivative[3][4];
+	for ( int axis = 0; axis < 3; ++axis ) {
+		core::Real t(0.0);
+		int const first = tricubic_stencil(xyz[axis],base[axis],length[axis],t);
+		for ( int k = 0; k < 4; ++k ) {
+			index[axis][k] = std::min(std::max(first+k,0),n[axis]-1);
+		}
+		catmull_rom_weights(t,weight[axis],derivative[axis]);
+	}
+
+	core::Real values[4][4][4];
+	for ( int i = 0; i < 4; ++i ) {
+		for ( int j = 0; j < 4; ++j ) {
+			for ( int k = 0; k < 4; ++k ) {
+				values[i][j][k] = grid_.getValue(index[0][i],index[1][j],index[2][k]);
+			}
+		}
+	}
+
+	// contract the stencil one axis at a time; the fixed length inner loops vectorize
+	core::Real along_z[4][4];
+	core::Real along_z_dz[4][4];
+	for ( int i = 0; i < 4; ++i ) {
+		for ( int j = 0; j < 4; ++j ) {
+			core::Real value(0.0);
+			core::Real dz(0.0);
+			for ( int k = 0; k < 4; ++k ) {
+				value += weight[2][k]*values[i][j][k];
+				dz += derivative[2][k]*values[i][j][k];
+			}
+			along_z[i][j] = value;
+			along_z_dz[i][j] = dz;
+		}
+	}
+	core::Real along_y[4];
+	core::Real along_y_dy[4];
+	core::Real along_y_dz[4];
+	for ( int i = 0; i < 4; ++i ) {
+		core::Real value(0.0);
+		core::Real dy(0.0);
+		core::Real dz(0.0);
+		for ( int j = 0; j < 4; ++j ) {
+			value += weight[1][j]*along_z[i][j];
+			dy += derivative[1][j]*along_z[i][j];
+			dz += weight[1][j]*along_z_dz[i][j];
+		}
+		along_y[i] = value;
+		along_y_dy[i] = dy;
+		along_y_dz[i] = dz;
+	}
+	core::Real value(0.0);
+	core::Real dx(0.0);
+	core::Real dy(0.0);
+	core::Real dz(0.0);
+	for ( int i = 0; i < 4; ++i ) {
+		value += weight[0][i]*along_y[i];
+		dx += derivative[0][i]*along_y[i];
+		dy += weight[0][i]*along_y_dy[i];
+		dz += weight[0][i]*along_y_dz[i];
+	}
+
+	gradient = core::Vector(dx/length.x(),dy/length.y(),dz/length.z());
+	return value;
+}
+
+void SingleGrid::atom_energies_and_gradients(
+	utility::vector1<core::Vector> const & coords,
+	utility::vector1<core::Real> & energies,
+	utility::vector1<core::Vector> & gradients) const
+{
+	energies.resize(coords.size());
+	gradients.resize(coords.size());
+	for ( core::Size atom_index = 1; atom_index <= coords.size(); ++atom_index ) {
+		energies[atom_index] = tricubic_value(coords[atom_index],gradients[atom_index]);
+	}
+}
 
 std::list<std::pair<core::Vector, core::Real> >
 SingleGrid::get_point_value_list_within_range(
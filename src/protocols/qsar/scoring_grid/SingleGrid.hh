@@ -29,6 +29,7 @@
 #include <numeric/interpolation/spline/SplineGenerator.hh>
 #include <numeric/xyzVector.hh>
 
+#include <iosfwd>
 #include <list>
 
 #ifdef WIN32
@@ -64,6 +65,14 @@ public:
 	virtual utility::json_spirit::Value serialize();
 	/// @brief deserialize a json_spirit object to a SingleGrid
 	virtual void deserialize(utility::json_spirit::mObject data);
+	/// @brief with false, serialize() leaves the grid values out of its record (as an empty "data" string)
+	/// so that they can be stored in binary by write_values() instead
+	void set_serialize_values(bool setting);
+	/// @brief write the grid values as little endian 32 bit floats, x slowest and z fastest
+	void write_values(std::ostream & out) const;
+	/// @brief read the grid values written by write_values() into a grid of the same dimensions;
+	/// false if the stream ended early
+	bool read_values(std::istream & in);
 	/// @brief return a constant reference to the grid
 	core::grid::CartGrid<core::Real> const &  get_grid();
 	/// @brief set the grid type
@@ -96,6 +105,15 @@ public:
 	virtual core::Real score(core::conformation::Residue const & residue, core::Real const max_score, qsarMapOP qsar_map);
 	/// @brief return the current score of an atom using the current grid
 	virtual core::Real atom_score(core::conformation::Residue const & residue, core::Size atomno, qsarMapOP qsar_map);
+	/// @brief the grid value at xyz by tricubic (Catmull-Rom) interpolation between the voxel centers, and its
+	/// gradient.  Unlike get_point() and score() the value is smooth, so it can be minimized against.  Points
+	/// outside the grid score 0 with a zero gradient.
+	core::Real tricubic_value(core::Vector const & xyz, core::Vector & gradient) const;
+	/// @brief the tricubic values and gradients at every point of coords, e.g. the atoms of an UltraLightResidue
+	void atom_energies_and_gradients(
+		utility::vector1<core::Vector> const & coords,
+		utility::vector1<core::Real> & energies,
+		utility::vector1<core::Vector> & gradients) const;
 	void grid_to_kin(utility::io::ozstream & out, core::Real min_val, core::Real max_val, core::Size stride);
 	//void grid_rotamer_trials(core::pose::Pose &  pose, core::Size residue_id, int const min_score);
 	/// @brief check to see if residue is in grid
@@ -127,6 +145,7 @@ private:
 	std::string type_;
 	core::Vector center_;
 	char chain_;
+	bool serialize_values_;
 
 };
 
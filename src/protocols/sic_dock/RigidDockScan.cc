@@ -0,0 +1,167 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   protocols/sic_dock/RigidDockScan.cc
+/// @brief  exhaustive rotational/translational two-body docking scan with slide-into-contact
+
+#include <protocols/sic_dock/RigidDockScan.hh>
+#include <protocols/sic_dock/SICFast.hh>
+#include <protocols/sic_dock/RigidScore.hh>
+#include <protocols/sic_dock/util.hh>
+#include <basic/sampling/orientations/QuaternionGrid.hh>
+#include <basic/Tracer.hh>
+#include <numeric/constants.hh>
+#include <utility/exit.hh>
+#include <utility/thread/parallel_for.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <ostream>
+
+#if defined MULTI_THREADED && defined CXX11
+#include <chrono>
+#endif
+
+namespace protocols {
+namespace sic_dock {
+
+static THREAD_LOCAL basic::Tracer TR( "protocols.sic_dock.RigidDockScan" );
+
+using core::Size;
+using core::Real;
+
+utility::vector1<Vec>
+sphere_directions( Size ndir ){
+	utility::vector1<Vec> dirs;
+	Real const golden_angle = numeric::constants::d::pi * ( 3.0 - std::sqrt(5.0) );
+	for ( Size i = 0; i < ndir; ++i ) {
+		Real const z = 1.0 - ( 2.0*i + 1.0 ) / (Real)ndir;
+		Real const r = std::sqrt( std::max( 0.0, 1.0 - z*z ) );
+		Real const phi = golden_angle * i;
+		dirs.push_back( Vec( r*std::cos(phi), r*std::sin(phi), z ) );
+	}
+	return dirs;
+}
+
+RigidDockScan::RigidDockScan(
+	SICFastCOP sic,
+	RigidScoreCOP score,
+	basic::sampling::orientations::QuaternionGridCOP rotations,
+	Size ndirections,
+	Size top_k
+):
+	sic_(sic),
+	score_(score),
+	rotations_(rotations),
+	directions_( sphere_directions(ndirections) ),
+	top_k_(top_k),
+	nthreads_(1),
+	min_score_(0.0),
+	nsamples_(0),
+	seconds_(0.0)
+{
+	if ( !sic_ || !score_ || !rotations_ ) utility_exit_with_message("RigidDockScan needs a SICFast, a RigidScore and a QuaternionGrid");
+	if ( top_k_ == 0 ) utility_exit_with_message("RigidDockScan top_k must be > 0");
+}
+
+RigidDockScan::~RigidDockScan() {}
+
+void
+RigidDockScan::push_result(
+	utility::vector1<RigidDockScanResult> & heap,
+	RigidDockScanResult const & r
+) const {
+	// heap front is the worst kept result
+	if ( heap.size() == top_k_ ) {
+		if ( !RigidDockScanResultBetter()( r, heap.front() ) ) return;
+		std::pop_heap( heap.begin(), heap.end(), RigidDockScanResultBetter() );
+		heap.pop_back();
+	}
+	heap.push_back(r);
+	std::push_heap( heap.begin(), heap.end(), RigidDockScanResultBetter() );
+}
+
+void
+RigidDockScan::scan_rotations(
+	Size ibeg,
+	Size stride,
+	utility::vector1<RigidDockScanResult> & heap,
+	Size & nsamples
+) const {
+	Xform const xfix;
+	long const nrot = rotations_->num_samples();
+	for ( long irot = (long)ibeg; irot <= nrot; irot += (long)stride ) {
+		Mat const R = rotations_->quaternion(irot).rotation_matrix();
+		for ( Size idir = 1; idir <= directions_.size(); ++idir ) {
+			++nsamples;
+			Xform xmob( R, Vec(0,0,0) );
+			// both bodies start overlapped at the origin; d is how far body 1 moves along ori to just touch
+			Real s = 0.0;
+			Real const d = slide_into_contact_and_score( *sic_, *score_, xmob, xfix, directions_[idir], s );
+			if ( d > 9e8 ) continue; // never touches
+			if ( s <= min_score_ ) continue;
+			push_result( heap, RigidDockScanResult(s,irot,idir,xmob) );
+		}
+	}
+}
+
+utility::vector1<RigidDockScanResult> const &
+RigidDockScan::run() {
+	results_.clear();
+	nsamples_ = 0;
+
+	Size nthreads = 1;
+#if defined MULTI_THREADED && defined CXX11
+	std::chrono::steady_clock::time_point const start_time = std::chrono::steady_clock::now();
+	nthreads = utility::thread::parallel_thread_count( rotations_->num_samples(), nthreads_ );
+#else
+	std::clock_t const start_time = std::clock();
+#endif
+
+	utility::vector1< utility::vector1<RigidDockScanResult> > heaps(nthreads);
+	utility::vector1<Size> nsamples(nthreads,0);
+
+#if defined MULTI_THREADED && defined CXX11
+	utility::thread::parallel_for( nthreads, nthreads, [&]( Size ithread, Size ) {
+		scan_rotations( ithread, nthreads, heaps[ithread], nsamples[ithread] );
+	} );
+#else
+	scan_rotations( 1, 1, heaps[1], nsamples[1] );
+#endif
+
+	// merge per-thread heaps
+	for ( Size ithread = 1; ithread <= nthreads; ++ithread ) {
+		nsamples_ += nsamples[ithread];
+		for ( Size i = 1; i <= heaps[ithread].size(); ++i ) push_result( results_, heaps[ithread][i] );
+	}
+	std::sort( results_.begin(), results_.end(), RigidDockScanResultBetter() );
+
+#if defined MULTI_THREADED && defined CXX11
+	seconds_ = std::chrono::duration<Real>( std::chrono::steady_clock::now() - start_time ).count();
+#else
+	seconds_ = Real( std::clock() - start_time ) / CLOCKS_PER_SEC;
+#endif
+	TR << "scanned " << rotations_->num_samples() << " rotations x " << directions_.size() << " directions ("
+		<< nsamples_ << " samples) on " << nthreads << " thread(s) in " << seconds_ << "s, "
+		<< ( seconds_ > 0.0 ? nsamples_/seconds_ : 0.0 ) << " samples/s, kept " << results_.size() << std::endl;
+	return results_;
+}
+
+void
+RigidDockScan::show( std::ostream & out ) const {
+	for ( Size i = 1; i <= results_.size(); ++i ) {
+		RigidDockScanResult const & r( results_[i] );
+		out << "RigidDockScan " << i << " score " << r.score << " rot " << r.irot << " dir " << r.idir
+			<< " trans " << r.xform.t.x() << " " << r.xform.t.y() << " " << r.xform.t.z() << std::endl;
+	}
+}
+
+} // namespace sic_dock
+} // namespace protocols
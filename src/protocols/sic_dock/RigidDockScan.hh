@@ -0,0 +1,116 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   protocols/sic_dock/RigidDockScan.hh
+/// @brief  exhaustive rotational/translational two-body docking scan with slide-into-contact
+/// @details for every rotation in a QuaternionGrid and every approach direction on a sphere, body 1
+/// is slid into contact with the fixed body 2 with SICFast and the contact is scored with a
+/// RigidScore (e.g. CBScore or ResPairScore, both backed by xyzStripeHash). no ScoreFunction is
+/// ever called. the best top_k placements are kept in a heap. rotations are divided among threads
+/// in MULTI_THREADED builds. both bodies are assumed to be centered at the origin, which is how
+/// SICFast::init sees them; the returned Xforms place body 1 relative to the unmoved body 2.
+
+#ifndef INCLUDED_protocols_sic_dock_RigidDockScan_hh
+#define INCLUDED_protocols_sic_dock_RigidDockScan_hh
+
+#include <protocols/sic_dock/RigidDockScan.fwd.hh>
+
+#include <protocols/sic_dock/types.hh>
+#include <protocols/sic_dock/SICFast.fwd.hh>
+#include <protocols/sic_dock/RigidScore.fwd.hh>
+#include <basic/sampling/orientations/QuaternionGrid.fwd.hh>
+#include <core/types.hh>
+#include <utility/vector1.hh>
+#include <utility/pointer/ReferenceCount.hh>
+
+#include <iosfwd>
+
+namespace protocols {
+namespace sic_dock {
+
+/// @brief one scored placement of body 1
+struct RigidDockScanResult {
+	RigidDockScanResult() : score(0.0), irot(0), idir(0) {}
+	RigidDockScanResult(core::Real s, core::Size r, core::Size d, Xform const & x) : score(s), irot(r), idir(d), xform(x) {}
+	core::Real score;
+	core::Size irot, idir;
+	Xform xform;
+};
+
+/// @brief orders results so the best (highest) score compares smallest; sorting with it puts the best first
+/// @details ties are broken by rotation and direction, so the results kept do not depend on the thread count
+struct RigidDockScanResultBetter {
+	bool operator()( RigidDockScanResult const & a, RigidDockScanResult const & b ) const {
+		if ( a.score != b.score ) return a.score > b.score;
+		if ( a.irot != b.irot ) return a.irot < b.irot;
+		return a.idir < b.idir;
+	}
+};
+
+/// @brief approximately uniform unit vectors on the sphere (golden-section spiral)
+utility::vector1<Vec> sphere_directions( core::Size ndir );
+
+class RigidDockScan : public utility::pointer::ReferenceCount {
+public:
+	RigidDockScan(
+		SICFastCOP sic,
+		RigidScoreCOP score,
+		basic::sampling::orientations::QuaternionGridCOP rotations,
+		core::Size ndirections,
+		core::Size top_k
+	);
+
+	virtual ~RigidDockScan();
+
+	/// @brief number of threads to scan rotations with, default 1; 0 means hardware concurrency
+	void nthreads( core::Size n ) { nthreads_ = n; }
+
+	/// @brief placements scoring below this are never kept
+	void min_score( core::Real s ) { min_score_ = s; }
+
+	/// @brief scan all rotations and directions; results sorted best first, at most top_k of them
+	utility::vector1<RigidDockScanResult> const & run();
+
+	utility::vector1<RigidDockScanResult> const & results() const { return results_; }
+
+	/// @brief number of rotation x direction samples slid and scored by the last run()
+	core::Size nsamples() const { return nsamples_; }
+
+	/// @brief wall-clock seconds spent in the last run()
+	core::Real seconds() const { return seconds_; }
+
+	void show( std::ostream & out ) const;
+
+private:
+	/// @brief scan rotations irot = ibeg, ibeg+stride, ... into a private top_k heap
+	void scan_rotations(
+		core::Size ibeg,
+		core::Size stride,
+		utility::vector1<RigidDockScanResult> & heap,
+		core::Size & nsamples
+	) const;
+
+	void push_result( utility::vector1<RigidDockScanResult> & heap, RigidDockScanResult const & r ) const;
+
+private:
+	SICFastCOP sic_;
+	RigidScoreCOP score_;
+	basic::sampling::orientations::QuaternionGridCOP rotations_;
+	utility::vector1<Vec> directions_;
+	core::Size top_k_, nthreads_;
+	core::Real min_score_;
+	utility::vector1<RigidDockScanResult> results_;
+	core::Size nsamples_;
+	core::Real seconds_;
+};
+
+} // namespace sic_dock
+} // namespace protocols
+
+#endif
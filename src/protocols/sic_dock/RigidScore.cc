@@ -26,6 +26,8 @@
 #include <core/id/AtomID_Map.hh>
 #include <core/scoring/sasa.hh>
 #include <core/pose/util.hh>
+#include <core/chemical/AA.hh>
+#include <core/conformation/Residue.hh>
 #include <protocols/loophash/BackboneDB.hh>
 #include <protocols/loophash/LoopHashLibrary.hh>
 #include <protocols/loophash/LoopHashLibrary.fwd.hh>
@@ -159,6 +161,87 @@ CBScore::score(
 	return hash_visitor.score;
 }
 
+ResPairScore::ResPairScore(
+	Pose const & pose1,
+	Pose const & pose2,
+	Real contact_dis,
+	ObjexxFCL::FArray2D<Real> const & table
+):
+	hash_pose1_( pose1_has_most_CBs(pose1,pose2) ),
+	contact_dis_(contact_dis),
+	table_( core::chemical::num_canonical_aas, core::chemical::num_canonical_aas, 0.0f ),
+	xyzhash_(contact_dis)
+{
+	using core::chemical::num_canonical_aas;
+	if ( table.size1() < (Size)num_canonical_aas || table.size2() < (Size)num_canonical_aas ) {
+		utility_exit_with_message("ResPairScore: residue-pair table must be at least num_canonical_aas x num_canonical_aas");
+	}
+	// the visitor looks up table_(hashed aa, other aa); store the table transposed when pose2 is
+	// the hashed pose so that table(aa1,aa2) always pairs an aa of pose1 with an aa of pose2
+	for ( int i = 1; i <= num_canonical_aas; ++i ) {
+		for ( int j = 1; j <= num_canonical_aas; ++j ) table_(i,j) = hash_pose1_ ? table(i,j) : table(j,i);
+	}
+	Pose const & hashpose( hash_pose1_?pose1:pose2 );
+	Pose const & otherpose( hash_pose1_?pose2:pose1 );
+	core::id::AtomID_Map<double> amap;
+	core::pose::initialize_atomid_map(amap,hashpose,-1.0);
+	for ( Size ir = 1; ir <= hashpose.n_residue(); ++ir ) {
+		core::conformation::Residue const & r( hashpose.residue(ir) );
+		if ( !r.has("CB") || r.aa() > num_canonical_aas ) continue;
+		amap[AtomID(r.atom_index("CB"),ir)] = (double)r.aa();
+	}
+	xyzhash_.init_with_pose(hashpose,amap);
+	for ( Size ir = 1; ir <= otherpose.n_residue(); ++ir ) {
+		core::conformation::Residue const & r( otherpose.residue(ir) );
+		if ( !r.has("CB") || r.aa() > num_canonical_aas ) continue;
+		points_.push_back( r.xyz("CB") );
+		aas_.push_back( (Real)r.aa() );
+	}
+}
+
+struct ResPairScoreVisitor {
+	float const contact_dis;
+	ObjexxFCL::FArray2D<float> const & table;
+	float score;
+	ResPairScoreVisitor(
+		float const & contact_dis_in,
+		ObjexxFCL::FArray2D<float> const & table_in
+	):
+		contact_dis(contact_dis_in),
+		table(table_in),
+		score(0.0)
+	{}
+	inline
+	void
+	visit(
+		numeric::xyzVector<float> const & /*v*/,
+		float  const & vm,
+		numeric::xyzVector<float> const & /*c*/,
+		float  const & cm,
+		float  const & d2
+	){
+		score += CBScore_dist_score(d2, 6.0f, contact_dis ) * table( (int)vm, (int)cm );
+	}
+};
+
+core::Real
+ResPairScore::score(
+	Xforms const & x1s,
+	Xforms const & x2s
+) const {
+	ResPairScoreVisitor hash_visitor(contact_dis_,table_);
+	BOOST_FOREACH ( Xform const & x1,x1s ) {
+		BOOST_FOREACH ( Xform const & x2,x2s ) {
+			Xform const xhp(multstubs(invstub(hash_pose1_?x1:x2),hash_pose1_?x2:x1));
+			Reals::const_iterator iaa = aas_.begin();
+			for ( Vecs::const_iterator i = points_.begin(); i != points_.end(); ++i,++iaa ) {
+				xyzhash_.visit(xhp*(*i),*iaa,hash_visitor);
+			}
+		}
+	}
+	return hash_visitor.score;
+}
+
 LinkerScore::LinkerScore(
 	Pose const & pose1,
 	Pose const & pose2,
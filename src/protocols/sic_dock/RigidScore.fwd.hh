@@ -27,6 +27,10 @@ class LinkerScore;
 typedef utility::pointer::shared_ptr< LinkerScore > LinkerScoreOP;
 typedef utility::pointer::shared_ptr< LinkerScore const > LinkerScoreCOP;
 
+class ResPairScore;
+typedef utility::pointer::shared_ptr< ResPairScore > ResPairScoreOP;
+typedef utility::pointer::shared_ptr< ResPairScore const > ResPairScoreCOP;
+
 class ConstraintSetScore;
 typedef utility::pointer::shared_ptr< ConstraintSetScore > ConstraintSetScoreOP;
 typedef utility::pointer::shared_ptr< ConstraintSetScore const > ConstraintSetScoreCOP;
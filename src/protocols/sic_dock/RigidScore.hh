@@ -97,6 +97,31 @@ inline T CBScore_dist_score( T const & sqdist, T const & start, T const & stop )
 	}
 }
 
+/// @brief CB contact score weighted by a precomputed residue-pair table
+/// @details like CBScore, the CBs of the pose with more CBs are hashed, but the hash metadata
+/// is the aa type of each CB, so each contact is weighted by table(aa1,aa2), aa1 from pose1 and aa2
+/// from pose2 whichever pose is hashed. the table is indexed by core::chemical::AA
+/// (1..num_canonical_aas); non-canonical residues are skipped.
+class ResPairScore : public RigidScore {
+public:
+	virtual ~ResPairScore(){}
+	ResPairScore(
+		Pose const & pose1,
+		Pose const & pose2,
+		Real contact_dis,
+		ObjexxFCL::FArray2D<Real> const & table
+	);
+	core::Real score( Xforms const & x1, Xforms const & x2 ) const;
+	std::string type() const { return "ResPairScore"; }
+private:
+	bool const hash_pose1_;
+	core::Real const contact_dis_;
+	ObjexxFCL::FArray2D<float> table_;
+	Reals aas_;
+	Vecs points_;
+	xyzStripeHashPoseWithMeta xyzhash_;
+};
+
 class LinkerScore : public RigidScore {
 public:
 	LinkerScore(
@@ -20,6 +20,7 @@
 #include <protocols/wum/WorkUnitBase.hh>
 #include <protocols/wum/SilentStructStore.hh>
 #include <core/pose/Pose.hh>
+#include <core/io/serialization/compact_pose.hh>
 #include <basic/Tracer.hh>
 
 #include <string>
@@ -82,14 +83,14 @@ void WorkUnitBase::raw_data_load( const unsigned char * raw_data_ptr, unsigned i
 
 	TR.Debug << "Extracting data information " << std::endl;
 	// make sure the last byte of the data block is a 0 ( it should be a 0 terminated string)
-	if ( raw_data_ptr[size-1] != 0 ) {
+	if ( size <= sizeof( WorkUnitBase::WU_Header ) || raw_data_ptr[size-1] != 0 ) {
 		TR.Error << "ERROR: cannot load data - terminal zero not found!" << std::endl;
 		serial_data() = "";
 		return;
 	}
 
-	std::string strdata( & (((char*)raw_data_ptr) [ sizeof( WorkUnitBase::WU_Header ) ]) );
-	serial_data() = strdata;
+	// the data may be binary (see WorkUnit_PoseStore), so take all of it rather than up to the first 0
+	serial_data().assign( (const char*) raw_data_ptr + sizeof( WorkUnitBase::WU_Header ), size - sizeof( WorkUnitBase::WU_Header ) - 1 );
 }
 
 
@@ -234,6 +235,37 @@ WorkUnit_SilentStructStore::deserialize()
 }
 
 
+void
+WorkUnit_PoseStore::add( core::pose::Pose const & pose )
+{
+	poses_.push_back( core::pose::PoseOP( new core::pose::Pose( pose ) ) );
+}
+
+// @brief Write the poses into the serial data store as concatenated compact pose records
+void
+WorkUnit_PoseStore::serialize()
+{
+	serial_data().clear();
+	for ( core::Size i = 1; i <= poses_.size(); ++i ) {
+		core::io::serialization::write_compact_pose( *poses_[i], serial_data(), compress_ );
+	}
+}
+
+// @brief Read the poses from the serial data store. Overwrite what's in the pose store.
+void
+WorkUnit_PoseStore::deserialize()
+{
+	poses_.clear();
+	std::string const & data( serial_data() );
+	core::Size offset = 0;
+	while ( offset < data.size() ) {
+		core::pose::PoseOP pose( new core::pose::Pose );
+		offset += core::io::serialization::read_compact_pose( data.data() + offset, data.size() - offset, *pose );
+		poses_.push_back( pose );
+	}
+}
+
+
 WorkUnit_MoverWrapper::WorkUnit_MoverWrapper( protocols::moves::MoverOP the_mover ):
 	WorkUnit_SilentStructStore(),
 	the_mover_(the_mover )
@@ -31,6 +31,10 @@ class WorkUnit_SilentStructStore;
 typedef utility::pointer::shared_ptr< WorkUnit_SilentStructStore > WorkUnit_SilentStructStoreOP;
 typedef utility::pointer::shared_ptr< WorkUnit_SilentStructStore const > WorkUnit_SilentStructStoreCOP;
 
+class WorkUnit_PoseStore;
+typedef utility::pointer::shared_ptr< WorkUnit_PoseStore > WorkUnit_PoseStoreOP;
+typedef utility::pointer::shared_ptr< WorkUnit_PoseStore const > WorkUnit_PoseStoreCOP;
+
 class WorkUnit_MoverWrapper;
 typedef utility::pointer::shared_ptr< WorkUnit_MoverWrapper > WorkUnit_MoverWrapperOP;
 typedef utility::pointer::shared_ptr< WorkUnit_MoverWrapper const > WorkUnit_MoverWrapperCOP;
@@ -248,6 +248,51 @@ private:
 };
 
 
+/// @brief This WorkUnit type carries full poses, sent as compact binary pose records
+/// (core/io/serialization/compact_pose.hh) rather than silent structures, so that neither side has
+/// to convert them.
+class WorkUnit_PoseStore : public WorkUnitBase {
+public:
+	WorkUnit_PoseStore( bool compress = false ):
+		WorkUnitBase (),
+		compress_( compress )
+	{
+	}
+
+	virtual ~WorkUnit_PoseStore(){}
+
+	virtual protocols::wum::WorkUnitBaseOP clone() const {
+		return protocols::wum::WorkUnitBaseOP( new WorkUnit_PoseStore( *this ) );
+	}
+
+	/// @brief This Work unit doesnt do *anything* - its just keeps the poses
+	virtual void run(){};
+
+	/// @brief write the poses into serial data store overwriting whatever was there before.
+	virtual void serialize();
+
+	/// @brief Make ready for working
+	virtual void deserialize();
+
+	/// @brief Add a copy of pose
+	void add( core::pose::Pose const & pose );
+
+	/// @brief Accessor for the poses
+	const utility::vector1< core::pose::PoseOP >& poses() const { return poses_; }
+
+	/// @brief Accessor for the poses
+	utility::vector1< core::pose::PoseOP >& poses(){ return poses_; }
+
+	/// @brief zlib-compress the records: smaller messages at some cost in speed
+	void set_compress( bool compress ){ compress_ = compress; }
+
+private:
+	utility::vector1< core::pose::PoseOP > poses_;
+
+	bool compress_;
+};
+
+
 /// @brief This WorkUnit type can encapsulate any MoverOP. When registering this WOrkunit
 /// provide it with a MoverOP and then, when executed on the slaves, this workunit will run the mover
 /// On every single input structure and return the results.
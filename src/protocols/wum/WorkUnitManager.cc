@@ -139,12 +139,15 @@ void WorkUnitManager::write_queue( const WorkUnitQueue &the_queue, std::ostream
 }
 
 
-void WorkUnitManager::write_work_unit( const WorkUnitBaseOP& MPI_ONLY(wu), std::ostream& MPI_ONLY( out ) ) const {
-#ifdef USEMPI
+void WorkUnitManager::write_work_unit( const WorkUnitBaseOP& wu, std::ostream& out ) const {
 	// serialize data
+#ifdef USEMPI
 	double time1=MPI_Wtime();
+#endif
 	wu->serialize();
+#ifdef USEMPI
 	double time2=MPI_Wtime();
+#endif
 	// now send data
 	int size_of_raw_data;
 	unsigned char * raw_data_ptr=NULL;
@@ -157,6 +160,7 @@ void WorkUnitManager::write_work_unit( const WorkUnitBaseOP& MPI_ONLY(wu), std::
 	delete [] raw_data_ptr;
 	TR.Debug << "  Deleted temp data.. " << std::endl;
 	wu->clear_serial_data();
+#ifdef USEMPI
 	double time3=MPI_Wtime();
 	TR.Debug << "S: " << time3-time2 << "  " << time2-time1 << "  " << std::endl;
 #endif
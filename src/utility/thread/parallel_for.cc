@@ -0,0 +1,189 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   utility/thread/parallel_for.cc
+/// @brief  Run the items of a loop on the threads of a persistent pool
+
+// Unit headers
+#include <utility/thread/parallel_for.hh>
+
+#if defined MULTI_THREADED && defined CXX11
+// C++11 headers
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace utility {
+namespace thread {
+
+using platform::Size;
+
+#if defined MULTI_THREADED && defined CXX11
+
+namespace {
+
+/// @brief One parallel_for() call.  The slots are the thread indices; slot 1 is the calling
+/// thread's, and the pool threads take the others.
+struct ParallelForBatch {
+	ParallelForBatch( Size n_items_in, Size n_slots_in, ParallelForWork const & work_in ) :
+		work( work_in ),
+		n_items( n_items_in ),
+		next_item( 1 ),
+		failed( false ),
+		n_slots( n_slots_in ),
+		last_slot( 1 ),
+		n_helpers_running( 0 )
+	{}
+
+	ParallelForWork const & work;
+	Size const n_items;
+	std::atomic< Size > next_item;
+	std::atomic< bool > failed;
+	std::mutex error_mutex;
+	std::exception_ptr error;
+
+	// guarded by the pool's mutex
+	Size const n_slots;
+	Size last_slot;
+	Size n_helpers_running;
+};
+
+void
+run_items( ParallelForBatch & batch, Size const slot )
+{
+	while ( ! batch.failed ) {
+		Size const item = batch.next_item++;
+		if ( item > batch.n_items ) return;
+		try {
+			batch.work( item, slot );
+		} catch ( ... ) {
+			std::lock_guard< std::mutex > lock( batch.error_mutex );
+			if ( ! batch.error ) batch.error = std::current_exception();
+			batch.failed = true;
+		}
+	}
+}
+
+/// @brief Threads that wait for batches with open slots.  The pool grows to the most threads any
+/// batch has asked for, and its threads live until the program exits.
+class ParallelForPool
+{
+public:
+	static ParallelForPool &
+	get_instance()
+	{
+		static ParallelForPool pool;
+		return pool;
+	}
+
+	~ParallelForPool()
+	{
+		{
+			std::lock_guard< std::mutex > lock( mutex_ );
+			shutdown_ = true;
+		}
+		batch_ready_.notify_all();
+		for ( Size ii = 0; ii < threads_.size(); ++ii ) threads_[ ii ].join();
+	}
+
+	void
+	run( ParallelForBatch & batch )
+	{
+		{
+			std::lock_guard< std::mutex > lock( mutex_ );
+			while ( threads_.size() + 1 < batch.n_slots ) {
+				threads_.push_back( std::thread( &ParallelForPool::thread_loop, this ) );
+			}
+			batches_.push_back( &batch );
+		}
+		batch_ready_.notify_all();
+
+		run_items( batch, 1 );
+
+		// close the batch to pool threads that have not joined yet, and wait for those that have
+		std::unique_lock< std::mutex > lock( mutex_ );
+		std::deque< ParallelForBatch * >::iterator iter = std::find( batches_.begin(), batches_.end(), &batch );
+		if ( iter != batches_.end() ) batches_.erase( iter );
+		helper_done_.wait( lock, [ &batch ]{ return batch.n_helpers_running == 0; } );
+	}
+
+private:
+	ParallelForPool() : shutdown_( false ) {}
+
+	void
+	thread_loop()
+	{
+		std::unique_lock< std::mutex > lock( mutex_ );
+		while ( true ) {
+			batch_ready_.wait( lock, [ this ]{ return shutdown_ || ! batches_.empty(); } );
+			if ( shutdown_ ) return;
+
+			ParallelForBatch & batch( *batches_.front() );
+			Size const slot = ++batch.last_slot;
+			if ( batch.last_slot == batch.n_slots ) batches_.pop_front();
+			++batch.n_helpers_running;
+
+			lock.unlock();
+			run_items( batch, slot );
+			lock.lock();
+
+			if ( --batch.n_helpers_running == 0 ) helper_done_.notify_all();
+		}
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable batch_ready_;
+	std::condition_variable helper_done_;
+	std::deque< ParallelForBatch * > batches_;
+	std::vector< std::thread > threads_;
+	bool shutdown_;
+};
+
+}
+
+#endif
+
+Size
+parallel_thread_count( Size const n_items, Size n_threads )
+{
+#if defined MULTI_THREADED && defined CXX11
+	if ( n_threads == 0 ) n_threads = std::thread::hardware_concurrency();
+#else
+	n_threads = 1;
+#endif
+	if ( n_threads > n_items ) n_threads = n_items;
+	return n_threads > 0 ? n_threads : 1;
+}
+
+void
+parallel_for( Size const n_items, Size const n_threads, ParallelForWork const & work )
+{
+	Size const n_slots = parallel_thread_count( n_items, n_threads );
+
+#if defined MULTI_THREADED && defined CXX11
+	if ( n_slots > 1 ) {
+		ParallelForBatch batch( n_items, n_slots, work );
+		ParallelForPool::get_instance().run( batch );
+		if ( batch.error ) std::rethrow_exception( batch.error );
+		return;
+	}
+#endif
+
+	for ( Size ii = 1; ii <= n_items; ++ii ) work( ii, 1 );
+}
+
+} // namespace thread
+} // namespace utility
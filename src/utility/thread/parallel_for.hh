@@ -0,0 +1,50 @@
+// -*- mode:c++;tab-width:2;indent-tabs-mode:t;show-trailing-whitespace:t;rm-trailing-spaces:t -*-
+// vi: set ts=2 noet:
+//
+// (c) Copyright Rosetta Commons Member Institutions.
+// (c) This file is part of the Rosetta software suite and is made available under license.
+// (c) The Rosetta software is developed by the contributing members of the Rosetta Commons.
+// (c) For more information, see http://www.rosettacommons.org. Questions about this can be
+// (c) addressed to University of Washington UW TechTransfer, email: license@u.washington.edu.
+
+/// @file   utility/thread/parallel_for.hh
+/// @brief  Run the items of a loop on the threads of a persistent pool
+
+#ifndef INCLUDED_utility_thread_parallel_for_HH
+#define INCLUDED_utility_thread_parallel_for_HH
+
+// Platform headers
+#include <platform/types.hh>
+
+// Boost headers
+#include <boost/function.hpp>
+
+namespace utility {
+namespace thread {
+
+/// @brief The work for one item of a parallel_for(): work( item, thread ), where thread, from 1 to
+/// the thread count, names the thread running the item.  No two items run at the same time on the
+/// same thread index, so per-thread data can be kept in a vector indexed by it.
+typedef boost::function< void ( platform::Size, platform::Size ) > ParallelForWork;
+
+/// @brief The number of threads parallel_for() runs n_items on when asked for n_threads: the
+/// hardware concurrency if n_threads is 0, and never more than n_items or less than 1.  Always 1
+/// in a build without thread support.
+platform::Size
+parallel_thread_count( platform::Size n_items, platform::Size n_threads );
+
+/// @brief Call work for every item from 1 to n_items, on parallel_thread_count( n_items, n_threads )
+/// threads.  Items are handed out one at a time, in order, so slow items do not leave threads idle.
+/// @details The calling thread works as thread 1; the other threads come from a pool that is started
+/// once and then reused, so a call costs no thread start-up.  The call returns once every item has
+/// run.  A pool thread that is busy elsewhere simply does not join, and the calling thread runs
+/// whatever items are left, so parallel_for() may be called from inside another parallel_for().
+/// If work throws, no further items are started, and the first exception is rethrown once the items
+/// already running have finished.
+void
+parallel_for( platform::Size n_items, platform::Size n_threads, ParallelForWork const & work );
+
+} // namespace thread
+} // namespace utility
+
+#endif